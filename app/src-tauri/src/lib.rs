@@ -1,7 +1,134 @@
-use std::process::Command;
+use std::io::{BufRead, BufReader, Write};
+use std::process::{Child, ChildStdin, ChildStdout, Command, Stdio};
+use std::sync::Mutex;
 
+// Long-lived `contam_engine --server` process speaking newline-delimited
+// JSON-RPC. Reusing it skips process start-up on every run; servers are
+// started on demand and kept in a small idle pool (IDLE_SERVERS).
+struct EngineServer {
+    child: Child,
+    stdin: ChildStdin,
+    stdout: BufReader<ChildStdout>,
+    next_id: u64,
+}
+
+enum CallError {
+    // The engine rejected the request (bad model, failed solve)
+    Engine(String),
+    // The server process is gone or its output is unreadable
+    Transport(String),
+}
+
+impl EngineServer {
+    fn spawn() -> Result<Self, String> {
+        let engine_path = find_engine_path();
+        let mut child = Command::new(&engine_path)
+            .arg("--server")
+            .stdin(Stdio::piped())
+            .stdout(Stdio::piped())
+            .stderr(Stdio::inherit())
+            .spawn()
+            .map_err(|e| format!("Failed to start engine server '{}': {}", engine_path, e))?;
+        let stdin = child.stdin.take().ok_or("Engine server stdin unavailable")?;
+        let stdout = child.stdout.take().ok_or("Engine server stdout unavailable")?;
+        Ok(Self { child, stdin, stdout: BufReader::new(stdout), next_id: 0 })
+    }
+
+    // Send one request (`params` is a JSON object text) and wait for its response
+    fn call(&mut self, method: &str, params: &str) -> Result<serde_json::Value, CallError> {
+        self.next_id += 1;
+        let id = self.next_id;
+        // Requests are one line each; JSON needs no raw newlines outside strings
+        let params = params.replace(['\n', '\r'], " ");
+        writeln!(self.stdin, r#"{{"jsonrpc":"2.0","id":{},"method":"{}","params":{}}}"#, id, method, params)
+            .and_then(|_| self.stdin.flush())
+            .map_err(|e| CallError::Transport(format!("Engine server write failed: {}", e)))?;
+
+        let mut line = String::new();
+        loop {
+            line.clear();
+            let n = self.stdout.read_line(&mut line)
+                .map_err(|e| CallError::Transport(format!("Engine server read failed: {}", e)))?;
+            if n == 0 {
+                return Err(CallError::Transport("Engine server exited".to_string()));
+            }
+            let mut response: serde_json::Value = serde_json::from_str(&line)
+                .map_err(|e| CallError::Transport(format!("Bad engine server response: {}", e)))?;
+            if response["id"].as_u64() != Some(id) {
+                continue; // reply to an earlier, abandoned request
+            }
+            if let Some(error) = response.get("error") {
+                return Err(CallError::Engine(format!("Engine failed: {}",
+                    error["message"].as_str().unwrap_or("unknown error"))));
+            }
+            return Ok(response["result"].take());
+        }
+    }
+}
+
+impl Drop for EngineServer {
+    fn drop(&mut self) {
+        let _ = self.child.kill();
+        let _ = self.child.wait();
+    }
+}
+
+// Idle engine servers. Each run takes one out, or starts a new one when none
+// is idle, so concurrent runs (or a run the UI gave up waiting for) each have
+// their own process instead of queueing behind a single server. A server is
+// put back after its run unless its transport failed.
+static IDLE_SERVERS: Mutex<Vec<EngineServer>> = Mutex::new(Vec::new());
+// Servers returned beyond this many idle ones are shut down
+const MAX_IDLE_SERVERS: usize = 2;
+
+fn release_server(server: EngineServer) {
+    let mut idle = IDLE_SERVERS.lock().unwrap_or_else(|e| e.into_inner());
+    if idle.len() < MAX_IDLE_SERVERS {
+        idle.push(server);
+    }
+}
+
+// Async so the run happens off the main thread and runs can overlap
 #[tauri::command]
-fn run_engine(input: String) -> Result<String, String> {
+async fn run_engine(input: String) -> Result<String, String> {
+    tauri::async_runtime::spawn_blocking(move || run_engine_blocking(&input))
+        .await
+        .map_err(|e| format!("Engine run aborted: {}", e))?
+}
+
+// Ok carries the engine's result document, including runs that did not
+// converge or complete (the document says so); Err is an engine or I/O error.
+// Both the server and the process path follow this.
+fn run_engine_blocking(input: &str) -> Result<String, String> {
+    let idle = IDLE_SERVERS.lock().unwrap_or_else(|e| e.into_inner()).pop();
+    let mut server = match idle.map_or_else(EngineServer::spawn, Ok) {
+        Ok(s) => s,
+        // Engines without server support still work one run at a time
+        Err(_) => return run_engine_process(input),
+    };
+    let params = format!(r#"{{"model":{}}}"#, input);
+    match server.call("execute", &params) {
+        Ok(result) => {
+            release_server(server);
+            Ok(result.to_string())
+        }
+        Err(CallError::Engine(message)) => {
+            release_server(server);
+            Err(message)
+        }
+        Err(CallError::Transport(message)) => {
+            log::warn!("{}; running the engine as a separate process", message);
+            drop(server);
+            run_engine_process(input)
+        }
+    }
+}
+
+// contam_engine exit status for results that did not converge or complete
+const ENGINE_EXIT_INCOMPLETE: i32 = 2;
+
+// One engine process per run, exchanging temp files
+fn run_engine_process(input: &str) -> Result<String, String> {
     let temp_dir = std::env::temp_dir();
     // C-06: Use UUID to avoid temp file collisions from concurrent runs
     let run_id = uuid::Uuid::new_v4().to_string();
@@ -9,13 +136,16 @@ fn run_engine(input: String) -> Result<String, String> {
     let output_path = temp_dir.join(format!("contam_output_{}.json", run_id));
 
     // Write input JSON to temp file
-    std::fs::write(&input_path, &input)
+    std::fs::write(&input_path, input)
         .map_err(|e| format!("Failed to write input file: {}", e))?;
 
     // Find engine executable (look relative to app executable, then in PATH)
     let engine_path = find_engine_path();
 
-    // Call engine CLI
+    // Call engine CLI. Compiled model caches are keyed by content hash and
+    // kept in the engine's per-user cache, which it prunes by size and age,
+    // so unchanged models skip JSON parsing even though each run uses a
+    // fresh temp file.
     let result = Command::new(&engine_path)
         .arg("-i")
         .arg(&input_path)
@@ -25,22 +155,26 @@ fn run_engine(input: String) -> Result<String, String> {
         .output()
         .map_err(|e| format!("Failed to run engine '{}': {}", engine_path, e))?;
 
-    if !result.status.success() {
+    // Exit code 2 means the results were written but the run did not
+    // converge or complete (or some sweep variants failed). The server path
+    // returns those results as Ok with `converged` / `completed` / `sweep.ok`
+    // in the document, so this path does the same; only errors are Err.
+    let wrote_results = result.status.success() || result.status.code() == Some(ENGINE_EXIT_INCOMPLETE);
+    let output = if wrote_results {
+        std::fs::read_to_string(&output_path)
+            .map_err(|e| format!("Failed to read output file: {}", e))
+    } else {
         let stderr = String::from_utf8_lossy(&result.stderr);
         let stdout = String::from_utf8_lossy(&result.stdout);
-        return Err(format!("Engine failed (exit code {:?}):\n{}\n{}", 
-            result.status.code(), stdout, stderr));
-    }
-
-    // Read output JSON
-    let output = std::fs::read_to_string(&output_path)
-        .map_err(|e| format!("Failed to read output file: {}", e))?;
+        Err(format!("Engine failed (exit code {:?}):\n{}\n{}",
+            result.status.code(), stdout, stderr))
+    };
 
     // Cleanup temp files
     let _ = std::fs::remove_file(&input_path);
     let _ = std::fs::remove_file(&output_path);
 
-    Ok(output)
+    output
 }
 
 fn find_engine_path() -> String {
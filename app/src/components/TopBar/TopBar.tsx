@@ -97,7 +97,12 @@ export default function TopBar() {
         } else {
           setResult(parsed);
         }
-        toast({ title: '求解完成', description: parsed.timeSeries ? `瞬态仿真完成，${parsed.totalSteps} 步` : '稳态收敛', variant: 'success' });
+        // Runs that did not converge or complete still return their results
+        const finished = parsed.timeSeries ? parsed.completed !== false : parsed.solver?.converged !== false;
+        const description = parsed.timeSeries
+          ? `瞬态仿真${finished ? '完成' : '未完成'}，${parsed.totalSteps} 步`
+          : (finished ? '稳态收敛' : '稳态未收敛');
+        toast({ title: '求解完成', description, variant: finished ? 'success' : 'destructive' });
         setAppMode('results');
       } else {
         // C-05: Browser mode — warn user that results are mock data
@@ -0,0 +1,75 @@
+#include "SyntheticModel.h"
+#include <algorithm>
+#include <string>
+
+namespace contam {
+
+using json = nlohmann::json;
+
+json makeSyntheticModel(int zones, int species, double hours) {
+    zones = std::max(zones, 1);
+    const int floors = std::clamp(zones / 20, 1, 60);
+    const int perFloor = (zones + floors - 1) / floors;
+    const double floorHeight = 3.5;
+
+    json model;
+    model["ambient"] = {{"temperature", 278.15}, {"windSpeed", 4.0}, {"windDirection", 200.0}};
+    model["flowElements"] = {
+        {"facade", {{"type", "PowerLawOrifice"}, {"C", 0.0008}, {"n", 0.65}}},
+        {"door", {{"type", "PowerLawOrifice"}, {"C", 0.02}, {"n", 0.6}}},
+        {"stair", {{"type", "PowerLawOrifice"}, {"C", 0.05}, {"n", 0.6}}}};
+
+    // Facades: north, east, south, west
+    json nodes = json::array();
+    const double cps[4] = {0.6, -0.3, -0.5, -0.3};
+    for (int f = 0; f < 4; ++f) {
+        nodes.push_back({{"id", f}, {"name", "Facade " + std::to_string(f)}, {"type", "ambient"},
+                         {"temperature", 278.15}, {"windCp", cps[f]}, {"wallAzimuth", 90.0 * f}});
+    }
+
+    json links = json::array();
+    int linkId = 1;
+    auto link = [&](int from, int to, double elevation, const char* element) {
+        links.push_back({{"id", linkId++}, {"from", from}, {"to", to},
+                         {"elevation", elevation}, {"element", element}});
+    };
+
+    const int first = 4;
+    for (int z = 0; z < zones; ++z) {
+        const int id = first + z;
+        const int floor = z / perFloor;
+        const int room = z % perFloor;
+        const double base = floor * floorHeight;
+        nodes.push_back({{"id", id}, {"name", "F" + std::to_string(floor) + "R" + std::to_string(room)},
+                         {"temperature", 293.15 + (z % 5) * 0.5}, {"elevation", base},
+                         {"volume", room == 0 ? 30.0 : 60.0 + (z % 7) * 10.0}});
+
+        link(z % 4, id, base + 1.2, "facade");
+        if (room > 0) link(id - 1, id, base + 1.0, "door");
+        if (room == 0 && floor > 0) link(id - perFloor, id, base, "stair");
+    }
+    model["nodes"] = std::move(nodes);
+    model["links"] = std::move(links);
+
+    if (species > 0) {
+        json sp = json::array(), sources = json::array();
+        for (int k = 0; k < species; ++k) {
+            sp.push_back({{"id", k}, {"name", "S" + std::to_string(k)}, {"molarMass", 0.044},
+                          {"outdoorConcentration", 1e-6 * (k + 1)}, {"decayRate", k % 2 ? 1e-5 : 0.0}});
+            for (int z = k % 10; z < zones; z += 10) {
+                sources.push_back({{"zoneId", first + z}, {"speciesId", k}, {"generationRate", 1e-7}});
+            }
+        }
+        model["species"] = std::move(sp);
+        model["sources"] = std::move(sources);
+    }
+
+    // Trust region stalls on stacked floors (see Solver/Steady/TrustRegion),
+    // so runs use sub-relaxation and time converged steps
+    model["transient"] = {{"startTime", 0.0}, {"endTime", hours * 3600.0},
+                          {"timeStep", 300.0}, {"outputInterval", 900.0},
+                          {"airflowMethod", "subRelaxation"}};
+    return model;
+}
+
+} // namespace contam
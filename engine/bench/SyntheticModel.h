@@ -0,0 +1,16 @@
+#pragma once
+#include <nlohmann/json.hpp>
+
+namespace contam {
+
+// Model JSON of an office building with `zones` rooms for the benchmarks.
+// Rooms are spread over up to 60 floors; the rooms of a floor open into
+// each other in a row, every room leaks to one of four facade ambient nodes
+// (one wind pressure coefficient per orientation) and the first room of
+// each floor is a stairwell connected to the floors above and below.
+// `species` species get an outdoor level and a constant source in every
+// tenth room; `hours` sets the transient end time (5 min steps, solved
+// with sub-relaxation).
+nlohmann::json makeSyntheticModel(int zones, int species = 0, double hours = 1.0);
+
+} // namespace contam
@@ -0,0 +1,82 @@
+// Flow element kernels: calculate() over a pressure sweep that covers both
+// the linearized (|ΔP| < DP_MIN) and the power-law regime.
+#include <benchmark/benchmark.h>
+#include "elements/BackdraftDamper.h"
+#include "elements/CheckValve.h"
+#include "elements/Damper.h"
+#include "elements/Duct.h"
+#include "elements/Fan.h"
+#include "elements/Filter.h"
+#include "elements/PowerLawOrifice.h"
+#include "elements/QuadraticElement.h"
+#include "elements/ReturnGrille.h"
+#include "elements/SelfRegulatingVent.h"
+#include "elements/SupplyDiffuser.h"
+#include "elements/TwoWayFlow.h"
+#include "elements/UVGIFilter.h"
+#include "utils/Constants.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace contam;
+
+const std::vector<double>& pressureSweep() {
+    static const std::vector<double> dps = [] {
+        std::vector<double> v;
+        for (int i = 0; i < 1024; ++i) {
+            const double u = (i - 512) / 512.0;
+            // A quarter of the points fall below DP_MIN
+            v.push_back(i % 4 == 0 ? u * DP_MIN : u * 50.0);
+        }
+        return v;
+    }();
+    return dps;
+}
+
+void elementKernel(benchmark::State& state, const FlowElement* element) {
+    const auto& dps = pressureSweep();
+    for (auto _ : state) {
+        for (double dp : dps) {
+            FlowResult r = element->calculate(dp, 1.2);
+            benchmark::DoNotOptimize(r);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(dps.size()));
+}
+
+std::vector<std::unique_ptr<FlowElement>> makeElements() {
+    std::vector<std::unique_ptr<FlowElement>> e;
+    e.push_back(std::make_unique<PowerLawOrifice>(0.003, 0.65));
+    e.push_back(std::make_unique<Fan>(std::vector<double>{0.5, -0.002, -1e-5}));
+    e.push_back(std::make_unique<TwoWayFlow>(0.6, 1.8, 2.0, 0.9));
+    e.push_back(std::make_unique<Duct>(5.0, 0.3, 0.0001, 1.5));
+    e.push_back(std::make_unique<Damper>(0.05, 0.5, 0.6));
+    e.push_back(std::make_unique<Filter>(0.02, 0.6, 0.85));
+    e.push_back(std::make_unique<SelfRegulatingVent>(0.01));
+    e.push_back(std::make_unique<CheckValve>(0.01, 0.5));
+    e.push_back(std::make_unique<QuadraticElement>(100.0, 2000.0));
+    e.push_back(std::make_unique<BackdraftDamper>(0.02, 0.5, 0.001, 0.65));
+    e.push_back(std::make_unique<SupplyDiffuser>(0.03));
+    e.push_back(std::make_unique<ReturnGrille>(0.03));
+    UVGIFilter::UVGIParams uv;
+    uv.k = 0.001;
+    uv.irradiance = 50.0;
+    uv.chamberVolume = 0.05;
+    e.push_back(std::make_unique<UVGIFilter>(0.02, 0.6, uv));
+    return e;
+}
+
+// One "Element/<type>" benchmark per element type
+const bool registered = [] {
+    static const auto elements = makeElements();
+    for (const auto& element : elements) {
+        benchmark::RegisterBenchmark(("Element/" + element->typeName()).c_str(), elementKernel,
+                                     element.get());
+    }
+    return true;
+}();
+
+} // namespace
@@ -0,0 +1,108 @@
+// Model loading, result writing and post-run reports
+#include <benchmark/benchmark.h>
+#include "SyntheticModel.h"
+#include "core/BatchSolve.h"
+#include "core/Solver.h"
+#include "core/TransientSimulation.h"
+#include "io/AchReport.h"
+#include "io/CsmReport.h"
+#include "io/JsonReader.h"
+#include "io/JsonWriter.h"
+#include <string>
+
+namespace {
+
+using namespace contam;
+
+// A model with a solved steady state and a 6 h transient history
+struct SolvedModel {
+    ModelInput model;
+    SolverResult steady;
+    TransientResult transient;
+};
+
+SolvedModel solveSynthetic(int zones, int species) {
+    auto j = makeSyntheticModel(zones, species, 6.0);
+    SolvedModel s{JsonReader::readModelFromJson(j), {}, {}};
+    Network steadyNet = s.model.network;
+    s.steady = Solver(SolverMethod::SubRelaxation).solve(steadyNet);
+    Network transientNet = s.model.network;
+    TransientSimulation sim;
+    configureSimulation(sim, s.model);
+    s.transient = sim.run(transientNet);
+    s.model.network = std::move(steadyNet);
+    return s;
+}
+
+void BM_JsonLoad(benchmark::State& state) {
+    const std::string text = makeSyntheticModel(static_cast<int>(state.range(0)), 2).dump();
+    for (auto _ : state) {
+        ModelInput model = JsonReader::readModelFromString(text);
+        benchmark::DoNotOptimize(model.network.getNodeCount());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+BENCHMARK(BM_JsonLoad)
+    ->Name("Json/Load")
+    ->RangeMultiplier(10)->Range(10, 100000)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_JsonWriteSteady(benchmark::State& state) {
+    const SolvedModel s = solveSynthetic(static_cast<int>(state.range(0)), 0);
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        std::string out = JsonWriter::writeToString(s.model.network, s.steady, -1);
+        bytes = out.size();
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_JsonWriteSteady)
+    ->Name("Json/WriteSteady")
+    ->RangeMultiplier(10)->Range(10, 10000)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_JsonWriteTransient(benchmark::State& state) {
+    const SolvedModel s = solveSynthetic(static_cast<int>(state.range(0)), 2);
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        std::string out = JsonWriter::writeTransientToString(s.model.network, s.transient, s.model.species);
+        bytes = out.size();
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+    state.counters["outputSteps"] = static_cast<double>(s.transient.history.size());
+}
+BENCHMARK(BM_JsonWriteTransient)
+    ->Name("Json/WriteTransient")
+    ->Arg(20)->Arg(200)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_AchReport(benchmark::State& state) {
+    const SolvedModel s = solveSynthetic(static_cast<int>(state.range(0)), 0);
+    for (auto _ : state) {
+        auto results = AchReport::compute(s.model.network, s.steady.massFlows);
+        std::string text = AchReport::formatText(results);
+        benchmark::DoNotOptimize(text.data());
+    }
+}
+BENCHMARK(BM_AchReport)
+    ->Name("Report/Ach")
+    ->RangeMultiplier(10)->Range(10, 10000)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_CsmReport(benchmark::State& state) {
+    const SolvedModel s = solveSynthetic(static_cast<int>(state.range(0)), 2);
+    for (auto _ : state) {
+        auto results = CsmReport::compute(s.model.network, s.model.species, s.transient.history,
+                                          s.model.sources, s.model.schedules);
+        std::string text = CsmReport::formatText(results);
+        benchmark::DoNotOptimize(text.data());
+    }
+}
+BENCHMARK(BM_CsmReport)
+    ->Name("Report/Csm")
+    ->Arg(20)->Arg(200)
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
@@ -0,0 +1,17 @@
+// contam_bench entry point. Results are machine readable with the usual
+// Google Benchmark flags, e.g.
+//   contam_bench --benchmark_out=bench.json --benchmark_out_format=json
+// and every run records the engine version and thread count in its context.
+#include <benchmark/benchmark.h>
+#include "utils/ThreadPool.h"
+#include <string>
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::AddCustomContext("contam_engine_version", CONTAM_ENGINE_VERSION);
+    benchmark::AddCustomContext("contam_threads", std::to_string(contam::ThreadPool::sharedThreads()));
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
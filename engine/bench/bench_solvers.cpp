@@ -0,0 +1,117 @@
+// Airflow and transport solvers and a whole transient day on synthetic
+// buildings (bench/SyntheticModel.h)
+#include <benchmark/benchmark.h>
+#include "SyntheticModel.h"
+#include "core/BatchSolve.h"
+#include "core/ContaminantSolver.h"
+#include "core/Solver.h"
+#include "core/TransientSimulation.h"
+#include "io/JsonReader.h"
+
+namespace {
+
+using namespace contam;
+
+ModelInput loadSynthetic(int zones, int species = 0, double hours = 1.0) {
+    auto j = makeSyntheticModel(zones, species, hours);
+    return JsonReader::readModelFromJson(j);
+}
+
+void setSizeCounters(benchmark::State& state, const Network& network) {
+    state.counters["nodes"] = network.getNodeCount();
+    state.counters["links"] = network.getLinkCount();
+}
+
+// Cold-start steady solve; the solver (and its cached equation ordering)
+// is reused across iterations as a transient run would. The counters show
+// whether the method converged and in how many Newton iterations.
+void BM_SteadySolve(benchmark::State& state, SolverMethod method) {
+    const int zones = static_cast<int>(state.range(0));
+    const ModelInput model = loadSynthetic(zones);
+    Solver solver(method);
+    int iterations = 0;
+    bool converged = true;
+    for (auto _ : state) {
+        state.PauseTiming();
+        Network network = model.network;
+        state.ResumeTiming();
+        SolverResult r = solver.solve(network);
+        iterations = r.iterations;
+        converged = converged && r.converged;
+        benchmark::DoNotOptimize(r.maxResidual);
+    }
+    setSizeCounters(state, model.network);
+    state.counters["newtonIterations"] = iterations;
+    state.counters["converged"] = converged ? 1 : 0;
+    state.SetComplexityN(zones);
+}
+BENCHMARK_CAPTURE(BM_SteadySolve, trustRegion, SolverMethod::TrustRegion)
+    ->Name("Solver/Steady/TrustRegion")
+    ->RangeMultiplier(10)->Range(10, 100000)
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity();
+BENCHMARK_CAPTURE(BM_SteadySolve, subRelaxation, SolverMethod::SubRelaxation)
+    ->Name("Solver/Steady/SubRelaxation")
+    ->RangeMultiplier(10)->Range(10, 100000)
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity();
+
+// One implicit transport step with the airflow solution fixed
+void BM_TransportStep(benchmark::State& state) {
+    const int zones = static_cast<int>(state.range(0));
+    const int species = static_cast<int>(state.range(1));
+    ModelInput model = loadSynthetic(zones, species);
+    Solver(SolverMethod::SubRelaxation).solve(model.network);
+
+    ContaminantSolver transport;
+    transport.setSpecies(model.species);
+    transport.setSources(model.sources);
+    transport.setSchedules(model.schedules);
+    transport.initialize(model.network);
+    double t = 0.0;
+    for (auto _ : state) {
+        ContaminantResult r = transport.step(model.network, t, 300.0);
+        benchmark::DoNotOptimize(r.concentrations.data());
+        t += 300.0;
+    }
+    setSizeCounters(state, model.network);
+    state.counters["species"] = species;
+    state.SetItemsProcessed(state.iterations() * zones * species);
+}
+BENCHMARK(BM_TransportStep)
+    ->Name("Transport/Step")
+    ->ArgNames({"zones", "species"})
+    ->ArgsProduct({{10, 50, 200}, {1, 4, 16}})
+    ->Args({800, 1})
+    ->Args({800, 4})
+    ->Unit(benchmark::kMicrosecond);
+
+// 24 h at 5 min steps with airflow, transport and recording
+void BM_TransientDay(benchmark::State& state) {
+    const int zones = static_cast<int>(state.range(0));
+    const ModelInput model = loadSynthetic(zones, 2, 24.0);
+    std::size_t steps = 0, unconverged = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        Network network = model.network;
+        TransientSimulation sim;
+        configureSimulation(sim, model);
+        state.ResumeTiming();
+        TransientResult r = sim.run(network);
+        steps = r.history.size();
+        unconverged = 0;
+        for (const auto& step : r.history) unconverged += step.airflow.converged ? 0 : 1;
+        benchmark::DoNotOptimize(r.completed);
+    }
+    setSizeCounters(state, model.network);
+    state.counters["outputSteps"] = static_cast<double>(steps);
+    state.counters["unconvergedOutputSteps"] = static_cast<double>(unconverged);
+    state.counters["simSecondsPerSecond"] = benchmark::Counter(
+        24.0 * 3600.0 * state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_TransientDay)
+    ->Name("Transient/Day")
+    ->Arg(20)->Arg(200)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -1,5 +1,6 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
 #include <pybind11/functional.h>
 
 #include "core/Node.h"
@@ -10,6 +11,7 @@
 #include "core/Schedule.h"
 #include "core/ContaminantSolver.h"
 #include "core/TransientSimulation.h"
+#include "core/BatchSolve.h"
 #include "elements/FlowElement.h"
 #include "elements/PowerLawOrifice.h"
 #include "elements/Fan.h"
@@ -24,14 +26,218 @@
 #include "control/LogicNodes.h"
 #include "io/JsonReader.h"
 #include "io/JsonWriter.h"
+#include "io/ModelCache.h"
 #include "io/ValReport.h"
 #include "io/EbwReport.h"
 #include "io/CexReport.h"
 #include "io/LogReport.h"
+#include "io/ResultRecorder.h"
+
+#include <chrono>
+#include <mutex>
 
 namespace py = pybind11;
 using namespace contam;
 
+// TransientResult::history is exposed as a list-like view instead of being
+// converted to a Python list of copies
+PYBIND11_MAKE_OPAQUE(std::vector<contam::TimeStepResult>)
+
+// ── NumPy views ──────────────────────────────────────────────────────
+// Read-only C-contiguous ndarray over engine memory. `owner` becomes the
+// array's base and keeps that memory alive as long as the array (or any
+// view derived from it) exists.
+static py::array readOnlyView(const py::dtype& dtype, const void* data,
+                              std::vector<py::ssize_t> shape, py::handle owner) {
+    std::vector<py::ssize_t> strides(shape.size());
+    py::ssize_t stride = dtype.itemsize();
+    for (std::size_t d = shape.size(); d-- > 0;) {
+        strides[d] = stride;
+        stride *= shape[d];
+    }
+    py::array a(dtype, std::move(shape), std::move(strides), data, owner);
+    a.attr("flags").attr("writeable") = false;
+    return a;
+}
+
+static py::array vectorView(const std::vector<double>& v, py::handle owner) {
+    return readOnlyView(py::dtype::of<double>(), v.data(),
+                        {static_cast<py::ssize_t>(v.size())}, owner);
+}
+
+// Capsule holding a reference to engine-owned results; views of a recorder
+// stay valid after the recorder starts another run or is destroyed
+template <typename T>
+static py::capsule keepAlive(std::shared_ptr<const T> results) {
+    return py::capsule(new std::shared_ptr<const T>(std::move(results)),
+                       [](void* p) { delete static_cast<std::shared_ptr<const T>*>(p); });
+}
+
+template <typename T>
+static py::array stackedView(const std::vector<T>& v, std::vector<py::ssize_t> shape,
+                             const py::capsule& owner) {
+    return readOnlyView(py::dtype::of<T>(), v.data(), std::move(shape), owner);
+}
+
+// ── Progress callbacks ───────────────────────────────────────────────
+// Adapts a Python callable for engine code that runs without the GIL. The
+// callable is invoked at most once per `interval` seconds, and always for
+// the final report (current >= total). Calls in between only compare
+// timestamps and return the last answer, so worker threads do not contend
+// for the interpreter; neither do reports made while another thread is
+// inside the callable. Returning False from the callable cancels; None
+// continues. An exception from the callable propagates out of the engine
+// call that reported progress.
+class ThrottledProgress {
+public:
+    ThrottledProgress(py::function fn, double interval) : state_(std::make_shared<State>()) {
+        // Copies of the engine-side std::function must not touch Python
+        // refcounts without the GIL, so the callable is held behind a
+        // shared_ptr whose deleter takes the GIL
+        state_->fn = std::shared_ptr<py::function>(new py::function(std::move(fn)),
+                                                   [](py::function* f) {
+                                                       py::gil_scoped_acquire gil;
+                                                       delete f;
+                                                   });
+        state_->interval = std::chrono::duration<double>(interval);
+    }
+
+    template <typename Number>
+    bool operator()(Number current, Number total) const {
+        State& s = *state_;
+        {
+            // The mutex only guards the throttle state; it is never held
+            // while waiting for the GIL or running Python, so a slow
+            // callable does not stall the other workers
+            std::lock_guard<std::mutex> lock(s.mutex);
+            const bool final = !(current < total);
+            const auto now = std::chrono::steady_clock::now();
+            if (s.inCall && !final) return s.keepGoing;
+            if (!final && s.called && now - s.last < s.interval) return s.keepGoing;
+            s.last = now;
+            s.called = true;
+            s.inCall = true;
+        }
+
+        bool keepGoing = true;
+        try {
+            py::gil_scoped_acquire gil;
+            py::object answer = (*s.fn)(current, total);
+            keepGoing = answer.is_none() || answer.cast<bool>();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.inCall = false;
+            s.keepGoing = false;
+            throw;
+        }
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.inCall = false;
+        s.keepGoing = s.keepGoing && keepGoing;
+        return keepGoing;
+    }
+
+private:
+    struct State {
+        std::shared_ptr<py::function> fn;
+        std::chrono::duration<double> interval{0.0};
+        std::mutex mutex;
+        std::chrono::steady_clock::time_point last;
+        bool called = false;
+        bool inCall = false;     // a thread is running the callable
+        bool keepGoing = true;   // sticky: once cancelled, stays cancelled
+    };
+    std::shared_ptr<State> state_;
+};
+
+using BatchValues = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+// Parameter sets as a (sets, parameters) array; 1-D is one parameter per set
+static std::size_t batchSetCount(const BatchValues& values, std::size_t numParams) {
+    if (numParams == 0) throw std::runtime_error("at least one parameter name is required");
+    if (values.ndim() == 1 && numParams == 1) return static_cast<std::size_t>(values.shape(0));
+    if (values.ndim() != 2 || static_cast<std::size_t>(values.shape(1)) != numParams) {
+        throw std::runtime_error("values must have shape (sets, len(parameters))");
+    }
+    return static_cast<std::size_t>(values.shape(0));
+}
+
+// ── Incremental runs ─────────────────────────────────────────────────
+// Python iterator over the recorded steps of TransientSimulation.start /
+// advance / finish. Each step is its own engine object, so the arrays of a
+// yielded step stay valid after the loop moves on.
+struct StepIterator {
+    py::object sim;       // TransientSimulation
+    py::object network;   // kept alive for the run
+    bool started = false;
+    bool done = false;
+    py::object result = py::none();
+
+    StepIterator() = default;
+    StepIterator(StepIterator&&) = default;
+    StepIterator& operator=(StepIterator&&) = default;
+
+    // `for step in sim.steps(net): ... break` does not call close(); the
+    // run is finished when the iterator goes away so its sinks are ended
+    // and a ResultRecorder's arrays become readable
+    ~StepIterator() {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    void close() {
+        if (!started || done) return;
+        done = true;
+        auto& s = sim.cast<TransientSimulation&>();
+        TransientResult r;
+        {
+            py::gil_scoped_release release;
+            r = s.finish();
+        }
+        result = py::cast(std::move(r));
+    }
+};
+
+static py::object nextStep(StepIterator& it) {
+    if (it.done) throw py::stop_iteration();
+    auto& sim = it.sim.cast<TransientSimulation&>();
+    auto& network = it.network.cast<Network&>();
+    bool more = true;
+    try {
+        py::gil_scoped_release release;
+        if (it.started) {
+            more = sim.advance();
+        } else {
+            sim.start(network);
+        }
+    } catch (...) {
+        // The run cannot continue; the next start or run on this
+        // simulation ends it
+        it.done = true;
+        throw;
+    }
+    it.started = true;
+    if (!more) {
+        it.close();
+        throw py::stop_iteration();
+    }
+    return py::cast(std::const_pointer_cast<TimeStepResult>(sim.lastStep()));
+}
+
+static BatchProgress batchProgress(const py::object& progress, double minInterval) {
+    if (progress.is_none()) return {};
+    ThrottledProgress throttled(progress.cast<py::function>(), minInterval);
+    return [throttled](std::size_t done, std::size_t total) { return throttled(done, total); };
+}
+
+static std::shared_ptr<const RecordedResults> finishedResults(const ResultRecorder& rec) {
+    if (rec.recording()) {
+        throw std::runtime_error("ResultRecorder: results are still being recorded");
+    }
+    return rec.results();
+}
+
 PYBIND11_MODULE(pycontam, m) {
     m.doc() = "AirSim Studio: Multi-zone airflow and contaminant transport simulation";
 
@@ -128,24 +334,44 @@ PYBIND11_MODULE(pycontam, m) {
             d["mass_flow"] = l.getMassFlow();
             if (l.getFlowElement()) d["element_type"] = l.getFlowElement()->typeName();
             return d;
-        });
+        })
+        // Pickled with the binary model cache format (fast for multiprocessing)
+        .def(py::pickle(
+            [](const Network& net) {
+                ModelInput model;
+                model.network = net;
+                return py::bytes(ModelCache::serialize(model));
+            },
+            [](const py::bytes& image) {
+                return ModelCache::deserialize(std::string(image)).network;
+            }));
 
     // ── SolverResult ─────────────────────────────────────────────────
     py::class_<SolverResult>(m, "SolverResult")
         .def_readonly("converged", &SolverResult::converged)
         .def_readonly("iterations", &SolverResult::iterations)
         .def_readonly("max_residual", &SolverResult::maxResidual)
-        .def_readonly("pressures", &SolverResult::pressures)
-        .def_readonly("mass_flows", &SolverResult::massFlows)
+        // Zero-copy views; the array keeps this result alive
+        .def_property_readonly("pressures", [](py::object self) {
+            return vectorView(self.cast<const SolverResult&>().pressures, self);
+        })
+        .def_property_readonly("mass_flows", [](py::object self) {
+            return vectorView(self.cast<const SolverResult&>().massFlows, self);
+        })
         .def("__repr__", [](const SolverResult& r) {
             return "<SolverResult converged=" + std::string(r.converged ? "True" : "False") +
                    " iterations=" + std::to_string(r.iterations) + ">";
         });
 
     // ── Solver ───────────────────────────────────────────────────────
+    py::enum_<SolverMethod>(m, "SolverMethod")
+        .value("SubRelaxation", SolverMethod::SubRelaxation)
+        .value("TrustRegion", SolverMethod::TrustRegion)
+        .export_values();
+
     py::class_<Solver>(m, "Solver")
-        .def(py::init<>())
-        .def("solve", &Solver::solve);
+        .def(py::init<SolverMethod>(), py::arg("method") = SolverMethod::TrustRegion)
+        .def("solve", &Solver::solve, py::call_guard<py::gil_scoped_release>());
 
     // ── Species ──────────────────────────────────────────────────────
     py::class_<Species>(m, "Species")
@@ -182,28 +408,280 @@ PYBIND11_MODULE(pycontam, m) {
         .def_readwrite("start_time", &TransientConfig::startTime)
         .def_readwrite("end_time", &TransientConfig::endTime)
         .def_readwrite("time_step", &TransientConfig::timeStep)
-        .def_readwrite("output_interval", &TransientConfig::outputInterval);
+        .def_readwrite("output_interval", &TransientConfig::outputInterval)
+        .def_readwrite("airflow_method", &TransientConfig::airflowMethod);
+
+    // ── OutputSpec ───────────────────────────────────────────────────
+    py::enum_<OutputPrecision>(m, "OutputPrecision")
+        .value("Double", OutputPrecision::Double)
+        .value("Float32", OutputPrecision::Float32)
+        .value("Quantized", OutputPrecision::Quantized)
+        .export_values();
+
+    py::class_<OutputSpec>(m, "OutputSpec")
+        .def(py::init<>())
+        .def_readwrite("node_ids", &OutputSpec::nodeIds)
+        .def_readwrite("link_ids", &OutputSpec::linkIds)
+        .def_readwrite("species_ids", &OutputSpec::speciesIds)
+        .def_readwrite("pressure_interval", &OutputSpec::pressureInterval)
+        .def_readwrite("mass_flow_interval", &OutputSpec::massFlowInterval)
+        .def_readwrite("concentration_interval", &OutputSpec::concentrationInterval)
+        .def_readwrite("window_start", &OutputSpec::windowStart)
+        .def_readwrite("window_end", &OutputSpec::windowEnd)
+        .def_readwrite("precision", &OutputSpec::precision)
+        .def_readwrite("significant_digits", &OutputSpec::significantDigits);
 
     // ── ContaminantResult ────────────────────────────────────────
     py::class_<ContaminantResult>(m, "ContaminantResult")
         .def_readonly("time", &ContaminantResult::time)
-        .def_readonly("concentrations", &ContaminantResult::concentrations);
+        // [node, species] array; rows are separate allocations in the
+        // engine, so this one is a copy (ResultRecorder gives views)
+        .def_property_readonly("concentrations", [](const ContaminantResult& r) {
+            const auto& conc = r.concentrations;
+            const std::size_t nodes = conc.size();
+            const std::size_t species = nodes > 0 ? conc[0].size() : 0;
+            py::array_t<double> a({static_cast<py::ssize_t>(nodes), static_cast<py::ssize_t>(species)});
+            auto out = a.mutable_unchecked<2>();
+            for (std::size_t i = 0; i < nodes; ++i) {
+                for (std::size_t k = 0; k < species; ++k) {
+                    out(i, k) = k < conc[i].size() ? conc[i][k] : 0.0;
+                }
+            }
+            return a;
+        });
 
     // ── TimeStepResult ──────────────────────────────────────────────
-    py::class_<TimeStepResult>(m, "TimeStepResult")
+    // shared_ptr holder: steps of an incremental run are shared with the engine
+    py::class_<TimeStepResult, std::shared_ptr<TimeStepResult>>(m, "TimeStepResult")
         .def_readonly("time", &TimeStepResult::time)
         .def_readonly("airflow", &TimeStepResult::airflow)
         .def_readonly("contaminant", &TimeStepResult::contaminant);
 
+    // Read-only: views handed out for a step point into this vector, so
+    // Python must not be able to append, insert or clear it
+    py::class_<std::vector<TimeStepResult>>(m, "TimeStepResultList")
+        .def("__len__", [](const std::vector<TimeStepResult>& v) { return v.size(); })
+        .def("__getitem__", [](const std::vector<TimeStepResult>& v, py::ssize_t i) -> const TimeStepResult& {
+            const auto n = static_cast<py::ssize_t>(v.size());
+            if (i < 0) i += n;
+            if (i < 0 || i >= n) throw py::index_error();
+            return v[static_cast<std::size_t>(i)];
+        }, py::return_value_policy::reference_internal)
+        .def("__iter__", [](const std::vector<TimeStepResult>& v) {
+            return py::make_iterator(v.begin(), v.end());
+        }, py::keep_alive<0, 1>());
+
     // ── TransientResult ──────────────────────────────────────────
     py::class_<TransientResult>(m, "TransientResult")
         .def_readonly("completed", &TransientResult::completed)
         .def_readonly("history", &TransientResult::history);
 
+    // ── ResultSink / ResultRecorder ─────────────────────────────────
+    py::class_<ResultSink, std::shared_ptr<ResultSink>>(m, "ResultSink");
+
+    // Contiguous recording of a run; arrays are zero-copy, read-only views
+    // shaped (time,), (time, node), (time, link) and (time, node, species)
+    py::class_<ResultRecorder, ResultSink, std::shared_ptr<ResultRecorder>>(m, "ResultRecorder")
+        .def(py::init<std::size_t>(), py::arg("expected_steps") = 0)
+        .def("set_expected_steps", &ResultRecorder::setExpectedSteps, py::arg("steps"))
+        .def_property_readonly("recording", &ResultRecorder::recording)
+        .def_property_readonly("completed", &ResultRecorder::completed)
+        .def_property_readonly("step_count", [](const ResultRecorder& rec) {
+            return rec.results()->numSteps();
+        })
+        .def_property_readonly("times", [](const ResultRecorder& rec) {
+            auto r = finishedResults(rec);
+            return readOnlyView(py::dtype::of<double>(), r->times.data(),
+                                {static_cast<py::ssize_t>(r->numSteps())}, keepAlive(r));
+        })
+        .def_property_readonly("iterations", [](const ResultRecorder& rec) {
+            auto r = finishedResults(rec);
+            return readOnlyView(py::dtype::of<int>(), r->iterations.data(),
+                                {static_cast<py::ssize_t>(r->numSteps())}, keepAlive(r));
+        })
+        .def_property_readonly("converged", [](const ResultRecorder& rec) {
+            auto r = finishedResults(rec);
+            return readOnlyView(py::dtype("bool"), r->converged.data(),
+                                {static_cast<py::ssize_t>(r->numSteps())}, keepAlive(r));
+        })
+        .def_property_readonly("pressures", [](const ResultRecorder& rec) {
+            auto r = finishedResults(rec);
+            return readOnlyView(py::dtype::of<double>(), r->pressures.data(),
+                                {static_cast<py::ssize_t>(r->numSteps()),
+                                 static_cast<py::ssize_t>(r->numNodes)}, keepAlive(r));
+        })
+        .def_property_readonly("mass_flows", [](const ResultRecorder& rec) {
+            auto r = finishedResults(rec);
+            return readOnlyView(py::dtype::of<double>(), r->massFlows.data(),
+                                {static_cast<py::ssize_t>(r->numSteps()),
+                                 static_cast<py::ssize_t>(r->numLinks)}, keepAlive(r));
+        })
+        .def_property_readonly("concentrations", [](const ResultRecorder& rec) {
+            auto r = finishedResults(rec);
+            return readOnlyView(py::dtype::of<double>(), r->concentrations.data(),
+                                {static_cast<py::ssize_t>(r->numSteps()),
+                                 static_cast<py::ssize_t>(r->numNodes),
+                                 static_cast<py::ssize_t>(r->numSpecies)}, keepAlive(r));
+        })
+        // Network/species index of each recorded column
+        .def_property_readonly("node_indices", [](const ResultRecorder& rec) {
+            auto r = rec.results();
+            std::vector<int> idx(r->numNodes);
+            for (std::size_t k = 0; k < idx.size(); ++k) idx[k] = r->output.node(k);
+            return idx;
+        })
+        .def_property_readonly("link_indices", [](const ResultRecorder& rec) {
+            auto r = rec.results();
+            std::vector<int> idx(r->numLinks);
+            for (std::size_t k = 0; k < idx.size(); ++k) idx[k] = r->output.link(k);
+            return idx;
+        })
+        .def_property_readonly("species_indices", [](const ResultRecorder& rec) {
+            auto r = rec.results();
+            std::vector<int> idx(r->numSpecies);
+            for (std::size_t k = 0; k < idx.size(); ++k) idx[k] = r->output.species(k);
+            return idx;
+        });
+
+    // ── ModelInput ───────────────────────────────────────────────────
+    py::class_<ModelInput>(m, "ModelInput")
+        .def_readwrite("network", &ModelInput::network)
+        .def_readwrite("species", &ModelInput::species)
+        .def_readwrite("sources", &ModelInput::sources)
+        .def_readwrite("schedules", &ModelInput::schedules)
+        .def_readwrite("transient_config", &ModelInput::transientConfig)
+        .def_readonly("has_transient", &ModelInput::hasTransient)
+        .def_readwrite("output_spec", &ModelInput::outputSpec)
+        .def(py::pickle(
+            [](const ModelInput& model) { return py::bytes(ModelCache::serialize(model)); },
+            [](const py::bytes& image) { return ModelCache::deserialize(std::string(image)); }));
+
+    m.def("load_model", &ModelCache::loadModel,
+          "Load a full model from a JSON file through the compiled model cache",
+          py::arg("path"), py::arg("cache_dir") = "");
+    m.def("load_model_string", &JsonReader::readModelFromString,
+          "Load a full model from a JSON string", py::arg("json_string"));
+
     // ── TransientSimulation ──────────────────────────────────────────
     py::class_<TransientSimulation>(m, "TransientSimulation")
         .def(py::init<>())
-        .def("run", &TransientSimulation::run);
+        .def("set_config", &TransientSimulation::setConfig, py::arg("config"))
+        .def("set_species", &TransientSimulation::setSpecies, py::arg("species"))
+        .def("set_sources", &TransientSimulation::setSources, py::arg("sources"))
+        .def("set_schedules", &TransientSimulation::setSchedules, py::arg("schedules"))
+        .def("set_occupants", &TransientSimulation::setOccupants, py::arg("occupants"))
+        .def("set_output_spec", &TransientSimulation::setOutputSpec, py::arg("spec"))
+        .def("add_result_sink", &TransientSimulation::addResultSink, py::arg("sink"))
+        .def("clear_result_sinks", &TransientSimulation::clearResultSinks)
+        .def("set_store_history", &TransientSimulation::setStoreHistory, py::arg("store"))
+        // callback(t, end_time) -> bool | None, called at most every min_interval seconds
+        .def("set_progress_callback", [](TransientSimulation& sim, py::object callback,
+                                         double minInterval) {
+            if (callback.is_none()) {
+                sim.setProgressCallback(nullptr);
+            } else {
+                sim.setProgressCallback(ThrottledProgress(callback.cast<py::function>(), minInterval));
+            }
+        }, py::arg("callback"), py::arg("min_interval") = 0.1)
+        .def("set_actuators", &TransientSimulation::setActuators, py::arg("actuators"))
+        .def("set_actuator_override", &TransientSimulation::setActuatorOverride,
+             py::arg("actuator_id"), py::arg("value"))
+        .def("clear_actuator_overrides", &TransientSimulation::clearActuatorOverrides)
+        // Runs without the GIL; other Python threads keep running
+        .def("run", &TransientSimulation::run, py::call_guard<py::gil_scoped_release>())
+        // Incremental execution; `network` is kept alive by the simulation
+        .def("start", &TransientSimulation::start, py::arg("network"),
+             py::keep_alive<1, 2>(), py::call_guard<py::gil_scoped_release>())
+        .def("advance", &TransientSimulation::advance, py::call_guard<py::gil_scoped_release>())
+        .def("finish", &TransientSimulation::finish, py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("is_running", &TransientSimulation::isRunning)
+        .def_property_readonly("current_time", &TransientSimulation::currentTime)
+        .def_property_readonly("last_step", [](const TransientSimulation& sim) {
+            return std::const_pointer_cast<TimeStepResult>(sim.lastStep());
+        })
+        // for step in sim.steps(net): ...  (sources, schedules and actuator
+        // overrides may be changed inside the loop; breaking out stops early)
+        .def("steps", [](py::object self, py::object network) {
+            network.cast<Network&>();
+            StepIterator it;
+            it.sim = std::move(self);
+            it.network = std::move(network);
+            return it;
+        }, py::arg("network"));
+
+    py::class_<StepIterator>(m, "StepIterator")
+        .def("__iter__", [](py::object self) { return self; })
+        .def("__next__", &nextStep)
+        .def("close", &StepIterator::close)
+        // TransientResult once the iteration has ended (None before)
+        .def_readonly("result", &StepIterator::result);
+
+    // ── Batch solves and runs ───────────────────────────────────────
+    // Each row of `values` is one parameter set; `parameters` names the
+    // columns ("ambient_temperature", "wind_speed", "wind_direction",
+    // "node_temperature:<id>", "orifice_c:<link id>", "orifice_n:<link id>").
+    // Sets run on the engine's thread pool without the GIL; `threads` caps
+    // the parallelism (0 = all cores). Results are stacked, read-only arrays.
+    m.def("solve_many", [](const Network& network, const BatchValues& values,
+                           const std::vector<std::string>& parameters, SolverMethod method,
+                           unsigned threads, py::object progress, double minInterval) {
+        auto params = parseBatchParameters(parameters, network);
+        const std::size_t sets = batchSetCount(values, params.size());
+        auto callback = batchProgress(progress, minInterval);
+
+        std::shared_ptr<const BatchSolveResult> r;
+        {
+            py::gil_scoped_release release;
+            r = std::make_shared<const BatchSolveResult>(
+                solveMany(network, params, values.data(), sets, ThreadPool::shared(),
+                          method, threads, callback));
+        }
+
+        const auto S = static_cast<py::ssize_t>(r->numSets);
+        const auto N = static_cast<py::ssize_t>(r->numNodes);
+        const auto L = static_cast<py::ssize_t>(r->numLinks);
+        auto owner = keepAlive(r);
+        py::dict out;
+        out["pressures"] = stackedView(r->pressures, {S, N}, owner);
+        out["mass_flows"] = stackedView(r->massFlows, {S, L}, owner);
+        out["iterations"] = stackedView(r->iterations, {S}, owner);
+        out["converged"] = readOnlyView(py::dtype("bool"), r->converged.data(), {S}, owner);
+        return out;
+    }, "Solve steady airflow for many parameter sets in parallel",
+       py::arg("network"), py::arg("values"), py::arg("parameters"),
+       py::arg("method") = SolverMethod::TrustRegion, py::arg("threads") = 0u,
+       py::arg("progress") = py::none(), py::arg("min_interval") = 0.1);
+
+    m.def("run_many", [](const ModelInput& model, const BatchValues& values,
+                         const std::vector<std::string>& parameters, unsigned threads,
+                         py::object progress, double minInterval) {
+        auto params = parseBatchParameters(parameters, model);
+        const std::size_t sets = batchSetCount(values, params.size());
+        auto callback = batchProgress(progress, minInterval);
+
+        std::shared_ptr<const BatchRunResult> r;
+        {
+            py::gil_scoped_release release;
+            r = std::make_shared<const BatchRunResult>(
+                runMany(model, params, values.data(), sets, ThreadPool::shared(), threads, callback));
+        }
+
+        const auto S = static_cast<py::ssize_t>(r->numSets);
+        const auto T = static_cast<py::ssize_t>(r->numSteps);
+        const auto N = static_cast<py::ssize_t>(r->numNodes);
+        const auto L = static_cast<py::ssize_t>(r->numLinks);
+        const auto K = static_cast<py::ssize_t>(r->numSpecies);
+        auto owner = keepAlive(r);
+        py::dict out;
+        out["times"] = stackedView(r->times, {T}, owner);
+        out["pressures"] = stackedView(r->pressures, {S, T, N}, owner);
+        out["mass_flows"] = stackedView(r->massFlows, {S, T, L}, owner);
+        out["concentrations"] = stackedView(r->concentrations, {S, T, N, K}, owner);
+        out["completed"] = readOnlyView(py::dtype("bool"), r->completed.data(), {S}, owner);
+        return out;
+    }, "Run the model's transient simulation for many parameter sets in parallel",
+       py::arg("model"), py::arg("values"), py::arg("parameters"), py::arg("threads") = 0u,
+       py::arg("progress") = py::none(), py::arg("min_interval") = 0.1);
 
     // ── SensorType ──────────────────────────────────────────────────
     py::enum_<SensorType>(m, "SensorType")
@@ -1,8 +1,9 @@
 """Test pycontam Python API"""
 import sys, os, json
 
-# Add build directory to path
-build_dir = os.path.join(os.path.dirname(__file__), '..', 'build', 'Release')
+# Module directory: PYCONTAM_PATH (set by ctest), else the Release build
+build_dir = os.environ.get("PYCONTAM_PATH",
+                           os.path.join(os.path.dirname(__file__), '..', 'build', 'Release'))
 sys.path.insert(0, os.path.abspath(build_dir))
 
 import pycontam as pc
@@ -116,4 +117,110 @@ if os.path.exists(case01_path):
 else:
     print(f"SKIPPED (file not found: {case01_path})")
 
+# ── Test 6: Pickling via the model cache format ──────────────────────
+print("\n=== Test 6: Pickling ===")
+import pickle
+net4 = pickle.loads(pickle.dumps(net))
+assert net4.node_count() == net.node_count()
+assert net4.link_count() == net.link_count()
+r4 = pc.Solver().solve(net4)
+assert abs(r4.pressures[1] - result.pressures[1]) < 1e-12
+print("PASSED")
+
+# ── Test 7: NumPy views of results ──────────────────────────────────
+print("\n=== Test 7: NumPy views ===")
+import numpy as np
+p = result.pressures
+assert isinstance(p, np.ndarray) and p.shape == (2,)
+assert not p.flags.writeable and not p.flags.owndata   # view of engine memory
+del result
+assert abs(p[1] - r4.pressures[1]) < 1e-12             # kept alive by the array
+
+model = pc.load_model_string(json.dumps({
+    "nodes": [
+        {"id": 0, "name": "Out", "type": "ambient", "temperature": 283.15},
+        {"id": 1, "name": "Room", "temperature": 293.15, "volume": 50}
+    ],
+    "links": [
+        {"id": 1, "from": 0, "to": 1, "elevation": 0.5,
+         "element": {"type": "PowerLawOrifice", "C": 0.002, "n": 0.65}},
+        {"id": 2, "from": 1, "to": 0, "elevation": 2.5,
+         "element": {"type": "PowerLawOrifice", "C": 0.002, "n": 0.65}}
+    ],
+    "species": [{"id": 0, "name": "CO2", "molarMass": 0.044}],
+    "sources": [{"zoneId": 1, "speciesId": 0, "generationRate": 1e-5}],
+    "transient": {"endTime": 600, "timeStep": 60, "outputInterval": 60}
+}))
+sim = pc.TransientSimulation()
+sim.set_config(model.transient_config)
+sim.set_species(model.species)
+sim.set_sources(model.sources)
+rec = pc.ResultRecorder()
+sim.add_result_sink(rec)
+tr = sim.run(model.network)
+c = rec.concentrations
+assert c.shape == (11, 2, 1) and not c.flags.owndata
+assert rec.times[-1] == 600.0
+assert c[5, 1, 0] == tr.history[5].contaminant.concentrations[1, 0]
+assert tr.history[5].airflow.pressures[1] == rec.pressures[5, 1]
+p5 = tr.history[5].airflow.pressures
+assert len(tr.history) == 11 and tr.history[-1].time == 600.0
+assert not hasattr(tr.history, "append") and not hasattr(tr.history, "clear")
+tr = sim.run(model.network)                            # earlier views stay valid
+assert c.shape == (11, 2, 1) and rec.concentrations.base is not c.base
+assert p5[1] == rec.pressures[5, 1]                    # p5 keeps its result alive
+print("PASSED")
+
+print("\n=== Test 8: Batch solves ===")
+temps = np.array([263.15, 283.15, 303.15])
+batch = pc.solve_many(model.network, temps, ["ambient_temperature"], threads=2)
+assert batch["pressures"].shape == (3, 2) and batch["converged"].all()
+single = pc.Solver().solve(model.network)
+assert abs(batch["pressures"][1, 1] - single.pressures[1]) < 1e-12
+calls = []
+runs = pc.run_many(model, temps, ["ambient_temperature"],
+                   progress=lambda done, total: calls.append(done), min_interval=0.0)
+assert runs["concentrations"].shape == (3, 11, 2, 1) and runs["completed"].all()
+assert calls[-1] == 3
+try:
+    pc.run_many(model, temps, ["ambient_temperature"], threads=2,
+                progress=lambda done, total: 1 / 0, min_interval=0.0)
+    assert False, "callback error was swallowed"
+except ZeroDivisionError:
+    pass
+print("PASSED")
+
+print("\n=== Test 9: Stepping iterator ===")
+sim.clear_result_sinks()
+sim.set_store_history(False)
+steps = sim.steps(model.network)
+seen = []
+for step in steps:
+    seen.append(step)
+    if step.time >= 300.0:
+        sim.set_sources([])                              # source off mid-run
+    if step.time >= 480.0:
+        break
+steps.close()
+assert [s.time for s in seen] == [0.0, 60.0, 120.0, 180.0, 240.0, 300.0, 360.0, 420.0, 480.0]
+assert not steps.result.completed and not sim.is_running
+assert seen[2].airflow.pressures[1] == tr.history[2].airflow.pressures[1]   # earlier steps stay valid
+
+sim.add_result_sink(rec)
+for step in sim.steps(model.network):                   # break without close()
+    if step.time >= 120.0:
+        break
+import gc; gc.collect()
+assert not sim.is_running and rec.times[-1] == 120.0
+
+sim.set_progress_callback(lambda t, end: 1 / 0, 0.0)
+try:
+    sim.run(model.network)
+    assert False, "callback error was swallowed"
+except ZeroDivisionError:
+    pass
+assert not sim.is_running
+sim.set_progress_callback(None)
+print("PASSED")
+
 print("\n✓ All Python API tests PASSED!")
@@ -0,0 +1,387 @@
+#include "contam_capi.h"
+#include "core/BatchSolve.h"
+#include "io/JsonReader.h"
+#include "io/ModelCache.h"
+#include "io/ResultRecorder.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace contam;
+
+struct contam_model {
+    ModelInput model;
+    Solver solver;   // keeps its equation ordering between solves
+};
+
+struct contam_transient {
+    ModelInput model;   // own copy; the run changes its network
+    TransientSimulation sim;
+    std::shared_ptr<ResultRecorder> recorder;
+    double time = 0.0;
+    bool finished = false;
+    bool completed = false;
+};
+
+namespace {
+
+thread_local std::string lastError;
+
+struct CapiError : std::runtime_error {
+    contam_status status;
+    CapiError(contam_status status, const std::string& message)
+        : std::runtime_error(message), status(status) {}
+};
+
+// Run `fn`, turning every exception into a status and a thread-local message
+template <typename Fn>
+contam_status guarded(Fn&& fn) {
+    try {
+        fn();
+        return CONTAM_OK;
+    } catch (const CapiError& e) {
+        lastError = e.what();
+        return e.status;
+    } catch (const nlohmann::json::exception& e) {
+        lastError = e.what();
+        return CONTAM_ERROR_PARSE;
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        return CONTAM_ERROR_ENGINE;
+    } catch (...) {
+        lastError = "unknown error";
+        return CONTAM_ERROR_ENGINE;
+    }
+}
+
+template <typename T>
+void require(const T* p, const char* what) {
+    if (!p) throw CapiError(CONTAM_ERROR_INVALID_ARGUMENT, std::string(what) + " is NULL");
+}
+
+// Copy `n` values to a caller buffer of `capacity` elements
+template <typename T>
+void copyOut(const T* data, std::size_t n, T* out, std::size_t capacity, std::size_t* count) {
+    if (count) *count = n;
+    if (n == 0) return;
+    if (!out || capacity < n) {
+        throw CapiError(CONTAM_ERROR_BUFFER_TOO_SMALL,
+                        "buffer holds " + std::to_string(capacity) + " of " + std::to_string(n) + " values");
+    }
+    std::copy(data, data + n, out);
+}
+
+template <typename T>
+void copyOut(const std::vector<T>& v, T* out, std::size_t capacity, std::size_t* count) {
+    copyOut(v.data(), v.size(), out, capacity, count);
+}
+
+SolverMethod solverMethod(contam_method method) {
+    switch (method) {
+    case CONTAM_METHOD_TRUST_REGION: return SolverMethod::TrustRegion;
+    case CONTAM_METHOD_SUB_RELAXATION: return SolverMethod::SubRelaxation;
+    }
+    throw CapiError(CONTAM_ERROR_INVALID_ARGUMENT, "unknown solver method");
+}
+
+contam_model* newModel(ModelInput&& input) {
+    auto* m = new contam_model;
+    m->model = std::move(input);
+    return m;
+}
+
+const TimeStepResult& latestStep(const contam_transient* run) {
+    require(run, "run");
+    auto step = run->sim.lastStep();
+    if (!step) throw CapiError(CONTAM_ERROR_STATE, "the run has no output step yet");
+    return *step;
+}
+
+const RecordedResults& recorded(const contam_transient* run) {
+    require(run, "run");
+    if (!run->recorder) throw CapiError(CONTAM_ERROR_STATE, "the run was started without recording");
+    return *run->recorder->results();
+}
+
+} // namespace
+
+// ── Library ──────────────────────────────────────────────────────────
+
+uint32_t contam_api_version(void) {
+    return CONTAM_API_VERSION;
+}
+
+const char* contam_last_error(void) {
+    return lastError.c_str();
+}
+
+// ── Models ───────────────────────────────────────────────────────────
+
+contam_status contam_model_load_json(const char* json, size_t size, contam_model** out) {
+    return guarded([&] {
+        require(json, "json");
+        require(out, "out");
+        *out = newModel(JsonReader::readModelFromString(std::string(json, size)));
+    });
+}
+
+contam_status contam_model_load_file(const char* path, contam_model** out) {
+    return guarded([&] {
+        require(path, "path");
+        require(out, "out");
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(path, ec)) {
+            throw CapiError(CONTAM_ERROR_IO, std::string("Cannot open file: ") + path);
+        }
+        *out = newModel(JsonReader::readModelFromFile(path));
+    });
+}
+
+contam_status contam_model_load_cache(const void* image, size_t size, contam_model** out) {
+    return guarded([&] {
+        require(image, "image");
+        require(out, "out");
+        ModelInput model;
+        try {
+            model = ModelCache::deserialize(std::string_view(static_cast<const char*>(image), size));
+        } catch (const std::runtime_error& e) {
+            throw CapiError(CONTAM_ERROR_PARSE, e.what());
+        }
+        *out = newModel(std::move(model));
+    });
+}
+
+contam_status contam_model_save_cache(const contam_model* model, void* image, size_t capacity,
+                                      size_t* count) {
+    return guarded([&] {
+        require(model, "model");
+        const std::string bytes = ModelCache::serialize(model->model);
+        copyOut(bytes.data(), bytes.size(), static_cast<char*>(image), capacity, count);
+    });
+}
+
+contam_status contam_model_clone(const contam_model* model, contam_model** out) {
+    return guarded([&] {
+        require(model, "model");
+        require(out, "out");
+        *out = new contam_model(*model);
+    });
+}
+
+void contam_model_free(contam_model* model) {
+    delete model;
+}
+
+size_t contam_model_node_count(const contam_model* model) {
+    return model ? static_cast<size_t>(model->model.network.getNodeCount()) : 0;
+}
+
+size_t contam_model_link_count(const contam_model* model) {
+    return model ? static_cast<size_t>(model->model.network.getLinkCount()) : 0;
+}
+
+size_t contam_model_species_count(const contam_model* model) {
+    return model ? model->model.species.size() : 0;
+}
+
+contam_status contam_model_node_ids(const contam_model* model, int32_t* ids, size_t capacity,
+                                    size_t* count) {
+    return guarded([&] {
+        require(model, "model");
+        std::vector<int32_t> v;
+        for (const auto& node : model->model.network.getNodes()) v.push_back(node.getId());
+        copyOut(v, ids, capacity, count);
+    });
+}
+
+contam_status contam_model_link_ids(const contam_model* model, int32_t* ids, size_t capacity,
+                                    size_t* count) {
+    return guarded([&] {
+        require(model, "model");
+        std::vector<int32_t> v;
+        for (const auto& link : model->model.network.getLinks()) v.push_back(link.getId());
+        copyOut(v, ids, capacity, count);
+    });
+}
+
+contam_status contam_model_set_ambient_temperature(contam_model* model, double kelvin) {
+    return guarded([&] {
+        require(model, "model");
+        BatchParameter p;
+        p.kind = BatchParameter::Kind::AmbientTemperature;
+        p.apply(model->model.network, kelvin);
+    });
+}
+
+contam_status contam_model_set_wind(contam_model* model, double speed, double direction) {
+    return guarded([&] {
+        require(model, "model");
+        model->model.network.setWindSpeed(speed);
+        model->model.network.setWindDirection(direction);
+    });
+}
+
+contam_status contam_model_set_node_temperature(contam_model* model, int32_t node_id,
+                                                double kelvin) {
+    return guarded([&] {
+        require(model, "model");
+        int idx = 0;
+        try {
+            idx = model->model.network.getNodeIndexById(node_id);
+        } catch (const std::runtime_error& e) {
+            throw CapiError(CONTAM_ERROR_INVALID_ARGUMENT, e.what());
+        }
+        model->model.network.getNode(idx).setTemperature(kelvin);
+    });
+}
+
+// ── Steady airflow ───────────────────────────────────────────────────
+
+contam_status contam_solve(contam_model* model, contam_method method, contam_solve_info* info) {
+    return guarded([&] {
+        require(model, "model");
+        model->solver.setMethod(solverMethod(method));
+        SolverResult r = model->solver.solve(model->model.network);
+        if (info) {
+            info->converged = r.converged ? 1 : 0;
+            info->iterations = r.iterations;
+            info->max_residual = r.maxResidual;
+        }
+    });
+}
+
+contam_status contam_model_pressures(const contam_model* model, double* out, size_t capacity,
+                                     size_t* count) {
+    return guarded([&] {
+        require(model, "model");
+        std::vector<double> v;
+        for (const auto& node : model->model.network.getNodes()) v.push_back(node.getPressure());
+        copyOut(v, out, capacity, count);
+    });
+}
+
+contam_status contam_model_mass_flows(const contam_model* model, double* out, size_t capacity,
+                                      size_t* count) {
+    return guarded([&] {
+        require(model, "model");
+        std::vector<double> v;
+        for (const auto& link : model->model.network.getLinks()) v.push_back(link.getMassFlow());
+        copyOut(v, out, capacity, count);
+    });
+}
+
+// ── Transient runs ───────────────────────────────────────────────────
+
+contam_status contam_transient_start(const contam_model* model, int32_t record,
+                                     contam_transient** out) {
+    return guarded([&] {
+        require(model, "model");
+        require(out, "out");
+        auto run = std::make_unique<contam_transient>();
+        run->model = model->model;
+        if (!run->model.hasTransient) {
+            run->model.transientConfig.endTime = 3600.0;
+            run->model.transientConfig.timeStep = 60.0;
+            run->model.transientConfig.outputInterval = 60.0;
+        }
+        configureSimulation(run->sim, run->model);
+        run->sim.setStoreHistory(false);
+        if (record) {
+            run->recorder = std::make_shared<ResultRecorder>();
+            run->sim.addResultSink(run->recorder);
+        }
+        run->sim.start(run->model.network);
+        run->time = run->sim.currentTime();
+        *out = run.release();
+    });
+}
+
+contam_status contam_transient_advance(contam_transient* run, int32_t* has_step) {
+    return guarded([&] {
+        require(run, "run");
+        bool stepped = false;
+        if (!run->finished) {
+            stepped = run->sim.advance();
+            run->time = run->sim.currentTime();
+            if (!stepped) {
+                run->completed = run->sim.finish().completed;
+                run->finished = true;
+            }
+        }
+        if (has_step) *has_step = stepped ? 1 : 0;
+    });
+}
+
+contam_status contam_transient_run(contam_transient* run, int32_t* completed) {
+    return guarded([&] {
+        require(run, "run");
+        if (!run->finished) {
+            while (run->sim.advance()) {
+            }
+            run->time = run->sim.currentTime();
+            run->completed = run->sim.finish().completed;
+            run->finished = true;
+        }
+        if (completed) *completed = run->completed ? 1 : 0;
+    });
+}
+
+double contam_transient_time(const contam_transient* run) {
+    return run ? run->time : 0.0;
+}
+
+void contam_transient_free(contam_transient* run) {
+    delete run;
+}
+
+contam_status contam_transient_pressures(const contam_transient* run, double* out, size_t capacity,
+                                         size_t* count) {
+    return guarded([&] { copyOut(latestStep(run).airflow.pressures, out, capacity, count); });
+}
+
+contam_status contam_transient_mass_flows(const contam_transient* run, double* out,
+                                          size_t capacity, size_t* count) {
+    return guarded([&] { copyOut(latestStep(run).airflow.massFlows, out, capacity, count); });
+}
+
+contam_status contam_transient_concentrations(const contam_transient* run, double* out,
+                                              size_t capacity, size_t* count) {
+    return guarded([&] {
+        const auto& rows = latestStep(run).contaminant.concentrations;
+        std::size_t species = 0;
+        for (const auto& row : rows) species = std::max(species, row.size());
+        std::vector<double> flat(rows.size() * species, 0.0);
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            std::copy(rows[i].begin(), rows[i].end(), flat.begin() + i * species);
+        }
+        copyOut(flat, out, capacity, count);
+    });
+}
+
+size_t contam_transient_step_count(const contam_transient* run) {
+    return run && run->recorder ? run->recorder->results()->numSteps() : 0;
+}
+
+contam_status contam_transient_series_times(const contam_transient* run, double* out,
+                                            size_t capacity, size_t* count) {
+    return guarded([&] { copyOut(recorded(run).times, out, capacity, count); });
+}
+
+contam_status contam_transient_series_pressures(const contam_transient* run, double* out,
+                                                size_t capacity, size_t* count) {
+    return guarded([&] { copyOut(recorded(run).pressures, out, capacity, count); });
+}
+
+contam_status contam_transient_series_mass_flows(const contam_transient* run, double* out,
+                                                 size_t capacity, size_t* count) {
+    return guarded([&] { copyOut(recorded(run).massFlows, out, capacity, count); });
+}
+
+contam_status contam_transient_series_concentrations(const contam_transient* run, double* out,
+                                                     size_t capacity, size_t* count) {
+    return guarded([&] { copyOut(recorded(run).concentrations, out, capacity, count); });
+}
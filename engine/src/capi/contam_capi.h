@@ -0,0 +1,162 @@
+/*
+ * C API of the contam engine (contam_engine_shared).
+ *
+ * Conventions
+ *   - Every object is an opaque handle created by a *_load / *_start /
+ *     *_clone function and released with the matching *_free function.
+ *   - Functions return CONTAM_OK or an error status; contam_last_error()
+ *     then describes the failure. No C++ exception crosses this interface.
+ *   - Results are copied into caller-owned buffers. Each copy function takes
+ *     the buffer capacity (in elements) and reports the number of elements
+ *     needed through `count`. With a NULL or too small buffer it writes
+ *     nothing and returns CONTAM_ERROR_BUFFER_TOO_SMALL, so a first call with
+ *     (NULL, 0, &count) sizes the buffer.
+ *   - Node and link values are ordered like the model's "nodes" and "links"
+ *     arrays; concentrations are [node][species].
+ *
+ * Thread safety
+ *   Distinct handles can be used concurrently from any threads. A single
+ *   handle must not be used by two threads at the same time; callers that
+ *   share one serialize access themselves. A transient run copies the model
+ *   when it starts and does not reference it afterwards.
+ *
+ * Versioning
+ *   contam_api_version() returns CONTAM_API_VERSION of the library. Minor
+ *   versions only add functions; a host built against major version M works
+ *   with any library whose major version is M.
+ */
+#ifndef CONTAM_CAPI_H
+#define CONTAM_CAPI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(CONTAM_CAPI_BUILD)
+#    define CONTAM_API __declspec(dllexport)
+#  else
+#    define CONTAM_API __declspec(dllimport)
+#  endif
+#else
+#  define CONTAM_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CONTAM_API_VERSION_MAJOR 1
+#define CONTAM_API_VERSION_MINOR 0
+#define CONTAM_API_VERSION ((CONTAM_API_VERSION_MAJOR << 16) | CONTAM_API_VERSION_MINOR)
+
+typedef enum contam_status {
+    CONTAM_OK = 0,
+    CONTAM_ERROR_INVALID_ARGUMENT = 1,   /* NULL handle, bad id, unknown option */
+    CONTAM_ERROR_PARSE = 2,              /* malformed JSON or model cache image */
+    CONTAM_ERROR_IO = 3,                 /* file could not be read or written */
+    CONTAM_ERROR_BUFFER_TOO_SMALL = 4,   /* see `count` for the required size */
+    CONTAM_ERROR_STATE = 5,              /* e.g. reading results before a step */
+    CONTAM_ERROR_ENGINE = 6              /* any other engine failure */
+} contam_status;
+
+typedef enum contam_method {
+    CONTAM_METHOD_TRUST_REGION = 0,
+    CONTAM_METHOD_SUB_RELAXATION = 1
+} contam_method;
+
+typedef struct contam_model contam_model;
+typedef struct contam_transient contam_transient;
+
+typedef struct contam_solve_info {
+    int32_t converged;       /* 1 when the residual tolerance was met */
+    int32_t iterations;
+    double max_residual;     /* kg/s */
+} contam_solve_info;
+
+/* ── Library ──────────────────────────────────────────────────────── */
+
+CONTAM_API uint32_t contam_api_version(void);
+
+/* Message for the last failed call on the calling thread ("" if none). The
+   pointer stays valid until the next failing call on that thread. */
+CONTAM_API const char* contam_last_error(void);
+
+/* ── Models ───────────────────────────────────────────────────────── */
+
+/* JSON model text (need not be NUL terminated) */
+CONTAM_API contam_status contam_model_load_json(const char* json, size_t size, contam_model** out);
+CONTAM_API contam_status contam_model_load_file(const char* path, contam_model** out);
+/* Compiled model cache image, as written by contam_model_save_cache */
+CONTAM_API contam_status contam_model_load_cache(const void* image, size_t size, contam_model** out);
+CONTAM_API contam_status contam_model_save_cache(const contam_model* model, void* image,
+                                                 size_t capacity, size_t* count);
+CONTAM_API contam_status contam_model_clone(const contam_model* model, contam_model** out);
+CONTAM_API void contam_model_free(contam_model* model);
+
+CONTAM_API size_t contam_model_node_count(const contam_model* model);
+CONTAM_API size_t contam_model_link_count(const contam_model* model);
+CONTAM_API size_t contam_model_species_count(const contam_model* model);
+CONTAM_API contam_status contam_model_node_ids(const contam_model* model, int32_t* ids,
+                                               size_t capacity, size_t* count);
+CONTAM_API contam_status contam_model_link_ids(const contam_model* model, int32_t* ids,
+                                               size_t capacity, size_t* count);
+
+/* Model inputs that hosts commonly vary between solves */
+CONTAM_API contam_status contam_model_set_ambient_temperature(contam_model* model, double kelvin);
+CONTAM_API contam_status contam_model_set_wind(contam_model* model, double speed, double direction);
+CONTAM_API contam_status contam_model_set_node_temperature(contam_model* model, int32_t node_id,
+                                                           double kelvin);
+
+/* ── Steady airflow ───────────────────────────────────────────────── */
+
+/* Solve in place. The model keeps the solution, so later solves start from
+   it; `info` may be NULL. */
+CONTAM_API contam_status contam_solve(contam_model* model, contam_method method,
+                                      contam_solve_info* info);
+/* Current node pressures (Pa) and link mass flows (kg/s) of the model */
+CONTAM_API contam_status contam_model_pressures(const contam_model* model, double* out,
+                                                size_t capacity, size_t* count);
+CONTAM_API contam_status contam_model_mass_flows(const contam_model* model, double* out,
+                                                 size_t capacity, size_t* count);
+
+/* ── Transient runs ───────────────────────────────────────────────── */
+
+/* Start a run of the model's transient settings (a model without a
+   "transient" section runs one hour at 60 s steps). The initial state is the
+   first output step. With `record` non-zero every output step is also kept
+   for the contam_transient_series_* functions. */
+CONTAM_API contam_status contam_transient_start(const contam_model* model, int32_t record,
+                                                contam_transient** out);
+/* Integrate to the next output step; *has_step is 0 once the run is over */
+CONTAM_API contam_status contam_transient_advance(contam_transient* run, int32_t* has_step);
+/* Advance to the end; *completed may be NULL */
+CONTAM_API contam_status contam_transient_run(contam_transient* run, int32_t* completed);
+CONTAM_API double contam_transient_time(const contam_transient* run);
+CONTAM_API void contam_transient_free(contam_transient* run);
+
+/* Latest output step */
+CONTAM_API contam_status contam_transient_pressures(const contam_transient* run, double* out,
+                                                    size_t capacity, size_t* count);
+CONTAM_API contam_status contam_transient_mass_flows(const contam_transient* run, double* out,
+                                                     size_t capacity, size_t* count);
+CONTAM_API contam_status contam_transient_concentrations(const contam_transient* run, double* out,
+                                                         size_t capacity, size_t* count);
+
+/* Recorded steps (record != 0): times [step], pressures [step][node],
+   mass flows [step][link], concentrations [step][node][species] */
+CONTAM_API size_t contam_transient_step_count(const contam_transient* run);
+CONTAM_API contam_status contam_transient_series_times(const contam_transient* run, double* out,
+                                                       size_t capacity, size_t* count);
+CONTAM_API contam_status contam_transient_series_pressures(const contam_transient* run, double* out,
+                                                           size_t capacity, size_t* count);
+CONTAM_API contam_status contam_transient_series_mass_flows(const contam_transient* run, double* out,
+                                                            size_t capacity, size_t* count);
+CONTAM_API contam_status contam_transient_series_concentrations(const contam_transient* run,
+                                                                double* out, size_t capacity,
+                                                                size_t* count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONTAM_CAPI_H */
@@ -0,0 +1,109 @@
+// contam_gen: writes a parametric office high-rise model (io/ModelGenerator.h)
+// for scaling runs and benchmarks
+#include "io/ModelGenerator.h"
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// Help goes to stdout; after a usage error it goes to stderr, away from the
+// model written to stdout
+void printUsage(const char* progName, std::ostream& out = std::cout) {
+    contam::ModelGeneratorOptions d;
+    out << "AirSim Studio model generator\n"
+        << "Usage: " << progName << " [options] [-o <model.json>]\n"
+        << "\nOptions:\n"
+        << "  --floors <n>      Floors (default " << d.floors << ")\n"
+        << "  --zones <n>       Offices per floor (default " << d.zonesPerFloor << ")\n"
+        << "  --floor-height <m> Floor-to-floor height (default " << d.floorHeight << ")\n"
+        << "  --stairs <n>      Stairwells (default " << d.stairwells << ")\n"
+        << "  --elevators <n>   Elevator shafts (default " << d.elevatorShafts << ")\n"
+        << "  --species <n>     Species; the first is CO2 (default " << d.species << ")\n"
+        << "  --ahs <n>         Air handling systems, one per band of floors (default " << d.ahsSystems << ")\n"
+        << "  --occupants <n>   Occupants per office (default " << d.occupantsPerZone << ")\n"
+        << "  --no-controls     No CO2 control of the floor exhaust fans\n"
+        << "  --outdoor-temp <K> Outdoor temperature (default " << d.outdoorTemperature << ")\n"
+        << "  --wind <m/s>:<deg> Wind speed and direction (default " << d.windSpeed << ":" << d.windDirection << ")\n"
+        << "  --hours <h>       Transient length (default " << d.hours << ")\n"
+        << "  -m <method>       Airflow method in the transient: 'sur' or 'tr' (default: sur)\n"
+        << "  --seed <n>        Random seed for volumes, leakage and sources (default " << d.seed << ")\n"
+        << "  -o <file>         Output model file (default: stdout)\n"
+        << "  --compact         Write JSON without indentation\n"
+        << "  -h, --help        Show this help\n";
+}
+
+int main(int argc, char* argv[]) {
+    contam::ModelGeneratorOptions options;
+    std::string outputFile;
+    bool compact = false;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--floors" && hasValue) {
+                options.floors = std::stoi(argv[++i]);
+            } else if (arg == "--zones" && hasValue) {
+                options.zonesPerFloor = std::stoi(argv[++i]);
+            } else if (arg == "--floor-height" && hasValue) {
+                options.floorHeight = std::stod(argv[++i]);
+            } else if (arg == "--stairs" && hasValue) {
+                options.stairwells = std::stoi(argv[++i]);
+            } else if (arg == "--elevators" && hasValue) {
+                options.elevatorShafts = std::stoi(argv[++i]);
+            } else if (arg == "--species" && hasValue) {
+                options.species = std::stoi(argv[++i]);
+            } else if (arg == "--ahs" && hasValue) {
+                options.ahsSystems = std::stoi(argv[++i]);
+            } else if (arg == "--occupants" && hasValue) {
+                options.occupantsPerZone = std::stoi(argv[++i]);
+            } else if (arg == "--no-controls") {
+                options.controls = false;
+            } else if (arg == "--outdoor-temp" && hasValue) {
+                options.outdoorTemperature = std::stod(argv[++i]);
+            } else if (arg == "--wind" && hasValue) {
+                std::string value = argv[++i];
+                auto colon = value.find(':');
+                options.windSpeed = std::stod(value.substr(0, colon));
+                if (colon != std::string::npos) options.windDirection = std::stod(value.substr(colon + 1));
+            } else if (arg == "--hours" && hasValue) {
+                options.hours = std::stod(argv[++i]);
+            } else if (arg == "-m" && hasValue) {
+                std::string m = argv[++i];
+                if (m == "sur") options.airflowMethod = "subRelaxation";
+                else if (m == "tr") options.airflowMethod = "trustRegion";
+                else {
+                    std::cerr << "Unknown solver method: " << m << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--seed" && hasValue) {
+                options.seed = std::stoull(argv[++i]);
+            } else if (arg == "-o" && hasValue) {
+                outputFile = argv[++i];
+            } else if (arg == "--compact") {
+                compact = true;
+            } else if (arg == "-h" || arg == "--help") {
+                printUsage(argv[0]);
+                return 0;
+            } else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                printUsage(argv[0], std::cerr);
+                return 1;
+            }
+        }
+
+        const std::string text = contam::generateModel(options).dump(compact ? -1 : 2);
+        if (outputFile.empty() || outputFile == "-") {
+            std::cout << text << "\n";
+        } else {
+            std::ofstream out(outputFile);
+            if (!out) throw std::runtime_error("Cannot write " + outputFile);
+            out << text << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,435 @@
+#include "core/BatchSolve.h"
+#include "elements/Fan.h"
+#include "elements/PowerLawOrifice.h"
+#include "io/ResultRecorder.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace contam {
+
+// ── BatchParameter ───────────────────────────────────────────────────
+
+static const PowerLawOrifice* orificeOf(const Network& network, int linkIndex) {
+    return dynamic_cast<const PowerLawOrifice*>(network.getLink(linkIndex).getFlowElement());
+}
+
+static const Fan* fanOf(const Network& network, int linkIndex) {
+    return dynamic_cast<const Fan*>(network.getLink(linkIndex).getFlowElement());
+}
+
+// Integer after the colon of "<key>:<id>"
+static int parameterId(const std::string& name, std::size_t colon) {
+    try {
+        std::size_t used = 0;
+        int id = std::stoi(name.substr(colon + 1), &used);
+        if (used != name.size() - colon - 1) throw std::invalid_argument(name);
+        return id;
+    } catch (const std::exception&) {
+        throw std::runtime_error("Invalid id in batch parameter: " + name);
+    }
+}
+
+BatchParameter BatchParameter::parse(const std::string& name, const Network& network) {
+    BatchParameter p;
+    const auto colon = name.find(':');
+    const std::string key = name.substr(0, colon);
+
+    if (colon == std::string::npos) {
+        if (key == "ambient_temperature") p.kind = Kind::AmbientTemperature;
+        else if (key == "wind_speed") p.kind = Kind::WindSpeed;
+        else if (key == "wind_direction") p.kind = Kind::WindDirection;
+        else throw std::runtime_error("Unknown batch parameter: " + name);
+        return p;
+    }
+
+    const int id = parameterId(name, colon);
+
+    if (key == "node_temperature") {
+        p.kind = Kind::NodeTemperature;
+        p.index = network.getNodeIndexById(id);
+        if (p.index < 0) throw std::runtime_error("Batch parameter " + name + ": unknown node id");
+        return p;
+    }
+
+    if (key == "source_rate") {
+        throw std::runtime_error("Batch parameter " + name + " needs the model's sources");
+    }
+    if (key == "orifice_c") p.kind = Kind::OrificeCoefficient;
+    else if (key == "orifice_n") p.kind = Kind::OrificeExponent;
+    else if (key == "fan_speed") p.kind = Kind::FanSpeed;
+    else throw std::runtime_error("Unknown batch parameter: " + name);
+
+    for (int j = 0; j < network.getLinkCount(); ++j) {
+        if (network.getLink(j).getId() == id) {
+            p.index = j;
+            break;
+        }
+    }
+    if (p.index < 0) throw std::runtime_error("Batch parameter " + name + ": unknown link id");
+    if (p.kind == Kind::FanSpeed) {
+        if (!fanOf(network, p.index)) {
+            throw std::runtime_error("Batch parameter " + name + ": link is not a Fan");
+        }
+    } else if (!orificeOf(network, p.index)) {
+        throw std::runtime_error("Batch parameter " + name + ": link is not a PowerLawOrifice");
+    }
+    return p;
+}
+
+BatchParameter BatchParameter::parse(const std::string& name, const ModelInput& model) {
+    const auto colon = name.find(':');
+    if (name.compare(0, colon, "source_rate") != 0) return parse(name, model.network);
+
+    BatchParameter p;
+    p.kind = Kind::SourceRate;
+    p.index = colon == std::string::npos ? -1 : parameterId(name, colon);
+    if (p.index < 0 || p.index >= static_cast<int>(model.sources.size())) {
+        throw std::runtime_error("Batch parameter " + name + ": the model has " +
+                                 std::to_string(model.sources.size()) + " sources");
+    }
+    return p;
+}
+
+void BatchParameter::apply(Network& network, std::vector<Source>& sources, double value) const {
+    if (kind == Kind::SourceRate) {
+        sources.at(static_cast<std::size_t>(index)).generationRate = value;
+        return;
+    }
+    apply(network, value);
+}
+
+void BatchParameter::apply(Network& network, double value) const {
+    switch (kind) {
+    case Kind::AmbientTemperature:
+        network.setAmbientTemperature(value);
+        for (auto& node : network.getNodes()) {
+            if (node.isKnownPressure()) node.setTemperature(value);
+        }
+        break;
+    case Kind::WindSpeed:
+        network.setWindSpeed(value);
+        break;
+    case Kind::WindDirection:
+        network.setWindDirection(value);
+        break;
+    case Kind::NodeTemperature:
+        network.getNode(index).setTemperature(value);
+        break;
+    case Kind::OrificeCoefficient:
+    case Kind::OrificeExponent: {
+        // Elements are shared and immutable; swap in a new one
+        const PowerLawOrifice* orifice = orificeOf(network, index);
+        double C = orifice->getFlowCoefficient();
+        double n = orifice->getFlowExponent();
+        (kind == Kind::OrificeCoefficient ? C : n) = value;
+        network.getLink(index).setFlowElement(std::make_unique<PowerLawOrifice>(C, n));
+        break;
+    }
+    case Kind::FanSpeed: {
+        if (!(value > 0.0)) throw std::runtime_error("Fan speed ratio must be positive");
+        // Affinity laws: at speed ratio r the curve dP(Q) becomes r^2 dP(Q / r)
+        const Fan* fan = fanOf(network, index);
+        std::unique_ptr<Fan> scaled;
+        if (fan->isPolynomial()) {
+            std::vector<double> coeffs = fan->getCoeffs();
+            for (std::size_t i = 0; i < coeffs.size(); ++i) {
+                coeffs[i] *= std::pow(value, 2.0 - static_cast<double>(i));
+            }
+            scaled = std::make_unique<Fan>(coeffs);
+        } else {
+            scaled = std::make_unique<Fan>(fan->getMaxFlow() * value,
+                                           fan->getShutoffPressure() * value * value);
+        }
+        network.getLink(index).setFlowElement(std::move(scaled));
+        break;
+    }
+    case Kind::SourceRate:
+        throw std::runtime_error("Source parameters apply to a model, not a network");
+    }
+}
+
+std::vector<BatchParameter> parseBatchParameters(const std::vector<std::string>& names,
+                                                 const Network& network) {
+    std::vector<BatchParameter> params;
+    params.reserve(names.size());
+    for (const auto& name : names) params.push_back(BatchParameter::parse(name, network));
+    return params;
+}
+
+std::vector<BatchParameter> parseBatchParameters(const std::vector<std::string>& names,
+                                                 const ModelInput& model) {
+    std::vector<BatchParameter> params;
+    params.reserve(names.size());
+    for (const auto& name : names) params.push_back(BatchParameter::parse(name, model));
+    return params;
+}
+
+// ── Batch execution ──────────────────────────────────────────────────
+
+namespace {
+
+// Serializes progress reports and turns a false return into cancellation
+class BatchTracker {
+public:
+    BatchTracker(std::size_t total, const BatchProgress& progress)
+        : total_(total), progress_(progress) {}
+
+    bool cancelled() const { return cancelled_.load(); }
+
+    void finished() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++done_;
+        if (progress_ && !progress_(done_, total_)) cancelled_.store(true);
+    }
+
+private:
+    std::size_t total_;
+    const BatchProgress& progress_;
+    std::mutex mutex_;
+    std::size_t done_ = 0;
+    std::atomic<bool> cancelled_{false};
+};
+
+Network networkForSet(const Network& base, const std::vector<BatchParameter>& params,
+                      const double* row) {
+    Network net = base;
+    for (std::size_t p = 0; p < params.size(); ++p) params[p].apply(net, row[p]);
+    return net;
+}
+
+void applySet(const std::vector<BatchParameter>& params, const double* row, Network& net,
+              std::vector<Source>& sources) {
+    for (std::size_t p = 0; p < params.size(); ++p) params[p].apply(net, sources, row[p]);
+}
+
+// Copy `count` values to dst, NaN-filling up to `width`
+void copyRow(double* dst, const double* src, std::size_t count, std::size_t width) {
+    std::copy(src, src + count, dst);
+    std::fill(dst + count, dst + width, std::numeric_limits<double>::quiet_NaN());
+}
+
+} // namespace
+
+BatchSolveResult solveMany(const Network& base, const std::vector<BatchParameter>& params,
+                           const double* values, std::size_t numSets, ThreadPool& pool,
+                           SolverMethod method, unsigned maxParallel,
+                           const BatchProgress& progress) {
+    BatchSolveResult out;
+    out.numSets = numSets;
+    out.numNodes = static_cast<std::size_t>(base.getNodeCount());
+    out.numLinks = static_cast<std::size_t>(base.getLinkCount());
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    out.pressures.assign(numSets * out.numNodes, nan);
+    out.massFlows.assign(numSets * out.numLinks, nan);
+    out.iterations.assign(numSets, 0);
+    out.converged.assign(numSets, 0);
+
+    BatchTracker tracker(numSets, progress);
+    pool.parallelFor(numSets, [&](std::size_t s) {
+        if (tracker.cancelled()) return;
+        Network net = networkForSet(base, params, values + s * params.size());
+        Solver solver(method);
+        SolverResult r = solver.solve(net);
+
+        copyRow(&out.pressures[s * out.numNodes], r.pressures.data(),
+                std::min(r.pressures.size(), out.numNodes), out.numNodes);
+        copyRow(&out.massFlows[s * out.numLinks], r.massFlows.data(),
+                std::min(r.massFlows.size(), out.numLinks), out.numLinks);
+        out.iterations[s] = r.iterations;
+        out.converged[s] = r.converged ? 1 : 0;
+        tracker.finished();
+    }, maxParallel);
+    return out;
+}
+
+BatchRunResult runMany(const ModelInput& model, const std::vector<BatchParameter>& params,
+                       const double* values, std::size_t numSets, ThreadPool& pool,
+                       unsigned maxParallel, const BatchProgress& progress) {
+    const OutputSelection selection(model.outputSpec, model.network, model.species);
+    BatchRunResult out;
+    out.numSets = numSets;
+    out.numNodes = selection.nodeCount(model.network);
+    out.numLinks = selection.linkCount(model.network);
+    out.numSpecies = selection.speciesCount(model.species);
+    out.completed.assign(numSets, 0);
+
+    const auto& cfg = model.transientConfig;
+    std::size_t expectedSteps = 0;
+    if (cfg.outputInterval > 0.0 && cfg.endTime > cfg.startTime) {
+        expectedSteps = static_cast<std::size_t>((cfg.endTime - cfg.startTime) / cfg.outputInterval) + 2;
+    }
+
+    std::vector<std::shared_ptr<const RecordedResults>> runs(numSets);
+    BatchTracker tracker(numSets, progress);
+    pool.parallelFor(numSets, [&](std::size_t s) {
+        if (tracker.cancelled()) return;
+        Network net = model.network;
+        std::vector<Source> sources = model.sources;
+        applySet(params, values + s * params.size(), net, sources);
+        TransientSimulation sim;
+        configureSimulation(sim, model);
+        sim.setSources(sources);
+        sim.setStoreHistory(false);
+        auto recorder = std::make_shared<ResultRecorder>(expectedSteps);
+        sim.addResultSink(recorder);
+        out.completed[s] = sim.run(net).completed ? 1 : 0;
+        runs[s] = recorder->results();
+        tracker.finished();
+    }, maxParallel);
+
+    // Stack the runs; the longest one supplies the time axis
+    for (const auto& r : runs) {
+        if (r && r->numSteps() > out.numSteps) {
+            out.numSteps = r->numSteps();
+            out.times = r->times;
+        }
+    }
+    const std::size_t T = out.numSteps;
+    const std::size_t N = out.numNodes, L = out.numLinks, NS = out.numNodes * out.numSpecies;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    out.pressures.assign(numSets * T * N, nan);
+    out.massFlows.assign(numSets * T * L, nan);
+    out.concentrations.assign(numSets * T * NS, nan);
+    for (std::size_t s = 0; s < numSets; ++s) {
+        if (!runs[s]) continue;
+        const RecordedResults& r = *runs[s];
+        std::copy(r.pressures.begin(), r.pressures.end(), out.pressures.begin() + s * T * N);
+        std::copy(r.massFlows.begin(), r.massFlows.end(), out.massFlows.begin() + s * T * L);
+        std::copy(r.concentrations.begin(), r.concentrations.end(),
+                  out.concentrations.begin() + s * T * NS);
+        runs[s].reset();
+    }
+    return out;
+}
+
+// ── Sweeps ───────────────────────────────────────────────────────────
+
+namespace {
+
+// Peak, output-step mean and final concentration of every node and species,
+// plus the last recorded pressures and flows
+class SweepSummarySink : public ResultSink {
+public:
+    explicit SweepSummarySink(SweepVariantResult& result) : r_(result) {}
+
+    void onStep(const TimeStepResult& step) override {
+        ++r_.outputSteps;
+        if (!step.airflow.pressures.empty()) r_.pressures = step.airflow.pressures;
+        if (!step.airflow.massFlows.empty()) r_.massFlows = step.airflow.massFlows;
+        const auto& conc = step.contaminant.concentrations;
+        if (conc.empty()) return;
+        const std::size_t NS = conc.size() * conc.front().size();
+        if (r_.finalConcentrations.size() != NS) {
+            r_.peakConcentrations.assign(NS, -std::numeric_limits<double>::infinity());
+            r_.meanConcentrations.assign(NS, 0.0);
+            r_.finalConcentrations.assign(NS, 0.0);
+            samples_ = 0;
+        }
+        std::size_t k = 0;
+        for (const auto& row : conc) {
+            for (double c : row) {
+                r_.peakConcentrations[k] = std::max(r_.peakConcentrations[k], c);
+                r_.meanConcentrations[k] += c;
+                r_.finalConcentrations[k] = c;
+                ++k;
+            }
+        }
+        ++samples_;
+    }
+
+    void end(bool) override {
+        if (samples_ == 0) return;
+        for (double& m : r_.meanConcentrations) m /= static_cast<double>(samples_);
+    }
+
+private:
+    SweepVariantResult& r_;
+    std::size_t samples_ = 0;
+};
+
+} // namespace
+
+SweepResult runSweep(const ModelInput& model, ThreadPool& pool, unsigned maxParallel,
+                     const BatchProgress& progress) {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+
+    SweepResult out;
+    out.plan = expandSweep(model.sweep);
+    const auto params = parseBatchParameters(out.plan.names, model);
+    out.transient = model.hasTransient || !model.species.empty();
+    out.numSpecies = model.species.size();
+    out.variants.resize(out.plan.numVariants);
+
+    TransientConfig config = model.transientConfig;
+    if (!model.hasTransient) {
+        config.endTime = 3600.0;
+        config.timeStep = 60.0;
+        config.outputInterval = 60.0;
+    }
+
+    // Solve the base model once; every variant starts from this solver's
+    // ordering and, if it converged, this solution
+    Network base = model.network;
+    Solver prototype(config.airflowMethod);
+    if (!prototype.solve(base).converged) base = model.network;
+
+    BatchTracker tracker(out.plan.numVariants, progress);
+    pool.parallelFor(out.plan.numVariants, [&](std::size_t v) {
+        if (tracker.cancelled()) return;
+        SweepVariantResult& r = out.variants[v];
+        const auto variantStart = Clock::now();
+        try {
+            Network net = base;
+            std::vector<Source> sources = model.sources;
+            applySet(params, out.plan.row(v), net, sources);
+            if (!out.transient) {
+                Solver solver = prototype;
+                SolverResult s = solver.solve(net);
+                r.ok = s.converged;
+                r.iterations = s.iterations;
+                r.maxResidual = s.maxResidual;
+                r.pressures = std::move(s.pressures);
+                r.massFlows = std::move(s.massFlows);
+            } else {
+                TransientSimulation sim;
+                configureSimulation(sim, model);
+                sim.setConfig(config);
+                sim.setSources(sources);
+                sim.setOutputSpec(OutputSpec{});   // summaries cover everything
+                sim.setAirflowSolver(prototype);
+                sim.setStoreHistory(false);
+                sim.addResultSink(std::make_shared<SweepSummarySink>(r));
+                r.ok = sim.run(net).completed;
+            }
+        } catch (const std::exception& e) {
+            r.ok = false;
+            r.error = e.what();
+        }
+        r.seconds = std::chrono::duration<double>(Clock::now() - variantStart).count();
+        tracker.finished();
+    }, maxParallel);
+
+    out.wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return out;
+}
+
+void configureSimulation(TransientSimulation& sim, const ModelInput& model) {
+    sim.setConfig(model.transientConfig);
+    sim.setSpecies(model.species);
+    sim.setSources(model.sources);
+    sim.setSchedules(model.schedules);
+    sim.setZoneTemperatureSchedules(model.zoneTemperatureSchedules);
+    sim.setOccupants(model.occupants);
+    sim.setOutputSpec(model.outputSpec);
+    if (!model.weatherData.empty()) sim.setWeatherData(model.weatherData);
+    if (!model.ahSystems.empty()) sim.setAHSystems(model.ahSystems);
+}
+
+} // namespace contam
@@ -0,0 +1,134 @@
+#pragma once
+#include "core/Network.h"
+#include "core/Solver.h"
+#include "core/Sweep.h"
+#include "core/TransientSimulation.h"
+#include "io/JsonReader.h"
+#include "utils/ThreadPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace contam {
+
+// A model input that varies across the parameter sets of a batch
+struct BatchParameter {
+    enum class Kind {
+        AmbientTemperature,   // K; also sets every ambient node
+        WindSpeed,            // m/s
+        WindDirection,        // degrees from north
+        NodeTemperature,      // K
+        OrificeCoefficient,   // PowerLawOrifice C of a link
+        OrificeExponent,      // PowerLawOrifice n of a link
+        FanSpeed,             // speed ratio of a Fan link (affinity laws: Q ~ r, dP ~ r^2)
+        SourceRate            // generation rate of a source (kg/s), by position in the model
+    };
+
+    Kind kind = Kind::AmbientTemperature;
+    int index = -1;   // node, link or source index for the per-entity kinds
+
+    // "ambient_temperature" | "wind_speed" | "wind_direction" |
+    // "node_temperature:<node id>" | "orifice_c:<link id>" | "orifice_n:<link id>" |
+    // "fan_speed:<link id>" | "source_rate:<source index>"
+    // Throws std::runtime_error for unknown names or ids, for orifice and fan
+    // parameters on links of another element type, and (network overload) for
+    // source parameters
+    static BatchParameter parse(const std::string& name, const Network& network);
+    static BatchParameter parse(const std::string& name, const ModelInput& model);
+
+    bool changesSources() const { return kind == Kind::SourceRate; }
+
+    // Source parameters change `sources`, all others `network`. The network
+    // overload throws for source parameters.
+    void apply(Network& network, std::vector<Source>& sources, double value) const;
+    void apply(Network& network, double value) const;
+};
+
+// Resolve parameter names against a network or a whole model
+std::vector<BatchParameter> parseBatchParameters(const std::vector<std::string>& names,
+                                                 const Network& network);
+std::vector<BatchParameter> parseBatchParameters(const std::vector<std::string>& names,
+                                                 const ModelInput& model);
+
+// Steady solves of every parameter set, stacked [set][node] / [set][link]
+struct BatchSolveResult {
+    std::size_t numSets = 0;
+    std::size_t numNodes = 0;
+    std::size_t numLinks = 0;
+    std::vector<double> pressures;
+    std::vector<double> massFlows;
+    std::vector<int> iterations;
+    std::vector<std::uint8_t> converged;
+};
+
+// Transient runs of every parameter set, stacked. Runs that stop early
+// (cancelled) are padded with NaN rows; `times` is the longest run's.
+struct BatchRunResult {
+    std::size_t numSets = 0;
+    std::size_t numSteps = 0;
+    std::size_t numNodes = 0;
+    std::size_t numLinks = 0;
+    std::size_t numSpecies = 0;
+    std::vector<double> times;           // [step]
+    std::vector<double> pressures;       // [set][step][node]
+    std::vector<double> massFlows;       // [set][step][link]
+    std::vector<double> concentrations;  // [set][step][node][species]
+    std::vector<std::uint8_t> completed; // [set]
+};
+
+// Called from worker threads (one call at a time) after each set finishes;
+// return false to cancel the sets that have not started yet
+using BatchProgress = std::function<bool(std::size_t done, std::size_t total)>;
+
+// Solve a copy of `base` for each row of `values` (numSets x params.size(),
+// row-major) on `pool`. `maxParallel` limits concurrent solves (0 = all).
+BatchSolveResult solveMany(const Network& base, const std::vector<BatchParameter>& params,
+                           const double* values, std::size_t numSets, ThreadPool& pool,
+                           SolverMethod method = SolverMethod::TrustRegion,
+                           unsigned maxParallel = 0, const BatchProgress& progress = {});
+
+// Run the model's transient simulation for each row of `values`
+BatchRunResult runMany(const ModelInput& model, const std::vector<BatchParameter>& params,
+                       const double* values, std::size_t numSets, ThreadPool& pool,
+                       unsigned maxParallel = 0, const BatchProgress& progress = {});
+
+// Summary of one sweep variant. Steady sweeps report the solution; transient
+// sweeps the final pressures and flows plus per node and species the peak,
+// time-averaged (over output steps) and final concentration, [node][species].
+struct SweepVariantResult {
+    bool ok = false;             // converged (steady) or completed (transient)
+    std::string error;           // set when the variant threw
+    int iterations = 0;          // airflow iterations (steady)
+    double maxResidual = 0.0;
+    double seconds = 0.0;
+    std::size_t outputSteps = 0;
+    std::vector<double> pressures;
+    std::vector<double> massFlows;
+    std::vector<double> peakConcentrations;
+    std::vector<double> meanConcentrations;
+    std::vector<double> finalConcentrations;
+};
+
+struct SweepResult {
+    SweepPlan plan;
+    bool transient = false;
+    std::size_t numSpecies = 0;
+    std::vector<SweepVariantResult> variants;   // in plan order
+    double wallSeconds = 0.0;
+};
+
+// Expand model.sweep and run every variant on `pool`. All variants share the
+// parsed model and start from one solved copy of its network: each takes a
+// copy of that Solver (with its equation ordering already computed) and,
+// when the base model converges, its solution as the initial guess. A variant that throws is reported
+// and does not stop the sweep.
+SweepResult runSweep(const ModelInput& model, ThreadPool& pool, unsigned maxParallel = 0,
+                     const BatchProgress& progress = {});
+
+// Set up `sim` with everything a model defines (config, species, sources,
+// schedules, occupants, output spec, weather and AHS)
+void configureSimulation(TransientSimulation& sim, const ModelInput& model);
+
+} // namespace contam
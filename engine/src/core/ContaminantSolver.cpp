@@ -1,7 +1,10 @@
 #include "ContaminantSolver.h"
 #include "utils/Constants.h"
+#include "utils/ThreadPool.h"
 #include <Eigen/Dense>
+#include <algorithm>
 #include <cmath>
+#include <optional>
 #include <stdexcept>
 
 namespace contam {
@@ -39,6 +42,32 @@ double ContaminantSolver::getScheduleValue(int scheduleId, double t) const {
     return it->second.getValue(t);
 }
 
+double ContaminantSolver::generationRate(const Source& src, double t, double conc,
+                                         double pressure) {
+    switch (src.type) {
+    case SourceType::ExponentialDecay: {
+        double elapsed = t - src.startTime;
+        if (elapsed < 0.0 || src.decayTimeConstant <= 0.0) return 0.0;
+        return src.multiplier * src.generationRate * std::exp(-elapsed / src.decayTimeConstant);
+    }
+    case SourceType::PressureDriven:
+        // G = pressureCoeff * |P_zone|
+        return src.pressureCoeff * std::abs(pressure);
+    case SourceType::CutoffConcentration:
+        // G = genRate when C < cutoff, 0 otherwise
+        return conc < src.cutoffConc ? src.generationRate : 0.0;
+    case SourceType::Burst:
+        // G = burstMass / burstDuration when t ∈ [burstTime, burstTime+burstDuration]
+        if (t >= src.burstTime && t <= src.burstTime + src.burstDuration) {
+            return src.burstMass / src.burstDuration;
+        }
+        return 0.0;
+    case SourceType::Constant:
+        break;
+    }
+    return src.generationRate;
+}
+
 ContaminantResult ContaminantSolver::step(const Network& network, double t, double dt) {
     if (numSpecies_ == 0) {
         return {t + dt, C_};
@@ -48,9 +77,17 @@ ContaminantResult ContaminantSolver::step(const Network& network, double t, doub
         // Coupled multi-species solve with chemical kinetics
         solveCoupled(network, t, dt);
     } else {
-        // Solve each species independently
-        for (int k = 0; k < numSpecies_; ++k) {
-            solveSpecies(network, k, t, dt);
+        // Solve each species independently. Each solve only writes its own
+        // column of C_, so species can run side by side once the zone
+        // systems are big enough to be worth a task.
+        if (numSpecies_ > 1 && numZones_ >= PARALLEL_SPECIES_MIN_ZONES && maxParallel_ != 1) {
+            ThreadPool::shared().parallelFor(static_cast<std::size_t>(numSpecies_), [&](std::size_t k) {
+                solveSpecies(network, static_cast<int>(k), t, dt);
+            }, maxParallel_);
+        } else {
+            for (int k = 0; k < numSpecies_; ++k) {
+                solveSpecies(network, k, t, dt);
+            }
         }
     }
 
@@ -69,7 +106,25 @@ ContaminantResult ContaminantSolver::step(const Network& network, double t, doub
     return {t + dt, C_};
 }
 
+std::size_t ContaminantSolver::systemBytes(int unknowns) {
+    // A, the QR copy of A, b, the solution, the Householder coefficients and
+    // the column permutation
+    const auto n = static_cast<std::size_t>(std::max(unknowns, 0));
+    return 2 * n * n * sizeof(double) + 4 * n * sizeof(double) + n * sizeof(int);
+}
+
+void ContaminantSolver::countSystemAllocation(int n) const {
+    if (!profiler_) return;
+    const auto size = static_cast<int64_t>(n);
+    profiler_->count(ProfileCounter::TransportSolves);
+    profiler_->count(ProfileCounter::Allocations);
+    profiler_->count(ProfileCounter::AllocatedBytes, (size * size + size) * static_cast<int64_t>(sizeof(double)));
+}
+
 void ContaminantSolver::solveSpecies(const Network& network, int specIdx, double t, double dt) {
+    std::optional<ProfileScope> assemble;
+    assemble.emplace(profiler_, ProfilePhase::TransportAssemble);
+
     // Build equation index map (only unknown = non-ambient zones)
     std::vector<int> unknownMap(numZones_, -1);
     int numUnknown = 0;
@@ -87,6 +142,8 @@ void ContaminantSolver::solveSpecies(const Network& network, int specIdx, double
     // A * C_new = b
     Eigen::MatrixXd A = Eigen::MatrixXd::Zero(numUnknown, numUnknown);
     Eigen::VectorXd b = Eigen::VectorXd::Zero(numUnknown);
+    countSystemAllocation(numUnknown);
+    MemoryScope system(memory_, MemoryComponent::TransportMatrices, systemBytes(numUnknown));
 
     // Diagonal terms: V_i / dt
     for (int i = 0; i < numZones_; ++i) {
@@ -175,34 +232,8 @@ void ContaminantSolver::solveSpecies(const Network& network, int specIdx, double
         if (eq < 0) continue;
 
         double scheduleMult = getScheduleValue(src.scheduleId, t + dt);
-
-        if (src.type == SourceType::ExponentialDecay) {
-            double elapsed = (t + dt) - src.startTime;
-            if (elapsed >= 0.0 && src.decayTimeConstant > 0.0) {
-                double decayGen = src.multiplier * src.generationRate
-                                  * std::exp(-elapsed / src.decayTimeConstant);
-                b(eq) += decayGen * scheduleMult;
-            }
-        } else if (src.type == SourceType::PressureDriven) {
-            // G = pressureCoeff * |P_zone|
-            double P = std::abs(network.getNode(zoneIdx).getPressure());
-            b(eq) += src.pressureCoeff * P * scheduleMult;
-        } else if (src.type == SourceType::CutoffConcentration) {
-            // G = genRate when C < cutoff, 0 otherwise
-            if (C_[zoneIdx][specIdx] < src.cutoffConc) {
-                b(eq) += src.generationRate * scheduleMult;
-            }
-        } else if (src.type == SourceType::Burst) {
-            // G = burstMass / burstDuration when t ∈ [burstTime, burstTime+burstDuration]
-            double tEval = t + dt;
-            if (tEval >= src.burstTime && tEval <= src.burstTime + src.burstDuration) {
-                double burstRate = src.burstMass / src.burstDuration;
-                b(eq) += burstRate * scheduleMult;
-            }
-        } else {
-            // Constant source: G * schedule → RHS
-            b(eq) += src.generationRate * scheduleMult;
-        }
+        b(eq) += generationRate(src, t + dt, C_[zoneIdx][specIdx],
+                                network.getNode(zoneIdx).getPressure()) * scheduleMult;
 
         // Removal sink: -R * C * V → A += R * V (implicit)
         if (src.removalRate > 0.0) {
@@ -228,6 +259,8 @@ void ContaminantSolver::solveSpecies(const Network& network, int specIdx, double
     }
 
     // Solve A * C_new = b
+    assemble.reset();
+    ProfileScope solve(profiler_, ProfilePhase::TransportSolve);
     Eigen::VectorXd C_new = A.colPivHouseholderQr().solve(b);
 
     // Update concentrations (clamp to non-negative)
@@ -240,6 +273,9 @@ void ContaminantSolver::solveSpecies(const Network& network, int specIdx, double
 }
 
 void ContaminantSolver::solveCoupled(const Network& network, double t, double dt) {
+    std::optional<ProfileScope> assemble;
+    assemble.emplace(profiler_, ProfilePhase::TransportAssemble);
+
     // Build equation index map (only unknown = non-ambient zones)
     std::vector<int> unknownMap(numZones_, -1);
     int numUnknown = 0;
@@ -255,6 +291,8 @@ void ContaminantSolver::solveCoupled(const Network& network, double t, double dt
     int N = numUnknown * numSpecies_;
     Eigen::MatrixXd A = Eigen::MatrixXd::Zero(N, N);
     Eigen::VectorXd b = Eigen::VectorXd::Zero(N);
+    countSystemAllocation(N);
+    MemoryScope system(memory_, MemoryComponent::TransportMatrices, systemBytes(N));
 
     auto idx = [&](int zoneEq, int specIdx) { return zoneEq * numSpecies_ + specIdx; };
 
@@ -384,6 +422,8 @@ void ContaminantSolver::solveCoupled(const Network& network, double t, double dt
     }
 
     // Solve block system
+    assemble.reset();
+    ProfileScope solve(profiler_, ProfilePhase::TransportSolve);
     Eigen::VectorXd C_new = A.colPivHouseholderQr().solve(b);
 
     // Update concentrations
@@ -34,6 +34,24 @@ public:
     // Set chemical reaction network (inter-species reactions)
     void setReactionNetwork(const ReactionNetwork& rxnNet) { rxnNetwork_ = rxnNet; }
 
+    // Threads solving uncoupled species side by side (0 = the whole shared
+    // pool, 1 = serial)
+    void setMaxParallel(unsigned n) { maxParallel_ = n; }
+    // Phase times and counters go to `profiler` (null: not profiled)
+    void setProfiler(Profiler* profiler) { profiler_ = profiler; }
+    // Dense systems are held in `memory` while they are solved (null: not
+    // tracked); species solved side by side each hold one
+    void setMemoryTracker(MemoryTracker* memory) { memory_ = memory; }
+
+    // Generation rate (kg/s, before the schedule multiplier) of `src` at time
+    // `t` in a zone holding `conc` at pressure `pressure`; the removal term
+    // is separate (removalRate * C * V)
+    static double generationRate(const Source& src, double t, double conc, double pressure);
+
+    // Bytes of one dense transport system of `unknowns` equations: the
+    // matrix, its pivoted QR and the vectors
+    static std::size_t systemBytes(int unknowns);
+
     // Initialize concentration matrix (all zones, all species)
     void initialize(const Network& network);
 
@@ -65,12 +83,18 @@ private:
 
     int numZones_ = 0;
     int numSpecies_ = 0;
+    unsigned maxParallel_ = 0;
+    Profiler* profiler_ = nullptr;
+    MemoryTracker* memory_ = nullptr;
 
     // Get schedule multiplier at time t
     double getScheduleValue(int scheduleId, double t) const;
 
     ReactionNetwork rxnNetwork_;
 
+    // Count one dense n x n transport system (and its right-hand side)
+    void countSystemAllocation(int n) const;
+
     // Build and solve the implicit system for one species (no inter-species coupling)
     void solveSpecies(const Network& network, int specIdx, double t, double dt);
 
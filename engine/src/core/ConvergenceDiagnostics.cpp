@@ -0,0 +1,257 @@
+#include "core/ConvergenceDiagnostics.h"
+#include "core/Solver.h"
+#include "utils/Constants.h"
+#include <nlohmann/json.hpp>
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+
+namespace contam {
+
+using json = nlohmann::json;
+
+namespace {
+
+// 1-norm condition estimate of J; `dense` tells which estimate was used
+double estimateCondition(const Eigen::SparseMatrix<double>& J, int denseMax, bool& dense) {
+    const auto n = J.rows();
+    if (n == 0) return 1.0;
+    dense = n <= denseMax;
+    if (dense) {
+        Eigen::MatrixXd Jd(J);
+        Eigen::PartialPivLU<Eigen::MatrixXd> lu(Jd);
+        double rcond = lu.rcond();
+        return rcond > 0.0 ? 1.0 / rcond : std::numeric_limits<double>::infinity();
+    }
+    double lo = std::numeric_limits<double>::infinity(), hi = 0.0;
+    for (Eigen::Index i = 0; i < n; ++i) {
+        double d = std::abs(J.coeff(i, i));
+        lo = std::min(lo, d);
+        hi = std::max(hi, d);
+    }
+    return lo > 0.0 ? hi / lo : std::numeric_limits<double>::infinity();
+}
+
+} // namespace
+
+void ConvergenceDiagnostics::captureTopology(const Network& network) {
+    const int nodeCount = network.getNodeCount(), linkCount = network.getLinkCount();
+    if (static_cast<int>(nodeIds_.size()) == nodeCount && static_cast<int>(linkIds_.size()) == linkCount) return;
+
+    nodeIds_.resize(nodeCount);
+    nodeNames_.resize(nodeCount);
+    for (int i = 0; i < nodeCount; ++i) {
+        nodeIds_[i] = network.getNode(i).getId();
+        nodeNames_[i] = network.getNode(i).getName();
+    }
+    linkIds_.resize(linkCount);
+    linkFrom_.resize(linkCount);
+    linkTo_.resize(linkCount);
+    linearizes_.resize(linkCount);
+    for (int k = 0; k < linkCount; ++k) {
+        const auto& link = network.getLink(k);
+        linkIds_[k] = link.getId();
+        linkFrom_[k] = link.getNodeFrom();
+        linkTo_[k] = link.getNodeTo();
+        const FlowElement* elem = link.getFlowElement();
+        // Fans and two-way openings have no DP_MIN linear branch
+        const std::string type = elem ? elem->typeName() : std::string();
+        linearizes_[k] = elem && type != "Fan" && type != "TwoWayFlow";
+    }
+    nodes_.assign(nodeCount, {});
+    links_.assign(linkCount, {});
+}
+
+void ConvergenceDiagnostics::beginSolve(const Network& network, const std::vector<int>& unknownMap,
+                                        int numUnknowns) {
+    captureTopology(network);
+    eqNode_.assign(numUnknowns, -1);
+    for (int i = 0; i < static_cast<int>(unknownMap.size()); ++i) {
+        if (unknownMap[i] >= 0) eqNode_[unknownMap[i]] = i;
+    }
+    lastSign_.assign(links_.size(), 0);
+    solveFlips_.assign(links_.size(), 0);
+}
+
+void ConvergenceDiagnostics::onIteration(const Network& network, const Eigen::VectorXd& R) {
+    if (R.size() > 0) {
+        Eigen::Index worst = 0;
+        R.cwiseAbs().maxCoeff(&worst);
+        ++nodes_[eqNode_[worst]].worstIterations;
+    }
+    const auto& links = network.getLinks();
+    for (std::size_t k = 0; k < links.size() && k < lastSign_.size(); ++k) {
+        const double m = links[k].getMassFlow();
+        const int8_t sign = std::abs(m) < CONVERGENCE_TOL ? 0 : (m > 0.0 ? 1 : -1);
+        if (sign == 0) continue;
+        if (lastSign_[k] != 0 && sign != lastSign_[k]) ++solveFlips_[k];
+        lastSign_[k] = sign;
+    }
+}
+
+void ConvergenceDiagnostics::endSolve(const Eigen::SparseMatrix<double>& J, const Eigen::VectorXd& R,
+                                      const std::vector<double>& deltaP, const SolverResult& result) {
+    ++solves_;
+    if (!result.converged) ++unconverged_;
+    iterations_ += result.iterations;
+    maxIterations_ = std::max(maxIterations_, result.iterations);
+
+    SolveRecord rec{time_, result.iterations, result.converged, result.maxResidual, -1, 1.0, 0};
+    if (R.size() > 0) {
+        Eigen::Index worst = 0;
+        double residual = R.cwiseAbs().maxCoeff(&worst);
+        rec.worstNode = eqNode_[worst];
+        auto& stats = nodes_[rec.worstNode];
+        ++stats.worstFinalSolves;
+        stats.maxFinalResidual = std::max(stats.maxFinalResidual, residual);
+    }
+    for (std::size_t k = 0; k < links_.size(); ++k) {
+        if (solveFlips_[k] > 0) {
+            links_[k].flips += solveFlips_[k];
+            ++links_[k].flipSolves;
+            ++rec.flippingLinks;
+        }
+        if (k < deltaP.size() && linearizes_[k] && std::abs(deltaP[k]) < DP_MIN) ++links_[k].linearSolves;
+    }
+
+    bool dense = true;
+    rec.condition = estimateCondition(J, options_.conditionDenseMax, dense);
+    denseCondition_ = denseCondition_ && dense;
+    if (solves_ == 1 || rec.condition > maxCondition_) {
+        maxCondition_ = rec.condition;
+        maxConditionTime_ = time_;
+    }
+
+    // Keep the slowest solves, unconverged first
+    auto slower = [](const SolveRecord& a, const SolveRecord& b) {
+        if (a.converged != b.converged) return !a.converged;
+        return a.iterations > b.iterations;
+    };
+    const auto keep = static_cast<std::size_t>(std::max(options_.slowestSolves, 0));
+    if (slowest_.size() < keep || (keep > 0 && slower(rec, slowest_.back()))) {
+        slowest_.insert(std::upper_bound(slowest_.begin(), slowest_.end(), rec, slower), rec);
+        if (slowest_.size() > keep) slowest_.pop_back();
+    }
+}
+
+json ConvergenceDiagnostics::report() const {
+    auto nodeRef = [this](int i, json& j) {
+        j["id"] = nodeIds_[i];
+        j["name"] = nodeNames_[i];
+    };
+
+    // Nodes: most iterations as the worst residual, then largest final residual
+    std::vector<int> nodeOrder;
+    for (int i = 0; i < static_cast<int>(nodes_.size()); ++i) {
+        if (nodes_[i].worstIterations > 0) nodeOrder.push_back(i);
+    }
+    std::stable_sort(nodeOrder.begin(), nodeOrder.end(), [this](int a, int b) {
+        if (nodes_[a].worstIterations != nodes_[b].worstIterations) {
+            return nodes_[a].worstIterations > nodes_[b].worstIterations;
+        }
+        return nodes_[a].maxFinalResidual > nodes_[b].maxFinalResidual;
+    });
+    if (static_cast<int>(nodeOrder.size()) > options_.topNodes) nodeOrder.resize(std::max(options_.topNodes, 0));
+    json nodes = json::array();
+    for (int i : nodeOrder) {
+        json j;
+        nodeRef(i, j);
+        j["worstIterations"] = nodes_[i].worstIterations;
+        j["share"] = iterations_ > 0 ? static_cast<double>(nodes_[i].worstIterations) / iterations_ : 0.0;
+        j["worstFinalSolves"] = nodes_[i].worstFinalSolves;
+        j["maxFinalResidual"] = nodes_[i].maxFinalResidual;
+        nodes.push_back(std::move(j));
+    }
+
+    // Links: direction changes first, then time in the linear regime
+    std::vector<int> linkOrder;
+    for (int k = 0; k < static_cast<int>(links_.size()); ++k) {
+        if (links_[k].flips > 0 || links_[k].linearSolves > 0) linkOrder.push_back(k);
+    }
+    std::stable_sort(linkOrder.begin(), linkOrder.end(), [this](int a, int b) {
+        if (links_[a].flips != links_[b].flips) return links_[a].flips > links_[b].flips;
+        return links_[a].linearSolves > links_[b].linearSolves;
+    });
+    if (static_cast<int>(linkOrder.size()) > options_.topLinks) linkOrder.resize(std::max(options_.topLinks, 0));
+    json links = json::array();
+    for (int k : linkOrder) {
+        links.push_back({{"id", linkIds_[k]}, {"from", nodeIds_[linkFrom_[k]]}, {"to", nodeIds_[linkTo_[k]]},
+                         {"flips", links_[k].flips}, {"flipSolves", links_[k].flipSolves},
+                         {"linearSolves", links_[k].linearSolves},
+                         {"linearShare", solves_ > 0 ? static_cast<double>(links_[k].linearSolves) / solves_ : 0.0}});
+    }
+
+    json slow = json::array();
+    for (const auto& rec : slowest_) {
+        json j{{"time", rec.time}, {"iterations", rec.iterations}, {"converged", rec.converged},
+               {"maxResidual", rec.maxResidual}, {"conditionEstimate", rec.condition},
+               {"flippingLinks", rec.flippingLinks}};
+        if (rec.worstNode >= 0) j["worstNode"] = nodeIds_[rec.worstNode];
+        slow.push_back(std::move(j));
+    }
+
+    json j;
+    j["solves"] = solves_;
+    j["unconverged"] = unconverged_;
+    j["iterations"] = {{"total", iterations_},
+                       {"mean", solves_ > 0 ? static_cast<double>(iterations_) / solves_ : 0.0},
+                       {"max", maxIterations_}};
+    j["conditioning"] = {{"max", maxCondition_}, {"maxTime", maxConditionTime_},
+                         {"method", denseCondition_ ? "lu1Norm" : "diagonalRatio"}};
+    j["nodes"] = std::move(nodes);
+    j["links"] = std::move(links);
+    j["slowestSolves"] = std::move(slow);
+    return j;
+}
+
+std::string ConvergenceDiagnostics::formatText() const {
+    const json r = report();
+    std::string out;
+    char line[200];
+    std::snprintf(line, sizeof(line), "Airflow solves: %d (%d unconverged), Newton iterations %lld (mean %.1f, max %d)\n",
+                  solves_, unconverged_, static_cast<long long>(iterations_),
+                  r["iterations"]["mean"].get<double>(), maxIterations_);
+    out += line;
+    std::snprintf(line, sizeof(line), "Largest condition estimate: %.3g at t=%g s\n", maxCondition_, maxConditionTime_);
+    out += line;
+
+    if (!r["nodes"].empty()) {
+        std::snprintf(line, sizeof(line), "\n%-8s %-24s %12s %7s %14s\n", "Node", "Name", "Worst iters", "Share",
+                      "Max final res");
+        out += line;
+        for (const auto& n : r["nodes"]) {
+            std::snprintf(line, sizeof(line), "%-8d %-24.24s %12lld %6.1f%% %14.3e\n", n["id"].get<int>(),
+                          n["name"].get<std::string>().c_str(), n["worstIterations"].get<long long>(),
+                          100.0 * n["share"].get<double>(), n["maxFinalResidual"].get<double>());
+            out += line;
+        }
+    }
+    if (!r["links"].empty()) {
+        std::snprintf(line, sizeof(line), "\n%-8s %8s %8s %8s %11s %14s\n", "Link", "From", "To", "Flips",
+                      "Flip solves", "Linear solves");
+        out += line;
+        for (const auto& l : r["links"]) {
+            std::snprintf(line, sizeof(line), "%-8d %8d %8d %8lld %11d %14d\n", l["id"].get<int>(),
+                          l["from"].get<int>(), l["to"].get<int>(), l["flips"].get<long long>(),
+                          l["flipSolves"].get<int>(), l["linearSolves"].get<int>());
+            out += line;
+        }
+    }
+    if (!slowest_.empty()) {
+        std::snprintf(line, sizeof(line), "\n%-12s %10s %10s %12s %12s %10s\n", "Time (s)", "Iterations", "Converged",
+                      "Max res", "Condition", "Worst node");
+        out += line;
+        for (const auto& rec : slowest_) {
+            std::snprintf(line, sizeof(line), "%-12g %10d %10s %12.3e %12.3g %10d\n", rec.time, rec.iterations,
+                          rec.converged ? "yes" : "no", rec.maxResidual, rec.condition,
+                          rec.worstNode >= 0 ? nodeIds_[rec.worstNode] : -1);
+            out += line;
+        }
+    }
+    return out;
+}
+
+} // namespace contam
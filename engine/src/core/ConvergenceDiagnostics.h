@@ -0,0 +1,119 @@
+#pragma once
+
+#include "core/Network.h"
+#include <nlohmann/json_fwd.hpp>
+#include <Eigen/Sparse>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace contam {
+
+struct SolverResult;
+
+// Where the airflow solves of a run struggle. A Solver given a
+// ConvergenceDiagnostics reports every Newton iteration and the end of every
+// solve; the totals are kept per node and link and ranked by report():
+//   nodes  - how many Newton iterations a node held the largest residual,
+//            and its largest final residual
+//   links  - flow direction changes within a solve (flows below the
+//            convergence tolerance count as no direction) and solves that
+//            ended with |ΔP| < DP_MIN, where power-law type elements run on
+//            their linearized branch
+//   solves - the slowest solves with their worst node and a Jacobian
+//            condition estimate (1-norm estimate from a dense LU up to
+//            conditionDenseMax unknowns, max/min |diagonal| ratio above)
+//
+//   ConvergenceDiagnostics diagnostics;
+//   sim.setDiagnostics(&diagnostics);
+//   sim.run(network);
+//   results["convergence"] = diagnostics.report();
+class ConvergenceDiagnostics {
+public:
+    struct Options {
+        int topNodes = 20;          // ranked nodes in the report
+        int topLinks = 20;          // ranked links in the report
+        int slowestSolves = 10;     // solves kept with their details
+        int conditionDenseMax = 200;
+    };
+
+    ConvergenceDiagnostics() = default;
+    explicit ConvergenceDiagnostics(const Options& options) : options_(options) {}
+
+    // Simulation time stamped on the following solves
+    void setTime(double t) { time_ = t; }
+
+    // ── Solver hooks ──
+    // unknownMap: node index -> equation index (-1 for known pressures)
+    void beginSolve(const Network& network, const std::vector<int>& unknownMap, int numUnknowns);
+    // After the residual R of an iteration has been assembled
+    void onIteration(const Network& network, const Eigen::VectorXd& R);
+    // With the last assembled Jacobian and residual and the pressure
+    // difference of every link
+    void endSolve(const Eigen::SparseMatrix<double>& J, const Eigen::VectorXd& R,
+                  const std::vector<double>& deltaP, const SolverResult& result);
+
+    int solveCount() const { return solves_; }
+    int unconvergedCount() const { return unconverged_; }
+    int64_t totalIterations() const { return iterations_; }
+
+    struct NodeStats {
+        int64_t worstIterations = 0;   // iterations with the largest |residual|
+        int worstFinalSolves = 0;      // solves that ended with it the worst
+        double maxFinalResidual = 0.0; // kg/s
+    };
+    struct LinkStats {
+        int64_t flips = 0;
+        int flipSolves = 0;            // solves with at least one flip
+        int linearSolves = 0;          // solves ending with |ΔP| < DP_MIN
+    };
+    const std::vector<NodeStats>& nodeStats() const { return nodes_; }
+    const std::vector<LinkStats>& linkStats() const { return links_; }
+
+    // { solves, unconverged, iterations: { total, mean, max }, conditioning:
+    //   { max, maxTime, method }, nodes: [...], links: [...], slowestSolves: [...] }
+    // Nodes and links are ranked worst first; entries that never showed a
+    // problem are left out.
+    nlohmann::json report() const;
+    std::string formatText() const;
+
+private:
+    Options options_;
+    double time_ = 0.0;
+
+    // Topology captured by the first solve
+    std::vector<int> nodeIds_;
+    std::vector<std::string> nodeNames_;
+    std::vector<int> linkIds_, linkFrom_, linkTo_;
+    std::vector<bool> linearizes_;   // element has a DP_MIN linear branch
+
+    std::vector<NodeStats> nodes_;
+    std::vector<LinkStats> links_;
+    int solves_ = 0;
+    int unconverged_ = 0;
+    int64_t iterations_ = 0;
+    int maxIterations_ = 0;
+    double maxCondition_ = 0.0;
+    double maxConditionTime_ = 0.0;
+    bool denseCondition_ = true;     // every estimate came from a dense LU
+
+    struct SolveRecord {
+        double time;
+        int iterations;
+        bool converged;
+        double maxResidual;
+        int worstNode;               // node index, -1 if none
+        double condition;
+        int flippingLinks;
+    };
+    std::vector<SolveRecord> slowest_;   // worst first, at most slowestSolves
+
+    // Per-solve scratch
+    std::vector<int> eqNode_;            // equation index -> node index
+    std::vector<int8_t> lastSign_;
+    std::vector<int> solveFlips_;
+
+    void captureTopology(const Network& network);
+};
+
+} // namespace contam
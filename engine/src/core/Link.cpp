@@ -9,10 +9,8 @@ Link::Link(int id, int nodeFrom, int nodeTo, double elevation)
 
 Link::Link(const Link& other)
     : id_(other.id_), nodeFrom_(other.nodeFrom_), nodeTo_(other.nodeTo_),
-      elevation_(other.elevation_), massFlow_(other.massFlow_), derivative_(other.derivative_) {
-    if (other.flowElement_) {
-        flowElement_ = other.flowElement_->clone();
-    }
+      elevation_(other.elevation_), flowElement_(other.flowElement_),
+      massFlow_(other.massFlow_), derivative_(other.derivative_) {
 }
 
 Link& Link::operator=(const Link& other) {
@@ -23,7 +21,7 @@ Link& Link::operator=(const Link& other) {
         elevation_ = other.elevation_;
         massFlow_ = other.massFlow_;
         derivative_ = other.derivative_;
-        flowElement_ = other.flowElement_ ? other.flowElement_->clone() : nullptr;
+        flowElement_ = other.flowElement_;
     }
     return *this;
 }
@@ -32,4 +30,8 @@ void Link::setFlowElement(std::unique_ptr<FlowElement> elem) {
     flowElement_ = std::move(elem);
 }
 
+void Link::setSharedFlowElement(std::shared_ptr<const FlowElement> elem) {
+    flowElement_ = std::move(elem);
+}
+
 } // namespace contam
@@ -11,7 +11,7 @@ public:
     Link() = default;
     Link(int id, int nodeFrom, int nodeTo, double elevation);
 
-    // Copy (clones FlowElement)
+    // Copy (shares the immutable FlowElement)
     Link(const Link& other);
     Link& operator=(const Link& other);
 
@@ -32,6 +32,8 @@ public:
 
     const FlowElement* getFlowElement() const { return flowElement_.get(); }
     void setFlowElement(std::unique_ptr<FlowElement> elem);
+    // Share one element instance between links (e.g. a named JSON template)
+    void setSharedFlowElement(std::shared_ptr<const FlowElement> elem);
 
 private:
     int id_ = 0;
@@ -39,7 +41,9 @@ private:
     int nodeTo_ = -1;     // index into Network's node array
     double elevation_ = 0.0;  // Z_k: centerline elevation of the path (m)
 
-    std::unique_ptr<FlowElement> flowElement_;
+    // Elements are never mutated after construction (actuators swap in a new
+    // instance), so links and network copies can share them.
+    std::shared_ptr<const FlowElement> flowElement_;
 
     double massFlow_ = 0.0;    // kg/s, computed result
     double derivative_ = 0.0;  // d(ṁ)/d(ΔP), for Jacobian
@@ -1,5 +1,6 @@
 #include "core/Network.h"
 #include <stdexcept>
+#include <unordered_set>
 
 namespace contam {
 
@@ -31,6 +32,23 @@ int Network::getUnknownCount() const {
     return count;
 }
 
+std::size_t Network::memoryBytes() const {
+    // Hash nodes hold the key/value pair and a next pointer
+    return sizeof(*this) + nodes_.capacity() * sizeof(Node) + links_.capacity() * sizeof(Link) +
+           idToIndex_.size() * (sizeof(std::pair<const int, int>) + sizeof(void*)) +
+           idToIndex_.bucket_count() * sizeof(void*);
+}
+
+std::size_t Network::elementMemoryBytes() const {
+    std::unordered_set<const FlowElement*> seen;
+    std::size_t bytes = 0;
+    for (const auto& link : links_) {
+        const FlowElement* elem = link.getFlowElement();
+        if (elem && seen.insert(elem).second) bytes += elem->memoryBytes();
+    }
+    return bytes;
+}
+
 void Network::updateAllDensities() {
     for (auto& node : nodes_) {
         node.updateDensity();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <vector>
 #include <unordered_map>
 #include <string>
@@ -34,6 +35,11 @@ public:
     // Count of unknown pressure nodes (excludes Ambient)
     int getUnknownCount() const;
 
+    // Bytes held by the nodes, links and node id index, and by the flow
+    // elements (an element shared by several links counts once)
+    std::size_t memoryBytes() const;
+    std::size_t elementMemoryBytes() const;
+
     // Update all node densities
     void updateAllDensities();
 
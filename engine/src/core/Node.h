@@ -58,6 +58,7 @@ public:
         cpProfile_ = profile;
         std::sort(cpProfile_.begin(), cpProfile_.end());
     }
+    const std::vector<std::pair<double, double>>& getWindPressureProfile() const { return cpProfile_; }
 
     // Wall azimuth angle (degrees from north, clockwise)
     void setWallAzimuth(double azimuth) { wallAzimuth_ = azimuth; }
@@ -0,0 +1,182 @@
+#include "core/OutputSpec.h"
+#include "core/TransientSimulation.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace contam {
+
+OutputPrecision parseOutputPrecision(const std::string& name) {
+    if (name == "double") return OutputPrecision::Double;
+    if (name == "float32" || name == "float") return OutputPrecision::Float32;
+    if (name == "quantized") return OutputPrecision::Quantized;
+    throw std::runtime_error("Unknown output precision: " + name +
+                             " (expected double, float32 or quantized)");
+}
+
+bool OutputSpec::isDefault() const {
+    return nodeIds.empty() && linkIds.empty() && speciesIds.empty() &&
+           pressureInterval == 0.0 && massFlowInterval == 0.0 && concentrationInterval == 0.0 &&
+           std::isinf(windowStart) && windowStart < 0 &&
+           std::isinf(windowEnd) && windowEnd > 0 &&
+           precision == OutputPrecision::Double;
+}
+
+// ── OutputSelection ──────────────────────────────────────────────────
+
+OutputSelection::OutputSelection(const OutputSpec& spec, const Network& network,
+                                 const std::vector<Species>& species)
+    : spec_(spec) {
+    if (spec_.precision == OutputPrecision::Quantized &&
+        (spec_.significantDigits < 1 || spec_.significantDigits > 17)) {
+        throw std::runtime_error("Output significantDigits must be between 1 and 17");
+    }
+
+    if (!spec_.nodeIds.empty()) {
+        filterNodes_ = true;
+        for (int id : spec_.nodeIds) nodes_.push_back(network.getNodeIndexById(id));
+    }
+
+    if (!spec_.linkIds.empty()) {
+        filterLinks_ = true;
+        std::unordered_map<int, int> linkIndex;
+        for (int i = 0; i < network.getLinkCount(); ++i) linkIndex[network.getLink(i).getId()] = i;
+        for (int id : spec_.linkIds) {
+            auto it = linkIndex.find(id);
+            if (it == linkIndex.end()) {
+                throw std::runtime_error("Output link ID " + std::to_string(id) + " not found");
+            }
+            links_.push_back(it->second);
+        }
+    }
+
+    if (!spec_.speciesIds.empty()) {
+        filterSpecies_ = true;
+        for (int id : spec_.speciesIds) {
+            int found = -1;
+            for (size_t k = 0; k < species.size(); ++k) {
+                if (species[k].id == id) found = static_cast<int>(k);
+            }
+            if (found < 0) {
+                throw std::runtime_error("Output species ID " + std::to_string(id) + " not found");
+            }
+            species_.push_back(found);
+        }
+    }
+}
+
+std::size_t OutputSelection::nodeCount(const Network& network) const {
+    return filterNodes_ ? nodes_.size() : static_cast<std::size_t>(network.getNodeCount());
+}
+
+std::size_t OutputSelection::linkCount(const Network& network) const {
+    return filterLinks_ ? links_.size() : static_cast<std::size_t>(network.getLinkCount());
+}
+
+std::size_t OutputSelection::speciesCount(const std::vector<Species>& species) const {
+    return filterSpecies_ ? species_.size() : species.size();
+}
+
+bool OutputSelection::hasPressures(const TimeStepResult& step) const {
+    return spec_.pressureInterval == 0.0 || !step.airflow.pressures.empty();
+}
+
+bool OutputSelection::hasMassFlows(const TimeStepResult& step) const {
+    return spec_.massFlowInterval == 0.0 || !step.airflow.massFlows.empty();
+}
+
+bool OutputSelection::hasConcentrations(const TimeStepResult& step) const {
+    return !step.contaminant.concentrations.empty();
+}
+
+void OutputSelection::reset() {
+    lastPressure_ = lastMassFlow_ = lastConcentration_ = std::numeric_limits<double>::quiet_NaN();
+}
+
+// Due on the first recorded step and then once `interval` has elapsed
+static bool isDue(double interval, double t, double& last) {
+    if (interval < 0.0) return false;
+    if (interval > 0.0 && !std::isnan(last) && t - last < interval * (1.0 - 1e-9)) return false;
+    last = t;
+    return true;
+}
+
+template <typename T>
+static void compact(std::vector<T>& values, const std::vector<int>& indices) {
+    std::vector<T> out;
+    out.reserve(indices.size());
+    for (int i : indices) {
+        out.push_back(i < static_cast<int>(values.size()) ? values[i] : T{});
+    }
+    values = std::move(out);
+}
+
+bool OutputSelection::apply(TimeStepResult& step) {
+    if (step.time < spec_.windowStart || step.time > spec_.windowEnd) return false;
+
+    auto& pressures = step.airflow.pressures;
+    auto& flows = step.airflow.massFlows;
+    auto& concs = step.contaminant.concentrations;
+
+    if (!isDue(spec_.pressureInterval, step.time, lastPressure_)) {
+        pressures.clear();
+    } else if (filterNodes_) {
+        compact(pressures, nodes_);
+    }
+
+    if (!isDue(spec_.massFlowInterval, step.time, lastMassFlow_)) {
+        flows.clear();
+    } else if (filterLinks_) {
+        compact(flows, links_);
+    }
+
+    if (!concs.empty()) {
+        if (!isDue(spec_.concentrationInterval, step.time, lastConcentration_)) {
+            concs.clear();
+        } else {
+            if (filterNodes_) compact(concs, nodes_);
+            if (filterSpecies_) {
+                for (auto& nodeConcs : concs) compact(nodeConcs, species_);
+            }
+        }
+    }
+
+    if (spec_.precision != OutputPrecision::Double) {
+        roundAll(pressures);
+        roundAll(flows);
+        for (auto& nodeConcs : concs) roundAll(nodeConcs);
+    }
+    return true;
+}
+
+double OutputSelection::round(double v) const {
+    if (!std::isfinite(v)) return v;
+    switch (spec_.precision) {
+    case OutputPrecision::Double:
+        return v;
+    case OutputPrecision::Float32:
+        return static_cast<double>(static_cast<float>(v));
+    case OutputPrecision::Quantized: {
+        if (v == 0.0) return 0.0;
+        const int exponent = static_cast<int>(std::floor(std::log10(std::fabs(v))));
+        const int shift = spec_.significantDigits - 1 - exponent;
+        if (shift > 300 || shift < -300) {
+            // Scale factor would overflow; go through the decimal text form
+            char tmp[40];
+            std::snprintf(tmp, sizeof(tmp), "%.*e", spec_.significantDigits - 1, v);
+            return std::strtod(tmp, nullptr);
+        }
+        const double scale = std::pow(10.0, shift);
+        return std::round(v * scale) / scale;
+    }
+    }
+    return v;
+}
+
+void OutputSelection::roundAll(std::vector<double>& values) const {
+    for (double& v : values) v = round(v);
+}
+
+} // namespace contam
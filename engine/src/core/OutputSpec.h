@@ -0,0 +1,112 @@
+#pragma once
+#include "Network.h"
+#include "Species.h"
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace contam {
+
+struct TimeStepResult;
+
+enum class OutputPrecision {
+    Double,     // values as computed
+    Float32,    // rounded to single precision (float datasets/short JSON numbers)
+    Quantized   // rounded to OutputSpec::significantDigits significant digits
+};
+
+// Parse "double" | "float32" | "quantized"; throws std::runtime_error otherwise
+OutputPrecision parseOutputPrecision(const std::string& name);
+
+// What a transient run records. Empty id lists select every node, link or
+// species. Intervals are in seconds and are applied on top of
+// TransientConfig::outputInterval: 0 records the variable at every output
+// step, a negative interval never records it.
+struct OutputSpec {
+    std::vector<int> nodeIds;
+    std::vector<int> linkIds;
+    std::vector<int> speciesIds;
+
+    double pressureInterval = 0.0;
+    double massFlowInterval = 0.0;
+    double concentrationInterval = 0.0;
+
+    // Output steps outside [windowStart, windowEnd] are dropped
+    double windowStart = -std::numeric_limits<double>::infinity();
+    double windowEnd = std::numeric_limits<double>::infinity();
+
+    OutputPrecision precision = OutputPrecision::Double;
+    int significantDigits = 4;
+
+    // True when the spec records everything at full precision
+    bool isDefault() const;
+};
+
+// An OutputSpec resolved against a network and species list. apply() turns a
+// full output step into the recorded one: pressures, mass flows and
+// concentrations are compacted to the selected entities (in selection order),
+// variables that are not due this step are left empty, and values are rounded
+// to the requested precision.
+//
+// Writers label compacted values through node(k)/link(k)/species(k), which
+// map a position in the recorded vectors back to the network index. A
+// default-constructed selection records everything and is what results
+// built without a spec carry.
+class OutputSelection {
+public:
+    OutputSelection() = default;
+
+    // Throws std::runtime_error for ids that are not in the model
+    OutputSelection(const OutputSpec& spec, const Network& network,
+                    const std::vector<Species>& species);
+
+    const OutputSpec& spec() const { return spec_; }
+    bool isDefault() const { return spec_.isDefault(); }
+    OutputPrecision precision() const { return spec_.precision; }
+
+    bool filtersNodes() const { return filterNodes_; }
+    bool filtersLinks() const { return filterLinks_; }
+    bool filtersSpecies() const { return filterSpecies_; }
+
+    std::size_t nodeCount(const Network& network) const;
+    std::size_t linkCount(const Network& network) const;
+    std::size_t speciesCount(const std::vector<Species>& species) const;
+
+    // Network/species index of the k-th recorded entity
+    int node(std::size_t k) const { return filterNodes_ ? nodes_[k] : static_cast<int>(k); }
+    int link(std::size_t k) const { return filterLinks_ ? links_[k] : static_cast<int>(k); }
+    int species(std::size_t k) const { return filterSpecies_ ? species_[k] : static_cast<int>(k); }
+
+    // Whether a recorded step carries the variable (false when it was not due)
+    bool hasPressures(const TimeStepResult& step) const;
+    bool hasMassFlows(const TimeStepResult& step) const;
+    bool hasConcentrations(const TimeStepResult& step) const;
+
+    // Restart interval tracking (called at the start of each run)
+    void reset();
+
+    // Reduce `step` in place; returns false if the step is outside the time
+    // window and should not be recorded at all
+    bool apply(TimeStepResult& step);
+
+    // Round one value to the selected precision
+    double round(double v) const;
+
+private:
+    OutputSpec spec_;
+    bool filterNodes_ = false;
+    bool filterLinks_ = false;
+    bool filterSpecies_ = false;
+    std::vector<int> nodes_;
+    std::vector<int> links_;
+    std::vector<int> species_;
+
+    double lastPressure_ = std::numeric_limits<double>::quiet_NaN();
+    double lastMassFlow_ = std::numeric_limits<double>::quiet_NaN();
+    double lastConcentration_ = std::numeric_limits<double>::quiet_NaN();
+
+    void roundAll(std::vector<double>& values) const;
+};
+
+} // namespace contam
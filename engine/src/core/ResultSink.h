@@ -0,0 +1,46 @@
+#pragma once
+#include "Network.h"
+#include "OutputSpec.h"
+#include "Species.h"
+#include "utils/MemoryTracker.h"
+#include <cstddef>
+#include <vector>
+
+namespace contam {
+
+struct TimeStepResult;
+
+// Receives transient results while the simulation runs, so writers and
+// post-processors do not need the full history in memory.
+//   begin()  once, before the initial state is recorded; `output` says how
+//            recorded steps are reduced (see OutputSelection)
+//   onStep() for every recorded output step (including t = startTime)
+//   onHistoryDropped()  after begin() when the run keeps no
+//            TransientResult::history to stay within its memory budget
+//   end()    once; completed is false if the run was cancelled or stopped
+//            by an exception
+class ResultSink {
+public:
+    virtual ~ResultSink() = default;
+
+    virtual void begin(const Network& network, const std::vector<Species>& species,
+                       const OutputSelection& output) {
+        (void)network;
+        (void)species;
+        (void)output;
+    }
+    virtual void onStep(const TimeStepResult& step) = 0;
+    virtual void onHistoryDropped() {}
+    virtual void end(bool completed) { (void)completed; }
+
+    // Bytes the sink holds between steps (buffers, running totals, recorded
+    // values) and what they count as; memory-tracked runs poll this after
+    // every recorded step
+    virtual std::size_t memoryBytes() const { return 0; }
+    virtual MemoryComponent memoryComponent() const { return MemoryComponent::IoBuffers; }
+    // What memoryBytes() is expected to reach once the run is under way, for
+    // predictions made before begin()
+    virtual std::size_t expectedMemoryBytes() const { return memoryBytes(); }
+};
+
+} // namespace contam
@@ -33,12 +33,16 @@ public:
     InterpolationMode getInterpolationMode() const { return interpMode_; }
 
     void addPoint(double time, double value) {
-        points_.push_back({time, value});
-        // Keep sorted by time
-        std::sort(points_.begin(), points_.end(),
-                  [](const SchedulePoint& a, const SchedulePoint& b) {
-                      return a.time < b.time;
-                  });
+        // Keep sorted by time; in-order appends (file readers) skip the search
+        if (points_.empty() || time >= points_.back().time) {
+            points_.push_back({time, value});
+            return;
+        }
+        auto pos = std::upper_bound(points_.begin(), points_.end(), time,
+                                    [](double t, const SchedulePoint& p) {
+                                        return t < p.time;
+                                    });
+        points_.insert(pos, {time, value});
     }
 
     // Get value at time t (respects interpolation mode)
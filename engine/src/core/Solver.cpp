@@ -1,4 +1,6 @@
 #include "core/Solver.h"
+#include "core/ConvergenceDiagnostics.h"
+#include "utils/ThreadPool.h"
 #include <Eigen/IterativeLinearSolvers>
 #include <cmath>
 #include <algorithm>
@@ -34,20 +36,32 @@ double Solver::computeDeltaP(const Network& network, const Link& link) const {
 }
 
 void Solver::computeFlows(Network& network) {
-    for (auto& link : network.getLinks()) {
-        const auto* elem = link.getFlowElement();
-        if (!elem) continue;
-
-        double deltaP = computeDeltaP(network, link);
-
-        // Use average density of the two connected nodes
-        const auto& nodeI = network.getNode(link.getNodeFrom());
-        const auto& nodeJ = network.getNode(link.getNodeTo());
-        double avgDensity = 0.5 * (nodeI.getDensity() + nodeJ.getDensity());
+    auto& links = network.getLinks();
+    auto evaluate = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t k = begin; k < end; ++k) {
+            auto& link = links[k];
+            const auto* elem = link.getFlowElement();
+            if (!elem) continue;
+
+            double deltaP = computeDeltaP(network, link);
+
+            // Use average density of the two connected nodes
+            const auto& nodeI = network.getNode(link.getNodeFrom());
+            const auto& nodeJ = network.getNode(link.getNodeTo());
+            double avgDensity = 0.5 * (nodeI.getDensity() + nodeJ.getDensity());
+
+            auto result = elem->calculate(deltaP, avgDensity);
+            link.setMassFlow(result.massFlow);
+            link.setDerivative(result.derivative);
+        }
+    };
 
-        auto result = elem->calculate(deltaP, avgDensity);
-        link.setMassFlow(result.massFlow);
-        link.setDerivative(result.derivative);
+    // Links are independent; only networks large enough to pay for the
+    // hand-off are split across the shared pool
+    if (links.size() < PARALLEL_LINK_MIN || maxParallel_ == 1) {
+        evaluate(0, links.size());
+    } else {
+        ThreadPool::shared().parallelForRange(links.size(), PARALLEL_LINK_GRAIN, evaluate, maxParallel_);
     }
 }
 
@@ -63,6 +77,11 @@ void Solver::assembleSystem(
 
     std::vector<Eigen::Triplet<double>> triplets;
     triplets.reserve(n * 5);  // estimate ~5 non-zeros per row
+    if (profiler_) {
+        profiler_->count(ProfileCounter::Allocations);
+        profiler_->count(ProfileCounter::AllocatedBytes,
+                         static_cast<int64_t>(triplets.capacity() * sizeof(Eigen::Triplet<double>)));
+    }
 
     // For each link, contribute to residual and Jacobian
     for (const auto& link : network.getLinks()) {
@@ -223,19 +242,44 @@ std::vector<int> Solver::computeRCMOrdering(const Network& network,
     return cmOrder;
 }
 
-SolverResult Solver::solve(Network& network) {
-    SolverResult result;
+const std::vector<int>& Solver::equationOrdering(const Network& network, int& numUnknowns) {
+    const int nodeCount = network.getNodeCount();
+    const auto& links = network.getLinks();
+
+    // Key: known-pressure flag per node, then the endpoints of every link
+    bool same = topologyKey_.size() == static_cast<size_t>(nodeCount) + 2 * links.size();
+    for (int i = 0; same && i < nodeCount; ++i) {
+        same = topologyKey_[i] == (network.getNode(i).isKnownPressure() ? 1 : 0);
+    }
+    for (size_t j = 0; same && j < links.size(); ++j) {
+        same = topologyKey_[nodeCount + 2 * j] == links[j].getNodeFrom() &&
+               topologyKey_[nodeCount + 2 * j + 1] == links[j].getNodeTo();
+    }
+    if (same) {
+        if (profiler_) profiler_->count(ProfileCounter::OrderingCacheHits);
+        numUnknowns = numUnknowns_;
+        return unknownMap_;
+    }
+    if (profiler_) profiler_->count(ProfileCounter::OrderingCacheMisses);
+
+    topologyKey_.clear();
+    for (int i = 0; i < nodeCount; ++i) {
+        topologyKey_.push_back(network.getNode(i).isKnownPressure() ? 1 : 0);
+    }
+    for (const auto& link : links) {
+        topologyKey_.push_back(link.getNodeFrom());
+        topologyKey_.push_back(link.getNodeTo());
+    }
 
     // Build unknown map: for each node, map to equation index (-1 if known pressure)
-    std::vector<int> baseUnknownMap(network.getNodeCount(), -1);
+    std::vector<int> baseUnknownMap(nodeCount, -1);
     int eqIdx = 0;
-    for (int i = 0; i < network.getNodeCount(); ++i) {
+    for (int i = 0; i < nodeCount; ++i) {
         if (!network.getNode(i).isKnownPressure()) {
             baseUnknownMap[i] = eqIdx++;
         }
     }
-
-    int n = eqIdx;  // number of unknowns
+    const int n = eqIdx;
 
     // Apply RCM node reordering for bandwidth reduction
     auto rcmPerm = computeRCMOrdering(network, baseUnknownMap, n);
@@ -244,17 +288,51 @@ SolverResult Solver::solve(Network& network) {
     std::vector<int> invPerm(n);
     for (int i = 0; i < n; ++i) invPerm[rcmPerm[i]] = i;
 
-    std::vector<int> unknownMap(network.getNodeCount(), -1);
-    for (int i = 0; i < network.getNodeCount(); ++i) {
+    unknownMap_.assign(nodeCount, -1);
+    for (int i = 0; i < nodeCount; ++i) {
         if (baseUnknownMap[i] >= 0) {
-            unknownMap[i] = invPerm[baseUnknownMap[i]];
+            unknownMap_[i] = invPerm[baseUnknownMap[i]];
         }
     }
+    numUnknowns_ = n;
+    numUnknowns = n;
+    return unknownMap_;
+}
+
+std::size_t Solver::workspaceBytes(int unknowns, int links) {
+    // Each link adds at most two diagonal and two off-diagonal entries;
+    // IncompleteLUT keeps up to its default fill factor (10) times the
+    // entries of a row, and SparseLU on small systems stays below that
+    constexpr std::size_t FILL_FACTOR = 10;
+    constexpr std::size_t NEWTON_VECTORS = 10;   // R, dP and BiCGSTAB's work vectors
+    const auto n = static_cast<std::size_t>(std::max(unknowns, 0));
+    const std::size_t nnz = std::min(n * n, n + 2 * static_cast<std::size_t>(std::max(links, 0)));
+    const std::size_t entry = sizeof(double) + sizeof(int);
+    return std::max(n * 5, nnz) * sizeof(Eigen::Triplet<double>) + nnz * entry + (n + 1) * sizeof(int) +
+           FILL_FACTOR * nnz * entry + NEWTON_VECTORS * n * sizeof(double);
+}
+
+MemoryEstimate Solver::estimateMemory(const Network& network) {
+    MemoryEstimate estimate;
+    estimate[MemoryComponent::Network] = network.memoryBytes();
+    estimate[MemoryComponent::Elements] = network.elementMemoryBytes();
+    estimate[MemoryComponent::SolverWorkspace] = workspaceBytes(network.getUnknownCount(), network.getLinkCount());
+    return estimate;
+}
+
+SolverResult Solver::solve(Network& network) {
+    SolverResult result;
+
+    int n = 0;  // number of unknowns
+    const std::vector<int>& unknownMap = equationOrdering(network, n);
     if (n == 0) {
         result.converged = true;
         return result;
     }
 
+    if (diagnostics_) diagnostics_->beginSolve(network, unknownMap, n);
+    MemoryScope workspace(memory_, MemoryComponent::SolverWorkspace, workspaceBytes(n, network.getLinkCount()));
+
     // Initialize densities
     network.updateAllDensities();
 
@@ -263,14 +341,18 @@ SolverResult Solver::solve(Network& network) {
     double trustRadius = TR_INITIAL_RADIUS;
 
     for (int iter = 0; iter < maxIterations_; ++iter) {
-        // Update densities based on current pressures
-        network.updateAllDensities();
+        {
+            ProfileScope assemble(profiler_, ProfilePhase::AirflowAssemble);
+
+            // Update densities based on current pressures
+            network.updateAllDensities();
 
-        // Compute flows and derivatives for all links
-        computeFlows(network);
+            // Compute flows and derivatives for all links
+            computeFlows(network);
 
-        // Assemble Jacobian and residual
-        assembleSystem(network, J, R, unknownMap);
+            // Assemble Jacobian and residual
+            assembleSystem(network, J, R, unknownMap);
+        }
 
         // Check convergence
         result.maxResidual = R.lpNorm<Eigen::Infinity>();
@@ -280,39 +362,49 @@ SolverResult Solver::solve(Network& network) {
             result.converged = true;
             break;
         }
+        if (diagnostics_) diagnostics_->onIteration(network, R);
 
         // Solve J * dP = -R
         // Auto-switch: SparseLU for small systems, BiCGSTAB+ILU for large
         Eigen::VectorXd dP;
         bool solveOk = false;
 
+        // Factorize then solve with `direct`, each step timed as its phase
+        auto solveDirect = [&]() {
+            Eigen::SparseLU<Eigen::SparseMatrix<double>> directSolver;
+            {
+                ProfileScope factor(profiler_, ProfilePhase::AirflowFactor);
+                directSolver.compute(J);
+            }
+            if (profiler_) profiler_->count(ProfileCounter::Factorizations);
+            if (directSolver.info() == Eigen::Success) {
+                ProfileScope solve(profiler_, ProfilePhase::AirflowSolve);
+                dP = directSolver.solve(-R);
+                solveOk = (directSolver.info() == Eigen::Success);
+            }
+        };
+
         if (n > 50) {
             // Large system: use iterative BiCGSTAB with ILU preconditioning
             Eigen::BiCGSTAB<Eigen::SparseMatrix<double>, Eigen::IncompleteLUT<double>> iterSolver;
             iterSolver.setMaxIterations(1000);
             iterSolver.setTolerance(1e-10);
-            iterSolver.compute(J);
+            {
+                ProfileScope factor(profiler_, ProfilePhase::AirflowFactor);
+                iterSolver.compute(J);
+            }
+            if (profiler_) profiler_->count(ProfileCounter::Factorizations);
             if (iterSolver.info() == Eigen::Success) {
+                ProfileScope solve(profiler_, ProfilePhase::AirflowSolve);
                 dP = iterSolver.solve(-R);
                 solveOk = (iterSolver.info() == Eigen::Success);
+                if (profiler_) profiler_->count(ProfileCounter::LinearIterations, iterSolver.iterations());
             }
             // Fallback to direct if iterative fails
-            if (!solveOk) {
-                Eigen::SparseLU<Eigen::SparseMatrix<double>> directSolver;
-                directSolver.compute(J);
-                if (directSolver.info() == Eigen::Success) {
-                    dP = directSolver.solve(-R);
-                    solveOk = (directSolver.info() == Eigen::Success);
-                }
-            }
+            if (!solveOk) solveDirect();
         } else {
             // Small system: use direct SparseLU
-            Eigen::SparseLU<Eigen::SparseMatrix<double>> directSolver;
-            directSolver.compute(J);
-            if (directSolver.info() == Eigen::Success) {
-                dP = directSolver.solve(-R);
-                solveOk = (directSolver.info() == Eigen::Success);
-            }
+            solveDirect();
         }
 
         if (!solveOk) {
@@ -321,6 +413,7 @@ SolverResult Solver::solve(Network& network) {
         }
 
         // Apply pressure update
+        ProfileScope update(profiler_, ProfilePhase::AirflowSolve);
         double prevResidualNorm = R.norm();
         if (method_ == SolverMethod::SubRelaxation) {
             applyUpdateSUR(network, dP, unknownMap);
@@ -328,6 +421,10 @@ SolverResult Solver::solve(Network& network) {
             applyUpdateTR(network, dP, unknownMap, trustRadius, prevResidualNorm, R);
         }
     }
+    if (profiler_) {
+        profiler_->count(ProfileCounter::AirflowSolves);
+        profiler_->count(ProfileCounter::NewtonIterations, result.iterations);
+    }
 
     // Collect final results
     result.pressures.resize(network.getNodeCount());
@@ -340,6 +437,14 @@ SolverResult Solver::solve(Network& network) {
         result.massFlows[i] = network.getLink(i).getMassFlow();
     }
 
+    if (diagnostics_) {
+        std::vector<double> deltaP(network.getLinkCount());
+        for (int i = 0; i < network.getLinkCount(); ++i) {
+            deltaP[i] = computeDeltaP(network, network.getLink(i));
+        }
+        diagnostics_->endSolve(J, R, deltaP, result);
+    }
+
     return result;
 }
 
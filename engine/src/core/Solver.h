@@ -1,12 +1,16 @@
 #pragma once
 
 #include "core/Network.h"
+#include "utils/MemoryTracker.h"
+#include "utils/Profiler.h"
 #include <Eigen/Sparse>
 #include <vector>
 #include <functional>
 
 namespace contam {
 
+class ConvergenceDiagnostics;
+
 enum class SolverMethod {
     SubRelaxation,  // Simple under-relaxation (SUR), α ≈ 0.75
     TrustRegion     // Trust region method (default, more robust)
@@ -32,12 +36,34 @@ public:
     void setMaxIterations(int n) { maxIterations_ = n; }
     void setConvergenceTol(double tol) { convergenceTol_ = tol; }
     void setRelaxFactor(double alpha) { relaxFactor_ = alpha; }
+    // Threads evaluating links on large networks (0 = the whole shared
+    // pool, 1 = serial)
+    void setMaxParallel(unsigned n) { maxParallel_ = n; }
+    // Phase times and counters go to `profiler` (null: not profiled)
+    void setProfiler(Profiler* profiler) { profiler_ = profiler; }
+    // Residual hot spots, flow reversals and conditioning of every solve go
+    // to `diagnostics` (null: none collected)
+    void setDiagnostics(ConvergenceDiagnostics* diagnostics) { diagnostics_ = diagnostics; }
+    // Work buffers of every solve are held in `memory` as the solver
+    // workspace (null: not tracked)
+    void setMemoryTracker(MemoryTracker* memory) { memory_ = memory; }
+
+    // Estimated bytes of one solve's Jacobian, triplets, factorization and
+    // Newton vectors for `unknowns` equations and `links` links
+    static std::size_t workspaceBytes(int unknowns, int links);
+    // Predicted memory of a steady solve of `network`: the network, its
+    // elements and the solver workspace
+    static MemoryEstimate estimateMemory(const Network& network);
 
 private:
     SolverMethod method_;
     int maxIterations_ = MAX_ITERATIONS;
     double convergenceTol_ = CONVERGENCE_TOL;
     double relaxFactor_ = RELAX_FACTOR_SUR;
+    unsigned maxParallel_ = 0;
+    Profiler* profiler_ = nullptr;
+    ConvergenceDiagnostics* diagnostics_ = nullptr;
+    MemoryTracker* memory_ = nullptr;
 
     // Compute real pressure difference across a link (with elevation correction)
     double computeDeltaP(const Network& network, const Link& link) const;
@@ -63,6 +89,13 @@ private:
                        double& trustRadius, double prevResidualNorm,
                        const Eigen::VectorXd& R);
 
+    // Equation ordering of the last solved topology, reused by later solves
+    // while the known-pressure nodes and link endpoints stay the same
+    std::vector<int> topologyKey_;
+    std::vector<int> unknownMap_;
+    int numUnknowns_ = 0;
+    const std::vector<int>& equationOrdering(const Network& network, int& numUnknowns);
+
     // Reverse Cuthill-McKee node reordering for bandwidth reduction
     // Returns a permutation vector: perm[new_idx] = old_node_idx
     static std::vector<int> computeRCMOrdering(const Network& network,
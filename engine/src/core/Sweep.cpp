@@ -0,0 +1,126 @@
+#include "core/Sweep.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace contam {
+
+SweepMethod parseSweepMethod(const std::string& name) {
+    if (name == "grid") return SweepMethod::Grid;
+    if (name == "lhs" || name == "latinHypercube") return SweepMethod::LatinHypercube;
+    throw std::runtime_error("Unknown sweep method: " + name + " (expected grid or lhs)");
+}
+
+const char* sweepMethodName(SweepMethod method) {
+    return method == SweepMethod::Grid ? "grid" : "lhs";
+}
+
+namespace {
+
+void checkRange(const SweepParameter& p) {
+    if (!(p.max >= p.min)) {
+        throw std::runtime_error("Sweep parameter " + p.name + ": max is below min");
+    }
+    if (p.logScale && p.min <= 0.0) {
+        throw std::runtime_error("Sweep parameter " + p.name + ": log scale needs min > 0");
+    }
+}
+
+// Point at fraction u in [0, 1] of the parameter's range
+double lerp(const SweepParameter& p, double u) {
+    if (p.logScale) return std::exp(std::log(p.min) + u * (std::log(p.max) - std::log(p.min)));
+    return p.min + u * (p.max - p.min);
+}
+
+std::vector<double> gridLevels(const SweepParameter& p) {
+    if (!p.values.empty()) return p.values;
+    if (p.steps < 1) {
+        throw std::runtime_error("Sweep parameter " + p.name + " needs \"values\" or \"steps\"");
+    }
+    checkRange(p);
+    std::vector<double> levels(static_cast<std::size_t>(p.steps));
+    for (int k = 0; k < p.steps; ++k) {
+        levels[k] = p.steps == 1 ? p.min : lerp(p, static_cast<double>(k) / (p.steps - 1));
+    }
+    return levels;
+}
+
+SweepPlan expandGrid(const SweepSpec& spec) {
+    SweepPlan plan;
+    std::vector<std::vector<double>> levels;
+    std::size_t total = 1;
+    for (const auto& p : spec.parameters) {
+        levels.push_back(gridLevels(p));
+        total *= levels.back().size();
+        if (total > MAX_SWEEP_VARIANTS) {
+            throw std::runtime_error("Sweep grid has more than " + std::to_string(MAX_SWEEP_VARIANTS) +
+                                     " variants");
+        }
+    }
+
+    const std::size_t P = levels.size();
+    plan.numVariants = total;
+    plan.values.resize(total * P);
+    std::vector<std::size_t> digit(P, 0);
+    for (std::size_t v = 0; v < total; ++v) {
+        for (std::size_t p = 0; p < P; ++p) plan.values[v * P + p] = levels[p][digit[p]];
+        // Odometer, last parameter fastest
+        for (std::size_t p = P; p-- > 0;) {
+            if (++digit[p] < levels[p].size()) break;
+            digit[p] = 0;
+        }
+    }
+    return plan;
+}
+
+SweepPlan expandLatinHypercube(const SweepSpec& spec) {
+    if (spec.samples < 1) throw std::runtime_error("Latin hypercube sweep needs \"samples\" >= 1");
+    const std::size_t N = static_cast<std::size_t>(spec.samples);
+    const std::size_t P = spec.parameters.size();
+    for (const auto& p : spec.parameters) {
+        if (p.values.empty()) checkRange(p);
+    }
+
+    // Own Fisher-Yates and uniform draws so a seed gives the same samples
+    // with every standard library
+    std::mt19937_64 rng(spec.seed);
+    auto uniform = [&rng] { return (rng() >> 11) * (1.0 / 9007199254740992.0); };
+
+    SweepPlan plan;
+    plan.numVariants = N;
+    plan.values.resize(N * P);
+    std::vector<std::size_t> strata(N);
+    for (std::size_t p = 0; p < P; ++p) {
+        const SweepParameter& param = spec.parameters[p];
+        std::iota(strata.begin(), strata.end(), 0);
+        for (std::size_t i = N; i > 1; --i) {
+            std::swap(strata[i - 1], strata[static_cast<std::size_t>(uniform() * i)]);
+        }
+        for (std::size_t v = 0; v < N; ++v) {
+            const double u = (strata[v] + uniform()) / N;
+            double value;
+            if (!param.values.empty()) {
+                const std::size_t k = std::min(param.values.size() - 1,
+                                               static_cast<std::size_t>(u * param.values.size()));
+                value = param.values[k];
+            } else {
+                value = lerp(param, u);
+            }
+            plan.values[v * P + p] = value;
+        }
+    }
+    return plan;
+}
+
+} // namespace
+
+SweepPlan expandSweep(const SweepSpec& spec) {
+    if (spec.parameters.empty()) throw std::runtime_error("Sweep has no parameters");
+    SweepPlan plan = spec.method == SweepMethod::Grid ? expandGrid(spec) : expandLatinHypercube(spec);
+    for (const auto& p : spec.parameters) plan.names.push_back(p.name);
+    return plan;
+}
+
+} // namespace contam
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace contam {
+
+enum class SweepMethod {
+    Grid,            // every combination of the parameter levels
+    LatinHypercube   // `samples` points, one per stratum of every parameter
+};
+
+// One swept model input. `name` uses the BatchParameter syntax, e.g.
+// "orifice_c:3", "fan_speed:7" or "source_rate:0". Levels are either listed
+// in `values` or spread over [min, max]: `steps` evenly spaced levels for a
+// grid, a continuous range for Latin hypercube sampling (which picks from
+// `values` by stratum when they are listed).
+struct SweepParameter {
+    std::string name;
+    std::vector<double> values;
+    double min = 0.0;
+    double max = 0.0;
+    int steps = 0;
+    bool logScale = false;   // space levels / samples evenly in log(value)
+};
+
+// The model's "sweep" section:
+//   "sweep": { "method": "grid" | "lhs", "samples": n, "seed": s,
+//              "parameters": [ { "name": "orifice_c:3", "values": [...] },
+//                              { "name": "fan_speed:7", "min": 0.8, "max": 1.2, "steps": 3 } ] }
+struct SweepSpec {
+    SweepMethod method = SweepMethod::Grid;
+    std::vector<SweepParameter> parameters;
+    int samples = 0;         // Latin hypercube sample count
+    uint64_t seed = 1;
+
+    bool empty() const { return parameters.empty(); }
+};
+
+// SweepMethod <-> "grid" | "lhs"; parse throws std::runtime_error
+SweepMethod parseSweepMethod(const std::string& name);
+const char* sweepMethodName(SweepMethod method);
+
+// Expanded parameter sets, row-major [variant][parameter]
+struct SweepPlan {
+    std::vector<std::string> names;
+    std::vector<double> values;
+    std::size_t numVariants = 0;
+
+    const double* row(std::size_t variant) const { return values.data() + variant * names.size(); }
+};
+
+// Expand a sweep. Grids vary the first parameter slowest. Latin hypercube
+// samples are reproducible for a given seed. Throws std::runtime_error for
+// parameters without levels, bad ranges and grids over MAX_SWEEP_VARIANTS.
+static constexpr std::size_t MAX_SWEEP_VARIANTS = 1000000;
+SweepPlan expandSweep(const SweepSpec& spec);
+
+} // namespace contam
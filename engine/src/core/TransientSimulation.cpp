@@ -1,53 +1,194 @@
 #include "TransientSimulation.h"
 #include "elements/Damper.h"
 #include "elements/Fan.h"
+#include "utils/Constants.h"
+#include "utils/ThreadPool.h"
+#include <algorithm>
 #include <cmath>
+#include <stdexcept>
 
 namespace contam {
 
+namespace {
+
+// Heap bytes of a stored step
+std::uint64_t stepBytes(const TimeStepResult& step) {
+    std::uint64_t bytes = vectorBytes(step.airflow.pressures) + vectorBytes(step.airflow.massFlows) +
+                          vectorBytes(step.contaminant.concentrations);
+    for (const auto& conc : step.contaminant.concentrations) bytes += vectorBytes(conc);
+    return bytes;
+}
+
+} // namespace
+
+void TransientSimulation::setSources(const std::vector<Source>& sources) {
+    sources_ = sources;
+    if (isRunning() && state_.hasContaminants) state_.contSolver.setSources(sources_);
+}
+
+void TransientSimulation::setSchedules(const std::map<int, Schedule>& schedules) {
+    schedules_ = schedules;
+    if (!isRunning()) return;
+    for (const auto& [id, sched] : externalSchedules_) {
+        schedules_[id] = sched;
+    }
+    if (state_.hasContaminants) state_.contSolver.setSchedules(schedules_);
+}
+
 TransientResult TransientSimulation::run(Network& network) {
-    TransientResult result;
-    result.completed = false;
+    keepLastStep_ = false;
+    try {
+        beginRun(network);
+        while (!state_.cancelled && state_.t < config_.endTime - 1e-10) {
+            stepOnce();
+        }
+    } catch (...) {
+        abandonRun();
+        throw;
+    }
+    return finish();
+}
+
+void TransientSimulation::start(Network& network) {
+    keepLastStep_ = true;
+    beginRun(network);
+}
+
+bool TransientSimulation::advance() {
+    if (!isRunning()) throw std::runtime_error("TransientSimulation::advance called before start");
+    while (!state_.cancelled && state_.t < config_.endTime - 1e-10) {
+        if (stepOnce()) return true;
+    }
+    return false;
+}
+
+TransientResult TransientSimulation::finish() {
+    if (!isRunning()) throw std::runtime_error("TransientSimulation::finish called before start");
+    TransientResult result = std::move(state_.result);
+    result.completed = !state_.cancelled && state_.t >= config_.endTime - 1e-10;
+    finishSinks(result.completed);
+    state_ = RunState{};
+    return result;
+}
+
+void TransientSimulation::beginRun(Network& network) {
+    // A run abandoned part-way (incremental use) ends here; one stopped by
+    // an exception leaves its state behind
+    if (isRunning()) finishSinks(false);
+    state_ = RunState{};
+    lastStep_.reset();
+    std::optional<ProfileScope> setup;
+    setup.emplace(profiler_, ProfilePhase::Setup);
 
     // Merge external schedules (CVF/DVF) into main schedule map
     for (const auto& [id, sched] : externalSchedules_) {
         schedules_[id] = sched;
     }
 
+    // Prepare WPC pressure table once; per-step interpolation then reuses the
+    // buffer. Ragged text records cannot be packed and keep the per-record
+    // interpolation.
+    wpcTable_ = {};
+    wpcRagged_ = false;
+    if (wpcBinary_) {
+        wpcTable_ = wpcBinary_->view();
+    } else if (WpcBinary::isRectangular(wpcPressures_)) {
+        wpcPacked_ = WpcBinary::pack(wpcPressures_);
+        wpcTable_ = wpcPacked_.view();
+    } else {
+        wpcRagged_ = true;
+    }
+    wpcBuffer_.assign(wpcTable_.stride, 0.0);
+    wpcCursor_.reset();
+
+    // Resolve the output selection first so bad ids fail before any solving
+    output_ = outputSpec_.isDefault() ? OutputSelection{}
+                                      : OutputSelection(outputSpec_, network, species_);
+
+    RunState& st = state_;
+    st.result.completed = false;
+    st.result.output = output_;
+    st.storeHistory = storeHistory_;
+
+    // Hold the run to its memory budget before anything is solved
+    if (memory_ || memoryBudget_ > 0) {
+        MemoryEstimate estimate = estimateMemory(network);
+        if (memoryBudget_ > 0 && estimate.total() > memoryBudget_ && storeHistory_ && !sinks_.empty()) {
+            // The sinks already see every step
+            st.storeHistory = false;
+            st.result.historyDropped = true;
+            estimate[MemoryComponent::History] = 0;
+        }
+        checkMemoryBudget(estimate, memoryBudget_);
+        if (memory_) {
+            memory_->setPrediction(estimate);
+            memory_->set(MemoryComponent::Network, network.memoryBytes());
+            memory_->set(MemoryComponent::Elements, network.elementMemoryBytes());
+        }
+    }
+
     // Initialize airflow solver
-    Solver airflowSolver(config_.airflowMethod);
+    st.airflowSolver = airflowPrototype_ ? *airflowPrototype_ : Solver();
+    st.airflowSolver.setMethod(config_.airflowMethod);
+    st.airflowSolver.setMaxParallel(config_.threads);
+    st.airflowSolver.setProfiler(profiler_);
+    st.airflowSolver.setDiagnostics(diagnostics_);
+    st.airflowSolver.setMemoryTracker(memory_);
 
     // Initialize contaminant solver
-    ContaminantSolver contSolver;
-    bool hasContaminants = !species_.empty();
-
-    if (hasContaminants) {
-        contSolver.setSpecies(species_);
-        contSolver.setSources(sources_);
-        contSolver.setSchedules(schedules_);
-        contSolver.initialize(network);
+    st.hasContaminants = !species_.empty();
+    if (st.hasContaminants) {
+        st.contSolver.setSpecies(species_);
+        st.contSolver.setSources(sources_);
+        st.contSolver.setSchedules(schedules_);
+        st.contSolver.setMaxParallel(config_.threads);
+        st.contSolver.setProfiler(profiler_);
+        st.contSolver.setMemoryTracker(memory_);
+        st.contSolver.initialize(network);
     }
 
-    double t = config_.startTime;
-    double dt = config_.timeStep;
-    double nextOutput = config_.startTime;
+    st.t = config_.startTime;
+    st.nextOutput = config_.startTime;
 
     // Initial airflow solve
-    auto airResult = airflowSolver.solve(network);
+    setup.reset();
+    if (diagnostics_) diagnostics_->setTime(st.t);
+    st.airResult = st.airflowSolver.solve(network);
+    st.network = &network;
+
+    {
+        ProfileScope output(profiler_, ProfilePhase::Output);
+        for (auto& sink : sinks_) sink->begin(network, species_, output_);
+        st.sinksBegun = true;
+        if (st.result.historyDropped) {
+            for (auto& sink : sinks_) sink->onHistoryDropped();
+        }
+        trackSinkMemory();
+    }
 
     // Record initial state
-    if (hasContaminants) {
-        ContaminantResult contResult = {t, contSolver.getConcentrations()};
-        result.history.push_back({t, airResult, contResult});
+    if (st.hasContaminants) {
+        ContaminantResult contResult = {st.t, st.contSolver.getConcentrations()};
+        recordStep({st.t, st.airResult, contResult});
     } else {
-        result.history.push_back({t, airResult, {t, {}}});
+        recordStep({st.t, st.airResult, {st.t, {}}});
     }
-    nextOutput += config_.outputInterval;
+    st.nextOutput += config_.outputInterval;
+}
+
+bool TransientSimulation::stepOnce() {
+    RunState& st = state_;
+    Network& network = *st.network;
+    ContaminantSolver& contSolver = st.contSolver;
+    double& t = st.t;
+    bool recorded = false;
 
-    // Main time-stepping loop
-    while (t < config_.endTime - 1e-10) {
-        // Adjust last step to hit endTime exactly
-        double currentDt = std::min(dt, config_.endTime - t);
+    // Adjust last step to hit endTime exactly
+    double currentDt = std::min(config_.timeStep, config_.endTime - t);
+
+    if (profiler_) profiler_->count(ProfileCounter::TimeSteps);
+    {
+        ProfileScope boundary(profiler_, ProfilePhase::Boundary);
 
         // Step 0: Update zone temperatures from schedules
         if (!zoneTempSchedules_.empty()) {
@@ -60,27 +201,35 @@ TransientResult TransientSimulation::run(Network& network) {
         }
 
         // Step 0c: Update WPC per-opening wind pressures
-        if (!wpcPressures_.empty()) {
+        if (!wpcTable_.empty() || wpcRagged_) {
             updateWpcConditions(network, t + currentDt);
         }
+    }
 
-        // Step 1: Update control system (read sensors -> run controllers -> apply actuators)
+    // Step 1: Update control system (read sensors -> run controllers -> apply actuators)
+    if (!controllers_.empty() || !actuatorOverrides_.empty()) {
+        ProfileScope controls(profiler_, ProfilePhase::Controls);
         if (!controllers_.empty()) {
             updateSensors(network, contSolver);
             updateControllers(currentDt);
-            applyActuators(network);
         }
+        applyActuators(network);
+    }
 
-        // Step 2: Solve airflow (quasi-steady at each timestep)
-        airResult = airflowSolver.solve(network);
+    // Step 2: Solve airflow (quasi-steady at each timestep)
+    if (diagnostics_) diagnostics_->setTime(t + currentDt);
+    st.airResult = st.airflowSolver.solve(network);
 
-        if (!airResult.converged) {
-            // Airflow didn't converge - continue with current solution
-        }
+    if (!st.airResult.converged) {
+        // Airflow didn't converge - continue with current solution
+    }
+
+    // Step 3: Solve contaminant transport
+    ContaminantResult contResult = {t + currentDt, {}};
+    if (st.hasContaminants) {
+        if (!ahSystems_.empty() || !occupants_.empty()) {
+            ProfileScope boundary(profiler_, ProfilePhase::Boundary);
 
-        // Step 3: Solve contaminant transport
-        ContaminantResult contResult = {t + currentDt, {}};
-        if (hasContaminants) {
             // Step 2b: Apply AHS flows to contaminant solver
             if (!ahSystems_.empty()) {
                 applyAHSFlows(network, contSolver, t + currentDt);
@@ -94,69 +243,157 @@ TransientResult TransientSimulation::run(Network& network) {
                     contSolver.addExtraSources(occSources);
                 }
             }
+        }
 
-            contResult = contSolver.step(network, t, currentDt);
+        contResult = contSolver.step(network, t, currentDt);
 
-            // Step 3b: Non-trace density feedback coupling
-            // If non-trace species exist, iterate density-airflow until convergence
-            if (hasNonTraceSpecies()) {
-                constexpr int MAX_COUPLING_ITER = 5;
-                constexpr double DENSITY_TOL = 1e-4; // relative tolerance
+        // Step 3b: Non-trace density feedback coupling
+        // If non-trace species exist, iterate density-airflow until convergence
+        if (hasNonTraceSpecies()) {
+            constexpr int MAX_COUPLING_ITER = 5;
+            constexpr double DENSITY_TOL = 1e-4; // relative tolerance
 
-                for (int iter = 0; iter < MAX_COUPLING_ITER; ++iter) {
-                    // Save current densities
-                    std::vector<double> prevDensities(network.getNodeCount());
-                    for (int i = 0; i < network.getNodeCount(); ++i) {
-                        prevDensities[i] = network.getNode(i).getDensity();
-                    }
+            for (int iter = 0; iter < MAX_COUPLING_ITER; ++iter) {
+                // Save current densities
+                std::vector<double> prevDensities(network.getNodeCount());
+                for (int i = 0; i < network.getNodeCount(); ++i) {
+                    prevDensities[i] = network.getNode(i).getDensity();
+                }
 
-                    // Update densities from concentrations
-                    updateDensitiesFromConcentrations(network, contSolver);
-
-                    // Check convergence
-                    double maxRelChange = 0.0;
-                    for (int i = 0; i < network.getNodeCount(); ++i) {
-                        if (network.getNode(i).isKnownPressure()) continue;
-                        double rhoOld = prevDensities[i];
-                        double rhoNew = network.getNode(i).getDensity();
-                        if (rhoOld > 0.0) {
-                            double relChange = std::abs(rhoNew - rhoOld) / rhoOld;
-                            maxRelChange = std::max(maxRelChange, relChange);
-                        }
+                // Update densities from concentrations
+                updateDensitiesFromConcentrations(network, contSolver);
+
+                // Check convergence
+                double maxRelChange = 0.0;
+                for (int i = 0; i < network.getNodeCount(); ++i) {
+                    if (network.getNode(i).isKnownPressure()) continue;
+                    double rhoOld = prevDensities[i];
+                    double rhoNew = network.getNode(i).getDensity();
+                    if (rhoOld > 0.0) {
+                        double relChange = std::abs(rhoNew - rhoOld) / rhoOld;
+                        maxRelChange = std::max(maxRelChange, relChange);
                     }
+                }
 
-                    // Re-solve airflow with updated densities
-                    auto airResult2 = airflowSolver.solve(network);
-                    if (airResult2.converged) airResult = airResult2;
+                // Re-solve airflow with updated densities
+                auto airResult2 = st.airflowSolver.solve(network);
+                if (airResult2.converged) st.airResult = airResult2;
 
-                    if (maxRelChange < DENSITY_TOL) break;
-                }
+                if (maxRelChange < DENSITY_TOL) break;
             }
         }
+    }
+
+    t += currentDt;
 
-        t += currentDt;
+    // Step 3c: Update occupant exposure
+    if (!occupants_.empty() && st.hasContaminants) {
+        ProfileScope boundary(profiler_, ProfilePhase::Boundary);
+        updateOccupantExposure(contSolver, t, currentDt);
+    }
+
+    // Step 4: Record at output intervals
+    if (t >= st.nextOutput - 1e-10 || t >= config_.endTime - 1e-10) {
+        recorded = recordStep({t, st.airResult, std::move(contResult)});
+        st.nextOutput += config_.outputInterval;
+    }
 
-        // Step 3c: Update occupant exposure
-        if (!occupants_.empty() && hasContaminants) {
-            updateOccupantExposure(contSolver, t, currentDt);
+    // Progress callback
+    if (progressCb_) {
+        if (!progressCb_(t, config_.endTime)) {
+            st.cancelled = true; // User cancelled
         }
+    }
+    return recorded;
+}
+
+bool TransientSimulation::recordStep(TimeStepResult&& step) {
+    ProfileScope output(profiler_, ProfilePhase::Output);
+    if (!output_.isDefault() && !output_.apply(step)) return false;
+    TransientResult& result = state_.result;
+    if (memory_ && state_.storeHistory) state_.historyBytes += stepBytes(step);
+    if (keepLastStep_) {
+        auto last = std::make_shared<TimeStepResult>(std::move(step));
+        for (auto& sink : sinks_) sink->onStep(*last);
+        if (state_.storeHistory) result.history.push_back(*last);
+        lastStep_ = std::move(last);
+    } else {
+        for (auto& sink : sinks_) sink->onStep(step);
+        if (state_.storeHistory) result.history.push_back(std::move(step));
+    }
+    trackSinkMemory();
+    return true;
+}
+
+void TransientSimulation::trackSinkMemory() {
+    if (!memory_) return;
+    MemoryEstimate held;
+    held[MemoryComponent::History] = vectorBytes(state_.result.history) + state_.historyBytes;
+    for (const auto& sink : sinks_) held[sink->memoryComponent()] += sink->memoryBytes();
+    for (auto c : {MemoryComponent::History, MemoryComponent::ReportAccumulators, MemoryComponent::IoBuffers}) {
+        memory_->set(c, held[c]);
+    }
+}
 
-        // Step 4: Record at output intervals
-        if (t >= nextOutput - 1e-10 || t >= config_.endTime - 1e-10) {
-            result.history.push_back({t, airResult, contResult});
-            nextOutput += config_.outputInterval;
+MemoryEstimate TransientSimulation::estimateMemory(const Network& network) const {
+    MemoryEstimate estimate = Solver::estimateMemory(network);
+
+    // Species are solved side by side on the shared pool for large enough models
+    const auto numSpecies = static_cast<unsigned>(species_.size());
+    if (numSpecies > 0) {
+        unsigned inFlight = 1;
+        if (numSpecies > 1 && network.getNodeCount() >= PARALLEL_SPECIES_MIN_ZONES && config_.threads != 1) {
+            const unsigned pool = ThreadPool::shared().concurrency();
+            inFlight = std::min(numSpecies, config_.threads == 0 ? pool : std::min(config_.threads, pool));
         }
+        estimate[MemoryComponent::TransportMatrices] =
+            inFlight * ContaminantSolver::systemBytes(network.getUnknownCount());
+    }
 
-        // Progress callback
-        if (progressCb_) {
-            if (!progressCb_(t, config_.endTime)) {
-                return result; // User cancelled
-            }
+    // Recorded values per step under the output spec
+    const OutputSelection selection =
+        outputSpec_.isDefault() ? OutputSelection{} : OutputSelection(outputSpec_, network, species_);
+    const OutputSpec& spec = selection.spec();
+    const std::uint64_t nodes = selection.nodeCount(network);
+    const std::uint64_t pressures = spec.pressureInterval < 0.0 ? 0 : nodes;
+    const std::uint64_t flows = spec.massFlowInterval < 0.0 ? 0 : selection.linkCount(network);
+    const std::uint64_t species = selection.speciesCount(species_);
+    const std::uint64_t concNodes = spec.concentrationInterval < 0.0 || species == 0 ? 0 : nodes;
+    const std::uint64_t rowBytes = (pressures + flows + concNodes * species) * sizeof(double);
+
+    if (storeHistory_) {
+        const double first = std::max(config_.startTime, spec.windowStart);
+        const double last = std::min(config_.endTime, spec.windowEnd);
+        std::uint64_t steps = 0;
+        if (last >= first) {
+            steps = config_.outputInterval > 0.0
+                        ? static_cast<std::uint64_t>(std::floor((last - first) / config_.outputInterval + 1e-9)) + 1
+                        : 1;
         }
+        const std::uint64_t perStep = sizeof(TimeStepResult) + rowBytes + concNodes * sizeof(std::vector<double>);
+        estimate[MemoryComponent::History] = steps * perStep;
+    }
+    // Sinks hold what they expect to, at least a step row
+    for (const auto& sink : sinks_) {
+        estimate[sink->memoryComponent()] += std::max<std::uint64_t>(sink->expectedMemoryBytes(), rowBytes);
     }
+    return estimate;
+}
 
-    result.completed = true;
-    return result;
+void TransientSimulation::finishSinks(bool completed) {
+    if (!state_.sinksBegun) return;
+    state_.sinksBegun = false;
+    ProfileScope output(profiler_, ProfilePhase::Output);
+    for (auto& sink : sinks_) sink->end(completed);
+}
+
+void TransientSimulation::abandonRun() noexcept {
+    try {
+        finishSinks(false);
+    } catch (...) {
+        // The run's own error is the one to report
+    }
+    state_ = RunState{};
 }
 
 void TransientSimulation::updateSensors(const Network& network, const ContaminantSolver& contSolver) {
@@ -204,10 +441,17 @@ void TransientSimulation::applyActuators(Network& network) {
     for (auto& act : actuators_) {
         // Find the controller output for this actuator
         double ctrlOutput = 0.0;
-        for (const auto& ctrl : controllers_) {
-            if (ctrl.actuatorId == act.id) {
-                ctrlOutput = ctrl.output;
-                break;
+        auto held = actuatorOverrides_.find(act.id);
+        if (held != actuatorOverrides_.end()) {
+            ctrlOutput = held->second;
+        } else if (controllers_.empty()) {
+            continue;   // only overridden actuators move without a control system
+        } else {
+            for (const auto& ctrl : controllers_) {
+                if (ctrl.actuatorId == act.id) {
+                    ctrlOutput = ctrl.output;
+                    break;
+                }
             }
         }
         act.currentValue = ctrlOutput;
@@ -468,7 +712,12 @@ void TransientSimulation::updateZoneTemperatures(Network& network, double t) {
 
 void TransientSimulation::updateWpcConditions(Network& network, double t) {
     // Apply per-opening wind pressure from WPC data
-    auto pressures = WpcReader::interpolatePressure(wpcPressures_, t);
+    if (wpcRagged_) {
+        wpcBuffer_ = WpcReader::interpolatePressure(wpcPressures_, t);
+    } else {
+        wpcCursor_.interpolate(wpcTable_, t, wpcBuffer_.data());
+    }
+    const auto& pressures = wpcBuffer_;
 
     for (size_t i = 0; i < wpcLinkIndices_.size() && i < pressures.size(); ++i) {
         int linkIdx = wpcLinkIndices_[i];
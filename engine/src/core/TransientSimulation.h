@@ -1,6 +1,7 @@
 #pragma once
 #include "Network.h"
 #include "Solver.h"
+#include "ConvergenceDiagnostics.h"
 #include "ContaminantSolver.h"
 #include "Species.h"
 #include "Schedule.h"
@@ -9,11 +10,15 @@
 #include "control/Actuator.h"
 #include "Occupant.h"
 #include "SimpleAHS.h"
+#include "ResultSink.h"
 #include "io/WeatherReader.h"
-#include "io/WpcReader.h"
+#include "io/WpcBinary.h"
+#include <cstdint>
 #include <vector>
 #include <map>
 #include <functional>
+#include <memory>
+#include <optional>
 
 namespace contam {
 
@@ -23,6 +28,9 @@ struct TransientConfig {
     double timeStep = 60.0;      // s
     double outputInterval = 60.0; // s (how often to record results)
     SolverMethod airflowMethod = SolverMethod::TrustRegion;
+    // Threads of the shared pool one run may use for its link and species
+    // loops: 0 = all of them, 1 = serial
+    unsigned threads = 0;
 };
 
 struct TimeStepResult {
@@ -34,6 +42,8 @@ struct TimeStepResult {
 struct TransientResult {
     bool completed;
     std::vector<TimeStepResult> history;
+    OutputSelection output;  // how history steps were reduced (default: not at all)
+    bool historyDropped = false;  // history was not kept to stay within the memory budget
 };
 
 // Main transient simulation loop:
@@ -48,14 +58,20 @@ public:
 
     void setConfig(const TransientConfig& config) { config_ = config; }
     void setSpecies(const std::vector<Species>& species) { species_ = species; }
-    void setSources(const std::vector<Source>& sources) { sources_ = sources; }
-    void setSchedules(const std::map<int, Schedule>& schedules) { schedules_ = schedules; }
+    // Sources and schedules may also be replaced between advance() calls
+    void setSources(const std::vector<Source>& sources);
+    void setSchedules(const std::map<int, Schedule>& schedules);
 
     // Control system
     void setSensors(const std::vector<Sensor>& sensors) { sensors_ = sensors; }
     void setControllers(const std::vector<Controller>& controllers) { controllers_ = controllers; }
     void setActuators(const std::vector<Actuator>& actuators) { actuators_ = actuators; }
 
+    // Hold an actuator at `value` instead of its controller output, from the
+    // next step on (e.g. a controller written outside the engine)
+    void setActuatorOverride(int actuatorId, double value) { actuatorOverrides_[actuatorId] = value; }
+    void clearActuatorOverrides() { actuatorOverrides_.clear(); }
+
     // Zone temperature schedules: maps node index -> schedule ID
     void setZoneTemperatureSchedules(const std::map<int, int>& zoneToSchedule) {
         zoneTempSchedules_ = zoneToSchedule;
@@ -81,14 +97,76 @@ public:
     void setWpcLinkIndices(const std::vector<int>& indices) { wpcLinkIndices_ = indices; }
     // WPC: per-opening ambient concentrations from CFD
     void setWpcConcentrations(const std::vector<WpcConcentration>& wpc) { wpcConcentrations_ = wpc; }
+    // WPC: memory-mapped binary pressure table (takes precedence over
+    // setWpcPressures); WpcBinaryReader::open rejects files of another kind
+    void setWpcBinaryPressures(std::shared_ptr<const WpcBinaryReader> reader) {
+        wpcBinary_ = std::move(reader);
+    }
 
     // Optional progress callback: (currentTime, endTime) -> bool (return false to cancel)
     using ProgressCallback = std::function<bool(double, double)>;
     void setProgressCallback(ProgressCallback cb) { progressCb_ = cb; }
 
-    // Run the full transient simulation
+    // Result sinks receive every recorded step during run(). With history
+    // storage disabled, TransientResult::history stays empty and the sinks are
+    // the only consumers of the results.
+    void addResultSink(std::shared_ptr<ResultSink> sink) { sinks_.push_back(std::move(sink)); }
+    void clearResultSinks() { sinks_.clear(); }
+    void setStoreHistory(bool store) { storeHistory_ = store; }
+
+    // Restrict what is recorded (history and sinks); resolved at run start
+    void setOutputSpec(const OutputSpec& spec) { outputSpec_ = spec; }
+
+    // Start runs from a copy of `solver` instead of a fresh one, e.g. one that
+    // already holds the network's equation ordering. Its method is replaced by
+    // TransientConfig::airflowMethod.
+    void setAirflowSolver(const Solver& solver) { airflowPrototype_ = solver; }
+
+    // Time the run's phases into `profiler` (null: not profiled); it is
+    // handed to the airflow and transport solvers at run start
+    void setProfiler(Profiler* profiler) { profiler_ = profiler; }
+    // Collect airflow convergence diagnostics over the run (null: none);
+    // solves are stamped with the time they solve for
+    void setDiagnostics(ConvergenceDiagnostics* diagnostics) { diagnostics_ = diagnostics; }
+
+    // Track the run's memory per component into `memory` (null: not
+    // tracked); the prediction of estimateMemory() is recorded with it
+    void setMemoryTracker(MemoryTracker* memory) { memory_ = memory; }
+    // Cap on the predicted memory of a run in bytes (0 = none). A run over
+    // the budget that stores history while result sinks stream its steps
+    // drops the history (TransientResult::historyDropped); one still over
+    // it throws std::runtime_error from start() before anything is solved.
+    void setMemoryBudget(std::uint64_t bytes) { memoryBudget_ = bytes; }
+
+    // Predicted peak memory of running `network` with the current species,
+    // config, output spec, history setting and sinks: the network and
+    // elements as they are, one airflow solve's workspace, the dense
+    // transport systems solved at once, every recorded history step and
+    // per sink what it expects to hold, at least a step row. Throws std::runtime_error for output spec ids that
+    // are not in the model.
+    MemoryEstimate estimateMemory(const Network& network) const;
+
+    // Run the full transient simulation. If it throws, the sinks are ended
+    // with completed = false before the exception propagates.
     TransientResult run(Network& network);
 
+    // Incremental execution, one output step at a time:
+    //   start(net); while (advance()) { inspect lastStep(), change inputs } finish();
+    // start() resolves the output selection, solves the initial state and
+    // records it. advance() integrates up to and including the next recorded
+    // step and returns false once the end time is reached (or the progress
+    // callback cancels). finish() ends the sinks and returns the result;
+    // completed is false when stopped early. `network` must outlive the run.
+    void start(Network& network);
+    bool advance();
+    TransientResult finish();
+    bool isRunning() const { return state_.network != nullptr; }
+    double currentTime() const { return state_.t; }
+
+    // Most recent step recorded by start()/advance(); each step is a separate
+    // object, so earlier ones stay valid while the run continues
+    std::shared_ptr<const TimeStepResult> lastStep() const { return lastStep_; }
+
 private:
     TransientConfig config_;
     std::vector<Species> species_;
@@ -105,7 +183,55 @@ private:
     std::vector<WpcRecord> wpcPressures_;
     std::vector<int> wpcLinkIndices_;
     std::vector<WpcConcentration> wpcConcentrations_;
+    std::shared_ptr<const WpcBinaryReader> wpcBinary_;
+    WpcPackedTable wpcPacked_;      // packed from wpcPressures_ at run start
+    WpcTableView wpcTable_;         // active table (packed or mapped)
+    bool wpcRagged_ = false;        // text records of unequal length, interpolated per record
+    WpcCursor wpcCursor_;
+    std::vector<double> wpcBuffer_; // per-step interpolated pressures
     ProgressCallback progressCb_;
+    std::vector<std::shared_ptr<ResultSink>> sinks_;
+    bool storeHistory_ = true;
+    OutputSpec outputSpec_;
+    OutputSelection output_;
+    std::map<int, double> actuatorOverrides_;  // actuator id -> held value
+    std::optional<Solver> airflowPrototype_;
+    Profiler* profiler_ = nullptr;
+    ConvergenceDiagnostics* diagnostics_ = nullptr;
+    MemoryTracker* memory_ = nullptr;
+    std::uint64_t memoryBudget_ = 0;
+
+    // State of the run between start() and finish()
+    struct RunState {
+        Network* network = nullptr;
+        Solver airflowSolver{SolverMethod::TrustRegion};
+        ContaminantSolver contSolver;
+        bool hasContaminants = false;
+        SolverResult airResult;
+        TransientResult result;
+        double t = 0.0;
+        double nextOutput = 0.0;
+        bool cancelled = false;
+        bool sinksBegun = false;
+        bool storeHistory = true;        // storeHistory_ unless the budget dropped it
+        std::uint64_t historyBytes = 0;  // tracked bytes of the stored steps
+    };
+    RunState state_;
+    bool keepLastStep_ = false;   // incremental runs hand out lastStep()
+    std::shared_ptr<const TimeStepResult> lastStep_;
+
+    void beginRun(Network& network);
+    // Integrate one time step; true when it produced a recorded step
+    bool stepOnce();
+
+    // Forward a recorded step to the sinks and (optionally) the history;
+    // false when the output selection skips it
+    bool recordStep(TimeStepResult&& step);
+    void finishSinks(bool completed);
+    // End the sinks of a run stopped by an exception and clear its state
+    void abandonRun() noexcept;
+    // Poll the sinks' buffers into the memory tracker
+    void trackSinkMemory();
 
     // Control system helpers
     void updateSensors(const Network& network, const ContaminantSolver& contSolver);
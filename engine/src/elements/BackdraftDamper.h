@@ -19,6 +19,7 @@ public:
     FlowResult calculate(double deltaP, double density) const override;
     std::string typeName() const override { return "BackdraftDamper"; }
     std::unique_ptr<FlowElement> clone() const override;
+    std::size_t memoryBytes() const override { return sizeof(*this); }
 
     double getForwardC() const { return Cf_; }
     double getForwardN() const { return nf_; }
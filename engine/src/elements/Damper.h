@@ -21,6 +21,7 @@ public:
     FlowResult calculate(double deltaP, double density) const override;
     std::string typeName() const override { return "Damper"; }
     std::unique_ptr<FlowElement> clone() const override;
+    std::size_t memoryBytes() const override { return sizeof(*this); }
 
     double getCmax() const { return Cmax_; }
     double getFlowExponent() const { return n_; }
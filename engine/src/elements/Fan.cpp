@@ -95,4 +95,8 @@ std::unique_ptr<FlowElement> Fan::clone() const {
     return std::make_unique<Fan>(*this);
 }
 
+std::size_t Fan::memoryBytes() const {
+    return sizeof(*this) + coeffs_.capacity() * sizeof(double);
+}
+
 } // namespace contam
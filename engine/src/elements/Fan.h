@@ -24,6 +24,7 @@ public:
     FlowResult calculate(double deltaP, double density) const override;
     std::string typeName() const override { return "Fan"; }
     std::unique_ptr<FlowElement> clone() const override;
+    std::size_t memoryBytes() const override;
 
     double getMaxFlow() const { return maxFlow_; }
     double getShutoffPressure() const { return shutoffPressure_; }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <memory>
 
@@ -24,6 +25,9 @@ public:
 
     // Clone for polymorphic copy
     virtual std::unique_ptr<FlowElement> clone() const = 0;
+
+    // Bytes the element occupies, including the tables it owns
+    virtual std::size_t memoryBytes() const { return sizeof(FlowElement); }
 };
 
 } // namespace contam
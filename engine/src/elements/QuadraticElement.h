@@ -22,6 +22,7 @@ public:
     FlowResult calculate(double deltaP, double density) const override;
     std::string typeName() const override { return "QuadraticElement"; }
     std::unique_ptr<FlowElement> clone() const override;
+    std::size_t memoryBytes() const override { return sizeof(*this); }
 
     double getLinearCoeff() const { return a_; }
     double getQuadraticCoeff() const { return b_; }
@@ -16,6 +16,7 @@ public:
     FlowResult calculate(double deltaP, double density) const override;
     std::string typeName() const override { return "ReturnGrille"; }
     std::unique_ptr<FlowElement> clone() const override;
+    std::size_t memoryBytes() const override { return sizeof(*this); }
 
     double getFlowCoefficient() const { return C_; }
     double getFlowExponent() const { return n_; }
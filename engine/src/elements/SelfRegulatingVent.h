@@ -25,6 +25,7 @@ public:
     FlowResult calculate(double deltaP, double density) const override;
     std::string typeName() const override { return "SelfRegulatingVent"; }
     std::unique_ptr<FlowElement> clone() const override;
+    std::size_t memoryBytes() const override { return sizeof(*this); }
 
     double getTargetFlow() const { return targetFlow_; }
     double getPMin() const { return pMin_; }
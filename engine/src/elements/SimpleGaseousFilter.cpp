@@ -128,4 +128,10 @@ std::unique_ptr<FlowElement> SimpleGaseousFilter::clone() const {
     return std::make_unique<SimpleGaseousFilter>(*this);
 }
 
+std::size_t SimpleGaseousFilter::memoryBytes() const {
+    return sizeof(*this) + table_.capacity() * sizeof(table_[0]) +
+           (splineA_.capacity() + splineB_.capacity() + splineC_.capacity() + splineD_.capacity()) *
+               sizeof(double);
+}
+
 } // namespace contam
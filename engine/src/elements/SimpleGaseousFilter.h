@@ -28,6 +28,7 @@ public:
     FlowResult calculate(double deltaP, double density) const override;
     std::string typeName() const override { return "SimpleGaseousFilter"; }
     std::unique_ptr<FlowElement> clone() const override;
+    std::size_t memoryBytes() const override;
 
     // Get efficiency for a given species at current loading
     double getEfficiency(int speciesIdx, double currentLoading) const;
@@ -110,4 +110,10 @@ std::unique_ptr<FlowElement> SimpleParticleFilter::clone() const {
     return std::make_unique<SimpleParticleFilter>(*this);
 }
 
+std::size_t SimpleParticleFilter::memoryBytes() const {
+    return sizeof(*this) + table_.capacity() * sizeof(table_[0]) +
+           (splineA_.capacity() + splineB_.capacity() + splineC_.capacity() + splineD_.capacity()) *
+               sizeof(double);
+}
+
 } // namespace contam
@@ -26,6 +26,7 @@ public:
     FlowResult calculate(double deltaP, double density) const override;
     std::string typeName() const override { return "SimpleParticleFilter"; }
     std::unique_ptr<FlowElement> clone() const override;
+    std::size_t memoryBytes() const override;
 
     // Get efficiency for a given particle diameter (μm)
     // Uses monotone cubic interpolation (Fritsch-Carlson)
@@ -33,6 +33,7 @@ public:
     FlowResult calculate(double deltaP, double density) const override;
     std::string typeName() const override { return "TwoWayFlow"; }
     std::unique_ptr<FlowElement> clone() const override;
+    std::size_t memoryBytes() const override { return sizeof(*this); }
 
     // Full bidirectional calculation with both zone densities
     // Returns net mass flow (positive = i→j) and derivative
@@ -85,4 +85,8 @@ std::unique_ptr<FlowElement> UVGIFilter::clone() const {
     return std::make_unique<UVGIFilter>(*this);
 }
 
+std::size_t UVGIFilter::memoryBytes() const {
+    return sizeof(*this) + (params_.tempCoeffs.capacity() + params_.flowCoeffs.capacity()) * sizeof(double);
+}
+
 } // namespace contam
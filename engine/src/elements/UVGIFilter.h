@@ -42,6 +42,7 @@ public:
     FlowResult calculate(double deltaP, double density) const override;
     std::string typeName() const override { return "UVGIFilter"; }
     std::unique_ptr<FlowElement> clone() const override;
+    std::size_t memoryBytes() const override;
 
     // Get survival fraction for given conditions
     // flowRate in m³/s, temperature in K, lampAge in hours
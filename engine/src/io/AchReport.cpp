@@ -2,6 +2,46 @@
 
 namespace contam {
 
+void AchReport::computeInflows(
+    const Network& net,
+    const std::vector<double>& massFlows,
+    double airDensity,
+    AchInflows& inflows)
+{
+    const std::size_t numNodes = static_cast<std::size_t>(net.getNodeCount());
+    inflows.total.assign(numNodes, 0.0);
+    inflows.interZone.assign(numNodes, 0.0);
+    inflows.infiltration.assign(numNodes, 0.0);
+
+    for (int j = 0; j < net.getLinkCount(); ++j) {
+        const auto& link = net.getLink(j);
+        double mf = (j < static_cast<int>(massFlows.size())) ? massFlows[j] : link.getMassFlow();
+
+        // Positive flow runs nodeFrom -> nodeTo
+        int into, from;
+        if (mf > 0.0) {
+            into = link.getNodeTo();
+            from = link.getNodeFrom();
+        } else if (mf < 0.0) {
+            into = link.getNodeFrom();
+            from = link.getNodeTo();
+        } else {
+            continue;
+        }
+
+        double volFlow = std::abs(mf) / airDensity; // m^3/s
+        inflows.total[into] += volFlow;
+
+        // Classify: if connected to ambient, it's infiltration
+        // Otherwise it's inter-zone (counted as mechanical for simplicity)
+        if (net.getNode(from).isKnownPressure()) {
+            inflows.infiltration[into] += volFlow;
+        } else {
+            inflows.interZone[into] += volFlow;
+        }
+    }
+}
+
 std::vector<AchResult> AchReport::compute(
     const Network& net,
     const std::vector<double>& massFlows,
@@ -9,6 +49,9 @@ std::vector<AchResult> AchReport::compute(
 {
     std::vector<AchResult> results;
 
+    AchInflows inflows;
+    computeInflows(net, massFlows, airDensity, inflows);
+
     for (int i = 0; i < net.getNodeCount(); ++i) {
         const auto& node = net.getNode(i);
         if (node.isKnownPressure()) continue; // Skip ambient nodes
@@ -21,44 +64,10 @@ std::vector<AchResult> AchReport::compute(
         r.zoneName = node.getName();
         r.volume = volume;
 
-        // Sum inflows to this zone from all links
-        double totalInflow = 0.0;      // m^3/s
-        double mechInflow = 0.0;
-        double infiltInflow = 0.0;
-
-        for (int j = 0; j < net.getLinkCount(); ++j) {
-            const auto& link = net.getLink(j);
-            double mf = (j < static_cast<int>(massFlows.size())) ? massFlows[j] : link.getMassFlow();
-            double volFlow = std::abs(mf) / airDensity; // m^3/s
-
-            bool flowIntoZone = false;
-            bool fromAmbient = false;
-
-            if (mf > 0.0 && link.getNodeTo() == i) {
-                flowIntoZone = true;
-                fromAmbient = net.getNode(link.getNodeFrom()).isKnownPressure();
-            } else if (mf < 0.0 && link.getNodeFrom() == i) {
-                flowIntoZone = true;
-                fromAmbient = net.getNode(link.getNodeTo()).isKnownPressure();
-            }
-
-            if (flowIntoZone) {
-                totalInflow += volFlow;
-
-                // Classify: if connected to ambient, it's infiltration
-                // Otherwise it's inter-zone (counted as mechanical for simplicity)
-                if (fromAmbient) {
-                    infiltInflow += volFlow;
-                } else {
-                    mechInflow += volFlow;
-                }
-            }
-        }
-
         // ACH = volumetric_flow_rate * 3600 / volume
-        r.totalAch = totalInflow * 3600.0 / volume;
-        r.mechanicalAch = mechInflow * 3600.0 / volume;
-        r.infiltrationAch = infiltInflow * 3600.0 / volume;
+        r.totalAch = inflows.total[i] * 3600.0 / volume;
+        r.mechanicalAch = inflows.interZone[i] * 3600.0 / volume;
+        r.infiltrationAch = inflows.infiltration[i] * 3600.0 / volume;
         r.naturalVentAch = 0.0; // Would need element type classification for full breakdown
 
         results.push_back(r);
@@ -18,8 +18,24 @@ struct AchResult {
     double naturalVentAch;   // from windows/doors
 };
 
+// Volumetric inflow (m^3/s) into each node, indexed by node index. Flow
+// from ambient nodes counts as infiltration, everything else as inter-zone.
+struct AchInflows {
+    std::vector<double> total;
+    std::vector<double> interZone;
+    std::vector<double> infiltration;
+};
+
 class AchReport {
 public:
+    // One pass over the links; `inflows` is resized and overwritten, so it
+    // can be reused across steps
+    static void computeInflows(
+        const Network& net,
+        const std::vector<double>& massFlows,
+        double airDensity,
+        AchInflows& inflows);
+
     static std::vector<AchResult> compute(
         const Network& net,
         const std::vector<double>& massFlows,
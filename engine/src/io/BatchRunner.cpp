@@ -0,0 +1,388 @@
+#include "io/BatchRunner.h"
+#include "core/BatchSolve.h"
+#include "io/JsonReader.h"
+#include "io/JsonStreamWriter.h"
+#include "io/JsonWriter.h"
+#include "io/ModelCache.h"
+#include "utils/ThreadPool.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace contam {
+
+using json = nlohmann::json;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const char* RESULTS_SUFFIX = ".results.json";
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool isModelFile(const fs::path& p) {
+    const std::string name = p.filename().string();
+    return p.extension() == ".json" && !endsWith(name, RESULTS_SUFFIX);
+}
+
+// '*' and '?' wildcard match of a whole file name
+bool wildcardMatch(const char* pattern, const char* name) {
+    const char* star = nullptr;
+    const char* resume = nullptr;
+    while (*name) {
+        if (*pattern == '?' || *pattern == *name) {
+            ++pattern;
+            ++name;
+        } else if (*pattern == '*') {
+            star = pattern++;
+            resume = name;
+        } else if (star) {
+            pattern = star + 1;
+            name = ++resume;
+        } else {
+            return false;
+        }
+    }
+    while (*pattern == '*') ++pattern;
+    return *pattern == '\0';
+}
+
+std::vector<fs::path> listDirectory(const fs::path& dir, const std::string& pattern) {
+    std::vector<fs::path> files;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        if (!entry.is_regular_file(ec)) continue;
+        const fs::path& p = entry.path();
+        if (!isModelFile(p)) continue;
+        if (!pattern.empty() && !wildcardMatch(pattern.c_str(), p.filename().string().c_str())) continue;
+        files.push_back(p);
+    }
+    if (ec) throw std::runtime_error("Cannot list directory: " + dir.string());
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+std::string defaultOutput(const fs::path& input, const std::string& outputDir) {
+    fs::path name = input.stem();
+    name += RESULTS_SUFFIX;
+    return ((outputDir.empty() ? input.parent_path() : fs::path(outputDir)) / name).string();
+}
+
+std::vector<BatchJob> readJobsFile(const fs::path& path, const std::string& outputDir) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot open jobs file: " + path.string());
+    const fs::path base = path.parent_path();
+    auto resolve = [&](const std::string& p) {
+        fs::path q(p);
+        return (q.is_absolute() ? q : base / q).lexically_normal();
+    };
+
+    std::vector<BatchJob> jobs;
+    std::string line;
+    for (int lineNo = 1; std::getline(in, line); ++lineNo) {
+        std::istringstream fields(line);
+        std::string input, output, extra;
+        if (!(fields >> input) || input[0] == '#') continue;
+        fields >> output;
+        if (fields >> extra) {
+            throw std::runtime_error(path.string() + ":" + std::to_string(lineNo) +
+                                     ": expected <input> [<output>]");
+        }
+        const fs::path inputPath = resolve(input);
+        jobs.push_back({inputPath.string(), output.empty() ? defaultOutput(inputPath, outputDir)
+                                                           : resolve(output).string()});
+    }
+    return jobs;
+}
+
+// Admission control for BatchOptions::memoryBudget
+class MemoryBudget {
+public:
+    explicit MemoryBudget(std::uint64_t budget) : budget_(budget) {}
+
+    // Blocks until `bytes` fit; a job larger than the budget waits until it
+    // can run alone
+    void acquire(std::uint64_t bytes) {
+        if (budget_ == 0) return;
+        std::unique_lock<std::mutex> lock(mutex_);
+        freed_.wait(lock, [&] { return inUse_ == 0 || inUse_ + bytes <= budget_; });
+        inUse_ += bytes;
+    }
+
+    // Trade a held reservation of `held` bytes for one of `bytes`. A job
+    // that needs more gives its share back while it waits, so jobs growing
+    // their reservations at once cannot block each other.
+    void resize(std::uint64_t held, std::uint64_t bytes) {
+        if (budget_ == 0 || bytes == held) return;
+        std::unique_lock<std::mutex> lock(mutex_);
+        inUse_ -= held;
+        if (bytes < held) {
+            inUse_ += bytes;
+            lock.unlock();
+            freed_.notify_all();
+            return;
+        }
+        freed_.notify_all();
+        freed_.wait(lock, [&] { return inUse_ == 0 || inUse_ + bytes <= budget_; });
+        inUse_ += bytes;
+    }
+
+    void release(std::uint64_t bytes) {
+        if (budget_ == 0) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            inUse_ -= bytes;
+        }
+        freed_.notify_all();
+    }
+
+private:
+    std::uint64_t budget_;
+    std::uint64_t inUse_ = 0;
+    std::mutex mutex_;
+    std::condition_variable freed_;
+};
+
+void ensureParentDirectory(const std::string& path) {
+    const fs::path parent = fs::path(path).parent_path();
+    if (parent.empty()) return;
+    std::error_code ec;
+    fs::create_directories(parent, ec);
+}
+
+// Run one job holding r.reservedBytes of `budget`. Once the model is parsed
+// the reservation becomes the model's own memory estimate.
+void runJob(const BatchJob& job, const BatchOptions& options, MemoryBudget& budget,
+            BatchJobResult& r) {
+    const auto start = Clock::now();
+    ModelInput model = options.useCache ? ModelCache::loadModel(job.input, options.cacheDir)
+                                        : JsonReader::readModelFromFile(job.input);
+    r.loadSeconds = secondsSince(start);
+    ensureParentDirectory(job.output);
+
+    if (model.hasTransient || !model.species.empty()) {
+        r.transient = true;
+        if (!model.hasTransient) {
+            model.transientConfig.endTime = 3600.0;
+            model.transientConfig.timeStep = 60.0;
+            model.transientConfig.outputInterval = 60.0;
+        }
+        model.transientConfig.airflowMethod = options.method;
+
+        TransientSimulation sim;
+        configureSimulation(sim, model);
+        auto writer = std::make_shared<JsonStreamWriter>(job.output);
+        sim.addResultSink(writer);
+        sim.setStoreHistory(false);
+        const std::uint64_t needed = sim.estimateMemory(model.network).total();
+        budget.resize(r.reservedBytes, needed);
+        r.reservedBytes = needed;
+        const bool completed = sim.run(model.network).completed;
+        r.outputSteps = writer->stepCount();
+        r.status = completed ? BatchJobStatus::Ok : BatchJobStatus::NotConverged;
+        if (!completed) r.message = "run stopped before endTime";
+    } else {
+        // One solver per worker: consecutive jobs with the same topology
+        // reuse its equation ordering
+        thread_local Solver solver;
+        solver.setMethod(options.method);
+        const std::uint64_t needed = Solver::estimateMemory(model.network).total();
+        budget.resize(r.reservedBytes, needed);
+        r.reservedBytes = needed;
+        SolverResult result = solver.solve(model.network);
+        JsonWriter::writeToFile(job.output, model.network, result);
+        r.iterations = result.iterations;
+        r.status = result.converged ? BatchJobStatus::Ok : BatchJobStatus::NotConverged;
+        if (!result.converged) r.message = "airflow did not converge";
+    }
+}
+
+} // namespace
+
+std::vector<BatchJob> collectBatchJobs(const std::string& spec, const std::string& outputDir) {
+    const fs::path path(spec);
+    const std::string name = path.filename().string();
+    std::vector<BatchJob> jobs;
+
+    std::error_code ec;
+    if (name.find_first_of("*?") != std::string::npos) {
+        const fs::path dir = path.parent_path().empty() ? fs::path(".") : path.parent_path();
+        for (const auto& p : listDirectory(dir, name)) jobs.push_back({p.string(), defaultOutput(p, outputDir)});
+    } else if (fs::is_directory(path, ec)) {
+        for (const auto& p : listDirectory(path, "")) jobs.push_back({p.string(), defaultOutput(p, outputDir)});
+    } else {
+        jobs = readJobsFile(path, outputDir);
+    }
+
+    std::map<std::string, std::string> outputs;
+    for (const auto& job : jobs) {
+        const std::string key = fs::path(job.output).lexically_normal().string();
+        auto [it, inserted] = outputs.emplace(key, job.input);
+        if (!inserted) {
+            throw std::runtime_error("Batch jobs " + it->second + " and " + job.input +
+                                     " both write " + job.output);
+        }
+    }
+    return jobs;
+}
+
+const char* toString(BatchJobStatus status) {
+    switch (status) {
+    case BatchJobStatus::Ok: return "ok";
+    case BatchJobStatus::NotConverged: return "not-converged";
+    case BatchJobStatus::Failed: return "failed";
+    }
+    return "failed";
+}
+
+std::uint64_t estimateJobBytes(const std::string& path) {
+    // A parsed model takes roughly ten times its JSON text
+    constexpr std::uint64_t EXPANSION = 10;
+    constexpr std::uint64_t BASE = 4ull << 20;
+    std::error_code ec;
+    const auto size = fs::file_size(path, ec);
+    return BASE + (ec ? 0 : static_cast<std::uint64_t>(size) * EXPANSION);
+}
+
+std::size_t BatchReport::count(BatchJobStatus status) const {
+    return static_cast<std::size_t>(std::count_if(
+        jobs.begin(), jobs.end(), [&](const BatchJobResult& r) { return r.status == status; }));
+}
+
+double BatchReport::busySeconds() const {
+    double total = 0.0;
+    for (const auto& r : jobs) total += r.seconds;
+    return total;
+}
+
+BatchReport runBatch(const std::vector<BatchJob>& jobs, const BatchOptions& options) {
+    const auto start = Clock::now();
+    BatchReport report;
+    report.jobs.resize(jobs.size());
+    ThreadPool& pool = ThreadPool::shared();
+    unsigned threads = options.threads ? std::min(options.threads, pool.concurrency()) : pool.concurrency();
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, std::max<std::size_t>(jobs.size(), 1)));
+    report.threads = threads;
+
+    // Largest inputs first
+    std::vector<std::uint64_t> estimates(jobs.size());
+    for (std::size_t i = 0; i < jobs.size(); ++i) estimates[i] = estimateJobBytes(jobs[i].input);
+    std::vector<std::size_t> order(jobs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::size_t a, std::size_t b) { return estimates[a] > estimates[b]; });
+
+    MemoryBudget budget(options.memoryBudget);
+    std::mutex doneMutex;
+    std::size_t done = 0;
+
+    auto work = [&](std::size_t k) {
+        const std::size_t i = order[k];
+        BatchJobResult& r = report.jobs[i];
+        r.job = jobs[i];
+        r.reservedBytes = estimates[i];
+        budget.acquire(r.reservedBytes);
+        const auto jobStart = Clock::now();
+        try {
+            runJob(jobs[i], options, budget, r);
+        } catch (const std::exception& e) {
+            r.status = BatchJobStatus::Failed;
+            r.message = e.what();
+        }
+        r.seconds = secondsSince(jobStart);
+        budget.release(r.reservedBytes);
+
+        std::lock_guard<std::mutex> lock(doneMutex);
+        ++done;
+        if (options.onJobDone) options.onJobDone(r, done, jobs.size());
+    };
+
+    if (threads <= 1) {
+        for (std::size_t k = 0; k < jobs.size(); ++k) work(k);
+    } else {
+        pool.parallelFor(jobs.size(), work, threads);
+    }
+
+    report.wallSeconds = secondsSince(start);
+    return report;
+}
+
+void printBatchSummary(const BatchReport& report, std::ostream& out) {
+    std::size_t width = 5;
+    for (const auto& r : report.jobs) width = std::max(width, r.job.input.size());
+
+    const auto flags = out.flags();
+    out << std::left << std::setw(static_cast<int>(width)) << "Input" << "  "
+        << std::setw(13) << "Status" << std::right << std::setw(10) << "Seconds"
+        << std::setw(8) << "Iter" << std::setw(8) << "Steps" << "\n";
+    out << std::fixed << std::setprecision(3);
+    for (const auto& r : report.jobs) {
+        const bool ran = r.status != BatchJobStatus::Failed;
+        out << std::left << std::setw(static_cast<int>(width)) << r.job.input << "  "
+            << std::setw(13) << toString(r.status) << std::right << std::setw(10) << r.seconds
+            << std::setw(8) << (ran && !r.transient ? std::to_string(r.iterations) : std::string("-"))
+            << std::setw(8) << (ran && r.transient ? std::to_string(r.outputSteps) : std::string("-"));
+        if (!r.message.empty()) out << "  " << r.message;
+        out << "\n";
+    }
+    const double speedup = report.wallSeconds > 0.0 ? report.busySeconds() / report.wallSeconds : 0.0;
+    out << report.jobs.size() << " jobs: " << report.count(BatchJobStatus::Ok) << " ok, "
+        << report.count(BatchJobStatus::NotConverged) << " not converged, "
+        << report.count(BatchJobStatus::Failed) << " failed; " << report.wallSeconds << " s wall on "
+        << report.threads << " threads (" << std::setprecision(1) << speedup << "x)\n";
+    out.flags(flags);
+}
+
+std::string batchSummaryJson(const BatchReport& report) {
+    json jobs = json::array();
+    for (const auto& r : report.jobs) {
+        json j = {{"input", r.job.input},
+                  {"output", r.job.output},
+                  {"status", toString(r.status)},
+                  {"transient", r.transient},
+                  {"seconds", r.seconds},
+                  {"loadSeconds", r.loadSeconds},
+                  {"reservedBytes", r.reservedBytes}};
+        if (r.status != BatchJobStatus::Failed) {
+            if (r.transient) j["outputSteps"] = r.outputSteps;
+            else j["iterations"] = r.iterations;
+        }
+        if (!r.message.empty()) j["message"] = r.message;
+        jobs.push_back(std::move(j));
+    }
+    json summary = {{"jobs", std::move(jobs)},
+                    {"threads", report.threads},
+                    {"wallSeconds", report.wallSeconds},
+                    {"busySeconds", report.busySeconds()},
+                    {"ok", report.count(BatchJobStatus::Ok)},
+                    {"notConverged", report.count(BatchJobStatus::NotConverged)},
+                    {"failed", report.count(BatchJobStatus::Failed)}};
+    return summary.dump(2);
+}
+
+void writeBatchSummary(const BatchReport& report, const std::string& filepath) {
+    std::ofstream out(filepath);
+    if (!out) throw std::runtime_error("Cannot open output file: " + filepath);
+    out << batchSummaryJson(report) << "\n";
+}
+
+} // namespace contam
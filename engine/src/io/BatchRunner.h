@@ -0,0 +1,89 @@
+#pragma once
+#include "core/Solver.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace contam {
+
+// One model file of a batch and where its results go
+struct BatchJob {
+    std::string input;
+    std::string output;
+};
+
+// Jobs named by `spec`, which is one of
+//   - a directory: every *.json file in it
+//   - a glob such as "models/case*.json" (wildcards in the file name only)
+//   - a jobs file: one "<input> [<output>]" per line; blank lines and lines
+//     starting with '#' are skipped, relative paths are relative to the file
+// Results files (*.results.json) are never picked up as inputs. Jobs without
+// an explicit output write <stem>.results.json into `outputDir`, or next to
+// their input when it is empty. Throws std::runtime_error for unreadable
+// specs, malformed lines and two jobs writing the same output.
+std::vector<BatchJob> collectBatchJobs(const std::string& spec, const std::string& outputDir = "");
+
+enum class BatchJobStatus {
+    Ok,
+    NotConverged,   // steady solve did not converge or transient run stopped early
+    Failed          // the model could not be loaded, run or written
+};
+
+const char* toString(BatchJobStatus status);
+
+struct BatchJobResult {
+    BatchJob job;
+    BatchJobStatus status = BatchJobStatus::Failed;
+    std::string message;         // error text for failed jobs
+    bool transient = false;
+    double seconds = 0.0;        // wall time including load and output
+    double loadSeconds = 0.0;
+    int iterations = 0;          // airflow iterations (steady solves)
+    std::size_t outputSteps = 0; // transient output steps written
+    std::uint64_t reservedBytes = 0;  // budget held by the run (see estimateJobBytes)
+};
+
+struct BatchOptions {
+    unsigned threads = 0;          // concurrent jobs, at most the shared pool's threads; 0 = all of them
+    std::uint64_t memoryBudget = 0; // bytes of estimated model memory in flight; 0 = no cap
+    SolverMethod method = SolverMethod::TrustRegion;
+    bool useCache = true;
+    std::string cacheDir;
+
+    // Called after each job, one call at a time, from the worker that ran it
+    std::function<void(const BatchJobResult& result, std::size_t done, std::size_t total)> onJobDone;
+};
+
+struct BatchReport {
+    std::vector<BatchJobResult> jobs;   // in job order
+    unsigned threads = 0;
+    double wallSeconds = 0.0;
+
+    std::size_t count(BatchJobStatus status) const;
+    double busySeconds() const;         // sum of job times
+};
+
+// Rough memory of loading the model in `path`, from its file size. Batches
+// order jobs by it and hold this much of BatchOptions::memoryBudget while a
+// job parses its model; the run itself is then admitted with
+// Solver::estimateMemory or TransientSimulation::estimateMemory of the
+// parsed model (BatchJobResult::reservedBytes).
+std::uint64_t estimateJobBytes(const std::string& path);
+
+// Run every job on the shared thread pool. Jobs are started largest input
+// first so long jobs do not end up in the tail, and each worker keeps its own
+// steady solver (and its cached equation ordering) across jobs. A job over
+// the memory budget still runs, alone. A failing job never stops the batch.
+BatchReport runBatch(const std::vector<BatchJob>& jobs, const BatchOptions& options = {});
+
+// Human readable table of the jobs and totals
+void printBatchSummary(const BatchReport& report, std::ostream& out);
+
+// The same summary as JSON
+std::string batchSummaryJson(const BatchReport& report);
+void writeBatchSummary(const BatchReport& report, const std::string& filepath);
+
+} // namespace contam
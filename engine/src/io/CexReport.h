@@ -35,6 +35,7 @@ public:
     // Compute contaminant exfiltration from transient history.
     // For each exterior link with outward flow, mass = massFlow * concentration / density.
     // Integrates over all timesteps using trapezoidal rule.
+    // CexAccumulator produces the same report while the simulation runs.
     static std::vector<CexSpeciesResult> compute(
         const Network& net,
         const std::vector<Species>& species,
@@ -0,0 +1,351 @@
+#include "io/ColumnarResults.h"
+#include "utils/ByteStream.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace contam {
+
+// finalize() transposes the spill in tiles of TRANSPOSE_TILE_SERIES series x
+// TRANSPOSE_TILE_STEPS steps (256 KB), collected into column chunks of up
+// to TRANSPOSE_BLOCK_ROWS steps that are written with one call each
+static constexpr std::size_t TRANSPOSE_TILE_SERIES = 64;
+static constexpr std::size_t TRANSPOSE_TILE_STEPS = 1024;
+static constexpr std::size_t TRANSPOSE_BLOCK_ROWS = 16384;
+
+// ── ResultSeriesLayout ───────────────────────────────────────────────
+
+void ResultSeriesLayout::flatten(const TimeStepResult& step, std::vector<float>& row) const {
+    row.assign(size(), std::numeric_limits<float>::quiet_NaN());
+    const auto& p = step.airflow.pressures;
+    for (std::size_t i = 0; i < std::min(numNodes, p.size()); ++i) {
+        row[pressure(i)] = static_cast<float>(p[i]);
+    }
+    const auto& f = step.airflow.massFlows;
+    for (std::size_t i = 0; i < std::min(numLinks, f.size()); ++i) {
+        row[massFlow(i)] = static_cast<float>(f[i]);
+    }
+    const auto& c = step.contaminant.concentrations;
+    for (std::size_t i = 0; i < std::min(numNodes, c.size()); ++i) {
+        for (std::size_t k = 0; k < std::min(numSpecies, c[i].size()); ++k) {
+            row[concentration(i, k)] = static_cast<float>(c[i][k]);
+        }
+    }
+}
+
+// ── ColumnarResultsWriter ────────────────────────────────────────────
+
+ColumnarResultsWriter::ColumnarResultsWriter(const std::string& filepath)
+    : path_(filepath), spillPath_(filepath + ".spill") {
+    std::ofstream probe(path_, std::ios::binary);
+    if (!probe.is_open()) {
+        throw std::runtime_error("Cannot open output file: " + path_);
+    }
+}
+
+ColumnarResultsWriter::~ColumnarResultsWriter() {
+    if (spill_.is_open()) {
+        spill_.close();
+        std::remove(spillPath_.c_str());
+    }
+}
+
+void ColumnarResultsWriter::begin(const Network& network, const std::vector<Species>& species,
+                                  const OutputSelection& output) {
+    nodes_.clear();
+    links_.clear();
+    species_.clear();
+    times_.clear();
+    iterations_.clear();
+    converged_.clear();
+
+    for (std::size_t k = 0; k < output.nodeCount(network); ++k) {
+        const auto& node = network.getNode(output.node(k));
+        nodes_.push_back({node.getId(), node.getName(), node.isKnownPressure()});
+    }
+    for (std::size_t k = 0; k < output.linkCount(network); ++k) {
+        const auto& link = network.getLink(output.link(k));
+        links_.push_back({link.getId(), network.getNode(link.getNodeFrom()).getId(),
+                          network.getNode(link.getNodeTo()).getId()});
+    }
+    for (std::size_t k = 0; k < output.speciesCount(species); ++k) {
+        const auto& sp = species[output.species(k)];
+        species_.push_back({sp.id, sp.name, sp.molarMass});
+    }
+    layout_ = {nodes_.size(), links_.size(), species_.size()};
+    row_.assign(layout_.size(), 0.0f);
+
+    spill_.open(spillPath_, std::ios::binary | std::ios::trunc);
+    if (!spill_.is_open()) {
+        throw std::runtime_error("Cannot open spill file: " + spillPath_);
+    }
+}
+
+void ColumnarResultsWriter::onStep(const TimeStepResult& step) {
+    layout_.flatten(step, row_);
+    spill_.write(reinterpret_cast<const char*>(row_.data()),
+                 static_cast<std::streamsize>(row_.size() * sizeof(float)));
+    times_.push_back(step.time);
+    iterations_.push_back(step.airflow.iterations);
+    converged_.push_back(step.airflow.converged ? 1 : 0);
+}
+
+std::size_t ColumnarResultsWriter::memoryBytes() const {
+    return vectorBytes(times_) + vectorBytes(iterations_) + vectorBytes(converged_) + vectorBytes(row_);
+}
+
+void ColumnarResultsWriter::end(bool completed) {
+    spill_.close();
+    try {
+        finalize(completed);
+    } catch (...) {
+        std::remove(spillPath_.c_str());
+        throw;
+    }
+    std::remove(spillPath_.c_str());
+}
+
+void ColumnarResultsWriter::finalize(bool completed) {
+    const std::size_t n = times_.size();
+    const std::size_t S = layout_.size();
+
+    // Everything before the data section
+    ByteWriter meta;
+    meta.put(ColumnarHeader{});
+
+    ColumnarHeader hdr{};
+    hdr.magic = COLUMNAR_MAGIC;
+    hdr.version = COLUMNAR_VERSION;
+    hdr.flags = completed ? 1 : 0;
+    hdr.numSteps = n;
+    hdr.numNodes = static_cast<uint32_t>(nodes_.size());
+    hdr.numLinks = static_cast<uint32_t>(links_.size());
+    hdr.numSpecies = static_cast<uint32_t>(species_.size());
+    hdr.numSeries = static_cast<uint32_t>(S);
+
+    hdr.tablesOffset = meta.size();
+    meta.put(static_cast<uint32_t>(nodes_.size()));
+    for (const auto& node : nodes_) {
+        meta.put<int32_t>(node.id);
+        meta.put<uint8_t>(node.ambient ? 1 : 0);
+        meta.putString(node.name);
+    }
+    meta.put(static_cast<uint32_t>(links_.size()));
+    for (const auto& link : links_) {
+        meta.put<int32_t>(link.id);
+        meta.put<int32_t>(link.fromId);
+        meta.put<int32_t>(link.toId);
+    }
+    meta.put(static_cast<uint32_t>(species_.size()));
+    for (const auto& sp : species_) {
+        meta.put<int32_t>(sp.id);
+        meta.put(sp.molarMass);
+        meta.putString(sp.name);
+    }
+
+    meta.align(8);
+    hdr.stepsOffset = meta.size();
+    meta.putRaw(times_.data(), n);
+    meta.putRaw(iterations_.data(), n);
+    meta.putRaw(converged_.data(), n);
+
+    meta.align(8);
+    hdr.indexOffset = meta.size();
+    hdr.dataOffset = hdr.indexOffset + S * sizeof(ColumnarSeriesEntry);
+    hdr.dataOffset += (8 - hdr.dataOffset % 8) % 8;
+
+    const std::size_t nn = nodes_.size();
+    const std::size_t nl = links_.size();
+    const std::size_t ns = species_.size();
+    for (std::size_t s = 0; s < S; ++s) {
+        ColumnarSeriesEntry e{};
+        if (s < nn) {
+            e.variable = static_cast<uint16_t>(ColumnarVariable::Pressure);
+            e.entity = static_cast<uint32_t>(s);
+        } else if (s < nn + nl) {
+            e.variable = static_cast<uint16_t>(ColumnarVariable::MassFlow);
+            e.entity = static_cast<uint32_t>(s - nn);
+        } else {
+            e.variable = static_cast<uint16_t>(ColumnarVariable::Concentration);
+            e.entity = static_cast<uint32_t>((s - nn - nl) / ns);
+            e.species = static_cast<uint32_t>((s - nn - nl) % ns);
+        }
+        e.offset = hdr.dataOffset + static_cast<uint64_t>(s) * n * sizeof(float);
+        meta.put(e);
+    }
+    meta.align(8);
+
+    std::memcpy(&meta.buffer()[0], &hdr, sizeof(hdr));
+
+    std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Cannot open output file: " + path_);
+    }
+    out.write(meta.buffer().data(), static_cast<std::streamsize>(meta.size()));
+
+    // Transpose the row-major spill into per-series arrays. Each tile reads
+    // one contiguous run of TRANSPOSE_TILE_SERIES floats per row and is
+    // turned in cache; memory stays bounded for long runs
+    if (n > 0 && S > 0) {
+        MappedFile rows(spillPath_);
+        if (rows.size() < n * S * sizeof(float)) {
+            throw std::runtime_error("Columnar spill file is truncated: " + spillPath_);
+        }
+        const char* base = rows.data();
+        const std::size_t blockRows = std::min(n, TRANSPOSE_BLOCK_ROWS);
+        std::vector<float> tile(TRANSPOSE_TILE_STEPS * TRANSPOSE_TILE_SERIES);
+        std::vector<float> columns(TRANSPOSE_TILE_SERIES * blockRows);   // [series][step]
+
+        for (std::size_t r0 = 0; r0 < n; r0 += blockRows) {
+            const std::size_t count = std::min(blockRows, n - r0);
+            for (std::size_t s0 = 0; s0 < S; s0 += TRANSPOSE_TILE_SERIES) {
+                const std::size_t width = std::min(TRANSPOSE_TILE_SERIES, S - s0);
+                for (std::size_t k0 = 0; k0 < count; k0 += TRANSPOSE_TILE_STEPS) {
+                    const std::size_t steps = std::min(TRANSPOSE_TILE_STEPS, count - k0);
+                    for (std::size_t k = 0; k < steps; ++k) {
+                        std::memcpy(&tile[k * width], base + ((r0 + k0 + k) * S + s0) * sizeof(float),
+                                    width * sizeof(float));
+                    }
+                    for (std::size_t j = 0; j < width; ++j) {
+                        float* col = &columns[j * count + k0];
+                        for (std::size_t k = 0; k < steps; ++k) col[k] = tile[k * width + j];
+                    }
+                }
+
+                if (count == n) {
+                    // The whole run is one block: the tile's series are
+                    // adjacent in the file
+                    out.seekp(static_cast<std::streamoff>(hdr.dataOffset + s0 * n * sizeof(float)));
+                    out.write(reinterpret_cast<const char*>(columns.data()),
+                              static_cast<std::streamsize>(width * n * sizeof(float)));
+                    continue;
+                }
+                for (std::size_t j = 0; j < width; ++j) {
+                    out.seekp(static_cast<std::streamoff>(hdr.dataOffset + ((s0 + j) * n + r0) * sizeof(float)));
+                    out.write(reinterpret_cast<const char*>(&columns[j * count]),
+                              static_cast<std::streamsize>(count * sizeof(float)));
+                }
+            }
+        }
+    }
+    if (!out) {
+        throw std::runtime_error("Failed writing columnar results: " + path_);
+    }
+}
+
+void ColumnarResultsWriter::write(const std::string& filepath, const Network& network,
+                                  const std::vector<Species>& species,
+                                  const TransientResult& result) {
+    ColumnarResultsWriter writer(filepath);
+    writer.begin(network, species, result.output);
+    for (const auto& step : result.history) writer.onStep(step);
+    writer.end(result.completed);
+}
+
+// ── ColumnarResultsReader ────────────────────────────────────────────
+
+void ColumnarResultsReader::open(const std::string& filepath) {
+    file_.open(filepath);
+    const std::size_t size = file_.size();
+    if (size < sizeof(ColumnarHeader)) {
+        throw std::runtime_error("Columnar results file too small: " + filepath);
+    }
+    std::memcpy(&header_, file_.data(), sizeof(header_));
+    if (header_.magic != COLUMNAR_MAGIC) {
+        throw std::runtime_error("Not a columnar results file: " + filepath);
+    }
+    if (header_.version != COLUMNAR_VERSION) {
+        throw std::runtime_error("Unsupported columnar results version " +
+            std::to_string(header_.version) + ": " + filepath);
+    }
+
+    const uint64_t n = header_.numSteps;
+    const uint64_t stepsEnd = header_.stepsOffset + n * (sizeof(double) + sizeof(int32_t) + 1);
+    const uint64_t dataEnd = header_.dataOffset + uint64_t(header_.numSeries) * n * sizeof(float);
+    if (header_.tablesOffset > header_.stepsOffset || stepsEnd > header_.indexOffset ||
+        header_.indexOffset + uint64_t(header_.numSeries) * sizeof(ColumnarSeriesEntry) > header_.dataOffset ||
+        dataEnd > size) {
+        throw std::runtime_error("Columnar results file truncated: " + filepath);
+    }
+
+    ByteReader r(file_.data() + header_.tablesOffset,
+                 static_cast<std::size_t>(header_.stepsOffset - header_.tablesOffset),
+                 "Columnar results table");
+    nodes_.resize(r.get<uint32_t>());
+    for (auto& node : nodes_) {
+        node.id = r.get<int32_t>();
+        node.ambient = r.get<uint8_t>() != 0;
+        node.name = r.getString();
+    }
+    links_.resize(r.get<uint32_t>());
+    for (auto& link : links_) {
+        link.id = r.get<int32_t>();
+        link.fromId = r.get<int32_t>();
+        link.toId = r.get<int32_t>();
+    }
+    species_.resize(r.get<uint32_t>());
+    for (auto& sp : species_) {
+        sp.id = r.get<int32_t>();
+        sp.molarMass = r.get<double>();
+        sp.name = r.getString();
+    }
+
+    const char* steps = file_.data() + header_.stepsOffset;
+    times_ = reinterpret_cast<const double*>(steps);
+    iterations_ = reinterpret_cast<const int32_t*>(steps + n * sizeof(double));
+    converged_ = reinterpret_cast<const uint8_t*>(steps + n * (sizeof(double) + sizeof(int32_t)));
+    index_ = reinterpret_cast<const ColumnarSeriesEntry*>(file_.data() + header_.indexOffset);
+}
+
+int ColumnarResultsReader::nodeIndex(int id) const {
+    for (std::size_t i = 0; i < nodes_.size(); ++i) {
+        if (nodes_[i].id == id) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+int ColumnarResultsReader::linkIndex(int id) const {
+    for (std::size_t i = 0; i < links_.size(); ++i) {
+        if (links_[i].id == id) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+int ColumnarResultsReader::speciesIndex(int id) const {
+    for (std::size_t i = 0; i < species_.size(); ++i) {
+        if (species_[i].id == id) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+ColumnarSeries ColumnarResultsReader::series(std::size_t s) const {
+    if (s >= header_.numSeries) {
+        throw std::out_of_range("Columnar series index out of range");
+    }
+    const uint64_t offset = index_[s].offset;
+    if (offset + header_.numSteps * sizeof(float) > file_.size()) {
+        throw std::runtime_error("Columnar series outside file: " + file_.path());
+    }
+    return {reinterpret_cast<const float*>(file_.data() + offset), numSteps()};
+}
+
+ColumnarSeries ColumnarResultsReader::pressure(std::size_t node) const {
+    if (node >= header_.numNodes) throw std::out_of_range("Columnar node index out of range");
+    return series(node);
+}
+
+ColumnarSeries ColumnarResultsReader::massFlow(std::size_t link) const {
+    if (link >= header_.numLinks) throw std::out_of_range("Columnar link index out of range");
+    return series(header_.numNodes + link);
+}
+
+ColumnarSeries ColumnarResultsReader::concentration(std::size_t node, std::size_t species) const {
+    if (node >= header_.numNodes || species >= header_.numSpecies) {
+        throw std::out_of_range("Columnar concentration index out of range");
+    }
+    return series(header_.numNodes + header_.numLinks + node * header_.numSpecies + species);
+}
+
+} // namespace contam
@@ -0,0 +1,191 @@
+#pragma once
+#include "core/ResultSink.h"
+#include "core/TransientSimulation.h"
+#include "utils/MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace contam {
+
+// ── Columnar results layout ──────────────────────────────────────────
+// [ColumnarHeader]
+// [tables]   node, link and species tables (ByteWriter encoding)
+// [steps]    times: double x numSteps, iterations: int32 x numSteps,
+//            converged: uint8 x numSteps
+// [index]    ColumnarSeriesEntry x numSeries
+// [data]     one float32 array of numSteps values per series
+//
+// A series is one variable of one entity over the whole run, stored
+// contiguously, so a zone's history is a single slice of the mapped file.
+// Series order: node pressures, link mass flows, then concentrations
+// (node-major, species-minor). Sections start on 8-byte boundaries.
+// Values are stored as float32 for charting; exact values remain in the
+// JSON/HDF5 outputs.
+
+static constexpr uint32_t COLUMNAR_MAGIC = 0x31535243;  // "CRS1"
+static constexpr uint16_t COLUMNAR_VERSION = 1;
+
+enum class ColumnarVariable : uint16_t { Pressure = 0, MassFlow = 1, Concentration = 2 };
+
+#pragma pack(push, 1)
+struct ColumnarHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;          // bit 0: run completed
+    uint64_t numSteps;
+    uint32_t numNodes;
+    uint32_t numLinks;
+    uint32_t numSpecies;
+    uint32_t numSeries;
+    uint64_t tablesOffset;
+    uint64_t stepsOffset;
+    uint64_t indexOffset;
+    uint64_t dataOffset;
+};
+
+struct ColumnarSeriesEntry {
+    uint16_t variable;       // ColumnarVariable
+    uint16_t reserved;
+    uint32_t entity;         // node or link index
+    uint32_t species;        // species index (concentrations only)
+    uint32_t reserved2;
+    uint64_t offset;         // absolute file offset of the float32 array
+};
+#pragma pack(pop)
+
+static_assert(sizeof(ColumnarHeader) == 64, "ColumnarHeader must be 64 bytes");
+static_assert(sizeof(ColumnarSeriesEntry) == 24, "ColumnarSeriesEntry must be 24 bytes");
+
+struct ColumnarNodeInfo {
+    int id;
+    std::string name;
+    bool ambient;
+};
+
+struct ColumnarLinkInfo {
+    int id;
+    int fromId;
+    int toId;
+};
+
+struct ColumnarSpeciesInfo {
+    int id;
+    std::string name;
+    double molarMass;
+};
+
+// Flat series numbering shared by the columnar format and the result
+// pyramid: node pressures, link mass flows, then concentrations
+// (node-major, species-minor).
+struct ResultSeriesLayout {
+    std::size_t numNodes = 0;
+    std::size_t numLinks = 0;
+    std::size_t numSpecies = 0;
+
+    std::size_t size() const { return numNodes + numLinks + numNodes * numSpecies; }
+    std::size_t pressure(std::size_t node) const { return node; }
+    std::size_t massFlow(std::size_t link) const { return numNodes + link; }
+    std::size_t concentration(std::size_t node, std::size_t species) const {
+        return numNodes + numLinks + node * numSpecies + species;
+    }
+
+    // Flatten one output step into `row` (resized to size()); values the
+    // step does not carry are NaN
+    void flatten(const TimeStepResult& step, std::vector<float>& row) const;
+};
+
+// Non-owning slice of one series in a mapped results file
+struct ColumnarSeries {
+    const float* data = nullptr;
+    std::size_t size = 0;
+
+    bool empty() const { return size == 0; }
+    float operator[](std::size_t i) const { return data[i]; }
+    const float* begin() const { return data; }
+    const float* end() const { return data + size; }
+};
+
+// Result sink writing the columnar format. Steps are appended row-wise to a
+// spill file next to the output while the run progresses; end() transposes
+// them block by block into per-series arrays and removes the spill file.
+class ColumnarResultsWriter : public ResultSink {
+public:
+    explicit ColumnarResultsWriter(const std::string& filepath);
+    ~ColumnarResultsWriter() override;
+
+    void begin(const Network& network, const std::vector<Species>& species,
+               const OutputSelection& output) override;
+    void onStep(const TimeStepResult& step) override;
+    void end(bool completed) override;
+    std::size_t memoryBytes() const override;
+
+    // Write an already collected result (honours result.output)
+    static void write(const std::string& filepath, const Network& network,
+                      const std::vector<Species>& species, const TransientResult& result);
+
+private:
+    std::string path_;
+    std::string spillPath_;
+    std::ofstream spill_;
+
+    std::vector<ColumnarNodeInfo> nodes_;
+    std::vector<ColumnarLinkInfo> links_;
+    std::vector<ColumnarSpeciesInfo> species_;
+    ResultSeriesLayout layout_;
+
+    std::vector<double> times_;
+    std::vector<int32_t> iterations_;
+    std::vector<uint8_t> converged_;
+    std::vector<float> row_;
+
+    void finalize(bool completed);
+};
+
+class ColumnarResultsReader {
+public:
+    ColumnarResultsReader() = default;
+    explicit ColumnarResultsReader(const std::string& filepath) { open(filepath); }
+
+    void open(const std::string& filepath);
+
+    bool completed() const { return (header_.flags & 1u) != 0; }
+    std::size_t numSteps() const { return static_cast<std::size_t>(header_.numSteps); }
+    std::size_t numSeries() const { return header_.numSeries; }
+
+    const std::vector<ColumnarNodeInfo>& nodes() const { return nodes_; }
+    const std::vector<ColumnarLinkInfo>& links() const { return links_; }
+    const std::vector<ColumnarSpeciesInfo>& species() const { return species_; }
+
+    const double* times() const { return times_; }
+    const int32_t* iterations() const { return iterations_; }
+    const uint8_t* converged() const { return converged_; }
+
+    // Index of a node/link/species by id (-1 if absent)
+    int nodeIndex(int id) const;
+    int linkIndex(int id) const;
+    int speciesIndex(int id) const;
+
+    const ColumnarSeriesEntry& seriesEntry(std::size_t s) const { return index_[s]; }
+    ColumnarSeries series(std::size_t s) const;
+
+    // Series by variable and entity index; throws std::out_of_range if absent
+    ColumnarSeries pressure(std::size_t node) const;
+    ColumnarSeries massFlow(std::size_t link) const;
+    ColumnarSeries concentration(std::size_t node, std::size_t species) const;
+
+private:
+    MappedFile file_;
+    ColumnarHeader header_{};
+    std::vector<ColumnarNodeInfo> nodes_;
+    std::vector<ColumnarLinkInfo> links_;
+    std::vector<ColumnarSpeciesInfo> species_;
+    const double* times_ = nullptr;
+    const int32_t* iterations_ = nullptr;
+    const uint8_t* converged_ = nullptr;
+    const ColumnarSeriesEntry* index_ = nullptr;
+};
+
+} // namespace contam
@@ -1,9 +1,9 @@
 #pragma once
 
+#include "io/TextTokenizer.h"
 #include <string>
+#include <string_view>
 #include <vector>
-#include <fstream>
-#include <sstream>
 #include <stdexcept>
 
 namespace contam {
@@ -21,20 +21,21 @@ struct ContaminantRecord {
 class ContaminantReader {
 public:
     static std::vector<ContaminantRecord> readFile(const std::string& filepath) {
-        std::ifstream file(filepath);
-        if (!file.is_open()) {
-            throw std::runtime_error("Cannot open contaminant file: " + filepath);
-        }
+        auto src = TextSource::fromFile(filepath, "contaminant file");
+        return parse(src.text());
+    }
 
+    static std::vector<ContaminantRecord> parse(std::string_view content) {
         std::vector<ContaminantRecord> records;
-        std::string line;
+        LineTokenizer tok(content);
 
-        while (std::getline(file, line)) {
-            if (line.empty() || line[0] == '!' || line[0] == '#') continue;
+        while (tok.nextLine()) {
+            char c0 = tok.firstChar();
+            if (c0 == '\0' || c0 == '!' || c0 == '#') continue;
 
             ContaminantRecord rec;
-            std::istringstream iss(line);
-            if (iss >> rec.time >> rec.speciesId >> rec.concentration) {
+            if (tok.nextDouble(rec.time) && tok.nextInt(rec.speciesId) &&
+                tok.nextDouble(rec.concentration)) {
                 records.push_back(rec);
             }
         }
@@ -1,7 +1,9 @@
 #pragma once
 #include "core/Network.h"
 #include "core/Species.h"
+#include "core/Schedule.h"
 #include "core/TransientSimulation.h"
+#include <map>
 #include <vector>
 #include <string>
 #include <sstream>
@@ -33,11 +35,15 @@ struct CsmSpeciesResult {
 
 class CsmReport {
 public:
-    // Compute from transient history
+    // Compute from transient history (CsmAccumulator produces the same
+    // report while the simulation runs, without keeping the history).
+    // Emission and removal totals need the run's sources and schedules.
     static std::vector<CsmSpeciesResult> compute(
         const Network& net,
         const std::vector<Species>& species,
-        const std::vector<TimeStepResult>& history);
+        const std::vector<TimeStepResult>& history,
+        const std::vector<Source>& sources = {},
+        const std::map<int, Schedule>& schedules = {});
 
     static std::string formatText(const std::vector<CsmSpeciesResult>& results);
     static std::string formatCsv(const std::vector<CsmSpeciesResult>& results);
@@ -1,26 +1,36 @@
 #include "CvfReader.h"
-#include <fstream>
-#include <sstream>
+#include "io/TextTokenizer.h"
 #include <stdexcept>
 
 namespace contam {
 
-static std::vector<std::pair<double, std::vector<double>>> parseLines(const std::string& content) {
-    std::vector<std::pair<double, std::vector<double>>> rows;
-    std::istringstream iss(content);
-    std::string line;
-    int lineNum = 0;
+namespace {
+
+// Parsed rows stored flat: row r has values[offsets[r] .. offsets[r+1])
+struct ParsedRows {
+    std::vector<double> times;
+    std::vector<double> values;
+    std::vector<size_t> offsets{0};
+
+    size_t size() const { return times.size(); }
+    size_t columns(size_t r) const { return offsets[r + 1] - offsets[r]; }
+    double value(size_t r, size_t c) const { return values[offsets[r] + c]; }
+};
+
+} // namespace
+
+static ParsedRows parseLines(std::string_view content) {
+    ParsedRows rows;
+    LineTokenizer tok(content);
     double prevTime = -1e30;
 
-    while (std::getline(iss, line)) {
-        ++lineNum;
+    while (tok.nextLine()) {
         // Skip comments and blank lines
-        size_t first = line.find_first_not_of(" \t\r");
-        if (first == std::string::npos || line[first] == '#') continue;
+        if (tok.isBlankOrComment("#")) continue;
 
-        std::istringstream ls(line);
+        int lineNum = tok.lineNumber();
         double t;
-        if (!(ls >> t)) {
+        if (!tok.nextDouble(t)) {
             throw std::runtime_error("CVF/DVF parse error at line " + std::to_string(lineNum) + ": invalid time");
         }
         if (t < prevTime) {
@@ -28,99 +38,93 @@ static std::vector<std::pair<double, std::vector<double>>> parseLines(const std:
         }
         prevTime = t;
 
-        std::vector<double> vals;
         double v;
-        while (ls >> v) vals.push_back(v);
-        if (vals.empty()) {
+        while (tok.nextDouble(v)) rows.values.push_back(v);
+        if (rows.values.size() == rows.offsets.back()) {
             throw std::runtime_error("CVF/DVF parse error at line " + std::to_string(lineNum) + ": no value columns");
         }
-        rows.push_back({t, vals});
+        rows.times.push_back(t);
+        rows.offsets.push_back(rows.values.size());
     }
     return rows;
 }
 
-static std::string readFile(const std::string& filepath) {
-    std::ifstream f(filepath);
-    if (!f.is_open()) throw std::runtime_error("Cannot open file: " + filepath);
-    std::ostringstream ss;
-    ss << f.rdbuf();
-    return ss.str();
+static ParsedRows parseFile(const std::string& filepath) {
+    auto src = TextSource::fromFile(filepath);
+    return parseLines(src.text());
 }
 
-// ── CvfReader ────────────────────────────────────────────────────────
+static std::vector<Schedule> buildColumns(const ParsedRows& rows, int startId,
+                                          const std::string& prefix, InterpolationMode mode) {
+    if (rows.size() == 0) return {};
+    size_t numCols = rows.columns(0);
+    std::vector<Schedule> result;
+    result.reserve(numCols);
+    for (size_t c = 0; c < numCols; ++c) {
+        Schedule s(startId + static_cast<int>(c), prefix + std::to_string(c));
+        s.setInterpolationMode(mode);
+        for (size_t r = 0; r < rows.size(); ++r) {
+            if (c < rows.columns(r)) {
+                s.addPoint(rows.times[r], rows.value(r, c));
+            }
+        }
+        result.push_back(std::move(s));
+    }
+    return result;
+}
 
-Schedule CvfReader::readFromString(const std::string& content, int scheduleId, const std::string& name) {
-    auto rows = parseLines(content);
-    Schedule s(scheduleId, name.empty() ? ("cvf_" + std::to_string(scheduleId)) : name);
-    s.setInterpolationMode(InterpolationMode::Linear);
-    for (const auto& [t, vals] : rows) {
-        s.addPoint(t, vals[0]);
+static Schedule buildSingle(const ParsedRows& rows, int scheduleId, const std::string& name,
+                            InterpolationMode mode) {
+    Schedule s(scheduleId, name);
+    s.setInterpolationMode(mode);
+    for (size_t r = 0; r < rows.size(); ++r) {
+        s.addPoint(rows.times[r], rows.value(r, 0));
     }
     return s;
 }
 
+// ── CvfReader ────────────────────────────────────────────────────────
+
+Schedule CvfReader::readFromString(const std::string& content, int scheduleId, const std::string& name) {
+    return buildSingle(parseLines(content), scheduleId,
+                       name.empty() ? ("cvf_" + std::to_string(scheduleId)) : name,
+                       InterpolationMode::Linear);
+}
+
 Schedule CvfReader::readFromFile(const std::string& filepath, int scheduleId, const std::string& name) {
-    return readFromString(readFile(filepath), scheduleId, name);
+    return buildSingle(parseFile(filepath), scheduleId,
+                       name.empty() ? ("cvf_" + std::to_string(scheduleId)) : name,
+                       InterpolationMode::Linear);
 }
 
 std::vector<Schedule> CvfReader::readMultiColumnFromString(const std::string& content, int startId) {
-    auto rows = parseLines(content);
-    if (rows.empty()) return {};
-    int numCols = static_cast<int>(rows[0].second.size());
-    std::vector<Schedule> result;
-    for (int c = 0; c < numCols; ++c) {
-        Schedule s(startId + c, "cvf_col_" + std::to_string(c));
-        s.setInterpolationMode(InterpolationMode::Linear);
-        for (const auto& [t, vals] : rows) {
-            if (c < static_cast<int>(vals.size())) {
-                s.addPoint(t, vals[c]);
-            }
-        }
-        result.push_back(std::move(s));
-    }
-    return result;
+    return buildColumns(parseLines(content), startId, "cvf_col_", InterpolationMode::Linear);
 }
 
 std::vector<Schedule> CvfReader::readMultiColumnFromFile(const std::string& filepath, int startId) {
-    return readMultiColumnFromString(readFile(filepath), startId);
+    return buildColumns(parseFile(filepath), startId, "cvf_col_", InterpolationMode::Linear);
 }
 
 // ── DvfReader ────────────────────────────────────────────────────────
 
 Schedule DvfReader::readFromString(const std::string& content, int scheduleId, const std::string& name) {
-    auto rows = parseLines(content);
-    Schedule s(scheduleId, name.empty() ? ("dvf_" + std::to_string(scheduleId)) : name);
-    s.setInterpolationMode(InterpolationMode::StepHold);
-    for (const auto& [t, vals] : rows) {
-        s.addPoint(t, vals[0]);
-    }
-    return s;
+    return buildSingle(parseLines(content), scheduleId,
+                       name.empty() ? ("dvf_" + std::to_string(scheduleId)) : name,
+                       InterpolationMode::StepHold);
 }
 
 Schedule DvfReader::readFromFile(const std::string& filepath, int scheduleId, const std::string& name) {
-    return readFromString(readFile(filepath), scheduleId, name);
+    return buildSingle(parseFile(filepath), scheduleId,
+                       name.empty() ? ("dvf_" + std::to_string(scheduleId)) : name,
+                       InterpolationMode::StepHold);
 }
 
 std::vector<Schedule> DvfReader::readMultiColumnFromString(const std::string& content, int startId) {
-    auto rows = parseLines(content);
-    if (rows.empty()) return {};
-    int numCols = static_cast<int>(rows[0].second.size());
-    std::vector<Schedule> result;
-    for (int c = 0; c < numCols; ++c) {
-        Schedule s(startId + c, "dvf_col_" + std::to_string(c));
-        s.setInterpolationMode(InterpolationMode::StepHold);
-        for (const auto& [t, vals] : rows) {
-            if (c < static_cast<int>(vals.size())) {
-                s.addPoint(t, vals[c]);
-            }
-        }
-        result.push_back(std::move(s));
-    }
-    return result;
+    return buildColumns(parseLines(content), startId, "dvf_col_", InterpolationMode::StepHold);
 }
 
 std::vector<Schedule> DvfReader::readMultiColumnFromFile(const std::string& filepath, int startId) {
-    return readMultiColumnFromString(readFile(filepath), startId);
+    return buildColumns(parseFile(filepath), startId, "dvf_col_", InterpolationMode::StepHold);
 }
 
 } // namespace contam
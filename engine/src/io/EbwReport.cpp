@@ -1,4 +1,5 @@
 #include "EbwReport.h"
+#include "io/ReportAccumulators.h"
 #include <algorithm>
 #include <cmath>
 #include <sstream>
@@ -52,64 +53,11 @@ std::vector<OccupantExposure> EbwReport::computeFromHistory(
     const std::vector<Species>& species,
     const TransientResult& result)
 {
-    std::vector<OccupantExposure> results;
-    if (occupants.empty() || species.empty() || result.history.size() < 2) return results;
-
-    int numSpecies = static_cast<int>(species.size());
-
-    for (const auto& occ : occupants) {
-        // Per-species accumulators
-        std::vector<double> dose(numSpecies, 0.0);
-        std::vector<double> peak(numSpecies, 0.0);
-        std::vector<double> peakTime(numSpecies, 0.0);
-        std::vector<double> exposureTime(numSpecies, 0.0);
-        std::vector<double> concSum(numSpecies, 0.0);
-        std::vector<int> concCount(numSpecies, 0);
-
-        for (size_t i = 1; i < result.history.size(); ++i) {
-            double t = result.history[i].time;
-            double dt = result.history[i].time - result.history[i - 1].time;
-            if (dt <= 0.0) continue;
-
-            int zoneIdx = occ.currentZoneIdx;
-            const auto& conc = result.history[i].contaminant.concentrations;
-            if (zoneIdx >= static_cast<int>(conc.size())) continue;
-
-            for (int s = 0; s < numSpecies; ++s) {
-                if (s >= static_cast<int>(conc[zoneIdx].size())) continue;
-                double c = conc[zoneIdx][s];
-
-                dose[s] += occ.breathingRate * c * dt;
-
-                if (c > peak[s]) {
-                    peak[s] = c;
-                    peakTime[s] = t;
-                }
-
-                if (c > 1e-15) {
-                    exposureTime[s] += dt;
-                }
-
-                concSum[s] += c;
-                concCount[s]++;
-            }
-        }
-
-        for (int s = 0; s < numSpecies; ++s) {
-            OccupantExposure ex;
-            ex.occupantId = occ.id;
-            ex.occupantName = occ.name;
-            ex.speciesIndex = s;
-            ex.breathingRate = occ.breathingRate;
-            ex.cumulativeDose = dose[s];
-            ex.peakConcentration = peak[s];
-            ex.timeAtPeak = peakTime[s];
-            ex.totalExposureTime = exposureTime[s];
-            ex.meanConcentration = (concCount[s] > 0) ? (concSum[s] / concCount[s]) : 0.0;
-            results.push_back(ex);
-        }
-    }
-    return results;
+    EbwAccumulator acc(occupants);
+    acc.begin(Network(), species, result.output);
+    for (const auto& step : result.history) acc.onStep(step);
+    acc.end(result.completed);
+    return acc.result();
 }
 
 std::vector<ZoneVisit> EbwReport::extractZoneHistory(
@@ -37,7 +37,8 @@ public:
         const std::vector<Species>& species);
 
     // Generate exposure summaries from transient result history
-    // (recomputes from concentration time series if occupant exposure wasn't tracked inline)
+    // (recomputes from concentration time series if occupant exposure wasn't tracked inline;
+    // EbwAccumulator does the same while the simulation runs)
     static std::vector<OccupantExposure> computeFromHistory(
         const std::vector<Occupant>& occupants,
         const std::vector<Species>& species,
@@ -0,0 +1,379 @@
+#include "io/EngineServer.h"
+#include "core/BatchSolve.h"
+#include "io/JsonStreamWriter.h"
+#include "io/JsonWriter.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+#if !defined(_WIN32) && !defined(MSG_NOSIGNAL)
+#define MSG_NOSIGNAL 0   // macOS: SO_NOSIGPIPE is set on the socket instead
+#endif
+
+using json = nlohmann::json;
+
+namespace contam {
+
+namespace {
+
+// JSON-RPC 2.0 error codes
+constexpr int PARSE_ERROR = -32700;
+constexpr int INVALID_REQUEST = -32600;
+constexpr int METHOD_NOT_FOUND = -32601;
+constexpr int INVALID_PARAMS = -32602;
+constexpr int ENGINE_ERROR = -32000;
+
+struct RpcError : std::runtime_error {
+    int code;
+    RpcError(int code, const std::string& message) : std::runtime_error(message), code(code) {}
+};
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+std::string errorResponse(const std::string& id, int code, const std::string& message) {
+    json err = {{"code", code}, {"message", message}};
+    return "{\"jsonrpc\":\"2.0\",\"id\":" + id + ",\"error\":" + err.dump() + "}";
+}
+
+SolverMethod parseMethod(const json& params, SolverMethod fallback) {
+    if (!params.contains("method")) return fallback;
+    const std::string m = params["method"].get<std::string>();
+    if (m == "tr") return SolverMethod::TrustRegion;
+    if (m == "sur") return SolverMethod::SubRelaxation;
+    throw RpcError(INVALID_PARAMS, "Unknown solver method: " + m);
+}
+
+int nodeIndexById(const Network& network, int id) {
+    try {
+        return network.getNodeIndexById(id);
+    } catch (const std::runtime_error&) {
+        throw RpcError(INVALID_PARAMS, "Unknown node id: " + std::to_string(id));
+    }
+}
+
+int linkIndexById(const Network& network, int id) {
+    for (int j = 0; j < network.getLinkCount(); ++j) {
+        if (network.getLink(j).getId() == id) return j;
+    }
+    throw RpcError(INVALID_PARAMS, "Unknown link id: " + std::to_string(id));
+}
+
+// Transient settings the CLI uses: models without a "transient" section
+// (species only) run one hour at 60 s steps
+TransientConfig transientConfigOf(const ModelInput& model) {
+    TransientConfig config = model.transientConfig;
+    if (!model.hasTransient) {
+        config.endTime = 3600.0;
+        config.timeStep = 60.0;
+        config.outputInterval = 60.0;
+    }
+    return config;
+}
+
+} // namespace
+
+// ── Protocol ─────────────────────────────────────────────────────────
+
+std::string EngineServer::handle(const std::string& line) {
+    json request;
+    try {
+        request = json::parse(line);
+    } catch (const json::exception& e) {
+        return errorResponse("null", PARSE_ERROR, e.what());
+    }
+    if (!request.is_object() || !request.contains("method") || !request["method"].is_string()) {
+        return errorResponse("null", INVALID_REQUEST, "Expected a JSON-RPC request object");
+    }
+
+    const bool notification = !request.contains("id");
+    const std::string id = notification ? "null" : request["id"].dump();
+    json params = request.value("params", json::object());
+    if (!params.is_object()) {
+        return notification ? std::string()
+                            : errorResponse(id, INVALID_PARAMS, "params must be an object");
+    }
+
+    std::string result;
+    try {
+        result = dispatch(request["method"].get<std::string>(), params);
+    } catch (const RpcError& e) {
+        return notification ? std::string() : errorResponse(id, e.code, e.what());
+    } catch (const json::exception& e) {
+        return notification ? std::string() : errorResponse(id, INVALID_PARAMS, e.what());
+    } catch (const std::exception& e) {
+        return notification ? std::string() : errorResponse(id, ENGINE_ERROR, e.what());
+    }
+    if (notification) return {};
+    // Results are spliced in as text; large outputs are never re-parsed
+    return "{\"jsonrpc\":\"2.0\",\"id\":" + id + ",\"result\":" + result + "}";
+}
+
+void EngineServer::serve(std::istream& in, std::ostream& out) {
+    std::string line;
+    while (!shutdown_ && std::getline(in, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        std::string response = handle(line);
+        if (!response.empty()) out << response << '\n' << std::flush;
+    }
+}
+
+#ifndef _WIN32
+void EngineServer::serveUnixSocket(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error("Socket path too long: " + path);
+    }
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+    ::unlink(path.c_str());
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listener, 1) < 0) {
+        std::string reason = std::strerror(errno);
+        ::close(listener);
+        throw std::runtime_error("Cannot listen on " + path + ": " + reason);
+    }
+
+    auto sendAll = [](int fd, const std::string& data) {
+        std::size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                if (n < 0 && errno == EINTR) continue;
+                return false;
+            }
+            sent += static_cast<std::size_t>(n);
+        }
+        return true;
+    };
+
+    while (!shutdown_) {
+        int client = ::accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+#ifdef SO_NOSIGPIPE
+        int one = 1;
+        ::setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+        std::string buffer;
+        char chunk[65536];
+        bool open = true;
+        while (open && !shutdown_) {
+            ssize_t n = ::recv(client, chunk, sizeof(chunk), 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            buffer.append(chunk, static_cast<std::size_t>(n));
+
+            std::size_t start = 0, newline;
+            while (open && !shutdown_ && (newline = buffer.find('\n', start)) != std::string::npos) {
+                std::string line = buffer.substr(start, newline - start);
+                start = newline + 1;
+                if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+                std::string response = handle(line);
+                if (!response.empty()) open = sendAll(client, response + '\n');
+            }
+            buffer.erase(0, start);
+        }
+        ::close(client);
+    }
+    ::close(listener);
+    ::unlink(path.c_str());
+}
+#endif
+
+// ── Methods ──────────────────────────────────────────────────────────
+
+std::string EngineServer::dispatch(const std::string& method, json& params) {
+    if (method == "load") return load(params);
+    if (method == "patch") return patch(params);
+    if (method == "solve") return solve(params);
+    if (method == "run") return run(params);
+    if (method == "execute") return execute(params);
+    if (method == "status") return status();
+    if (method == "shutdown") {
+        shutdown_ = true;
+        return "null";
+    }
+    throw RpcError(METHOD_NOT_FOUND, "Unknown method: " + method);
+}
+
+void EngineServer::requireModel() const {
+    if (!loaded_) throw RpcError(ENGINE_ERROR, "No model loaded");
+}
+
+std::string EngineServer::load(json& params) {
+    const auto start = Clock::now();
+    if (params.contains("model")) {
+        model_ = JsonReader::readModelFromJson(params["model"]);
+    } else if (params.contains("path")) {
+        model_ = JsonReader::readModelFromFile(params["path"].get<std::string>());
+    } else {
+        throw RpcError(INVALID_PARAMS, "load expects \"model\" or \"path\"");
+    }
+    loaded_ = true;
+    solved_ = false;
+    solver_ = Solver(model_.transientConfig.airflowMethod);
+
+    json summary = {
+        {"elapsedMs", millisecondsSince(start)},
+        {"nodes", model_.network.getNodeCount()},
+        {"links", model_.network.getLinkCount()},
+        {"species", model_.species.size()},
+        {"transient", model_.hasTransient || !model_.species.empty()},
+    };
+    return summary.dump();
+}
+
+std::string EngineServer::patch(const json& params) {
+    requireModel();
+    const json& patches = params.at("patches");
+    if (!patches.is_array()) throw RpcError(INVALID_PARAMS, "patches must be an array");
+    int applied = 0;
+    for (const auto& op : patches) {
+        applyPatch(op);
+        ++applied;
+    }
+    return json{{"applied", applied}}.dump();
+}
+
+void EngineServer::applyPatch(const json& op) {
+    const std::string kind = op.at("op").get<std::string>();
+    Network& net = model_.network;
+
+    if (kind == "setElement") {
+        int link = linkIndexById(net, op.at("linkId").get<int>());
+        net.getLink(link).setFlowElement(JsonReader::readFlowElement(op.at("element")));
+    } else if (kind == "setNode") {
+        Node& node = net.getNode(nodeIndexById(net, op.at("nodeId").get<int>()));
+        if (op.contains("temperature")) node.setTemperature(op["temperature"].get<double>());
+        if (op.contains("volume")) node.setVolume(op["volume"].get<double>());
+        if (op.contains("elevation")) node.setElevation(op["elevation"].get<double>());
+    } else if (kind == "setAmbient") {
+        if (op.contains("temperature")) {
+            BatchParameter p;
+            p.kind = BatchParameter::Kind::AmbientTemperature;
+            p.apply(net, op["temperature"].get<double>());
+        }
+        if (op.contains("windSpeed")) net.setWindSpeed(op["windSpeed"].get<double>());
+        if (op.contains("windDirection")) net.setWindDirection(op["windDirection"].get<double>());
+        if (op.contains("pressure")) net.setAmbientPressure(op["pressure"].get<double>());
+    } else if (kind == "setSchedule") {
+        Schedule schedule = JsonReader::readSchedule(op.at("schedule"));
+        model_.schedules[schedule.id] = schedule;
+    } else if (kind == "setSource" || kind == "removeSource") {
+        const auto index = op.at("index").get<std::size_t>();
+        if (index >= model_.sources.size()) {
+            throw RpcError(INVALID_PARAMS, "Source index out of range: " + std::to_string(index));
+        }
+        if (kind == "setSource") {
+            model_.sources[index] = JsonReader::readSource(op.at("source"));
+        } else {
+            model_.sources.erase(model_.sources.begin() + static_cast<std::ptrdiff_t>(index));
+        }
+    } else if (kind == "addSource") {
+        model_.sources.push_back(JsonReader::readSource(op.at("source")));
+    } else if (kind == "setTransient") {
+        auto& cfg = model_.transientConfig;
+        if (!model_.hasTransient) cfg = transientConfigOf(model_);
+        model_.hasTransient = true;
+        cfg.startTime = op.value("startTime", cfg.startTime);
+        cfg.endTime = op.value("endTime", cfg.endTime);
+        cfg.timeStep = op.value("timeStep", cfg.timeStep);
+        cfg.outputInterval = op.value("outputInterval", cfg.outputInterval);
+    } else {
+        throw RpcError(INVALID_PARAMS, "Unknown patch op: " + kind);
+    }
+}
+
+std::string EngineServer::solveOutput(const json& params) {
+    requireModel();
+    solver_.setMethod(parseMethod(params, model_.transientConfig.airflowMethod));
+    // The network keeps the previous solution, so re-solves after a patch
+    // start close to the answer
+    SolverResult result = solver_.solve(model_.network);
+    solved_ = true;
+    return JsonWriter::writeToString(model_.network, result, -1);
+}
+
+std::string EngineServer::runOutput(const json& params, bool& completed) {
+    requireModel();
+
+    // Runs change zone temperatures and ambient conditions as they go; keep
+    // the loaded model as it was and start from its last steady solution
+    Network network = model_.network;
+    TransientSimulation sim;
+    configureSimulation(sim, model_);
+    TransientConfig config = transientConfigOf(model_);
+    config.airflowMethod = parseMethod(params, config.airflowMethod);
+    sim.setConfig(config);
+
+    std::ostringstream out;
+    JsonStreamOptions options;
+    options.minify = true;
+    sim.addResultSink(std::make_shared<JsonStreamWriter>(out, options));
+    sim.setStoreHistory(false);
+    completed = sim.run(network).completed;
+    return out.str();
+}
+
+std::string EngineServer::solve(const json& params) {
+    const auto start = Clock::now();
+    std::string output = solveOutput(params);
+    return "{\"elapsedMs\":" + json(millisecondsSince(start)).dump() + ",\"output\":" + output + "}";
+}
+
+std::string EngineServer::run(const json& params) {
+    const auto start = Clock::now();
+    bool completed = false;
+    std::string output = runOutput(params, completed);
+    return "{\"elapsedMs\":" + json(millisecondsSince(start)).dump() +
+           ",\"completed\":" + (completed ? "true" : "false") + ",\"output\":" + output + "}";
+}
+
+std::string EngineServer::execute(json& params) {
+    load(params);
+    json runParams = json::object();
+    if (params.contains("method")) runParams["method"] = params["method"];
+    if (!model_.sweep.empty()) {
+        // Every variant, as the CLI writes a model with a "sweep" section
+        ModelInput model = model_;
+        model.transientConfig.airflowMethod = parseMethod(runParams, model.transientConfig.airflowMethod);
+        SweepResult sweep = runSweep(model, ThreadPool::shared());
+        return JsonWriter::writeSweepToString(model, sweep, -1);
+    }
+    if (model_.hasTransient || !model_.species.empty()) {
+        bool completed = false;
+        return runOutput(runParams, completed);
+    }
+    return solveOutput(runParams);
+}
+
+std::string EngineServer::status() const {
+    json s = {{"loaded", loaded_}, {"solved", solved_}};
+    if (loaded_) {
+        s["nodes"] = model_.network.getNodeCount();
+        s["links"] = model_.network.getLinkCount();
+        s["sources"] = model_.sources.size();
+        s["schedules"] = model_.schedules.size();
+    }
+    return s.dump();
+}
+
+} // namespace contam
@@ -0,0 +1,77 @@
+#pragma once
+#include "core/Solver.h"
+#include "io/JsonReader.h"
+#include <nlohmann/json_fwd.hpp>
+#include <iosfwd>
+#include <string>
+
+namespace contam {
+
+// Long-lived engine session speaking newline-delimited JSON-RPC 2.0: one
+// request object per line in, one response object per line out (none for
+// notifications). The loaded model and the solver stay in memory between
+// requests, so an edit/re-solve cycle pays neither process start-up nor a
+// full parse, and each steady solve starts from the previous solution.
+//
+// Methods and params:
+//   load     {model: {...}} | {path: "model.json"}  -> model summary
+//   patch    {patches: [{op, ...}, ...]}             -> {applied}
+//   solve    {method?: "tr" | "sur"}                 -> {elapsedMs, output}
+//   run      {}                                      -> {elapsedMs, completed, output}
+//   execute  {model: {...}, method?}                 -> output, as the CLI writes it
+//   status   {}                                      -> {loaded, solved, nodes, links}
+//   shutdown {}                                      -> null; the server then stops
+// `output` is the steady or transient results document of the CLI.
+//
+// Patch ops (ids are model ids, `index` is a position in "sources"):
+//   {op: "setElement", linkId, element: {type, ...}}
+//   {op: "setNode", nodeId, temperature?, volume?, elevation?}
+//   {op: "setAmbient", temperature?, windSpeed?, windDirection?, pressure?}
+//   {op: "setSchedule", schedule: {id, name?, points: [{time, value}]}}
+//   {op: "setSource", index, source: {...}} | {op: "addSource", source: {...}}
+//   {op: "removeSource", index}
+//   {op: "setTransient", startTime?, endTime?, timeStep?, outputInterval?}
+class EngineServer {
+public:
+    EngineServer() = default;
+
+    // Handle one request line; returns the response line without the
+    // trailing newline (empty for notifications)
+    std::string handle(const std::string& line);
+
+    // Serve requests line by line until EOF or shutdown
+    void serve(std::istream& in, std::ostream& out);
+
+#ifndef _WIN32
+    // Listen on a Unix domain socket and serve one client at a time (same
+    // protocol as serve) until a shutdown request. Throws if it cannot bind.
+    void serveUnixSocket(const std::string& path);
+#endif
+
+    bool shutdownRequested() const { return shutdown_; }
+    bool hasModel() const { return loaded_; }
+    const ModelInput& model() const { return model_; }
+
+private:
+    ModelInput model_;
+    bool loaded_ = false;
+    bool solved_ = false;   // model_.network holds the last steady solution
+    Solver solver_;
+    bool shutdown_ = false;
+
+    // Method handlers; each returns the serialized "result" value
+    std::string dispatch(const std::string& method, nlohmann::json& params);
+    std::string load(nlohmann::json& params);
+    std::string patch(const nlohmann::json& params);
+    std::string solve(const nlohmann::json& params);
+    std::string run(const nlohmann::json& params);
+    std::string execute(nlohmann::json& params);
+    std::string solveOutput(const nlohmann::json& params);
+    std::string runOutput(const nlohmann::json& params, bool& completed);
+    std::string status() const;
+
+    void applyPatch(const nlohmann::json& op);
+    void requireModel() const;
+};
+
+} // namespace contam
@@ -0,0 +1,226 @@
+#ifdef CONTAM_HAS_HDF5
+
+#include "io/Hdf5File.h"
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace contam {
+namespace hdf5 {
+
+static void check(herr_t status, const std::string& what) {
+    if (status < 0) throw std::runtime_error("HDF5: failed to " + what);
+}
+
+// ── Handle ───────────────────────────────────────────────────────────
+
+Handle::Handle(hid_t id, Closer close, const std::string& what) : id_(id), close_(close) {
+    if (id_ < 0) throw std::runtime_error("HDF5: failed to " + what);
+}
+
+Handle::~Handle() { reset(); }
+
+Handle::Handle(Handle&& other) noexcept : id_(other.id_), close_(other.close_) {
+    other.id_ = -1;
+}
+
+Handle& Handle::operator=(Handle&& other) noexcept {
+    if (this != &other) {
+        reset();
+        id_ = std::exchange(other.id_, -1);
+        close_ = other.close_;
+    }
+    return *this;
+}
+
+void Handle::reset() {
+    if (id_ >= 0 && close_) close_(id_);
+    id_ = -1;
+}
+
+static Handle dataspace(const std::vector<hsize_t>& dims, const std::vector<hsize_t>* maxDims = nullptr) {
+    if (dims.empty()) return Handle(H5Screate(H5S_SCALAR), H5Sclose, "create dataspace");
+    return Handle(H5Screate_simple(static_cast<int>(dims.size()), dims.data(),
+                                   maxDims ? maxDims->data() : nullptr),
+                  H5Sclose, "create dataspace");
+}
+
+static Handle stringType() {
+    Handle type(H5Tcopy(H5T_C_S1), H5Tclose, "create string type");
+    check(H5Tset_size(type.get(), H5T_VARIABLE), "size string type");
+    check(H5Tset_cset(type.get(), H5T_CSET_UTF8), "set string encoding");
+    return type;
+}
+
+// ── Writing ──────────────────────────────────────────────────────────
+
+Handle createFile(const std::string& path) {
+    return Handle(H5Fcreate(path.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT), H5Fclose,
+                  "create " + path);
+}
+
+Handle createGroup(hid_t loc, const std::string& name) {
+    return Handle(H5Gcreate2(loc, name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT), H5Gclose,
+                  "create group " + name);
+}
+
+void flush(hid_t file) { check(H5Fflush(file, H5F_SCOPE_LOCAL), "flush file"); }
+
+static void writeScalarAttribute(hid_t loc, const std::string& name, hid_t type, const void* value) {
+    Handle space = dataspace({});
+    Handle attr(H5Acreate2(loc, name.c_str(), type, space.get(), H5P_DEFAULT, H5P_DEFAULT),
+                H5Aclose, "create attribute " + name);
+    check(H5Awrite(attr.get(), type, value), "write attribute " + name);
+}
+
+void writeAttribute(hid_t loc, const std::string& name, int value) {
+    writeScalarAttribute(loc, name, H5T_NATIVE_INT, &value);
+}
+
+void writeAttribute(hid_t loc, const std::string& name, double value) {
+    writeScalarAttribute(loc, name, H5T_NATIVE_DOUBLE, &value);
+}
+
+void writeDataset(hid_t loc, const std::string& name, const std::vector<hsize_t>& dims,
+                  hid_t fileType, hid_t memType, const void* data) {
+    Handle space = dataspace(dims);
+    Handle ds(H5Dcreate2(loc, name.c_str(), fileType, space.get(), H5P_DEFAULT, H5P_DEFAULT,
+                         H5P_DEFAULT),
+              H5Dclose, "create dataset " + name);
+    const hsize_t count = std::accumulate(dims.begin(), dims.end(), hsize_t{1}, std::multiplies<>());
+    if (count > 0) {
+        check(H5Dwrite(ds.get(), memType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data),
+              "write dataset " + name);
+    }
+}
+
+void writeStrings(hid_t loc, const std::string& name, const std::vector<std::string>& values) {
+    std::vector<const char*> ptrs;
+    ptrs.reserve(values.size());
+    for (const auto& v : values) ptrs.push_back(v.c_str());
+    Handle type = stringType();
+    writeDataset(loc, name, {static_cast<hsize_t>(values.size())}, type.get(), type.get(),
+                 ptrs.data());
+}
+
+Handle createExtendable(hid_t loc, const std::string& name, hid_t fileType,
+                        const std::vector<hsize_t>& entityDims, const ChunkLayout& layout) {
+    std::vector<hsize_t> dims{0}, maxDims{H5S_UNLIMITED};
+    for (hsize_t d : entityDims) {
+        dims.push_back(d);
+        maxDims.push_back(std::max<hsize_t>(d, 1));
+    }
+    if (layout.chunk.size() != dims.size()) {
+        throw std::runtime_error("HDF5: chunk rank does not match dataset " + name);
+    }
+    Handle space = dataspace(dims, &maxDims);
+
+    Handle props(H5Pcreate(H5P_DATASET_CREATE), H5Pclose, "create dataset properties");
+    check(H5Pset_chunk(props.get(), static_cast<int>(layout.chunk.size()), layout.chunk.data()),
+          "set chunking for " + name);
+    if (layout.shuffle) check(H5Pset_shuffle(props.get()), "enable shuffle for " + name);
+    if (layout.deflateLevel > 0) {
+        check(H5Pset_deflate(props.get(), layout.deflateLevel), "enable deflate for " + name);
+    }
+    return Handle(H5Dcreate2(loc, name.c_str(), fileType, space.get(), H5P_DEFAULT, props.get(),
+                             H5P_DEFAULT),
+                  H5Dclose, "create dataset " + name);
+}
+
+void appendRows(hid_t dataset, hsize_t firstRow, hsize_t rowCount, hid_t memType,
+                const void* data) {
+    std::vector<hsize_t> dims = datasetDims(dataset);
+    dims[0] = firstRow + rowCount;
+    check(H5Dset_extent(dataset, dims.data()), "extend dataset");
+
+    std::vector<hsize_t> offset(dims.size(), 0), count = dims;
+    offset[0] = firstRow;
+    count[0] = rowCount;
+    const hsize_t total = std::accumulate(count.begin(), count.end(), hsize_t{1}, std::multiplies<>());
+    if (total == 0) return;
+
+    Handle fileSpace(H5Dget_space(dataset), H5Sclose, "get dataset space");
+    check(H5Sselect_hyperslab(fileSpace.get(), H5S_SELECT_SET, offset.data(), nullptr, count.data(),
+                              nullptr),
+          "select rows");
+    Handle memSpace = dataspace(count);
+    check(H5Dwrite(dataset, memType, memSpace.get(), fileSpace.get(), H5P_DEFAULT, data),
+          "append rows");
+}
+
+// ── Reading ──────────────────────────────────────────────────────────
+
+Handle openFile(const std::string& path) {
+    return Handle(H5Fopen(path.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT), H5Fclose, "open " + path);
+}
+
+Handle openGroup(hid_t loc, const std::string& name) {
+    return Handle(H5Gopen2(loc, name.c_str(), H5P_DEFAULT), H5Gclose, "open group " + name);
+}
+
+Handle openDataset(hid_t loc, const std::string& name) {
+    return Handle(H5Dopen2(loc, name.c_str(), H5P_DEFAULT), H5Dclose, "open dataset " + name);
+}
+
+int readIntAttribute(hid_t loc, const std::string& name) {
+    Handle attr(H5Aopen(loc, name.c_str(), H5P_DEFAULT), H5Aclose, "open attribute " + name);
+    int value = 0;
+    check(H5Aread(attr.get(), H5T_NATIVE_INT, &value), "read attribute " + name);
+    return value;
+}
+
+std::vector<hsize_t> datasetDims(hid_t dataset) {
+    Handle space(H5Dget_space(dataset), H5Sclose, "get dataset space");
+    const int rank = H5Sget_simple_extent_ndims(space.get());
+    check(rank, "get dataset rank");
+    std::vector<hsize_t> dims(static_cast<std::size_t>(rank));
+    check(H5Sget_simple_extent_dims(space.get(), dims.data(), nullptr), "get dataset extent");
+    return dims;
+}
+
+std::size_t datasetTypeSize(hid_t dataset) {
+    Handle type(H5Dget_type(dataset), H5Tclose, "get dataset type");
+    return H5Tget_size(type.get());
+}
+
+template <typename T> std::vector<T> readDataset(hid_t dataset) {
+    const auto dims = datasetDims(dataset);
+    const hsize_t count = std::accumulate(dims.begin(), dims.end(), hsize_t{1}, std::multiplies<>());
+    std::vector<T> values(static_cast<std::size_t>(count));
+    if (count > 0) {
+        check(H5Dread(dataset, nativeType<T>(), H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data()),
+              "read dataset");
+    }
+    return values;
+}
+
+template std::vector<int> readDataset<int>(hid_t);
+template std::vector<float> readDataset<float>(hid_t);
+template std::vector<double> readDataset<double>(hid_t);
+
+std::vector<std::string> readStrings(hid_t dataset) {
+    const auto dims = datasetDims(dataset);
+    std::vector<char*> ptrs(dims.empty() ? 1 : static_cast<std::size_t>(dims[0]), nullptr);
+    if (ptrs.empty()) return {};
+
+    Handle type = stringType();
+    check(H5Dread(dataset, type.get(), H5S_ALL, H5S_ALL, H5P_DEFAULT, ptrs.data()), "read strings");
+    std::vector<std::string> values;
+    values.reserve(ptrs.size());
+    for (const char* p : ptrs) values.emplace_back(p ? p : "");
+
+    Handle space(H5Dget_space(dataset), H5Sclose, "get dataset space");
+#if H5_VERSION_GE(1, 12, 0)
+    H5Treclaim(type.get(), space.get(), H5P_DEFAULT, ptrs.data());
+#else
+    H5Dvlen_reclaim(type.get(), space.get(), H5P_DEFAULT, ptrs.data());
+#endif
+    return values;
+}
+
+} // namespace hdf5
+} // namespace contam
+
+#endif // CONTAM_HAS_HDF5
@@ -0,0 +1,99 @@
+#pragma once
+
+#ifdef CONTAM_HAS_HDF5
+
+#include <hdf5.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace contam {
+namespace hdf5 {
+
+// Thin RAII layer over the HDF5 C API shared by Hdf5Writer and
+// Hdf5StreamWriter. Failures throw std::runtime_error naming the object.
+
+// Owning hid_t closed with the matching H5*close function
+class Handle {
+public:
+    using Closer = herr_t (*)(hid_t);
+
+    Handle() = default;
+    Handle(hid_t id, Closer close, const std::string& what);
+    ~Handle();
+
+    Handle(Handle&& other) noexcept;
+    Handle& operator=(Handle&& other) noexcept;
+    Handle(const Handle&) = delete;
+    Handle& operator=(const Handle&) = delete;
+
+    hid_t get() const { return id_; }
+    explicit operator bool() const { return id_ >= 0; }
+
+private:
+    void reset();
+
+    hid_t id_ = -1;
+    Closer close_ = nullptr;
+};
+
+template <typename T> hid_t nativeType();
+template <> inline hid_t nativeType<int>() { return H5T_NATIVE_INT; }
+template <> inline hid_t nativeType<float>() { return H5T_NATIVE_FLOAT; }
+template <> inline hid_t nativeType<double>() { return H5T_NATIVE_DOUBLE; }
+
+// ── Writing ──────────────────────────────────────────────────────────
+
+Handle createFile(const std::string& path);   // truncates an existing file
+Handle createGroup(hid_t loc, const std::string& name);
+void flush(hid_t file);
+
+void writeAttribute(hid_t loc, const std::string& name, int value);
+void writeAttribute(hid_t loc, const std::string& name, double value);
+
+// Fixed-size dataset of `dims` stored as `fileType`, filled from `data`
+// (row-major, `memType` elements)
+void writeDataset(hid_t loc, const std::string& name, const std::vector<hsize_t>& dims,
+                  hid_t fileType, hid_t memType, const void* data);
+
+template <typename T>
+void writeDataset(hid_t loc, const std::string& name, const std::vector<T>& values) {
+    writeDataset(loc, name, {static_cast<hsize_t>(values.size())}, nativeType<T>(),
+                 nativeType<T>(), values.data());
+}
+
+// 1-D dataset of variable-length UTF-8 strings
+void writeStrings(hid_t loc, const std::string& name, const std::vector<std::string>& values);
+
+struct ChunkLayout {
+    std::vector<hsize_t> chunk;  // one extent per dimension, time first
+    bool shuffle = false;
+    unsigned deflateLevel = 0;   // 0 disables compression
+};
+
+// Dataset of 0 x entityDims... rows, unlimited along time (dimension 0)
+Handle createExtendable(hid_t loc, const std::string& name, hid_t fileType,
+                        const std::vector<hsize_t>& entityDims, const ChunkLayout& layout);
+
+// Grow `dataset` to firstRow + rowCount rows and write the rows from `data`
+void appendRows(hid_t dataset, hsize_t firstRow, hsize_t rowCount, hid_t memType,
+                const void* data);
+
+// ── Reading ──────────────────────────────────────────────────────────
+
+Handle openFile(const std::string& path);     // read-only
+Handle openGroup(hid_t loc, const std::string& name);
+Handle openDataset(hid_t loc, const std::string& name);
+
+int readIntAttribute(hid_t loc, const std::string& name);
+std::vector<hsize_t> datasetDims(hid_t dataset);
+std::size_t datasetTypeSize(hid_t dataset);    // bytes per stored element
+
+// Whole dataset, row-major, converted to T
+template <typename T> std::vector<T> readDataset(hid_t dataset);
+std::vector<std::string> readStrings(hid_t dataset);
+
+} // namespace hdf5
+} // namespace contam
+
+#endif // CONTAM_HAS_HDF5
@@ -0,0 +1,208 @@
+#ifdef CONTAM_HAS_HDF5
+
+#include "io/Hdf5StreamWriter.h"
+#include "io/Hdf5File.h"
+#include <algorithm>
+#include <limits>
+
+namespace contam {
+
+struct Hdf5StreamWriter::Impl {
+    Hdf5StreamOptions options;
+    hdf5::Handle file;
+    hdf5::Handle time, pressures, flows, concs;
+    OutputSelection output;
+
+    std::size_t nNodes = 0, nLinks = 0, nSpecies = 0;
+    std::size_t timeChunk = 1;
+    bool asFloat = false;
+    bool ended = false;
+
+    std::size_t written = 0;    // rows already in the file
+    std::size_t buffered = 0;   // rows waiting in the buffers
+    std::vector<double> bufTime, bufPressure, bufFlow, bufConc;
+    std::vector<float> bufSingle;   // float32 staging for append()
+
+    hdf5::Handle createExtendable(const std::string& name,
+                                  const std::vector<std::size_t>& entityDims,
+                                  bool forceDouble = false);
+    void append(const hdf5::Handle& ds, const std::vector<double>& values, bool single);
+    void writeBuffered();
+};
+
+// Chunk extent along one entity dimension: as many entities as fit in the
+// target chunk size with the full time-chunk length
+static std::size_t entityChunk(std::size_t count, std::size_t bytesPerEntityStep,
+                               std::size_t timeChunk, std::size_t chunkBytes) {
+    std::size_t fit = chunkBytes / std::max<std::size_t>(1, timeChunk * bytesPerEntityStep);
+    return std::max<std::size_t>(1, std::min(std::max<std::size_t>(count, 1), fit));
+}
+
+hdf5::Handle Hdf5StreamWriter::Impl::createExtendable(const std::string& name,
+                                                      const std::vector<std::size_t>& entityDims,
+                                                      bool forceDouble) {
+    const bool single = asFloat && !forceDouble;
+    const std::size_t elemSize = single ? sizeof(float) : sizeof(double);
+
+    hdf5::ChunkLayout layout;
+    layout.chunk.push_back(timeChunk);
+    layout.shuffle = options.shuffle;
+    layout.deflateLevel = options.deflateLevel;
+
+    // The innermost dimension (species) is kept whole; the node/link
+    // dimension is split so each chunk is about options.chunkBytes
+    std::size_t inner = 1;
+    for (std::size_t d = 1; d < entityDims.size(); ++d) inner *= std::max<std::size_t>(entityDims[d], 1);
+    std::vector<hsize_t> dims;
+    for (std::size_t d = 0; d < entityDims.size(); ++d) {
+        dims.push_back(entityDims[d]);
+        layout.chunk.push_back(d == 0 ? entityChunk(entityDims[d], elemSize * inner, timeChunk,
+                                                    options.chunkBytes)
+                                      : std::max<std::size_t>(entityDims[d], 1));
+    }
+    return hdf5::createExtendable(file.get(), name, single ? H5T_NATIVE_FLOAT : H5T_NATIVE_DOUBLE,
+                                  dims, layout);
+}
+
+void Hdf5StreamWriter::Impl::append(const hdf5::Handle& ds, const std::vector<double>& values,
+                                    bool single) {
+    if (single) {
+        bufSingle.assign(values.begin(), values.end());
+        hdf5::appendRows(ds.get(), written, buffered, H5T_NATIVE_FLOAT, bufSingle.data());
+    } else {
+        hdf5::appendRows(ds.get(), written, buffered, H5T_NATIVE_DOUBLE, values.data());
+    }
+}
+
+void Hdf5StreamWriter::Impl::writeBuffered() {
+    if (buffered == 0) return;
+    append(time, bufTime, false);
+    append(pressures, bufPressure, asFloat);
+    append(flows, bufFlow, asFloat);
+    append(concs, bufConc, asFloat);
+    written += buffered;
+    buffered = 0;
+    bufTime.clear();
+    bufPressure.clear();
+    bufFlow.clear();
+    bufConc.clear();
+    hdf5::flush(file.get());
+}
+
+// ── Hdf5StreamWriter ─────────────────────────────────────────────────
+
+Hdf5StreamWriter::Hdf5StreamWriter(const std::string& filepath, const Hdf5StreamOptions& options)
+    : impl_(std::make_unique<Impl>()) {
+    impl_->options = options;
+    impl_->file = hdf5::createFile(filepath);
+}
+
+Hdf5StreamWriter::~Hdf5StreamWriter() {
+    // Keep whatever was produced if the run never reached end()
+    if (impl_ && impl_->file && !impl_->ended && impl_->time) {
+        try {
+            impl_->writeBuffered();
+        } catch (...) {
+        }
+    }
+}
+
+std::size_t Hdf5StreamWriter::stepCount() const { return impl_->written + impl_->buffered; }
+std::size_t Hdf5StreamWriter::timeChunk() const { return impl_->timeChunk; }
+
+void Hdf5StreamWriter::begin(const Network& network, const std::vector<Species>& species,
+                             const OutputSelection& output) {
+    Impl& d = *impl_;
+    d.output = output;
+    d.asFloat = output.precision() != OutputPrecision::Double;
+    d.nNodes = output.nodeCount(network);
+    d.nLinks = output.linkCount(network);
+    d.nSpecies = output.speciesCount(species);
+    d.written = d.buffered = 0;
+    d.ended = false;
+
+    const std::size_t rowBytes = sizeof(double) * (1 + d.nNodes + d.nLinks + d.nNodes * d.nSpecies);
+    d.timeChunk = std::max<std::size_t>(1, std::min(d.options.maxTimeChunk,
+                                                    d.options.bufferBytes / rowBytes));
+    d.bufTime.reserve(d.timeChunk);
+    d.bufPressure.reserve(d.timeChunk * d.nNodes);
+    d.bufFlow.reserve(d.timeChunk * d.nLinks);
+    d.bufConc.reserve(d.timeChunk * d.nNodes * d.nSpecies);
+
+    hdf5::Handle meta = hdf5::createGroup(d.file.get(), "metadata");
+    hdf5::writeAttribute(meta.get(), "nodeCount", static_cast<int>(d.nNodes));
+    hdf5::writeAttribute(meta.get(), "linkCount", static_cast<int>(d.nLinks));
+    hdf5::writeAttribute(meta.get(), "speciesCount", static_cast<int>(d.nSpecies));
+
+    std::vector<std::string> speciesNames(d.nSpecies);
+    for (std::size_t s = 0; s < d.nSpecies; ++s) speciesNames[s] = species[output.species(s)].name;
+    hdf5::writeStrings(d.file.get(), "speciesNames", speciesNames);
+
+    std::vector<std::string> nodeNames(d.nNodes);
+    std::vector<int> nodeIds(d.nNodes);
+    for (std::size_t i = 0; i < d.nNodes; ++i) {
+        const auto& node = network.getNode(output.node(i));
+        nodeNames[i] = node.getName();
+        nodeIds[i] = node.getId();
+    }
+    hdf5::writeStrings(d.file.get(), "nodeNames", nodeNames);
+    hdf5::writeDataset(d.file.get(), "nodeIds", nodeIds);
+
+    std::vector<int> linkIds(d.nLinks);
+    for (std::size_t i = 0; i < d.nLinks; ++i) linkIds[i] = network.getLink(output.link(i)).getId();
+    hdf5::writeDataset(d.file.get(), "linkIds", linkIds);
+
+    d.time = d.createExtendable("time", {}, true);
+    d.pressures = d.createExtendable("pressures", {d.nNodes});
+    d.flows = d.createExtendable("massFlows", {d.nLinks});
+    d.concs = d.createExtendable("concentrations", {d.nNodes, d.nSpecies});
+    hdf5::flush(d.file.get());
+}
+
+// Append `count` values from `src` (zero-filled past its end), or NaN when
+// the variable was not recorded at this step
+static void appendRow(std::vector<double>& buf, const std::vector<double>& src,
+                      std::size_t count, bool recorded) {
+    if (!recorded) {
+        buf.insert(buf.end(), count, std::numeric_limits<double>::quiet_NaN());
+        return;
+    }
+    const std::size_t n = std::min(count, src.size());
+    buf.insert(buf.end(), src.begin(), src.begin() + static_cast<std::ptrdiff_t>(n));
+    buf.insert(buf.end(), count - n, 0.0);
+}
+
+void Hdf5StreamWriter::onStep(const TimeStepResult& step) {
+    Impl& d = *impl_;
+    d.bufTime.push_back(step.time);
+    appendRow(d.bufPressure, step.airflow.pressures, d.nNodes, d.output.hasPressures(step));
+    appendRow(d.bufFlow, step.airflow.massFlows, d.nLinks, d.output.hasMassFlows(step));
+
+    const auto& concs = step.contaminant.concentrations;
+    const bool recorded = d.output.hasConcentrations(step);
+    static const std::vector<double> none;
+    for (std::size_t i = 0; i < d.nNodes; ++i) {
+        appendRow(d.bufConc, i < concs.size() ? concs[i] : none, d.nSpecies, recorded);
+    }
+
+    if (++d.buffered >= d.timeChunk) d.writeBuffered();
+}
+
+std::size_t Hdf5StreamWriter::memoryBytes() const {
+    return vectorBytes(impl_->bufTime) + vectorBytes(impl_->bufPressure) + vectorBytes(impl_->bufFlow) +
+           vectorBytes(impl_->bufConc) + vectorBytes(impl_->bufSingle);
+}
+
+void Hdf5StreamWriter::end(bool completed) {
+    Impl& d = *impl_;
+    d.writeBuffered();
+    hdf5::Handle meta = hdf5::openGroup(d.file.get(), "metadata");
+    hdf5::writeAttribute(meta.get(), "completed", completed ? 1 : 0);
+    hdf5::writeAttribute(meta.get(), "timeSteps", static_cast<int>(d.written));
+    hdf5::flush(d.file.get());
+    d.ended = true;
+}
+
+} // namespace contam
+
+#endif // CONTAM_HAS_HDF5
@@ -0,0 +1,55 @@
+#pragma once
+
+#ifdef CONTAM_HAS_HDF5
+
+#include "core/ResultSink.h"
+#include "core/TransientSimulation.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace contam {
+
+struct Hdf5StreamOptions {
+    unsigned deflateLevel = 4;          // 0 disables compression
+    bool shuffle = true;                // byte shuffle before deflate
+    std::size_t maxTimeChunk = 1024;    // output steps per chunk (upper bound)
+    std::size_t chunkBytes = 1 << 20;   // target uncompressed chunk size
+    std::size_t bufferBytes = 64 << 20; // cap on buffered step rows
+};
+
+// Result sink writing the Hdf5Writer::writeTransient layout (time, pressures,
+// massFlows, concentrations, nodeNames/nodeIds, linkIds, speciesNames,
+// metadata) incrementally. The result datasets are extendable along time,
+// chunked and optionally shuffle+deflate compressed.
+//
+// Chunks are long in time and narrow in entities (time x a few nodes), so
+// reading one zone's history touches few chunks. Steps are buffered until a
+// full time chunk is ready, appended and the file flushed: memory stays
+// constant and a crash loses at most one chunk of steps. The time-chunk
+// length shrinks for very large models so the buffer stays under
+// bufferBytes. metadata/completed is written by end() as an int (0/1).
+// contam_engine --hdf5 attaches this sink to transient runs.
+class Hdf5StreamWriter : public ResultSink {
+public:
+    explicit Hdf5StreamWriter(const std::string& filepath, const Hdf5StreamOptions& options = {});
+    ~Hdf5StreamWriter() override;
+
+    void begin(const Network& network, const std::vector<Species>& species,
+               const OutputSelection& output) override;
+    void onStep(const TimeStepResult& step) override;
+    void end(bool completed) override;
+    std::size_t memoryBytes() const override;
+
+    std::size_t stepCount() const;
+    std::size_t timeChunk() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace contam
+
+#endif // CONTAM_HAS_HDF5
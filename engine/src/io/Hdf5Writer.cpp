@@ -1,26 +1,27 @@
 #ifdef CONTAM_HAS_HDF5
 
 #include "io/Hdf5Writer.h"
-#include <highfive/H5File.hpp>
-#include <highfive/H5DataSet.hpp>
-#include <highfive/H5DataSpace.hpp>
+#include "io/Hdf5File.h"
+#include <algorithm>
+#include <limits>
 
 namespace contam {
 
 void Hdf5Writer::writeSteadyState(const std::string& filepath,
                                    const Network& network,
                                    const SolverResult& result) {
-    HighFive::File file(filepath, HighFive::File::Overwrite);
+    hdf5::Handle file = hdf5::createFile(filepath);
 
-    auto meta = file.createGroup("metadata");
-    meta.createAttribute("nodeCount", network.getNodeCount());
-    meta.createAttribute("linkCount", network.getLinkCount());
-    meta.createAttribute("converged", result.converged);
-    meta.createAttribute("iterations", result.iterations);
-    meta.createAttribute("maxResidual", result.maxResidual);
+    // Flags are stored as int 0/1, the same as metadata/completed
+    hdf5::Handle meta = hdf5::createGroup(file.get(), "metadata");
+    hdf5::writeAttribute(meta.get(), "nodeCount", network.getNodeCount());
+    hdf5::writeAttribute(meta.get(), "linkCount", network.getLinkCount());
+    hdf5::writeAttribute(meta.get(), "converged", result.converged ? 1 : 0);
+    hdf5::writeAttribute(meta.get(), "iterations", result.iterations);
+    hdf5::writeAttribute(meta.get(), "maxResidual", result.maxResidual);
 
     // Node data
-    auto nodesGrp = file.createGroup("nodes");
+    hdf5::Handle nodesGrp = hdf5::createGroup(file.get(), "nodes");
     const int nNodes = network.getNodeCount();
 
     std::vector<double> pressures(nNodes), densities(nNodes), temperatures(nNodes), elevations(nNodes);
@@ -35,101 +36,140 @@ void Hdf5Writer::writeSteadyState(const std::string& filepath,
         names[i] = node.getName();
     }
 
-    nodesGrp.createDataSet("pressure", pressures);
-    nodesGrp.createDataSet("density", densities);
-    nodesGrp.createDataSet("temperature", temperatures);
-    nodesGrp.createDataSet("elevation", elevations);
-    nodesGrp.createDataSet("name", names);
+    hdf5::writeDataset(nodesGrp.get(), "pressure", pressures);
+    hdf5::writeDataset(nodesGrp.get(), "density", densities);
+    hdf5::writeDataset(nodesGrp.get(), "temperature", temperatures);
+    hdf5::writeDataset(nodesGrp.get(), "elevation", elevations);
+    hdf5::writeStrings(nodesGrp.get(), "name", names);
 
     // Link data
-    auto linksGrp = file.createGroup("links");
+    hdf5::Handle linksGrp = hdf5::createGroup(file.get(), "links");
     const int nLinks = network.getLinkCount();
 
     std::vector<double> massFlows(nLinks), volFlows(nLinks);
     for (int i = 0; i < nLinks; ++i) {
         const auto& link = network.getLink(i);
         massFlows[i] = link.getMassFlow();
-        volFlows[i] = link.getVolumeFlow();
+        const double density = network.getNode(link.getNodeFrom()).getDensity();
+        volFlows[i] = density > 0 ? massFlows[i] / density : 0.0;
     }
 
-    linksGrp.createDataSet("massFlow", massFlows);
-    linksGrp.createDataSet("volumeFlow", volFlows);
+    hdf5::writeDataset(linksGrp.get(), "massFlow", massFlows);
+    hdf5::writeDataset(linksGrp.get(), "volumeFlow", volFlows);
+}
+
+// Write a row-major [steps x ...] block as double, or as float when the
+// output precision does not need doubles
+static void writeBlock(hid_t file, const std::string& name, const std::vector<hsize_t>& dims,
+                       const std::vector<double>& values, bool asFloat) {
+    if (!asFloat) {
+        hdf5::writeDataset(file, name, dims, H5T_NATIVE_DOUBLE, H5T_NATIVE_DOUBLE, values.data());
+        return;
+    }
+    const std::vector<float> f(values.begin(), values.end());
+    hdf5::writeDataset(file, name, dims, H5T_NATIVE_FLOAT, H5T_NATIVE_FLOAT, f.data());
 }
 
 void Hdf5Writer::writeTransient(const std::string& filepath,
                                  const Network& network,
                                  const std::vector<Species>& species,
                                  const TransientResult& result) {
-    HighFive::File file(filepath, HighFive::File::Overwrite);
+    hdf5::Handle file = hdf5::createFile(filepath);
 
-    const int nSteps = static_cast<int>(result.history.size());
-    const int nNodes = network.getNodeCount();
-    const int nSpecies = static_cast<int>(species.size());
-    const int nLinks = network.getLinkCount();
+    // Datasets cover the recorded subset (result.output); steps where a
+    // variable was not due hold NaN rows
+    const OutputSelection& output = result.output;
+    const bool asFloat = output.precision() != OutputPrecision::Double;
+    const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+    const std::size_t nSteps = result.history.size();
+    const std::size_t nNodes = output.nodeCount(network);
+    const std::size_t nSpecies = output.speciesCount(species);
+    const std::size_t nLinks = output.linkCount(network);
 
     // Metadata
-    auto meta = file.createGroup("metadata");
-    meta.createAttribute("completed", result.completed);
-    meta.createAttribute("timeSteps", nSteps);
-    meta.createAttribute("nodeCount", nNodes);
-    meta.createAttribute("linkCount", nLinks);
-    meta.createAttribute("speciesCount", nSpecies);
+    hdf5::Handle meta = hdf5::createGroup(file.get(), "metadata");
+    hdf5::writeAttribute(meta.get(), "completed", result.completed ? 1 : 0);
+    hdf5::writeAttribute(meta.get(), "timeSteps", static_cast<int>(nSteps));
+    hdf5::writeAttribute(meta.get(), "nodeCount", static_cast<int>(nNodes));
+    hdf5::writeAttribute(meta.get(), "linkCount", static_cast<int>(nLinks));
+    hdf5::writeAttribute(meta.get(), "speciesCount", static_cast<int>(nSpecies));
 
     // Species names
     std::vector<std::string> speciesNames(nSpecies);
-    for (int s = 0; s < nSpecies; ++s) {
-        speciesNames[s] = species[s].name;
+    for (std::size_t s = 0; s < nSpecies; ++s) {
+        speciesNames[s] = species[output.species(s)].name;
     }
-    file.createDataSet("speciesNames", speciesNames);
+    hdf5::writeStrings(file.get(), "speciesNames", speciesNames);
 
-    // Node names
+    // Node names and ids
     std::vector<std::string> nodeNames(nNodes);
-    for (int i = 0; i < nNodes; ++i) {
-        nodeNames[i] = network.getNode(i).getName();
+    std::vector<int> nodeIds(nNodes);
+    for (std::size_t i = 0; i < nNodes; ++i) {
+        const auto& node = network.getNode(output.node(i));
+        nodeNames[i] = node.getName();
+        nodeIds[i] = node.getId();
     }
-    file.createDataSet("nodeNames", nodeNames);
+    hdf5::writeStrings(file.get(), "nodeNames", nodeNames);
+    hdf5::writeDataset(file.get(), "nodeIds", nodeIds);
+
+    // Link ids
+    std::vector<int> linkIds(nLinks);
+    for (std::size_t i = 0; i < nLinks; ++i) {
+        linkIds[i] = network.getLink(output.link(i)).getId();
+    }
+    hdf5::writeDataset(file.get(), "linkIds", linkIds);
 
     // Time vector
     std::vector<double> times(nSteps);
-    for (int t = 0; t < nSteps; ++t) {
+    for (std::size_t t = 0; t < nSteps; ++t) {
         times[t] = result.history[t].time;
     }
-    file.createDataSet("time", times);
+    hdf5::writeDataset(file.get(), "time", times);
 
     // Pressures: [nSteps x nNodes]
-    std::vector<std::vector<double>> pressures(nSteps, std::vector<double>(nNodes, 0.0));
-    for (int t = 0; t < nSteps; ++t) {
-        const auto& af = result.history[t].airflow;
-        for (int i = 0; i < nNodes && i < static_cast<int>(af.pressures.size()); ++i) {
-            pressures[t][i] = af.pressures[i];
+    std::vector<double> pressures(nSteps * nNodes, 0.0);
+    for (std::size_t t = 0; t < nSteps; ++t) {
+        const auto& step = result.history[t];
+        double* row = pressures.data() + t * nNodes;
+        if (!output.hasPressures(step)) {
+            std::fill(row, row + nNodes, NaN);
+            continue;
         }
+        const auto& p = step.airflow.pressures;
+        std::copy_n(p.begin(), std::min(nNodes, p.size()), row);
     }
-    file.createDataSet("pressures", pressures);
+    writeBlock(file.get(), "pressures", {nSteps, nNodes}, pressures, asFloat);
 
     // Mass flows: [nSteps x nLinks]
-    std::vector<std::vector<double>> flows(nSteps, std::vector<double>(nLinks, 0.0));
-    for (int t = 0; t < nSteps; ++t) {
-        const auto& af = result.history[t].airflow;
-        for (int i = 0; i < nLinks && i < static_cast<int>(af.massFlows.size()); ++i) {
-            flows[t][i] = af.massFlows[i];
+    std::vector<double> flows(nSteps * nLinks, 0.0);
+    for (std::size_t t = 0; t < nSteps; ++t) {
+        const auto& step = result.history[t];
+        double* row = flows.data() + t * nLinks;
+        if (!output.hasMassFlows(step)) {
+            std::fill(row, row + nLinks, NaN);
+            continue;
         }
+        const auto& f = step.airflow.massFlows;
+        std::copy_n(f.begin(), std::min(nLinks, f.size()), row);
     }
-    file.createDataSet("massFlows", flows);
+    writeBlock(file.get(), "massFlows", {nSteps, nLinks}, flows, asFloat);
 
     // Concentrations: [nSteps x nNodes x nSpecies]
-    // HDF5 via HighFive supports nested vectors for 3D
-    std::vector<std::vector<std::vector<double>>> conc(
-        nSteps, std::vector<std::vector<double>>(nNodes, std::vector<double>(nSpecies, 0.0)));
-
-    for (int t = 0; t < nSteps; ++t) {
-        const auto& cr = result.history[t].contaminant;
-        for (int i = 0; i < nNodes && i < static_cast<int>(cr.concentrations.size()); ++i) {
-            for (int s = 0; s < nSpecies && s < static_cast<int>(cr.concentrations[i].size()); ++s) {
-                conc[t][i][s] = cr.concentrations[i][s];
-            }
+    std::vector<double> conc(nSteps * nNodes * nSpecies, 0.0);
+    for (std::size_t t = 0; t < nSteps; ++t) {
+        const auto& step = result.history[t];
+        double* plane = conc.data() + t * nNodes * nSpecies;
+        if (!output.hasConcentrations(step)) {
+            std::fill(plane, plane + nNodes * nSpecies, NaN);
+            continue;
+        }
+        const auto& c = step.contaminant.concentrations;
+        for (std::size_t i = 0; i < nNodes && i < c.size(); ++i) {
+            std::copy_n(c[i].begin(), std::min(nSpecies, c[i].size()), plane + i * nSpecies);
         }
     }
-    file.createDataSet("concentrations", conc);
+    writeBlock(file.get(), "concentrations", {nSteps, nNodes, nSpecies}, conc, asFloat);
 }
 
 } // namespace contam
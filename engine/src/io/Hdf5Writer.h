@@ -12,7 +12,7 @@
 namespace contam {
 
 // HDF5 output writer for CONTAM simulation results
-// Requires HDF5 C library + HighFive header-only wrapper
+// Requires the HDF5 C library (CONTAM_ENABLE_HDF5)
 class Hdf5Writer {
 public:
     // Write steady-state results to HDF5 file
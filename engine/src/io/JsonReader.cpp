@@ -9,26 +9,150 @@
 #include "elements/CheckValve.h"
 #include "elements/SimpleGaseousFilter.h"
 #include "elements/UVGIFilter.h"
+#include "utils/MappedFile.h"
 #include <nlohmann/json.hpp>
-#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <memory>
 #include <stdexcept>
+#include <unordered_map>
 
 using json = nlohmann::json;
 
 namespace contam {
 
-Network JsonReader::readFromFile(const std::string& filepath) {
-    std::ifstream ifs(filepath);
-    if (!ifs.is_open()) {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Map the file and parse it into a single DOM (no intermediate string copy)
+json parseFile(const std::string& filepath, JsonLoadStats& stats) {
+    MappedFile file;
+    try {
+        file.open(filepath);
+    } catch (const std::runtime_error&) {
         throw std::runtime_error("Cannot open file: " + filepath);
     }
-    json j;
-    ifs >> j;
-    return readFromString(j.dump());
+    auto start = Clock::now();
+    json j = json::parse(file.data(), file.data() + file.size());
+    stats.bytes = file.size();
+    stats.parseSeconds = secondsSince(start);
+    return j;
 }
 
-Network JsonReader::readFromString(const std::string& jsonStr) {
+json parseString(const std::string& jsonStr, JsonLoadStats& stats) {
+    auto start = Clock::now();
     json j = json::parse(jsonStr);
+    stats.bytes = jsonStr.size();
+    stats.parseSeconds = secondsSince(start);
+    return j;
+}
+
+// Build a flow element from its JSON definition. Returns nullptr for types
+// this engine does not construct (and for incomplete gaseous filter tables).
+std::unique_ptr<FlowElement> createFlowElement(json& elemDef) {
+    std::string elemType = elemDef["type"].get<std::string>();
+    if (elemType == "PowerLawOrifice") {
+        if (elemDef.contains("leakageArea")) {
+            // ASHRAE Effective Leakage Area conversion
+            double ela = elemDef["leakageArea"].get<double>();
+            double n = elemDef.value("n", 0.65);
+            double dpRef = elemDef.value("dPref", 4.0);
+            auto plo = PowerLawOrifice::fromLeakageArea(ela, n, dpRef);
+            return std::make_unique<PowerLawOrifice>(plo);
+        } else if (elemDef.contains("orificeArea")) {
+            // Equivalent orifice area conversion
+            double area = elemDef["orificeArea"].get<double>();
+            double cd = elemDef.value("Cd", 0.6);
+            auto plo = PowerLawOrifice::fromOrificeArea(area, cd);
+            return std::make_unique<PowerLawOrifice>(plo);
+        } else {
+            double C = elemDef["C"].get<double>();
+            double n = elemDef["n"].get<double>();
+            return std::make_unique<PowerLawOrifice>(C, n);
+        }
+    } else if (elemType == "Fan") {
+        if (elemDef.contains("coeffs")) {
+            auto coeffs = elemDef["coeffs"].get<std::vector<double>>();
+            return std::make_unique<Fan>(coeffs);
+        } else {
+            double maxFlow = elemDef["maxFlow"].get<double>();
+            double shutoffPressure = elemDef["shutoffPressure"].get<double>();
+            return std::make_unique<Fan>(maxFlow, shutoffPressure);
+        }
+    } else if (elemType == "TwoWayFlow") {
+        double Cd = elemDef["Cd"].get<double>();
+        double area = elemDef["area"].get<double>();
+        double height = elemDef.value("height", 2.0);
+        double width = elemDef.value("width", 0.0);
+        return std::make_unique<TwoWayFlow>(Cd, area, height, width);
+    } else if (elemType == "Duct") {
+        double length = elemDef["length"].get<double>();
+        double diameter = elemDef["diameter"].get<double>();
+        double roughness = elemDef.value("roughness", 0.0001);
+        double sumK = elemDef.value("sumK", 0.0);
+        return std::make_unique<Duct>(length, diameter, roughness, sumK);
+    } else if (elemType == "Damper") {
+        double Cmax = elemDef["Cmax"].get<double>();
+        double n = elemDef["n"].get<double>();
+        double fraction = elemDef.value("fraction", 1.0);
+        return std::make_unique<Damper>(Cmax, n, fraction);
+    } else if (elemType == "Filter") {
+        double C = elemDef["C"].get<double>();
+        double n = elemDef["n"].get<double>();
+        double efficiency = elemDef.value("efficiency", 0.9);
+        return std::make_unique<Filter>(C, n, efficiency);
+    } else if (elemType == "SelfRegulatingVent") {
+        double targetFlow = elemDef["targetFlow"].get<double>();
+        double pMin = elemDef.value("pMin", 1.0);
+        double pMax = elemDef.value("pMax", 50.0);
+        return std::make_unique<SelfRegulatingVent>(targetFlow, pMin, pMax);
+    } else if (elemType == "CheckValve") {
+        double C = elemDef["C"].get<double>();
+        double n = elemDef["n"].get<double>();
+        return std::make_unique<CheckValve>(C, n);
+    } else if (elemType == "SimpleGaseousFilter") {
+        double C = elemDef["C"].get<double>();
+        double n = elemDef["n"].get<double>();
+        double breakthrough = elemDef.value("breakthroughThreshold", 0.05);
+        std::vector<SimpleGaseousFilter::LoadingPoint> loadingTable;
+        if (elemDef.contains("loadingTable")) {
+            for (auto& lp : elemDef["loadingTable"]) {
+                loadingTable.push_back({
+                    lp["loading"].get<double>(),
+                    lp["efficiency"].get<double>()
+                });
+            }
+        }
+        if (loadingTable.size() >= 2) {
+            return std::make_unique<SimpleGaseousFilter>(
+                C, n, loadingTable, breakthrough);
+        }
+    } else if (elemType == "UVGIFilter") {
+        double C = elemDef["C"].get<double>();
+        double n = elemDef["n"].get<double>();
+        UVGIFilter::UVGIParams params;
+        params.k = elemDef.value("k", 0.0);
+        params.irradiance = elemDef.value("irradiance", 0.0);
+        params.chamberVolume = elemDef.value("chamberVolume", 0.001);
+        params.agingRate = elemDef.value("agingRate", 0.0);
+        params.lampAgeHours = elemDef.value("lampAgeHours", 0.0);
+        if (elemDef.contains("tempCoeffs")) {
+            params.tempCoeffs = elemDef["tempCoeffs"].get<std::vector<double>>();
+        }
+        if (elemDef.contains("flowCoeffs")) {
+            params.flowCoeffs = elemDef["flowCoeffs"].get<std::vector<double>>();
+        }
+        return std::make_unique<UVGIFilter>(C, n, params);
+    }
+    return nullptr;
+}
+
+Network buildNetwork(json& j, JsonLoadStats& stats) {
     Network network;
 
     // Parse ambient conditions
@@ -48,13 +172,13 @@ Network JsonReader::readFromString(const std::string& jsonStr) {
         }
     }
 
-    // Parse flow element definitions (reusable templates)
-    std::unordered_map<std::string, json> elementDefs;
-    if (j.contains("flowElements")) {
-        for (auto& [key, val] : j["flowElements"].items()) {
-            elementDefs[key] = val;
-        }
+    // Flow element definitions (reusable templates). Each template is built on
+    // first reference and the instance is shared by all links that use it.
+    json* elementDefs = nullptr;
+    if (j.contains("flowElements") && j["flowElements"].is_object()) {
+        elementDefs = &j["flowElements"];
     }
+    std::unordered_map<std::string, std::shared_ptr<const FlowElement>> sharedElements;
 
     // Parse nodes
     if (j.contains("nodes")) {
@@ -128,114 +252,28 @@ Network JsonReader::readFromString(const std::string& jsonStr) {
             // Create flow element
             if (jLink.contains("element")) {
                 auto& elemRef = jLink["element"];
-                json elemDef;
 
                 if (elemRef.is_string()) {
                     // Reference to a named element definition
                     std::string ref = elemRef.get<std::string>();
-                    if (elementDefs.count(ref)) {
-                        elemDef = elementDefs[ref];
-                    } else {
-                        throw std::runtime_error("Unknown flow element reference: " + ref);
-                    }
-                } else {
-                    // Inline definition
-                    elemDef = elemRef;
-                }
-
-                std::string elemType = elemDef["type"].get<std::string>();
-                if (elemType == "PowerLawOrifice") {
-                    if (elemDef.contains("leakageArea")) {
-                        // ASHRAE Effective Leakage Area conversion
-                        double ela = elemDef["leakageArea"].get<double>();
-                        double n = elemDef.value("n", 0.65);
-                        double dpRef = elemDef.value("dPref", 4.0);
-                        auto plo = PowerLawOrifice::fromLeakageArea(ela, n, dpRef);
-                        link.setFlowElement(std::make_unique<PowerLawOrifice>(plo));
-                    } else if (elemDef.contains("orificeArea")) {
-                        // Equivalent orifice area conversion
-                        double area = elemDef["orificeArea"].get<double>();
-                        double cd = elemDef.value("Cd", 0.6);
-                        auto plo = PowerLawOrifice::fromOrificeArea(area, cd);
-                        link.setFlowElement(std::make_unique<PowerLawOrifice>(plo));
-                    } else {
-                        double C = elemDef["C"].get<double>();
-                        double n = elemDef["n"].get<double>();
-                        link.setFlowElement(std::make_unique<PowerLawOrifice>(C, n));
-                    }
-                } else if (elemType == "Fan") {
-                    if (elemDef.contains("coeffs")) {
-                        auto coeffs = elemDef["coeffs"].get<std::vector<double>>();
-                        link.setFlowElement(std::make_unique<Fan>(coeffs));
-                    } else {
-                        double maxFlow = elemDef["maxFlow"].get<double>();
-                        double shutoffPressure = elemDef["shutoffPressure"].get<double>();
-                        link.setFlowElement(std::make_unique<Fan>(maxFlow, shutoffPressure));
-                    }
-                } else if (elemType == "TwoWayFlow") {
-                    double Cd = elemDef["Cd"].get<double>();
-                    double area = elemDef["area"].get<double>();
-                    double height = elemDef.value("height", 2.0);
-                    double width = elemDef.value("width", 0.0);
-                    link.setFlowElement(std::make_unique<TwoWayFlow>(Cd, area, height, width));
-                } else if (elemType == "Duct") {
-                    double length = elemDef["length"].get<double>();
-                    double diameter = elemDef["diameter"].get<double>();
-                    double roughness = elemDef.value("roughness", 0.0001);
-                    double sumK = elemDef.value("sumK", 0.0);
-                    link.setFlowElement(std::make_unique<Duct>(length, diameter, roughness, sumK));
-                } else if (elemType == "Damper") {
-                    double Cmax = elemDef["Cmax"].get<double>();
-                    double n = elemDef["n"].get<double>();
-                    double fraction = elemDef.value("fraction", 1.0);
-                    link.setFlowElement(std::make_unique<Damper>(Cmax, n, fraction));
-                } else if (elemType == "Filter") {
-                    double C = elemDef["C"].get<double>();
-                    double n = elemDef["n"].get<double>();
-                    double efficiency = elemDef.value("efficiency", 0.9);
-                    link.setFlowElement(std::make_unique<Filter>(C, n, efficiency));
-                } else if (elemType == "SelfRegulatingVent") {
-                    double targetFlow = elemDef["targetFlow"].get<double>();
-                    double pMin = elemDef.value("pMin", 1.0);
-                    double pMax = elemDef.value("pMax", 50.0);
-                    link.setFlowElement(std::make_unique<SelfRegulatingVent>(targetFlow, pMin, pMax));
-                } else if (elemType == "CheckValve") {
-                    double C = elemDef["C"].get<double>();
-                    double n = elemDef["n"].get<double>();
-                    link.setFlowElement(std::make_unique<CheckValve>(C, n));
-                } else if (elemType == "SimpleGaseousFilter") {
-                    double C = elemDef["C"].get<double>();
-                    double n = elemDef["n"].get<double>();
-                    double breakthrough = elemDef.value("breakthroughThreshold", 0.05);
-                    std::vector<SimpleGaseousFilter::LoadingPoint> loadingTable;
-                    if (elemDef.contains("loadingTable")) {
-                        for (auto& lp : elemDef["loadingTable"]) {
-                            loadingTable.push_back({
-                                lp["loading"].get<double>(),
-                                lp["efficiency"].get<double>()
-                            });
+                    auto it = sharedElements.find(ref);
+                    if (it == sharedElements.end()) {
+                        if (!elementDefs || !elementDefs->contains(ref)) {
+                            throw std::runtime_error("Unknown flow element reference: " + ref);
                         }
+                        std::shared_ptr<const FlowElement> elem = createFlowElement((*elementDefs)[ref]);
+                        it = sharedElements.emplace(ref, std::move(elem)).first;
+                        ++stats.flowElementTemplates;
                     }
-                    if (loadingTable.size() >= 2) {
-                        link.setFlowElement(std::make_unique<SimpleGaseousFilter>(
-                            C, n, loadingTable, breakthrough));
-                    }
-                } else if (elemType == "UVGIFilter") {
-                    double C = elemDef["C"].get<double>();
-                    double n = elemDef["n"].get<double>();
-                    UVGIFilter::UVGIParams params;
-                    params.k = elemDef.value("k", 0.0);
-                    params.irradiance = elemDef.value("irradiance", 0.0);
-                    params.chamberVolume = elemDef.value("chamberVolume", 0.001);
-                    params.agingRate = elemDef.value("agingRate", 0.0);
-                    params.lampAgeHours = elemDef.value("lampAgeHours", 0.0);
-                    if (elemDef.contains("tempCoeffs")) {
-                        params.tempCoeffs = elemDef["tempCoeffs"].get<std::vector<double>>();
+                    if (it->second) {
+                        link.setSharedFlowElement(it->second);
+                        ++stats.sharedElementLinks;
                     }
-                    if (elemDef.contains("flowCoeffs")) {
-                        params.flowCoeffs = elemDef["flowCoeffs"].get<std::vector<double>>();
+                } else {
+                    // Inline definition
+                    if (auto elem = createFlowElement(elemRef)) {
+                        link.setFlowElement(std::move(elem));
                     }
-                    link.setFlowElement(std::make_unique<UVGIFilter>(C, n, params));
                 }
             }
 
@@ -246,22 +284,51 @@ Network JsonReader::readFromString(const std::string& jsonStr) {
     return network;
 }
 
-ModelInput JsonReader::readModelFromFile(const std::string& filepath) {
-    std::ifstream ifs(filepath);
-    if (!ifs.is_open()) {
-        throw std::runtime_error("Cannot open file: " + filepath);
+Source parseSource(const json& jsrc) {
+    Source src;
+    src.zoneId = jsrc.at("zoneId").get<int>();
+    src.speciesId = jsrc.at("speciesId").get<int>();
+    src.generationRate = jsrc.value("generationRate", 0.0);
+    src.removalRate = jsrc.value("removalRate", 0.0);
+    src.scheduleId = jsrc.value("scheduleId", -1);
+
+    std::string srcType = jsrc.value("type", "Constant");
+    if (srcType == "ExponentialDecay") {
+        src.type = SourceType::ExponentialDecay;
+        src.decayTimeConstant = jsrc.value("decayTimeConstant", 3600.0);
+        src.startTime = jsrc.value("startTime", 0.0);
+        src.multiplier = jsrc.value("multiplier", 1.0);
+    } else if (srcType == "PressureDriven") {
+        src.type = SourceType::PressureDriven;
+        src.pressureCoeff = jsrc.value("pressureCoeff", 0.0);
+    } else if (srcType == "CutoffConcentration") {
+        src.type = SourceType::CutoffConcentration;
+        src.cutoffConc = jsrc.value("cutoffConcentration", 0.0);
+    } else if (srcType == "Burst") {
+        src.type = SourceType::Burst;
+        src.burstMass = jsrc.value("burstMass", 0.0);
+        src.burstTime = jsrc.value("burstTime", 0.0);
+        src.burstDuration = jsrc.value("burstDuration", 1.0);
     }
-    json j;
-    ifs >> j;
-    return readModelFromString(j.dump());
+    return src;
 }
 
-ModelInput JsonReader::readModelFromString(const std::string& jsonStr) {
-    ModelInput model;
-    json j = json::parse(jsonStr);
+Schedule parseSchedule(const json& jsch) {
+    int id = jsch.at("id").get<int>();
+    Schedule sch(id, jsch.value("name", "Schedule_" + std::to_string(id)));
+    if (jsch.contains("points")) {
+        for (auto& jp : jsch["points"]) {
+            sch.addPoint(jp.at("time").get<double>(), jp.at("value").get<double>());
+        }
+    }
+    return sch;
+}
 
-    // Parse network (reuse existing logic via readFromString)
-    model.network = readFromString(jsonStr);
+ModelInput buildModel(json& j, const JsonLoadStats& parseStats) {
+    auto start = Clock::now();
+    ModelInput model;
+    model.loadStats = parseStats;
+    model.network = buildNetwork(j, model.loadStats);
 
     // Parse species
     if (j.contains("species")) {
@@ -283,47 +350,15 @@ ModelInput JsonReader::readModelFromString(const std::string& jsonStr) {
     // Parse sources
     if (j.contains("sources")) {
         for (auto& jsrc : j["sources"]) {
-            Source src;
-            src.zoneId = jsrc["zoneId"].get<int>();
-            src.speciesId = jsrc["speciesId"].get<int>();
-            src.generationRate = jsrc.value("generationRate", 0.0);
-            src.removalRate = jsrc.value("removalRate", 0.0);
-            src.scheduleId = jsrc.value("scheduleId", -1);
-
-            std::string srcType = jsrc.value("type", "Constant");
-            if (srcType == "ExponentialDecay") {
-                src.type = SourceType::ExponentialDecay;
-                src.decayTimeConstant = jsrc.value("decayTimeConstant", 3600.0);
-                src.startTime = jsrc.value("startTime", 0.0);
-                src.multiplier = jsrc.value("multiplier", 1.0);
-            } else if (srcType == "PressureDriven") {
-                src.type = SourceType::PressureDriven;
-                src.pressureCoeff = jsrc.value("pressureCoeff", 0.0);
-            } else if (srcType == "CutoffConcentration") {
-                src.type = SourceType::CutoffConcentration;
-                src.cutoffConc = jsrc.value("cutoffConcentration", 0.0);
-            } else if (srcType == "Burst") {
-                src.type = SourceType::Burst;
-                src.burstMass = jsrc.value("burstMass", 0.0);
-                src.burstTime = jsrc.value("burstTime", 0.0);
-                src.burstDuration = jsrc.value("burstDuration", 1.0);
-            }
-
-            model.sources.push_back(src);
+            model.sources.push_back(parseSource(jsrc));
         }
     }
 
     // Parse schedules
     if (j.contains("schedules")) {
         for (auto& jsch : j["schedules"]) {
-            int id = jsch["id"].get<int>();
-            Schedule sch(id, jsch.value("name", "Schedule_" + std::to_string(id)));
-            if (jsch.contains("points")) {
-                for (auto& jp : jsch["points"]) {
-                    sch.addPoint(jp["time"].get<double>(), jp["value"].get<double>());
-                }
-            }
-            model.schedules[id] = sch;
+            Schedule sch = parseSchedule(jsch);
+            model.schedules[sch.id] = sch;
         }
     }
 
@@ -347,12 +382,59 @@ ModelInput JsonReader::readModelFromString(const std::string& jsonStr) {
         model.transientConfig.endTime = jt.value("endTime", 3600.0);
         model.transientConfig.timeStep = jt.value("timeStep", 60.0);
         model.transientConfig.outputInterval = jt.value("outputInterval", 60.0);
+        model.transientConfig.threads = static_cast<unsigned>(std::max(0, jt.value("threads", 0)));
         std::string method = jt.value("airflowMethod", "trustRegion");
         if (method == "subRelaxation") {
             model.transientConfig.airflowMethod = SolverMethod::SubRelaxation;
         }
     }
 
+    // Parse output selection:
+    //   "output": { "nodes": [ids], "links": [ids], "species": [ids],
+    //               "intervals": { "pressure": s, "massFlow": s, "concentration": s },
+    //               "window": { "start": s, "end": s },
+    //               "precision": "double" | "float32" | "quantized",
+    //               "significantDigits": n }
+    if (j.contains("output")) {
+        auto& jo = j["output"];
+        auto& spec = model.outputSpec;
+        spec.nodeIds = jo.value("nodes", std::vector<int>{});
+        spec.linkIds = jo.value("links", std::vector<int>{});
+        spec.speciesIds = jo.value("species", std::vector<int>{});
+        if (jo.contains("intervals")) {
+            auto& ji = jo["intervals"];
+            spec.pressureInterval = ji.value("pressure", 0.0);
+            spec.massFlowInterval = ji.value("massFlow", 0.0);
+            spec.concentrationInterval = ji.value("concentration", 0.0);
+        }
+        if (jo.contains("window")) {
+            auto& jw = jo["window"];
+            spec.windowStart = jw.value("start", spec.windowStart);
+            spec.windowEnd = jw.value("end", spec.windowEnd);
+        }
+        spec.precision = parseOutputPrecision(jo.value("precision", "double"));
+        spec.significantDigits = jo.value("significantDigits", spec.significantDigits);
+    }
+
+    // Parse parametric sweep (see SweepSpec)
+    if (j.contains("sweep")) {
+        auto& js = j["sweep"];
+        auto& sweep = model.sweep;
+        sweep.method = parseSweepMethod(js.value("method", "grid"));
+        sweep.samples = js.value("samples", 0);
+        sweep.seed = js.value("seed", uint64_t{1});
+        for (auto& jp : js.at("parameters")) {
+            SweepParameter p;
+            p.name = jp.at("name").get<std::string>();
+            p.values = jp.value("values", std::vector<double>{});
+            p.min = jp.value("min", 0.0);
+            p.max = jp.value("max", p.min);
+            p.steps = jp.value("steps", 0);
+            p.logScale = jp.value("scale", "linear") == "log";
+            sweep.parameters.push_back(std::move(p));
+        }
+    }
+
     // Parse weather data
     if (j.contains("weather") && j["weather"].contains("records")) {
         for (auto& jw : j["weather"]["records"]) {
@@ -420,7 +502,55 @@ ModelInput JsonReader::readModelFromString(const std::string& jsonStr) {
         }
     }
 
+    model.loadStats.buildSeconds = secondsSince(start);
     return model;
 }
 
+} // namespace
+
+Network JsonReader::readFromFile(const std::string& filepath) {
+    JsonLoadStats stats;
+    json j = parseFile(filepath, stats);
+    return buildNetwork(j, stats);
+}
+
+Network JsonReader::readFromString(const std::string& jsonStr) {
+    JsonLoadStats stats;
+    json j = parseString(jsonStr, stats);
+    return buildNetwork(j, stats);
+}
+
+ModelInput JsonReader::readModelFromFile(const std::string& filepath) {
+    JsonLoadStats stats;
+    json j = parseFile(filepath, stats);
+    return buildModel(j, stats);
+}
+
+ModelInput JsonReader::readModelFromString(const std::string& jsonStr) {
+    JsonLoadStats stats;
+    json j = parseString(jsonStr, stats);
+    return buildModel(j, stats);
+}
+
+ModelInput JsonReader::readModelFromJson(json& j) {
+    return buildModel(j, JsonLoadStats{});
+}
+
+std::unique_ptr<FlowElement> JsonReader::readFlowElement(const json& j) {
+    json def = j;
+    auto element = createFlowElement(def);
+    if (!element) {
+        throw std::runtime_error("Unsupported flow element type: " + j.value("type", std::string()));
+    }
+    return element;
+}
+
+Source JsonReader::readSource(const json& j) {
+    return parseSource(j);
+}
+
+Schedule JsonReader::readSchedule(const json& j) {
+    return parseSchedule(j);
+}
+
 } // namespace contam
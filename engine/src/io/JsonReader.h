@@ -6,13 +6,33 @@
 #include "core/TransientSimulation.h"
 #include "core/SimpleAHS.h"
 #include "core/Occupant.h"
+#include "core/Sweep.h"
 #include "io/WeatherReader.h"
+#include <nlohmann/json_fwd.hpp>
+#include <memory>
 #include <string>
 #include <vector>
 #include <map>
 
 namespace contam {
 
+// Load statistics for a parsed model (filled by the JsonReader model loaders)
+struct JsonLoadStats {
+    size_t bytes = 0;              // size of the JSON text
+    double parseSeconds = 0.0;     // JSON text -> DOM
+    double buildSeconds = 0.0;     // DOM -> Network/ModelInput
+    int flowElementTemplates = 0;  // named flowElements built once
+    int sharedElementLinks = 0;    // links referencing a shared template
+    bool fromCache = false;        // loaded from a compiled ModelCache file
+
+    double totalSeconds() const { return parseSeconds + buildSeconds; }
+    // Parse throughput in MB/s (0 when too fast to measure)
+    double throughputMBps() const {
+        double t = totalSeconds();
+        return t > 0.0 ? (static_cast<double>(bytes) / (1024.0 * 1024.0)) / t : 0.0;
+    }
+};
+
 struct ModelInput {
     Network network;
     std::vector<Species> species;
@@ -21,11 +41,17 @@ struct ModelInput {
     std::map<int, int> zoneTemperatureSchedules;  // nodeIdx -> scheduleId
     TransientConfig transientConfig;
     bool hasTransient = false;
+    OutputSpec outputSpec;
     std::vector<WeatherRecord> weatherData;
     std::vector<SimpleAHS> ahSystems;
     std::vector<Occupant> occupants;
+    SweepSpec sweep;
+    JsonLoadStats loadStats;
 };
 
+// The file loaders map the input and parse it into a single DOM; the model is
+// built straight from that DOM. Named flowElements templates are constructed
+// once and shared by every link that references them.
 class JsonReader {
 public:
     // Parse a JSON topology file and build a Network
@@ -35,6 +61,14 @@ public:
     // Parse full model including contaminant and transient config
     static ModelInput readModelFromFile(const std::string& filepath);
     static ModelInput readModelFromString(const std::string& jsonStr);
+    // Build from an already parsed document (e.g. part of a larger message)
+    static ModelInput readModelFromJson(nlohmann::json& j);
+
+    // Single model parts, in the same format as inside a model file. Used to
+    // patch a loaded model. readFlowElement throws for unsupported types.
+    static std::unique_ptr<FlowElement> readFlowElement(const nlohmann::json& j);
+    static Source readSource(const nlohmann::json& j);
+    static Schedule readSchedule(const nlohmann::json& j);
 };
 
 } // namespace contam
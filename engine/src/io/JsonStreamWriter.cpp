@@ -0,0 +1,323 @@
+#include "io/JsonStreamWriter.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace contam {
+
+static constexpr std::size_t FLUSH_THRESHOLD = 1 << 20;  // bytes buffered before writing
+
+JsonStreamWriter::JsonStreamWriter(const std::string& filepath, const JsonStreamOptions& options)
+    : file_(filepath, std::ios::binary), out_(&file_), options_(options) {
+    if (!file_.is_open()) {
+        throw std::runtime_error("Cannot open output file: " + filepath);
+    }
+}
+
+JsonStreamWriter::JsonStreamWriter(std::ostream& out, const JsonStreamOptions& options)
+    : out_(&out), options_(options) {
+}
+
+JsonStreamWriter::~JsonStreamWriter() {
+    if (!open_) return;
+    try {
+        end(false);
+    } catch (...) {
+        // Nothing more can be written
+    }
+}
+
+// ── ResultSink ───────────────────────────────────────────────────────
+
+void JsonStreamWriter::begin(const Network& network, const std::vector<Species>& species,
+                             const OutputSelection& output) {
+    buf_.reserve(FLUSH_THRESHOLD + 4096);
+    steps_ = 0;
+    historyDropped_ = false;
+    hasMember_.clear();
+    output_ = output;
+    float32_ = output.precision() == OutputPrecision::Float32;
+    openObject();
+
+    key("nodes");
+    openArray();
+    for (std::size_t k = 0; k < output.nodeCount(network); ++k) {
+        const auto& node = network.getNode(output.node(k));
+        separator();
+        openObject();
+        key("id");
+        number(static_cast<long long>(node.getId()));
+        key("name");
+        string(node.getName());
+        key("type");
+        string(node.isKnownPressure() ? "ambient" : "normal");
+        close('}');
+    }
+    close(']');
+
+    if (output.filtersLinks()) {
+        key("links");
+        openArray();
+        for (std::size_t k = 0; k < output.linkCount(network); ++k) {
+            const auto& link = network.getLink(output.link(k));
+            separator();
+            openObject();
+            key("from");
+            number(static_cast<long long>(network.getNode(link.getNodeFrom()).getId()));
+            key("id");
+            number(static_cast<long long>(link.getId()));
+            key("to");
+            number(static_cast<long long>(network.getNode(link.getNodeTo()).getId()));
+            close('}');
+        }
+        close(']');
+    }
+
+    key("species");
+    openArray();
+    for (std::size_t k = 0; k < output.speciesCount(species); ++k) {
+        const auto& sp = species[output.species(k)];
+        separator();
+        openObject();
+        key("id");
+        number(static_cast<long long>(sp.id));
+        key("molarMass");
+        number(sp.molarMass);
+        key("name");
+        string(sp.name);
+        close('}');
+    }
+    close(']');
+
+    key("timeSeries");
+    openArray();
+    open_ = true;
+    flush();
+}
+
+void JsonStreamWriter::onStep(const TimeStepResult& step) {
+    separator();
+    openObject();
+
+    key("airflow");
+    openObject();
+    key("converged");
+    boolean(step.airflow.converged);
+    key("iterations");
+    number(static_cast<long long>(step.airflow.iterations));
+    if (output_.hasMassFlows(step)) {
+        key("massFlows");
+        numberArray(step.airflow.massFlows);
+    }
+    if (output_.hasPressures(step)) {
+        key("pressures");
+        numberArray(step.airflow.pressures);
+    }
+    close('}');
+
+    // Concentrations [nodeIdx][speciesIdx]
+    if (!step.contaminant.concentrations.empty()) {
+        key("concentrations");
+        openArray();
+        for (const auto& nodeConcs : step.contaminant.concentrations) {
+            separator();
+            numberArray(nodeConcs);
+        }
+        close(']');
+    }
+
+    key("time");
+    number(step.time);
+    close('}');
+
+    ++steps_;
+    flush();
+}
+
+std::size_t JsonStreamWriter::memoryBytes() const {
+    return buf_.capacity() + hasMember_.capacity() / 8;
+}
+
+std::size_t JsonStreamWriter::expectedMemoryBytes() const {
+    return std::max(memoryBytes(), FLUSH_THRESHOLD + 4096);
+}
+
+void JsonStreamWriter::end(bool completed) {
+    if (!open_) return;
+    open_ = false;
+    close(']');  // timeSeries
+    key("completed");
+    boolean(completed);
+    key("totalSteps");
+    number(static_cast<long long>(steps_));
+    if (historyDropped_) {
+        key("historyDropped");
+        boolean(true);
+    }
+    if (profile_) {
+        key("profile");
+        document(profile_->summary());
+    }
+    if (diagnostics_) {
+        key("convergence");
+        document(diagnostics_->report());
+    }
+    if (memory_) {
+        key("memory");
+        document(memory_->summary());
+    }
+    close('}');
+    flush(true);
+    out_->flush();
+    if (!*out_) {
+        throw std::runtime_error("Failed writing JSON results");
+    }
+}
+
+// ── Whole-result helpers ─────────────────────────────────────────────
+
+void JsonStreamWriter::writeTransient(std::ostream& out, const Network& network,
+                                      const TransientResult& result,
+                                      const std::vector<Species>& species,
+                                      const JsonStreamOptions& options) {
+    JsonStreamWriter writer(out, options);
+    writer.begin(network, species, result.output);
+    for (const auto& step : result.history) writer.onStep(step);
+    writer.end(result.completed);
+}
+
+void JsonStreamWriter::writeTransientToFile(const std::string& filepath, const Network& network,
+                                            const TransientResult& result,
+                                            const std::vector<Species>& species,
+                                            const JsonStreamOptions& options) {
+    JsonStreamWriter writer(filepath, options);
+    writer.begin(network, species, result.output);
+    for (const auto& step : result.history) writer.onStep(step);
+    writer.end(result.completed);
+}
+
+// ── Emitter ──────────────────────────────────────────────────────────
+
+void JsonStreamWriter::document(const nlohmann::json& value) {
+    std::string text = value.dump(options_.minify ? -1 : options_.indent);
+    if (!options_.minify) {
+        // Indent the nested lines to the member's depth
+        const std::string pad(hasMember_.size() * static_cast<std::size_t>(options_.indent), ' ');
+        for (std::size_t at = text.find('\n'); at != std::string::npos; at = text.find('\n', at + 1)) {
+            text.insert(at + 1, pad);
+        }
+    }
+    buf_ += text;
+}
+
+void JsonStreamWriter::flush(bool force) {
+    if (buf_.empty() || (!force && buf_.size() < FLUSH_THRESHOLD)) return;
+    out_->write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+    buf_.clear();
+}
+
+void JsonStreamWriter::newline() {
+    if (options_.minify) return;
+    buf_ += '\n';
+    buf_.append(hasMember_.size() * static_cast<std::size_t>(options_.indent), ' ');
+}
+
+void JsonStreamWriter::separator() {
+    if (hasMember_.back()) buf_ += ',';
+    hasMember_.back() = true;
+    newline();
+}
+
+void JsonStreamWriter::key(const char* name) {
+    separator();
+    buf_ += '"';
+    buf_ += name;
+    buf_ += options_.minify ? "\":" : "\": ";
+}
+
+void JsonStreamWriter::openObject() {
+    buf_ += '{';
+    hasMember_.push_back(false);
+}
+
+void JsonStreamWriter::openArray() {
+    buf_ += '[';
+    hasMember_.push_back(false);
+}
+
+void JsonStreamWriter::close(char bracket) {
+    bool hadMembers = hasMember_.back();
+    hasMember_.pop_back();
+    if (hadMembers) newline();
+    buf_ += bracket;
+}
+
+void JsonStreamWriter::number(double v) {
+    if (!std::isfinite(v)) {
+        buf_ += "null";
+        return;
+    }
+    char tmp[32];
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    char* end = float32_ ? std::to_chars(tmp, tmp + sizeof(tmp), static_cast<float>(v)).ptr
+                         : std::to_chars(tmp, tmp + sizeof(tmp), v).ptr;
+#else
+    // Fallback for standard libraries without floating-point to_chars
+    char* end = tmp + std::snprintf(tmp, sizeof(tmp), "%.*g", float32_ ? 9 : 17, v);
+#endif
+    buf_.append(tmp, end);
+    // Keep integral values recognisable as floating point ("60.0"), as the DOM writer does
+    if (std::memchr(tmp, '.', end - tmp) == nullptr && std::memchr(tmp, 'e', end - tmp) == nullptr) {
+        buf_ += ".0";
+    }
+}
+
+void JsonStreamWriter::number(long long v) {
+    char tmp[24];
+    char* end = std::to_chars(tmp, tmp + sizeof(tmp), v).ptr;
+    buf_.append(tmp, end);
+}
+
+void JsonStreamWriter::boolean(bool v) {
+    buf_ += v ? "true" : "false";
+}
+
+void JsonStreamWriter::string(const std::string& s) {
+    static const char* HEX = "0123456789abcdef";
+    buf_ += '"';
+    for (char c : s) {
+        switch (c) {
+        case '"':  buf_ += "\\\""; break;
+        case '\\': buf_ += "\\\\"; break;
+        case '\b': buf_ += "\\b"; break;
+        case '\f': buf_ += "\\f"; break;
+        case '\n': buf_ += "\\n"; break;
+        case '\r': buf_ += "\\r"; break;
+        case '\t': buf_ += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                buf_ += "\\u00";
+                buf_ += HEX[(c >> 4) & 0xF];
+                buf_ += HEX[c & 0xF];
+            } else {
+                buf_ += c;
+            }
+        }
+    }
+    buf_ += '"';
+}
+
+void JsonStreamWriter::numberArray(const std::vector<double>& values) {
+    openArray();
+    for (double v : values) {
+        separator();
+        number(v);
+    }
+    close(']');
+}
+
+} // namespace contam
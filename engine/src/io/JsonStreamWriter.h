@@ -0,0 +1,105 @@
+#pragma once
+#include "core/ResultSink.h"
+#include "core/TransientSimulation.h"
+#include "utils/Profiler.h"
+#include <nlohmann/json_fwd.hpp>
+#include <cstddef>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace contam {
+
+struct JsonStreamOptions {
+    bool minify = false;   // no whitespace; otherwise indented like JsonWriter
+    int indent = 2;
+};
+
+// Streaming writer for transient results. Produces the same document as
+// JsonWriter::writeTransientToString (completed, totalSteps, species, nodes,
+// timeSeries) without building a DOM: steps are formatted as they arrive and
+// flushed in large chunks. "completed" and "totalSteps" are written after
+// "timeSeries" because they are only known at the end of the run, as is
+// the optional "historyDropped" flag and the "profile" and "convergence"
+// reports that follow them. A document the run never ended (the simulation
+// threw, or the writer is destroyed first) is closed with "completed": false,
+// so the file is always valid JSON.
+//
+// Numbers use the shortest round-trip representation (of the float value
+// when the output precision is float32); non-finite values are written as
+// null. With an output selection, "nodes"/"species" list the recorded
+// entities, a "links" table is added when links are filtered, and variables
+// that were not due at a step are omitted from it.
+//
+//   auto writer = std::make_shared<JsonStreamWriter>("results.json");
+//   sim.addResultSink(writer);
+//   sim.setStoreHistory(false);
+//   sim.run(network);
+class JsonStreamWriter : public ResultSink {
+public:
+    explicit JsonStreamWriter(const std::string& filepath, const JsonStreamOptions& options = {});
+    // Write to a caller-owned stream (e.g. std::cout)
+    explicit JsonStreamWriter(std::ostream& out, const JsonStreamOptions& options = {});
+    ~JsonStreamWriter() override;
+
+    void begin(const Network& network, const std::vector<Species>& species,
+               const OutputSelection& output) override;
+    void onStep(const TimeStepResult& step) override;
+    void onHistoryDropped() override { historyDropped_ = true; }
+    void end(bool completed) override;
+    std::size_t memoryBytes() const override;
+    std::size_t expectedMemoryBytes() const override;
+
+    std::size_t stepCount() const { return steps_; }
+
+    // Append the profiler's summary as "profile", the convergence report
+    // as "convergence" and the memory summary as "memory" when the document
+    // ends
+    void setProfile(const Profiler* profiler) { profile_ = profiler; }
+    void setDiagnostics(const ConvergenceDiagnostics* diagnostics) { diagnostics_ = diagnostics; }
+    void setMemory(const MemoryTracker* memory) { memory_ = memory; }
+
+    // Stream an already collected result (same output as the sink path)
+    static void writeTransient(std::ostream& out, const Network& network,
+                               const TransientResult& result,
+                               const std::vector<Species>& species,
+                               const JsonStreamOptions& options = {});
+    static void writeTransientToFile(const std::string& filepath, const Network& network,
+                                     const TransientResult& result,
+                                     const std::vector<Species>& species,
+                                     const JsonStreamOptions& options = {});
+
+private:
+    std::ofstream file_;
+    std::ostream* out_;
+    JsonStreamOptions options_;
+    OutputSelection output_;
+    bool float32_ = false;  // format values as single precision
+    std::string buf_;
+    std::size_t steps_ = 0;
+    bool open_ = false;             // begun and not yet ended
+    bool historyDropped_ = false;
+    const Profiler* profile_ = nullptr;
+    const ConvergenceDiagnostics* diagnostics_ = nullptr;
+    const MemoryTracker* memory_ = nullptr;
+
+    // Container nesting: true once the current container has a member
+    std::vector<bool> hasMember_;
+
+    void flush(bool force = false);
+    void newline();
+    void separator();  // comma + newline/indent before a member
+    void key(const char* name);
+    void openObject();
+    void openArray();
+    void close(char bracket);
+    void number(double v);
+    void number(long long v);
+    void boolean(bool v);
+    void string(const std::string& s);
+    void numberArray(const std::vector<double>& values);
+    void document(const nlohmann::json& value);  // a DOM value at the current depth
+};
+
+} // namespace contam
@@ -7,7 +7,11 @@ using json = nlohmann::json;
 namespace contam {
 
 std::string JsonWriter::writeToString(const Network& network,
-                                       const SolverResult& result) {
+                                       const SolverResult& result,
+                                       int indent,
+                                       const Profiler* profile,
+                                       const ConvergenceDiagnostics* diagnostics,
+                                       const MemoryTracker* memory) {
     json j;
 
     // Solver info
@@ -45,30 +49,39 @@ std::string JsonWriter::writeToString(const Network& network,
         linksArr.push_back(jl);
     }
     j["links"] = linksArr;
+    if (profile) j["profile"] = profile->summary();
+    if (diagnostics) j["convergence"] = diagnostics->report();
+    if (memory) j["memory"] = memory->summary();
 
-    return j.dump(2);
+    return j.dump(indent);
 }
 
 void JsonWriter::writeToFile(const std::string& filepath,
                               const Network& network,
-                              const SolverResult& result) {
+                              const SolverResult& result,
+                              const Profiler* profile,
+                              const ConvergenceDiagnostics* diagnostics,
+                              const MemoryTracker* memory) {
     std::ofstream ofs(filepath);
     if (!ofs.is_open()) {
         throw std::runtime_error("Cannot open output file: " + filepath);
     }
-    ofs << writeToString(network, result);
+    ofs << writeToString(network, result, 2, profile, diagnostics, memory);
 }
 
 std::string JsonWriter::writeTransientToString(const Network& network,
                                                 const TransientResult& result,
                                                 const std::vector<Species>& species) {
+    const OutputSelection& output = result.output;
     json j;
     j["completed"] = result.completed;
     j["totalSteps"] = result.history.size();
+    if (result.historyDropped) j["historyDropped"] = true;
 
     // Species info
     json specArr = json::array();
-    for (const auto& sp : species) {
+    for (size_t k = 0; k < output.speciesCount(species); ++k) {
+        const auto& sp = species[output.species(k)];
         json js;
         js["id"] = sp.id;
         js["name"] = sp.name;
@@ -79,8 +92,8 @@ std::string JsonWriter::writeTransientToString(const Network& network,
 
     // Node info
     json nodeInfo = json::array();
-    for (int i = 0; i < network.getNodeCount(); ++i) {
-        const auto& node = network.getNode(i);
+    for (size_t k = 0; k < output.nodeCount(network); ++k) {
+        const auto& node = network.getNode(output.node(k));
         json jn;
         jn["id"] = node.getId();
         jn["name"] = node.getName();
@@ -89,6 +102,20 @@ std::string JsonWriter::writeTransientToString(const Network& network,
     }
     j["nodes"] = nodeInfo;
 
+    // Link info, only needed to label a link subset
+    if (output.filtersLinks()) {
+        json linkInfo = json::array();
+        for (size_t k = 0; k < output.linkCount(network); ++k) {
+            const auto& link = network.getLink(output.link(k));
+            json jl;
+            jl["id"] = link.getId();
+            jl["from"] = network.getNode(link.getNodeFrom()).getId();
+            jl["to"] = network.getNode(link.getNodeTo()).getId();
+            linkInfo.push_back(jl);
+        }
+        j["links"] = linkInfo;
+    }
+
     // Time series
     json timeSeriesArr = json::array();
     for (const auto& step : result.history) {
@@ -100,18 +127,22 @@ std::string JsonWriter::writeTransientToString(const Network& network,
         jStep["airflow"]["iterations"] = step.airflow.iterations;
 
         // Pressures
-        json pressures = json::array();
-        for (double p : step.airflow.pressures) {
-            pressures.push_back(p);
+        if (output.hasPressures(step)) {
+            json pressures = json::array();
+            for (double p : step.airflow.pressures) {
+                pressures.push_back(p);
+            }
+            jStep["airflow"]["pressures"] = pressures;
         }
-        jStep["airflow"]["pressures"] = pressures;
 
         // Mass flows
-        json flows = json::array();
-        for (double f : step.airflow.massFlows) {
-            flows.push_back(f);
+        if (output.hasMassFlows(step)) {
+            json flows = json::array();
+            for (double f : step.airflow.massFlows) {
+                flows.push_back(f);
+            }
+            jStep["airflow"]["massFlows"] = flows;
         }
-        jStep["airflow"]["massFlows"] = flows;
 
         // Concentrations [nodeIdx][speciesIdx]
         if (!step.contaminant.concentrations.empty()) {
@@ -144,4 +175,84 @@ void JsonWriter::writeTransientToFile(const std::string& filepath,
     ofs << writeTransientToString(network, result, species);
 }
 
+// Rows of a [node][species] block
+static json nodeSpeciesRows(const std::vector<double>& values, std::size_t numSpecies) {
+    json rows = json::array();
+    if (numSpecies == 0) return rows;
+    for (std::size_t i = 0; i + numSpecies <= values.size(); i += numSpecies) {
+        rows.push_back(std::vector<double>(values.begin() + i, values.begin() + i + numSpecies));
+    }
+    return rows;
+}
+
+std::string JsonWriter::writeSweepToString(const ModelInput& model, const SweepResult& result,
+                                           int indent) {
+    const Network& network = model.network;
+    json j;
+
+    std::size_t ok = 0;
+    for (const auto& v : result.variants) ok += v.ok ? 1 : 0;
+    j["sweep"]["method"] = sweepMethodName(model.sweep.method);
+    j["sweep"]["parameters"] = result.plan.names;
+    j["sweep"]["variants"] = result.plan.numVariants;
+    j["sweep"]["ok"] = ok;
+    j["sweep"]["transient"] = result.transient;
+    j["sweep"]["wallSeconds"] = result.wallSeconds;
+
+    json nodesArr = json::array();
+    for (int i = 0; i < network.getNodeCount(); ++i) {
+        const auto& node = network.getNode(i);
+        nodesArr.push_back({{"id", node.getId()}, {"name", node.getName()}});
+    }
+    j["nodes"] = nodesArr;
+    json linksArr = json::array();
+    for (int i = 0; i < network.getLinkCount(); ++i) {
+        const auto& link = network.getLink(i);
+        linksArr.push_back({{"id", link.getId()},
+                            {"from", network.getNode(link.getNodeFrom()).getId()},
+                            {"to", network.getNode(link.getNodeTo()).getId()}});
+    }
+    j["links"] = linksArr;
+    json specArr = json::array();
+    for (const auto& sp : model.species) specArr.push_back({{"id", sp.id}, {"name", sp.name}});
+    j["species"] = specArr;
+
+    const std::size_t P = result.plan.names.size();
+    json variants = json::array();
+    for (std::size_t v = 0; v < result.variants.size(); ++v) {
+        const auto& r = result.variants[v];
+        json jv;
+        jv["index"] = v;
+        jv["values"] = std::vector<double>(result.plan.row(v), result.plan.row(v) + P);
+        jv[result.transient ? "completed" : "converged"] = r.ok;
+        if (!r.error.empty()) jv["error"] = r.error;
+        if (result.transient) {
+            jv["outputSteps"] = r.outputSteps;
+        } else {
+            jv["iterations"] = r.iterations;
+            jv["maxResidual"] = r.maxResidual;
+        }
+        jv["seconds"] = r.seconds;
+        jv["pressures"] = r.pressures;
+        jv["massFlows"] = r.massFlows;
+        if (result.transient && result.numSpecies > 0) {
+            jv["concentrations"]["peak"] = nodeSpeciesRows(r.peakConcentrations, result.numSpecies);
+            jv["concentrations"]["mean"] = nodeSpeciesRows(r.meanConcentrations, result.numSpecies);
+            jv["concentrations"]["final"] = nodeSpeciesRows(r.finalConcentrations, result.numSpecies);
+        }
+        variants.push_back(std::move(jv));
+    }
+    j["variants"] = std::move(variants);
+    return j.dump(indent);
+}
+
+void JsonWriter::writeSweepToFile(const std::string& filepath, const ModelInput& model,
+                                  const SweepResult& result) {
+    std::ofstream ofs(filepath);
+    if (!ofs.is_open()) {
+        throw std::runtime_error("Cannot open output file: " + filepath);
+    }
+    ofs << writeSweepToString(model, result);
+}
+
 } // namespace contam
@@ -1,9 +1,11 @@
 #pragma once
 
+#include "core/BatchSolve.h"
 #include "core/Network.h"
 #include "core/Solver.h"
 #include "core/TransientSimulation.h"
 #include "core/Species.h"
+#include "utils/Profiler.h"
 #include <string>
 #include <vector>
 
@@ -11,12 +13,22 @@ namespace contam {
 
 class JsonWriter {
 public:
-    // Write steady-state solver results
+    // Write steady-state solver results; with a profiler its summary is
+    // added as "profile", with diagnostics their report as "convergence" and
+    // with a memory tracker its summary as "memory"
     static void writeToFile(const std::string& filepath,
                             const Network& network,
-                            const SolverResult& result);
+                            const SolverResult& result,
+                            const Profiler* profile = nullptr,
+                            const ConvergenceDiagnostics* diagnostics = nullptr,
+                            const MemoryTracker* memory = nullptr);
+    // indent < 0 writes a single line
     static std::string writeToString(const Network& network,
-                                     const SolverResult& result);
+                                     const SolverResult& result,
+                                     int indent = 2,
+                                     const Profiler* profile = nullptr,
+                                     const ConvergenceDiagnostics* diagnostics = nullptr,
+                                     const MemoryTracker* memory = nullptr);
 
     // Write transient simulation results
     static void writeTransientToFile(const std::string& filepath,
@@ -26,6 +38,14 @@ public:
     static std::string writeTransientToString(const Network& network,
                                               const TransientResult& result,
                                               const std::vector<Species>& species);
+
+    // Write per-variant sweep summaries: the expanded parameter values and
+    // each variant's solution (steady) or final state and peak/mean/final
+    // concentrations [node][species] (transient)
+    static void writeSweepToFile(const std::string& filepath, const ModelInput& model,
+                                 const SweepResult& result);
+    static std::string writeSweepToString(const ModelInput& model, const SweepResult& result,
+                                          int indent = 2);
 };
 
 } // namespace contam
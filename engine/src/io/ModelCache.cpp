@@ -0,0 +1,917 @@
+#include "io/ModelCache.h"
+#include "elements/PowerLawOrifice.h"
+#include "elements/Fan.h"
+#include "elements/TwoWayFlow.h"
+#include "elements/Duct.h"
+#include "elements/Damper.h"
+#include "elements/Filter.h"
+#include "elements/SelfRegulatingVent.h"
+#include "elements/CheckValve.h"
+#include "elements/SimpleGaseousFilter.h"
+#include "elements/UVGIFilter.h"
+#include "elements/BackdraftDamper.h"
+#include "elements/QuadraticElement.h"
+#include "elements/ReturnGrille.h"
+#include "elements/SupplyDiffuser.h"
+#include "elements/SimpleParticleFilter.h"
+#include "utils/MappedFile.h"
+#include "utils/ByteStream.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace contam {
+
+namespace {
+
+// ── Flow element parameters ──────────────────────────────────────────
+// Each unique element is stored as a kind tag plus the resolved values its
+// constructor needs (e.g. leakage areas are already converted to C/n).
+
+enum class ElementKind : uint8_t {
+    PowerLawOrifice = 1,
+    FanLinear,
+    FanPolynomial,
+    TwoWayFlow,
+    Duct,
+    Damper,
+    Filter,
+    SelfRegulatingVent,
+    CheckValve,
+    SimpleGaseousFilter,
+    UVGIFilter,
+    BackdraftDamper,
+    QuadraticElement,
+    ReturnGrille,
+    SupplyDiffuser,
+    SimpleParticleFilter
+};
+
+ElementKind encodeElement(const FlowElement& elem, std::vector<double>& p) {
+    if (auto* e = dynamic_cast<const PowerLawOrifice*>(&elem)) {
+        p = {e->getFlowCoefficient(), e->getFlowExponent()};
+        return ElementKind::PowerLawOrifice;
+    }
+    if (auto* e = dynamic_cast<const Fan*>(&elem)) {
+        if (e->isPolynomial()) {
+            p = e->getCoeffs();
+            return ElementKind::FanPolynomial;
+        }
+        p = {e->getMaxFlow(), e->getShutoffPressure()};
+        return ElementKind::FanLinear;
+    }
+    if (auto* e = dynamic_cast<const TwoWayFlow*>(&elem)) {
+        p = {e->getDischargeCoefficient(), e->getArea(), e->getHeight(), e->getWidth()};
+        return ElementKind::TwoWayFlow;
+    }
+    if (auto* e = dynamic_cast<const Duct*>(&elem)) {
+        p = {e->getLength(), e->getDiameter(), e->getRoughness(), e->getSumK()};
+        return ElementKind::Duct;
+    }
+    if (auto* e = dynamic_cast<const Damper*>(&elem)) {
+        p = {e->getCmax(), e->getFlowExponent(), e->getFraction()};
+        return ElementKind::Damper;
+    }
+    if (auto* e = dynamic_cast<const Filter*>(&elem)) {
+        p = {e->getFlowCoefficient(), e->getFlowExponent(), e->getEfficiency()};
+        return ElementKind::Filter;
+    }
+    if (auto* e = dynamic_cast<const SelfRegulatingVent*>(&elem)) {
+        p = {e->getTargetFlow(), e->getPMin(), e->getPMax()};
+        return ElementKind::SelfRegulatingVent;
+    }
+    if (auto* e = dynamic_cast<const CheckValve*>(&elem)) {
+        p = {e->getFlowCoefficient(), e->getFlowExponent()};
+        return ElementKind::CheckValve;
+    }
+    if (auto* e = dynamic_cast<const SimpleGaseousFilter*>(&elem)) {
+        p = {e->getFlowCoefficient(), e->getFlowExponent(),
+             e->getBreakthroughThreshold(), e->getCurrentLoading()};
+        for (const auto& lp : e->getLoadingTable()) {
+            p.push_back(lp.loading);
+            p.push_back(lp.efficiency);
+        }
+        return ElementKind::SimpleGaseousFilter;
+    }
+    if (auto* e = dynamic_cast<const UVGIFilter*>(&elem)) {
+        const auto& prm = e->getParams();
+        p = {e->getFlowCoefficient(), e->getFlowExponent(), prm.k, prm.irradiance,
+             prm.chamberVolume, prm.agingRate, prm.lampAgeHours,
+             static_cast<double>(prm.tempCoeffs.size())};
+        p.insert(p.end(), prm.tempCoeffs.begin(), prm.tempCoeffs.end());
+        p.insert(p.end(), prm.flowCoeffs.begin(), prm.flowCoeffs.end());
+        return ElementKind::UVGIFilter;
+    }
+    if (auto* e = dynamic_cast<const BackdraftDamper*>(&elem)) {
+        p = {e->getForwardC(), e->getForwardN(), e->getReverseC(), e->getReverseN()};
+        return ElementKind::BackdraftDamper;
+    }
+    if (auto* e = dynamic_cast<const QuadraticElement*>(&elem)) {
+        p = {e->getLinearCoeff(), e->getQuadraticCoeff()};
+        return ElementKind::QuadraticElement;
+    }
+    if (auto* e = dynamic_cast<const ReturnGrille*>(&elem)) {
+        p = {e->getFlowCoefficient(), e->getFlowExponent()};
+        return ElementKind::ReturnGrille;
+    }
+    if (auto* e = dynamic_cast<const SupplyDiffuser*>(&elem)) {
+        p = {e->getFlowCoefficient(), e->getFlowExponent()};
+        return ElementKind::SupplyDiffuser;
+    }
+    if (auto* e = dynamic_cast<const SimpleParticleFilter*>(&elem)) {
+        p = {e->getFlowCoefficient(), e->getFlowExponent()};
+        for (const auto& ep : e->getEfficiencyTable()) {
+            p.push_back(ep.diameter);
+            p.push_back(ep.efficiency);
+        }
+        return ElementKind::SimpleParticleFilter;
+    }
+    throw std::runtime_error("Model cache: unsupported flow element type " + elem.typeName());
+}
+
+std::unique_ptr<FlowElement> decodeElement(ElementKind kind, const double* p, size_t n) {
+    auto need = [n](size_t count) {
+        if (n < count) throw std::runtime_error("Model cache: bad flow element record");
+    };
+
+    switch (kind) {
+    case ElementKind::PowerLawOrifice:
+        need(2);
+        return std::make_unique<PowerLawOrifice>(p[0], p[1]);
+    case ElementKind::FanLinear:
+        need(2);
+        return std::make_unique<Fan>(p[0], p[1]);
+    case ElementKind::FanPolynomial:
+        return std::make_unique<Fan>(std::vector<double>(p, p + n));
+    case ElementKind::TwoWayFlow:
+        need(4);
+        return std::make_unique<TwoWayFlow>(p[0], p[1], p[2], p[3]);
+    case ElementKind::Duct:
+        need(4);
+        return std::make_unique<Duct>(p[0], p[1], p[2], p[3]);
+    case ElementKind::Damper:
+        need(3);
+        return std::make_unique<Damper>(p[0], p[1], p[2]);
+    case ElementKind::Filter:
+        need(3);
+        return std::make_unique<Filter>(p[0], p[1], p[2]);
+    case ElementKind::SelfRegulatingVent:
+        need(3);
+        return std::make_unique<SelfRegulatingVent>(p[0], p[1], p[2]);
+    case ElementKind::CheckValve:
+        need(2);
+        return std::make_unique<CheckValve>(p[0], p[1]);
+    case ElementKind::SimpleGaseousFilter: {
+        need(4);
+        std::vector<SimpleGaseousFilter::LoadingPoint> table;
+        for (size_t i = 4; i + 1 < n; i += 2) table.push_back({p[i], p[i + 1]});
+        auto filter = std::make_unique<SimpleGaseousFilter>(p[0], p[1], table, p[2]);
+        filter->setCurrentLoading(p[3]);
+        return filter;
+    }
+    case ElementKind::UVGIFilter: {
+        need(8);
+        UVGIFilter::UVGIParams params;
+        params.k = p[2];
+        params.irradiance = p[3];
+        params.chamberVolume = p[4];
+        params.agingRate = p[5];
+        params.lampAgeHours = p[6];
+        size_t numTemp = static_cast<size_t>(p[7]);
+        need(8 + numTemp);
+        params.tempCoeffs.assign(p + 8, p + 8 + numTemp);
+        params.flowCoeffs.assign(p + 8 + numTemp, p + n);
+        return std::make_unique<UVGIFilter>(p[0], p[1], params);
+    }
+    case ElementKind::BackdraftDamper:
+        need(4);
+        return std::make_unique<BackdraftDamper>(p[0], p[1], p[2], p[3]);
+    case ElementKind::QuadraticElement:
+        need(2);
+        return std::make_unique<QuadraticElement>(p[0], p[1]);
+    case ElementKind::ReturnGrille:
+        need(2);
+        return std::make_unique<ReturnGrille>(p[0], p[1]);
+    case ElementKind::SupplyDiffuser:
+        need(2);
+        return std::make_unique<SupplyDiffuser>(p[0], p[1]);
+    case ElementKind::SimpleParticleFilter: {
+        need(2);
+        std::vector<SimpleParticleFilter::EfficiencyPoint> table;
+        for (size_t i = 2; i + 1 < n; i += 2) table.push_back({p[i], p[i + 1]});
+        return std::make_unique<SimpleParticleFilter>(p[0], p[1], table);
+    }
+    }
+    throw std::runtime_error("Model cache: unknown flow element kind " +
+                             std::to_string(static_cast<int>(kind)));
+}
+
+// ── Network (struct-of-arrays) ───────────────────────────────────────
+
+void writeNetwork(ByteWriter& w, const Network& net) {
+    w.put(net.getAmbientTemperature());
+    w.put(net.getAmbientPressure());
+    w.put(net.getWindSpeed());
+    w.put(net.getWindDirection());
+
+    const auto& nodes = net.getNodes();
+    const size_t nn = nodes.size();
+    std::vector<int32_t> ids(nn), types(nn);
+    std::vector<double> pressure(nn), temperature(nn), elevation(nn), volume(nn), density(nn);
+    std::vector<double> windCp(nn), wallAzimuth(nn), terrainCh(nn);
+    std::vector<uint32_t> nameOffsets(nn + 1, 0), profileOffsets(nn + 1, 0);
+    std::vector<char> names;
+    std::vector<double> profiles;  // (angle, Cp) pairs
+    for (size_t i = 0; i < nn; ++i) {
+        const auto& n = nodes[i];
+        ids[i] = n.getId();
+        types[i] = static_cast<int32_t>(n.getType());
+        pressure[i] = n.getPressure();
+        temperature[i] = n.getTemperature();
+        elevation[i] = n.getElevation();
+        volume[i] = n.getVolume();
+        density[i] = n.getDensity();
+        windCp[i] = n.getWindPressureCoeff();
+        wallAzimuth[i] = n.getWallAzimuth();
+        terrainCh[i] = n.getTerrainFactor();
+        names.insert(names.end(), n.getName().begin(), n.getName().end());
+        nameOffsets[i + 1] = static_cast<uint32_t>(names.size());
+        for (const auto& [angle, cp] : n.getWindPressureProfile()) {
+            profiles.push_back(angle);
+            profiles.push_back(cp);
+        }
+        profileOffsets[i + 1] = static_cast<uint32_t>(profiles.size() / 2);
+    }
+    w.putArray(ids);
+    w.putArray(types);
+    w.putArray(pressure);
+    w.putArray(temperature);
+    w.putArray(elevation);
+    w.putArray(volume);
+    w.putArray(density);
+    w.putArray(windCp);
+    w.putArray(wallAzimuth);
+    w.putArray(terrainCh);
+    w.putArray(nameOffsets);
+    w.putArray(names);
+    w.putArray(profileOffsets);
+    w.putArray(profiles);
+
+    // Unique elements; links sharing one instance share one record
+    std::unordered_map<const FlowElement*, int32_t> elementIndex;
+    std::vector<uint8_t> kinds;
+    std::vector<uint32_t> paramOffsets{0};
+    std::vector<double> params, p;
+
+    const auto& links = net.getLinks();
+    const size_t nl = links.size();
+    std::vector<int32_t> linkIds(nl), from(nl), to(nl), element(nl, -1);
+    std::vector<double> linkElevation(nl);
+    for (size_t i = 0; i < nl; ++i) {
+        const auto& l = links[i];
+        linkIds[i] = l.getId();
+        from[i] = l.getNodeFrom();
+        to[i] = l.getNodeTo();
+        linkElevation[i] = l.getElevation();
+        if (const FlowElement* fe = l.getFlowElement()) {
+            auto it = elementIndex.find(fe);
+            if (it == elementIndex.end()) {
+                kinds.push_back(static_cast<uint8_t>(encodeElement(*fe, p)));
+                params.insert(params.end(), p.begin(), p.end());
+                paramOffsets.push_back(static_cast<uint32_t>(params.size()));
+                it = elementIndex.emplace(fe, static_cast<int32_t>(kinds.size() - 1)).first;
+            }
+            element[i] = it->second;
+        }
+    }
+    w.putArray(kinds);
+    w.putArray(paramOffsets);
+    w.putArray(params);
+
+    w.putArray(linkIds);
+    w.putArray(from);
+    w.putArray(to);
+    w.putArray(linkElevation);
+    w.putArray(element);
+}
+
+Network readNetwork(ByteReader& r) {
+    Network net;
+    net.setAmbientTemperature(r.get<double>());
+    net.setAmbientPressure(r.get<double>());
+    net.setWindSpeed(r.get<double>());
+    net.setWindDirection(r.get<double>());
+
+    auto ids = r.getArray<int32_t>();
+    auto types = r.getArray<int32_t>();
+    auto pressure = r.getArray<double>();
+    auto temperature = r.getArray<double>();
+    auto elevation = r.getArray<double>();
+    auto volume = r.getArray<double>();
+    auto density = r.getArray<double>();
+    auto windCp = r.getArray<double>();
+    auto wallAzimuth = r.getArray<double>();
+    auto terrainCh = r.getArray<double>();
+    auto nameOffsets = r.getArray<uint32_t>();
+    auto names = r.getArray<char>();
+    auto profileOffsets = r.getArray<uint32_t>();
+    auto profiles = r.getArray<double>();
+
+    const size_t nn = ids.size();
+    for (const auto* arr : {&pressure, &temperature, &elevation, &volume, &density,
+                            &windCp, &wallAzimuth, &terrainCh}) {
+        if (arr->size() != nn) throw std::runtime_error("Model cache: inconsistent node arrays");
+    }
+    if (types.size() != nn || nameOffsets.size() != nn + 1 || profileOffsets.size() != nn + 1 ||
+        nameOffsets[nn] > names.size() || size_t(profileOffsets[nn]) * 2 > profiles.size()) {
+        throw std::runtime_error("Model cache: inconsistent node arrays");
+    }
+
+    for (size_t i = 0; i < nn; ++i) {
+        std::string name(names.data() + nameOffsets[i], nameOffsets[i + 1] - nameOffsets[i]);
+        Node node(ids[i], name, static_cast<NodeType>(types[i]));
+        node.setPressure(pressure[i]);
+        node.setTemperature(temperature[i]);
+        node.setElevation(elevation[i]);
+        node.setVolume(volume[i]);
+        node.setWindPressureCoeff(windCp[i]);
+        node.setWallAzimuth(wallAzimuth[i]);
+        node.setTerrainFactor(terrainCh[i]);
+        if (profileOffsets[i + 1] > profileOffsets[i]) {
+            std::vector<std::pair<double, double>> profile;
+            for (uint32_t k = profileOffsets[i]; k < profileOffsets[i + 1]; ++k) {
+                profile.emplace_back(profiles[2 * k], profiles[2 * k + 1]);
+            }
+            node.setWindPressureProfile(profile);
+        }
+        node.setDensity(density[i]);
+        net.addNode(node);
+    }
+
+    auto kinds = r.getArray<uint8_t>();
+    auto paramOffsets = r.getArray<uint32_t>();
+    auto params = r.getArray<double>();
+    if (paramOffsets.size() != kinds.size() + 1 || paramOffsets.back() > params.size()) {
+        throw std::runtime_error("Model cache: inconsistent element table");
+    }
+    std::vector<std::shared_ptr<const FlowElement>> elements;
+    elements.reserve(kinds.size());
+    for (size_t e = 0; e < kinds.size(); ++e) {
+        elements.emplace_back(decodeElement(static_cast<ElementKind>(kinds[e]),
+                                            params.data() + paramOffsets[e],
+                                            paramOffsets[e + 1] - paramOffsets[e]));
+    }
+
+    auto linkIds = r.getArray<int32_t>();
+    auto from = r.getArray<int32_t>();
+    auto to = r.getArray<int32_t>();
+    auto linkElevation = r.getArray<double>();
+    auto element = r.getArray<int32_t>();
+    const size_t nl = linkIds.size();
+    if (from.size() != nl || to.size() != nl || linkElevation.size() != nl || element.size() != nl) {
+        throw std::runtime_error("Model cache: inconsistent link arrays");
+    }
+    for (size_t i = 0; i < nl; ++i) {
+        Link link(linkIds[i], from[i], to[i], linkElevation[i]);
+        if (element[i] >= 0) {
+            if (static_cast<size_t>(element[i]) >= elements.size()) {
+                throw std::runtime_error("Model cache: bad element index");
+            }
+            link.setSharedFlowElement(elements[element[i]]);
+        }
+        net.addLink(std::move(link));
+    }
+    return net;
+}
+
+// ── Remaining model sections ─────────────────────────────────────────
+
+void writeModel(ByteWriter& w, const ModelInput& model) {
+    writeNetwork(w, model.network);
+
+    w.put(static_cast<uint32_t>(model.species.size()));
+    for (const auto& sp : model.species) {
+        w.put<int32_t>(sp.id);
+        w.putString(sp.name);
+        w.put(sp.molarMass);
+        w.put(sp.decayRate);
+        w.put(sp.outdoorConc);
+        w.put<uint8_t>(sp.isTrace ? 1 : 0);
+        w.put(sp.diffusionCoeff);
+        w.put(sp.meanDiameter);
+        w.put(sp.effectiveDensity);
+    }
+
+    w.put(static_cast<uint32_t>(model.sources.size()));
+    for (const auto& src : model.sources) {
+        w.put<int32_t>(src.zoneId);
+        w.put<int32_t>(src.speciesId);
+        w.put<int32_t>(static_cast<int32_t>(src.type));
+        w.put<int32_t>(src.scheduleId);
+        for (double v : {src.generationRate, src.removalRate, src.decayTimeConstant,
+                         src.startTime, src.multiplier, src.pressureCoeff, src.cutoffConc,
+                         src.burstMass, src.burstTime, src.burstDuration}) {
+            w.put(v);
+        }
+    }
+
+    // Schedules as sorted time/value arrays
+    w.put(static_cast<uint32_t>(model.schedules.size()));
+    std::vector<double> times, values;
+    for (const auto& [id, sch] : model.schedules) {
+        w.put<int32_t>(id);
+        w.putString(sch.name);
+        w.put<uint8_t>(static_cast<uint8_t>(sch.getInterpolationMode()));
+        times.clear();
+        values.clear();
+        for (const auto& pt : sch.getPoints()) {
+            times.push_back(pt.time);
+            values.push_back(pt.value);
+        }
+        w.putArray(times);
+        w.putArray(values);
+    }
+
+    w.put(static_cast<uint32_t>(model.zoneTemperatureSchedules.size()));
+    for (const auto& [nodeIdx, schedId] : model.zoneTemperatureSchedules) {
+        w.put<int32_t>(nodeIdx);
+        w.put<int32_t>(schedId);
+    }
+
+    const auto& tc = model.transientConfig;
+    w.put<uint8_t>(model.hasTransient ? 1 : 0);
+    w.put(tc.startTime);
+    w.put(tc.endTime);
+    w.put(tc.timeStep);
+    w.put(tc.outputInterval);
+    w.put<int32_t>(static_cast<int32_t>(tc.airflowMethod));
+    w.put<uint32_t>(tc.threads);
+
+    const auto& os = model.outputSpec;
+    w.putArray(os.nodeIds);
+    w.putArray(os.linkIds);
+    w.putArray(os.speciesIds);
+    w.put(os.pressureInterval);
+    w.put(os.massFlowInterval);
+    w.put(os.concentrationInterval);
+    w.put(os.windowStart);
+    w.put(os.windowEnd);
+    w.put<int32_t>(static_cast<int32_t>(os.precision));
+    w.put<int32_t>(os.significantDigits);
+
+    const size_t nw = model.weatherData.size();
+    std::vector<int32_t> month(nw), day(nw), hour(nw);
+    std::vector<double> wT(nw), wWs(nw), wWd(nw), wP(nw), wRH(nw);
+    for (size_t i = 0; i < nw; ++i) {
+        const auto& rec = model.weatherData[i];
+        month[i] = rec.month;
+        day[i] = rec.day;
+        hour[i] = rec.hour;
+        wT[i] = rec.temperature;
+        wWs[i] = rec.windSpeed;
+        wWd[i] = rec.windDirection;
+        wP[i] = rec.pressure;
+        wRH[i] = rec.humidity;
+    }
+    w.putArray(month);
+    w.putArray(day);
+    w.putArray(hour);
+    w.putArray(wT);
+    w.putArray(wWs);
+    w.putArray(wWd);
+    w.putArray(wP);
+    w.putArray(wRH);
+
+    auto putZones = [&w](const std::vector<SimpleAHS::ZoneConnection>& zones) {
+        w.put(static_cast<uint32_t>(zones.size()));
+        for (const auto& z : zones) {
+            w.put<int32_t>(z.zoneId);
+            w.put(z.fraction);
+        }
+    };
+    w.put(static_cast<uint32_t>(model.ahSystems.size()));
+    for (const auto& ahs : model.ahSystems) {
+        w.put<int32_t>(ahs.id);
+        w.putString(ahs.name);
+        w.put(ahs.supplyFlow);
+        w.put(ahs.returnFlow);
+        w.put(ahs.outdoorAirFlow);
+        w.put(ahs.exhaustFlow);
+        w.put(ahs.supplyTemperature);
+        w.put<int32_t>(ahs.outdoorAirScheduleId);
+        w.put<int32_t>(ahs.supplyFlowScheduleId);
+        putZones(ahs.supplyZones);
+        putZones(ahs.returnZones);
+    }
+
+    w.put(static_cast<uint32_t>(model.occupants.size()));
+    for (const auto& occ : model.occupants) {
+        w.put<int32_t>(occ.id);
+        w.putString(occ.name);
+        w.put<int32_t>(occ.currentZoneIdx);
+        w.put(occ.breathingRate);
+        w.put<int32_t>(occ.scheduleId);
+    }
+
+    const auto& sweep = model.sweep;
+    w.put<int32_t>(static_cast<int32_t>(sweep.method));
+    w.put<int32_t>(sweep.samples);
+    w.put<uint64_t>(sweep.seed);
+    w.put(static_cast<uint32_t>(sweep.parameters.size()));
+    for (const auto& p : sweep.parameters) {
+        w.putString(p.name);
+        w.putArray(p.values);
+        w.put(p.min);
+        w.put(p.max);
+        w.put<int32_t>(p.steps);
+        w.put<uint8_t>(p.logScale ? 1 : 0);
+    }
+}
+
+ModelInput readModel(ByteReader& r) {
+    ModelInput model;
+    model.network = readNetwork(r);
+
+    uint32_t count = r.get<uint32_t>();
+    for (uint32_t i = 0; i < count; ++i) {
+        Species sp;
+        sp.id = r.get<int32_t>();
+        sp.name = r.getString();
+        sp.molarMass = r.get<double>();
+        sp.decayRate = r.get<double>();
+        sp.outdoorConc = r.get<double>();
+        sp.isTrace = r.get<uint8_t>() != 0;
+        sp.diffusionCoeff = r.get<double>();
+        sp.meanDiameter = r.get<double>();
+        sp.effectiveDensity = r.get<double>();
+        model.species.push_back(sp);
+    }
+
+    count = r.get<uint32_t>();
+    for (uint32_t i = 0; i < count; ++i) {
+        Source src;
+        src.zoneId = r.get<int32_t>();
+        src.speciesId = r.get<int32_t>();
+        src.type = static_cast<SourceType>(r.get<int32_t>());
+        src.scheduleId = r.get<int32_t>();
+        src.generationRate = r.get<double>();
+        src.removalRate = r.get<double>();
+        src.decayTimeConstant = r.get<double>();
+        src.startTime = r.get<double>();
+        src.multiplier = r.get<double>();
+        src.pressureCoeff = r.get<double>();
+        src.cutoffConc = r.get<double>();
+        src.burstMass = r.get<double>();
+        src.burstTime = r.get<double>();
+        src.burstDuration = r.get<double>();
+        model.sources.push_back(src);
+    }
+
+    count = r.get<uint32_t>();
+    for (uint32_t i = 0; i < count; ++i) {
+        int id = r.get<int32_t>();
+        Schedule sch(id, r.getString());
+        sch.setInterpolationMode(static_cast<InterpolationMode>(r.get<uint8_t>()));
+        auto times = r.getArray<double>();
+        auto values = r.getArray<double>();
+        if (times.size() != values.size()) {
+            throw std::runtime_error("Model cache: inconsistent schedule arrays");
+        }
+        for (size_t k = 0; k < times.size(); ++k) sch.addPoint(times[k], values[k]);
+        model.schedules[id] = std::move(sch);
+    }
+
+    count = r.get<uint32_t>();
+    for (uint32_t i = 0; i < count; ++i) {
+        int nodeIdx = r.get<int32_t>();
+        model.zoneTemperatureSchedules[nodeIdx] = r.get<int32_t>();
+    }
+
+    auto& tc = model.transientConfig;
+    model.hasTransient = r.get<uint8_t>() != 0;
+    tc.startTime = r.get<double>();
+    tc.endTime = r.get<double>();
+    tc.timeStep = r.get<double>();
+    tc.outputInterval = r.get<double>();
+    tc.airflowMethod = static_cast<SolverMethod>(r.get<int32_t>());
+    tc.threads = r.get<uint32_t>();
+
+    auto& os = model.outputSpec;
+    os.nodeIds = r.getArray<int>();
+    os.linkIds = r.getArray<int>();
+    os.speciesIds = r.getArray<int>();
+    os.pressureInterval = r.get<double>();
+    os.massFlowInterval = r.get<double>();
+    os.concentrationInterval = r.get<double>();
+    os.windowStart = r.get<double>();
+    os.windowEnd = r.get<double>();
+    os.precision = static_cast<OutputPrecision>(r.get<int32_t>());
+    os.significantDigits = r.get<int32_t>();
+
+    auto month = r.getArray<int32_t>();
+    auto day = r.getArray<int32_t>();
+    auto hour = r.getArray<int32_t>();
+    auto wT = r.getArray<double>();
+    auto wWs = r.getArray<double>();
+    auto wWd = r.getArray<double>();
+    auto wP = r.getArray<double>();
+    auto wRH = r.getArray<double>();
+    const size_t nw = month.size();
+    if (day.size() != nw || hour.size() != nw || wT.size() != nw || wWs.size() != nw ||
+        wWd.size() != nw || wP.size() != nw || wRH.size() != nw) {
+        throw std::runtime_error("Model cache: inconsistent weather arrays");
+    }
+    model.weatherData.resize(nw);
+    for (size_t i = 0; i < nw; ++i) {
+        model.weatherData[i] = {month[i], day[i], hour[i], wT[i], wWs[i], wWd[i], wP[i], wRH[i]};
+    }
+
+    auto getZones = [&r]() {
+        std::vector<SimpleAHS::ZoneConnection> zones(r.get<uint32_t>());
+        for (auto& z : zones) {
+            z.zoneId = r.get<int32_t>();
+            z.fraction = r.get<double>();
+        }
+        return zones;
+    };
+    count = r.get<uint32_t>();
+    for (uint32_t i = 0; i < count; ++i) {
+        SimpleAHS ahs;
+        ahs.id = r.get<int32_t>();
+        ahs.name = r.getString();
+        ahs.supplyFlow = r.get<double>();
+        ahs.returnFlow = r.get<double>();
+        ahs.outdoorAirFlow = r.get<double>();
+        ahs.exhaustFlow = r.get<double>();
+        ahs.supplyTemperature = r.get<double>();
+        ahs.outdoorAirScheduleId = r.get<int32_t>();
+        ahs.supplyFlowScheduleId = r.get<int32_t>();
+        ahs.supplyZones = getZones();
+        ahs.returnZones = getZones();
+        model.ahSystems.push_back(ahs);
+    }
+
+    count = r.get<uint32_t>();
+    for (uint32_t i = 0; i < count; ++i) {
+        Occupant occ;
+        occ.id = r.get<int32_t>();
+        occ.name = r.getString();
+        occ.currentZoneIdx = r.get<int32_t>();
+        occ.breathingRate = r.get<double>();
+        occ.scheduleId = r.get<int32_t>();
+        model.occupants.push_back(occ);
+    }
+
+    auto& sweep = model.sweep;
+    sweep.method = static_cast<SweepMethod>(r.get<int32_t>());
+    sweep.samples = r.get<int32_t>();
+    sweep.seed = r.get<uint64_t>();
+    count = r.get<uint32_t>();
+    for (uint32_t i = 0; i < count; ++i) {
+        SweepParameter p;
+        p.name = r.getString();
+        p.values = r.getArray<double>();
+        p.min = r.get<double>();
+        p.max = r.get<double>();
+        p.steps = r.get<int32_t>();
+        p.logScale = r.get<uint8_t>() != 0;
+        sweep.parameters.push_back(std::move(p));
+    }
+    return model;
+}
+
+bool readHeader(std::string_view image, ModelCacheHeader& hdr) {
+    if (image.size() < sizeof(ModelCacheHeader)) return false;
+    std::memcpy(&hdr, image.data(), sizeof(hdr));
+    return hdr.magic == MODEL_CACHE_MAGIC;
+}
+
+} // namespace
+
+// ── ModelCache ───────────────────────────────────────────────────────
+
+Sha256Digest ModelCache::contentHash(std::string_view text) {
+    return Sha256::hash(text);
+}
+
+std::string ModelCache::serialize(const ModelInput& model, const Sha256Digest& contentHash,
+                                  uint64_t sourceBytes) {
+    ByteWriter w;
+    w.put(ModelCacheHeader{});
+    writeModel(w, model);
+
+    std::string& image = w.buffer();
+    ModelCacheHeader hdr{};
+    hdr.magic = MODEL_CACHE_MAGIC;
+    hdr.version = MODEL_CACHE_VERSION;
+    std::memcpy(hdr.contentHash, contentHash.data(), contentHash.size());
+    hdr.sourceBytes = sourceBytes;
+    hdr.payloadBytes = image.size() - sizeof(ModelCacheHeader);
+    std::memcpy(&image[0], &hdr, sizeof(hdr));
+    return std::move(image);
+}
+
+ModelInput ModelCache::deserialize(std::string_view image) {
+    ModelCacheHeader hdr;
+    if (!readHeader(image, hdr)) {
+        throw std::runtime_error("Not a model cache image");
+    }
+    if (hdr.version != MODEL_CACHE_VERSION) {
+        throw std::runtime_error("Unsupported model cache version " + std::to_string(hdr.version));
+    }
+    if (hdr.payloadBytes > image.size() - sizeof(ModelCacheHeader)) {
+        throw std::runtime_error("Model cache is truncated");
+    }
+    ByteReader r(image.data() + sizeof(ModelCacheHeader), static_cast<size_t>(hdr.payloadBytes),
+                 "Model cache");
+    return readModel(r);
+}
+
+static std::string uniqueSuffix() {
+#ifdef _WIN32
+    const long pid = static_cast<long>(_getpid());
+#else
+    const long pid = static_cast<long>(getpid());
+#endif
+    std::random_device rd;
+    const uint64_t r = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+    char buf[40];
+    std::snprintf(buf, sizeof(buf), "%ld.%016llx", pid, static_cast<unsigned long long>(r));
+    return buf;
+}
+
+void ModelCache::write(const std::string& filepath, const ModelInput& model,
+                       const Sha256Digest& contentHash, uint64_t sourceBytes) {
+    std::string image = serialize(model, contentHash, sourceBytes);
+
+    // Write to a temporary name and rename so concurrent readers never map a
+    // partially written cache. The name is unique per writer (pid plus a
+    // random suffix): two processes caching the same model must not write
+    // into one temporary file.
+    std::string tmpPath = filepath + "." + uniqueSuffix() + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary);
+        if (!out.is_open()) {
+            throw std::runtime_error("Cannot open model cache for writing: " + tmpPath);
+        }
+        out.write(image.data(), static_cast<std::streamsize>(image.size()));
+        out.close();
+        if (!out) {
+            std::remove(tmpPath.c_str());
+            throw std::runtime_error("Failed writing model cache: " + tmpPath);
+        }
+    }
+#ifdef _WIN32
+    // rename() does not replace an existing file on Windows
+    std::remove(filepath.c_str());
+#endif
+    if (std::rename(tmpPath.c_str(), filepath.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        throw std::runtime_error("Cannot move model cache into place: " + filepath);
+    }
+}
+
+bool ModelCache::tryRead(const std::string& filepath, const Sha256Digest& contentHash,
+                         uint64_t sourceBytes, ModelInput& model) {
+    auto start = std::chrono::steady_clock::now();
+    MappedFile file;
+    try {
+        file.open(filepath);
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+
+    std::string_view image(file.data(), file.size());
+    ModelCacheHeader hdr;
+    if (!readHeader(image, hdr) || hdr.version != MODEL_CACHE_VERSION ||
+        hdr.sourceBytes != sourceBytes ||
+        std::memcmp(hdr.contentHash, contentHash.data(), contentHash.size()) != 0) {
+        return false;
+    }
+    try {
+        model = deserialize(image);
+    } catch (const std::runtime_error&) {
+        return false;  // corrupt cache: caller rebuilds it
+    }
+
+    model.loadStats = JsonLoadStats{};
+    model.loadStats.bytes = file.size();
+    model.loadStats.fromCache = true;
+    model.loadStats.parseSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+std::string ModelCache::cachePathFor(const Sha256Digest& contentHash, const std::string& cacheDir) {
+    return (std::filesystem::path(cacheDir) / (Sha256::toHex(contentHash) + ".cmc")).string();
+}
+
+std::string ModelCache::defaultCacheDir() {
+    namespace fs = std::filesystem;
+    auto env = [](const char* name) -> const char* {
+        const char* value = std::getenv(name);
+        return value && *value ? value : nullptr;
+    };
+#ifdef _WIN32
+    if (const char* local = env("LOCALAPPDATA")) return (fs::path(local) / "contam" / "models").string();
+#else
+    if (const char* xdg = env("XDG_CACHE_HOME")) return (fs::path(xdg) / "contam" / "models").string();
+    if (const char* home = env("HOME")) return (fs::path(home) / ".cache" / "contam" / "models").string();
+#endif
+    return "";
+}
+
+void ModelCache::prune(const std::string& cacheDir, uint64_t maxBytes, int maxAgeDays,
+                       const std::string& keepPath) {
+    namespace fs = std::filesystem;
+    struct Entry {
+        fs::path path;
+        fs::file_time_type used;
+        uint64_t bytes;
+    };
+    std::error_code ec;
+    const auto now = fs::file_time_type::clock::now();
+    const fs::path keep = keepPath.empty() ? fs::path() : fs::path(keepPath).lexically_normal();
+    std::vector<Entry> entries;
+    for (const auto& item : fs::directory_iterator(cacheDir, ec)) {
+        // Temporary files of writers that died before their rename
+        if (item.path().extension() == ".tmp") {
+            auto written = item.last_write_time(ec);
+            if (!ec && now - written > std::chrono::hours(1)) fs::remove(item.path(), ec);
+            continue;
+        }
+        if (item.path().extension() != ".cmc") continue;
+        Entry e{item.path(), item.last_write_time(ec), 0};
+        if (ec) continue;
+        e.bytes = item.file_size(ec);
+        if (ec) continue;
+        entries.push_back(std::move(e));
+    }
+
+    // Oldest first; a hit refreshes the file's time (see loadModel)
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    const auto cutoff = now - std::chrono::hours(24 * maxAgeDays);
+    uint64_t total = 0;
+    for (const auto& e : entries) total += e.bytes;
+    for (const auto& e : entries) {
+        if (e.used >= cutoff && total <= maxBytes) break;
+        if (!keep.empty() && e.path.lexically_normal() == keep) continue;
+        if (fs::remove(e.path, ec)) total -= e.bytes;
+    }
+}
+
+ModelInput ModelCache::loadModel(const std::string& jsonPath, const std::string& cacheDir) {
+    const std::string dir = cacheDir.empty() ? defaultCacheDir() : cacheDir;
+    if (dir.empty()) return JsonReader::readModelFromFile(jsonPath);
+
+    Sha256Digest hash;
+    uint64_t sourceBytes = 0;
+    {
+        MappedFile file;
+        try {
+            file.open(jsonPath);
+        } catch (const std::runtime_error&) {
+            throw std::runtime_error("Cannot open file: " + jsonPath);
+        }
+        hash = contentHash(std::string_view(file.data(), file.size()));
+        sourceBytes = file.size();
+    }
+
+    std::string cachePath = cachePathFor(hash, dir);
+    ModelInput model;
+    if (tryRead(cachePath, hash, sourceBytes, model)) {
+        // Mark as recently used for prune()
+        std::error_code ec;
+        std::filesystem::last_write_time(cachePath, std::filesystem::file_time_type::clock::now(), ec);
+        return model;
+    }
+
+    model = JsonReader::readModelFromFile(jsonPath);
+    try {
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+        write(cachePath, model, hash, sourceBytes);
+        // The new entry stays even when it alone exceeds the size cap
+        prune(dir, MODEL_CACHE_MAX_BYTES, MODEL_CACHE_MAX_AGE_DAYS, cachePath);
+    } catch (const std::runtime_error&) {
+        // Read-only location or unsupported element: run without a cache
+    }
+    return model;
+}
+
+} // namespace contam
@@ -0,0 +1,90 @@
+#pragma once
+#include "io/JsonReader.h"
+#include "utils/Sha256.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace contam {
+
+// ── Compiled model cache layout ──────────────────────────────────────
+// [ModelCacheHeader][payload]
+// The payload is a fully resolved ModelInput, not JSON:
+//   network   ambient scalars, nodes and links as struct-of-arrays
+//   elements  unique flow elements (shared templates stored once) as
+//             kind + resolved constructor parameters
+//   model     species, sources, schedules (sorted time/value arrays),
+//             transient config, weather arrays, AHS, occupants, sweep
+// Counts are uint32, arrays are raw native-endian values. The reader copies
+// arrays straight out of the memory-mapped file without any text parsing.
+//
+// contentHash is the SHA-256 of the source JSON text; a cache whose hash,
+// source size or version differs from the input is ignored and rebuilt.
+//
+// Caches live in one directory per user (defaultCacheDir) unless a directory
+// is given. Each write prunes the directory: files unused for
+// MODEL_CACHE_MAX_AGE_DAYS go first, then the least recently used until it
+// holds at most MODEL_CACHE_MAX_BYTES.
+
+static constexpr uint32_t MODEL_CACHE_MAGIC = 0x31434D43;  // "CMC1"
+static constexpr uint16_t MODEL_CACHE_VERSION = 5;
+static constexpr uint64_t MODEL_CACHE_MAX_BYTES = 256ull * 1024 * 1024;
+static constexpr int MODEL_CACHE_MAX_AGE_DAYS = 30;
+
+#pragma pack(push, 1)
+struct ModelCacheHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint8_t contentHash[32];  // SHA-256 of the source JSON
+    uint64_t sourceBytes;     // size of the source JSON
+    uint64_t payloadBytes;    // bytes following the header
+};
+#pragma pack(pop)
+
+static_assert(sizeof(ModelCacheHeader) == 56, "ModelCacheHeader must be 56 bytes");
+
+class ModelCache {
+public:
+    // SHA-256 of the source text, used as the cache key
+    static Sha256Digest contentHash(std::string_view text);
+
+    // Serialize a model to an in-memory image (header + payload). Also used for
+    // pickling pycontam objects.
+    static std::string serialize(const ModelInput& model, const Sha256Digest& contentHash = {},
+                                 uint64_t sourceBytes = 0);
+    // Rebuild a model from an image produced by serialize(); throws on a
+    // foreign, truncated or version-mismatched image
+    static ModelInput deserialize(std::string_view image);
+
+    static void write(const std::string& filepath, const ModelInput& model,
+                      const Sha256Digest& contentHash, uint64_t sourceBytes);
+    // Map and load a cache file. Returns false (leaving `model` untouched) if the
+    // file is missing, stale for `contentHash` or `sourceBytes`, or from
+    // another format version.
+    static bool tryRead(const std::string& filepath, const Sha256Digest& contentHash,
+                        uint64_t sourceBytes, ModelInput& model);
+
+    // "<cacheDir>/<hex hash>.cmc"
+    static std::string cachePathFor(const Sha256Digest& contentHash, const std::string& cacheDir);
+    // Per-user cache directory: $XDG_CACHE_HOME/contam/models or
+    // ~/.cache/contam/models (%LOCALAPPDATA%\contam\models on Windows).
+    // Empty when none of those is set.
+    static std::string defaultCacheDir();
+    // Delete *.cmc files not used for `maxAgeDays`, then the least recently
+    // used ones until the directory holds at most `maxBytes`. `keepPath` (the
+    // entry just written) is never deleted. Temporary files left by writers
+    // that died are removed after an hour.
+    static void prune(const std::string& cacheDir, uint64_t maxBytes = MODEL_CACHE_MAX_BYTES,
+                      int maxAgeDays = MODEL_CACHE_MAX_AGE_DAYS, const std::string& keepPath = "");
+
+    // Load a JSON model through the cache in `cacheDir` (defaultCacheDir when
+    // empty): hash the input, use a matching cache file if present, otherwise
+    // parse the JSON, write the cache and prune the directory. A cache that
+    // cannot be written is not an error; without any cache directory the
+    // JSON is parsed every time.
+    static ModelInput loadModel(const std::string& jsonPath, const std::string& cacheDir = "");
+};
+
+} // namespace contam
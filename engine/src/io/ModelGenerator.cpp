@@ -0,0 +1,282 @@
+#include "io/ModelGenerator.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace contam {
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr int FLOORS_PER_WIND_BAND = 10;
+constexpr int OFFICES_PER_CORRIDOR_SEGMENT = 6;
+constexpr double HOUR = 3600.0;
+
+void checkOption(bool ok, const char* message) {
+    if (!ok) throw std::runtime_error(std::string("Model generator: ") + message);
+}
+
+// Uniform draws from mt19937_64 without the library distributions, whose
+// output differs between standard libraries
+class Random {
+public:
+    explicit Random(uint64_t seed) : rng_(seed) {}
+    double uniform(double lo, double hi) { return lo + (hi - lo) * ((rng_() >> 11) * (1.0 / 9007199254740992.0)); }
+    bool chance(double p) { return uniform(0.0, 1.0) < p; }
+
+private:
+    std::mt19937_64 rng_;
+};
+
+// Wall Cp by wind angle from the wall normal, for a tall building
+json wallCpProfile() {
+    static const double angles[] = {0, 45, 90, 135, 180, 225, 270, 315, 360};
+    static const double cps[] = {0.60, 0.35, -0.55, -0.45, -0.35, -0.45, -0.55, 0.35, 0.60};
+    json profile = json::array();
+    for (int k = 0; k < 9; ++k) profile.push_back({{"angle", angles[k]}, {"cp", cps[k]}});
+    return profile;
+}
+
+// Schedule points holding `value` from each `time` on (the engine
+// interpolates linearly, so every change gets a one-second ramp)
+json stepSchedule(int id, const std::string& name, const std::vector<std::pair<double, double>>& steps) {
+    json points = json::array();
+    for (std::size_t k = 0; k < steps.size(); ++k) {
+        if (k > 0) points.push_back({{"time", steps[k].first - 1.0}, {"value", steps[k - 1].second}});
+        points.push_back({{"time", steps[k].first}, {"value", steps[k].second}});
+    }
+    return {{"id", id}, {"name", name}, {"points", std::move(points)}};
+}
+
+} // namespace
+
+json generateModel(const ModelGeneratorOptions& o) {
+    checkOption(o.floors >= 1 && o.floors <= 1000, "floors must be 1..1000");
+    checkOption(o.zonesPerFloor >= 1 && o.zonesPerFloor <= 10000, "zonesPerFloor must be 1..10000");
+    checkOption(o.floorHeight > 0.0, "floorHeight must be positive");
+    checkOption(o.stairwells >= 0 && o.elevatorShafts >= 0, "stairwells and elevatorShafts must be >= 0");
+    checkOption(o.species >= 0 && o.species <= 64, "species must be 0..64");
+    checkOption(o.ahsSystems >= 0 && o.ahsSystems <= o.floors, "ahsSystems must be 0..floors");
+    checkOption(o.occupantsPerZone >= 0, "occupantsPerZone must be >= 0");
+    checkOption(o.hours > 0.0, "hours must be positive");
+    checkOption(o.airflowMethod == "trustRegion" || o.airflowMethod == "subRelaxation",
+                "airflowMethod must be trustRegion or subRelaxation");
+
+    Random rnd(o.seed);
+    const int corridors = (o.zonesPerFloor + OFFICES_PER_CORRIDOR_SEGMENT - 1) / OFFICES_PER_CORRIDOR_SEGMENT;
+    const int bands = (o.floors + FLOORS_PER_WIND_BAND - 1) / FLOORS_PER_WIND_BAND;
+    const int perFloor = corridors + o.zonesPerFloor + o.stairwells + o.elevatorShafts;
+    const int firstFloorNode = 4 * bands;
+
+    // Node ids of floor f
+    auto corridor = [&](int f, int s) { return firstFloorNode + f * perFloor + s; };
+    auto office = [&](int f, int i) { return corridor(f, corridors) + i; };
+    auto stair = [&](int f, int k) { return office(f, o.zonesPerFloor) + k; };
+    auto shaft = [&](int f, int e) { return stair(f, o.stairwells) + e; };
+    auto facade = [&](int f, int orientation) { return (f / FLOORS_PER_WIND_BAND) * 4 + orientation; };
+
+    json model;
+    model["description"] = "Generated office high-rise: " + std::to_string(o.floors) + " floors x " +
+                           std::to_string(o.zonesPerFloor) + " offices, seed " + std::to_string(o.seed);
+    model["ambient"] = {{"temperature", o.outdoorTemperature}, {"pressure", 0.0},
+                        {"windSpeed", o.windSpeed}, {"windDirection", o.windDirection}};
+    model["flowElements"] = {
+        {"officeDoor", {{"type", "PowerLawOrifice"}, {"C", 0.012}, {"n", 0.6}}},
+        {"corridor", {{"type", "PowerLawOrifice"}, {"C", 0.4}, {"n", 0.6}}},
+        {"stairDoor", {{"type", "PowerLawOrifice"}, {"C", 0.006}, {"n", 0.6}}},
+        {"stairFlight", {{"type", "PowerLawOrifice"}, {"C", 0.8}, {"n", 0.6}}},
+        {"elevatorDoor", {{"type", "PowerLawOrifice"}, {"C", 0.015}, {"n", 0.6}}},
+        {"shaftOpen", {{"type", "PowerLawOrifice"}, {"C", 1.5}, {"n", 0.6}}},
+        {"shaftVent", {{"type", "PowerLawOrifice"}, {"orificeArea", 0.1}}},
+        {"floorLeak", {{"type", "PowerLawOrifice"}, {"leakageArea", 0.002}, {"n", 0.65}}},
+        {"entrance", {{"type", "PowerLawOrifice"}, {"C", 0.05}, {"n", 0.6}}},
+        {"exhaustFan", {{"type", "Fan"}, {"maxFlow", 0.08}, {"shutoffPressure", 250.0}}}};
+
+    // ── Nodes ──
+    json nodes = json::array();
+    static const char* sides[] = {"N", "E", "S", "W"};
+    for (int b = 0; b < bands; ++b) {
+        // Terrain factor of the band's mid height, power-law wind profile
+        const double z = std::max(10.0, (b * FLOORS_PER_WIND_BAND + 0.5 * FLOORS_PER_WIND_BAND) * o.floorHeight);
+        const double ch = std::pow(z / 10.0, 0.5);
+        for (int s = 0; s < 4; ++s) {
+            nodes.push_back({{"id", b * 4 + s}, {"name", std::string("Facade ") + sides[s] + " " + std::to_string(b)},
+                             {"type", "ambient"}, {"temperature", o.outdoorTemperature},
+                             {"wallAzimuth", 90.0 * s}, {"terrainFactor", ch},
+                             {"windPressureProfile", wallCpProfile()}});
+        }
+    }
+
+    std::vector<double> officeVolumes;
+    for (int f = 0; f < o.floors; ++f) {
+        const double z = f * o.floorHeight;
+        const std::string fl = "F" + std::to_string(f + 1);
+        for (int s = 0; s < corridors; ++s) {
+            nodes.push_back({{"id", corridor(f, s)}, {"name", fl + " Corridor " + std::to_string(s + 1)},
+                             {"temperature", 293.15}, {"elevation", z}, {"volume", 60.0}});
+        }
+        for (int i = 0; i < o.zonesPerFloor; ++i) {
+            const double volume = rnd.uniform(15.0, 40.0) * (o.floorHeight - 0.5);
+            officeVolumes.push_back(volume);
+            nodes.push_back({{"id", office(f, i)}, {"name", fl + " Office " + std::to_string(i + 1)},
+                             {"temperature", 294.15 + rnd.uniform(-1.0, 1.0)}, {"elevation", z},
+                             {"volume", volume}});
+        }
+        for (int k = 0; k < o.stairwells; ++k) {
+            nodes.push_back({{"id", stair(f, k)}, {"name", fl + " Stair " + std::to_string(k + 1)},
+                             {"temperature", 291.15}, {"elevation", z}, {"volume", 20.0 * o.floorHeight}});
+        }
+        for (int e = 0; e < o.elevatorShafts; ++e) {
+            nodes.push_back({{"id", shaft(f, e)}, {"name", fl + " Elevator " + std::to_string(e + 1)},
+                             {"temperature", 292.15}, {"elevation", z}, {"volume", 6.0 * o.floorHeight}});
+        }
+    }
+    model["nodes"] = std::move(nodes);
+
+    // ── Links ──
+    json links = json::array();
+    std::vector<int> exhaustLinks;   // link index of each floor's exhaust fan
+    auto link = [&](int from, int to, double elevation, json element) {
+        links.push_back({{"id", static_cast<int>(links.size()) + 1}, {"from", from}, {"to", to},
+                         {"elevation", elevation}, {"element", std::move(element)}});
+    };
+
+    for (int f = 0; f < o.floors; ++f) {
+        const double z = f * o.floorHeight;
+        for (int s = 0; s + 1 < corridors; ++s) link(corridor(f, s), corridor(f, s + 1), z + 1.0, "corridor");
+        for (int i = 0; i < o.zonesPerFloor; ++i) {
+            const int orientation = i * 4 / o.zonesPerFloor;
+            const int seg = i * corridors / o.zonesPerFloor;
+            link(corridor(f, seg), office(f, i), z + 1.0, "officeDoor");
+            // Facade leakage scattered around 0.5 cm² per m³ of office
+            const double ela = 0.00005 * officeVolumes[f * o.zonesPerFloor + i] * rnd.uniform(0.7, 1.3);
+            link(facade(f, orientation), office(f, i), z + 1.5,
+                 json{{"type", "PowerLawOrifice"}, {"leakageArea", ela}, {"n", 0.65}});
+        }
+        for (int k = 0; k < o.stairwells; ++k) {
+            link(corridor(f, k * corridors / std::max(o.stairwells, 1)), stair(f, k), z + 1.0, "stairDoor");
+            if (f > 0) link(stair(f - 1, k), stair(f, k), z, "stairFlight");
+        }
+        for (int e = 0; e < o.elevatorShafts; ++e) {
+            link(corridor(f, (e * corridors) / std::max(o.elevatorShafts, 1)), shaft(f, e), z + 1.0, "elevatorDoor");
+            if (f > 0) link(shaft(f - 1, e), shaft(f, e), z, "shaftOpen");
+        }
+        if (f > 0) link(corridor(f - 1, 0), corridor(f, 0), z, "floorLeak");
+
+        exhaustLinks.push_back(static_cast<int>(links.size()));
+        link(corridor(f, corridors - 1), facade(f, 2), z + o.floorHeight - 0.5, "exhaustFan");
+    }
+    link(facade(0, 0), corridor(0, 0), 1.0, "entrance");
+    for (int e = 0; e < o.elevatorShafts; ++e) {
+        const int top = o.floors - 1;
+        link(shaft(top, e), facade(top, 0), o.floors * o.floorHeight, "shaftVent");
+    }
+    model["links"] = std::move(links);
+
+    // ── Schedules ──
+    const int OFFICE_HOURS = 1;
+    json schedules = json::array();
+    schedules.push_back(stepSchedule(OFFICE_HOURS, "Office hours",
+                                     {{0.0, 0.0}, {7 * HOUR, 1.0}, {19 * HOUR, 0.0}}));
+
+    // ── Species and sources ──
+    if (o.species > 0) {
+        json species = json::array(), sources = json::array();
+        species.push_back({{"id", 0}, {"name", "CO2"}, {"molarMass", 0.044},
+                           {"outdoorConcentration", 7.2e-4}});
+        for (int k = 1; k < o.species; ++k) {
+            species.push_back({{"id", k}, {"name", "VOC" + std::to_string(k)}, {"molarMass", 0.1},
+                               {"decayRate", k % 2 ? 0.0 : 2e-5}});
+            for (int f = 0; f < o.floors; ++f) {
+                for (int i = 0; i < o.zonesPerFloor; ++i) {
+                    if (!rnd.chance(0.25)) continue;
+                    sources.push_back({{"zoneId", office(f, i)}, {"speciesId", k},
+                                       {"generationRate", rnd.uniform(0.5e-8, 2e-8)},
+                                       {"scheduleId", OFFICE_HOURS}});
+                }
+            }
+        }
+        model["species"] = std::move(species);
+        if (!sources.empty()) model["sources"] = std::move(sources);
+    }
+
+    // ── Air handling: contiguous floor bands ──
+    if (o.ahsSystems > 0) {
+        json systems = json::array();
+        for (int a = 0; a < o.ahsSystems; ++a) {
+            const int f0 = a * o.floors / o.ahsSystems, f1 = (a + 1) * o.floors / o.ahsSystems;
+            double volume = 0.0;
+            for (int f = f0; f < f1; ++f) {
+                for (int i = 0; i < o.zonesPerFloor; ++i) volume += officeVolumes[f * o.zonesPerFloor + i];
+            }
+            json supply = json::array(), ret = json::array();
+            const int offices = (f1 - f0) * o.zonesPerFloor, segments = (f1 - f0) * corridors;
+            for (int f = f0; f < f1; ++f) {
+                for (int i = 0; i < o.zonesPerFloor; ++i) {
+                    supply.push_back({{"zoneId", office(f, i)}, {"fraction", 1.0 / offices}});
+                }
+                for (int s = 0; s < corridors; ++s) {
+                    ret.push_back({{"zoneId", corridor(f, s)}, {"fraction", 1.0 / segments}});
+                }
+            }
+            const double supplyFlow = volume * 4.0 / HOUR;   // 4 air changes per hour
+            systems.push_back({{"id", a + 1}, {"name", "AHS " + std::to_string(a + 1)},
+                               {"supplyFlow", supplyFlow}, {"returnFlow", 0.9 * supplyFlow},
+                               {"outdoorAirFlow", 0.2 * supplyFlow}, {"exhaustFlow", 0.1 * supplyFlow},
+                               {"supplyTemperature", 291.15}, {"supplyFlowScheduleId", OFFICE_HOURS},
+                               {"supplyZones", std::move(supply)}, {"returnZones", std::move(ret)}});
+        }
+        model["ahsSystems"] = std::move(systems);
+    }
+
+    // ── Occupants: office, lunch in the corridor, office ──
+    if (o.occupantsPerZone > 0) {
+        json occupants = json::array();
+        int occupantId = 1;
+        for (int f = 0; f < o.floors; ++f) {
+            for (int i = 0; i < o.zonesPerFloor; ++i) {
+                const double home = office(f, i);
+                const double lunch = corridor(f, i * corridors / o.zonesPerFloor);
+                for (int p = 0; p < o.occupantsPerZone; ++p) {
+                    const int scheduleId = 100 + occupantId;
+                    const double leave = 12 * HOUR + 300.0 * std::floor(rnd.uniform(0.0, 6.0));
+                    schedules.push_back(stepSchedule(scheduleId, "Occupant " + std::to_string(occupantId),
+                                                     {{0.0, home}, {leave, lunch}, {leave + HOUR, home}}));
+                    occupants.push_back({{"id", occupantId}, {"name", "Occupant " + std::to_string(occupantId)},
+                                         {"zoneId", office(f, i)}, {"breathingRate", rnd.uniform(1.0e-4, 1.4e-4)},
+                                         {"scheduleId", scheduleId}});
+                    ++occupantId;
+                }
+            }
+        }
+        model["occupants"] = std::move(occupants);
+    }
+    model["schedules"] = std::move(schedules);
+
+    // ── Controls: corridor CO2 drives the floor exhaust fan ──
+    if (o.controls && o.species > 0) {
+        json sensors = json::array(), controllers = json::array(), actuators = json::array();
+        for (int f = 0; f < o.floors; ++f) {
+            const std::string fl = "F" + std::to_string(f + 1);
+            sensors.push_back({{"id", f + 1}, {"name", fl + " corridor CO2"}, {"type", "Concentration"},
+                               {"targetId", corridor(f, 0)}, {"speciesIdx", 0}});
+            actuators.push_back({{"id", f + 1}, {"name", fl + " exhaust fan"}, {"type", "FanSpeed"},
+                                 {"linkIdx", exhaustLinks[f]}});
+            controllers.push_back({{"id", f + 1}, {"name", fl + " exhaust control"}, {"sensorId", f + 1},
+                                   {"actuatorId", f + 1}, {"setpoint", 1.6e-3}, {"Kp", 500.0},
+                                   {"Ki", 0.5}, {"deadband", 5e-5}});
+        }
+        model["controls"] = {{"sensors", std::move(sensors)}, {"controllers", std::move(controllers)},
+                             {"actuators", std::move(actuators)}};
+    }
+
+    model["transient"] = {{"startTime", 0.0}, {"endTime", o.hours * HOUR}, {"timeStep", 300.0},
+                          {"outputInterval", 900.0}, {"airflowMethod", o.airflowMethod}};
+    return model;
+}
+
+} // namespace contam
@@ -0,0 +1,44 @@
+#pragma once
+#include <nlohmann/json_fwd.hpp>
+#include <cstdint>
+#include <string>
+
+namespace contam {
+
+// Parameters of a generated office high-rise
+struct ModelGeneratorOptions {
+    int floors = 10;
+    int zonesPerFloor = 12;        // offices per floor
+    double floorHeight = 3.5;      // m
+    int stairwells = 2;
+    int elevatorShafts = 1;
+    int species = 1;               // the first is CO2, the rest are office VOCs
+    int ahsSystems = 1;            // floors are split into this many AHS zones
+    int occupantsPerZone = 1;      // occupants per office
+    bool controls = true;          // CO2 control of the floor exhaust fans (needs a species)
+    double outdoorTemperature = 278.15;   // K
+    double windSpeed = 5.0;        // m/s
+    double windDirection = 225.0;  // degrees from north
+    double hours = 24.0;           // transient length; 5 min steps, 15 min output
+    std::string airflowMethod = "subRelaxation";
+    uint64_t seed = 1;
+};
+
+// Model JSON of an office high-rise. Every floor has a corridor of one
+// segment per six offices, offices spread over the four facades, and one
+// node per stairwell and elevator shaft; shafts and stairs are stacked
+// through the building, the elevator shafts vent at the roof and each
+// floor has a corridor exhaust fan. Offices leak to ambient nodes of their
+// facade orientation with a wall Cp(θ) profile; a new set of facade nodes
+// (with a higher terrain factor) starts every ten floors. AHS systems supply
+// the offices and return from the corridors of their floors, and occupants
+// work in their office with a lunch break in the corridor.
+//
+// Node ids equal node indices and link ids equal link index + 1, so zone
+// references (AHS, occupants, actuators) are valid either way. Volumes,
+// leakage, temperatures and VOC source placement are drawn from `seed`;
+// the same options give the same model with every standard library.
+// Throws std::runtime_error for out-of-range options.
+nlohmann::json generateModel(const ModelGeneratorOptions& options);
+
+} // namespace contam
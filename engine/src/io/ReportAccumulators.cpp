@@ -0,0 +1,442 @@
+#include "io/ReportAccumulators.h"
+#include "core/ContaminantSolver.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace contam {
+
+static void requireWholeNetwork(const OutputSelection& output, const char* what) {
+    if (output.filtersNodes() || output.filtersLinks() || output.filtersSpecies()) {
+        throw std::runtime_error(std::string(what) +
+                                 ": output selection must not filter nodes, links or species");
+    }
+}
+
+// ── CsmAccumulator ───────────────────────────────────────────────────
+
+CsmAccumulator::CsmAccumulator(const std::vector<Source>& sources,
+                               const std::map<int, Schedule>& schedules)
+    : sources_(sources), schedules_(schedules) {}
+
+void CsmAccumulator::begin(const Network& network, const std::vector<Species>& species,
+                           const OutputSelection& output) {
+    requireWholeNetwork(output, "CsmAccumulator");
+    net_ = &network;
+    species_ = species;
+    zones_.clear();
+    std::vector<int> zoneOf(static_cast<std::size_t>(network.getNodeCount()), -1);
+    for (int i = 0; i < network.getNodeCount(); ++i) {
+        if (network.getNode(i).isKnownPressure()) continue;
+        zoneOf[static_cast<std::size_t>(i)] = static_cast<int>(zones_.size());
+        zones_.push_back(i);
+    }
+
+    // Sources in a non-ambient zone for a simulated species, as the
+    // contaminant solver applies them
+    zoneSources_.clear();
+    for (std::size_t n = 0; n < sources_.size(); ++n) {
+        const Source& src = sources_[n];
+        int node = network.getNodeIndexById(src.zoneId);
+        if (node < 0 || zoneOf[static_cast<std::size_t>(node)] < 0) continue;
+        auto sp = std::find_if(species.begin(), species.end(),
+                               [&](const Species& s) { return s.id == src.speciesId; });
+        if (sp == species.end()) continue;
+        zoneSources_.push_back({static_cast<std::size_t>(zoneOf[static_cast<std::size_t>(node)]),
+                                static_cast<std::size_t>(sp - species.begin()), n});
+    }
+
+    stats_.assign(zones_.size() * species.size(), ZoneStats{});
+    exfiltration_.assign(species.size(), 0.0);
+    lastConc_.assign(zones_.size() * species.size(), 0.0);
+    lastTime_ = 0.0;
+    steps_ = 0;
+}
+
+void CsmAccumulator::onStep(const TimeStepResult& step) {
+    // The step at startTime is the initial state; each later step closes the
+    // interval since the previous one. Rates are taken at the end of the
+    // interval, like the solver's implicit Euler step, so with one recorded
+    // step per time step the totals close the solver's mass balance.
+    const double dt = step.time - lastTime_;
+    const bool integrate = steps_ > 0 && dt > 0.0;
+    steps_++;
+    lastTime_ = step.time;
+
+    const Network& net = *net_;
+    const auto& conc = step.contaminant.concentrations;
+    const std::size_t numSpecies = species_.size();
+    auto concAt = [&](std::size_t node, std::size_t k) {
+        return node < conc.size() && k < conc[node].size() ? conc[node][k] : 0.0;
+    };
+
+    if (integrate) {
+        const auto& pressures = step.airflow.pressures;
+        for (const auto& zs : zoneSources_) {
+            const std::size_t node = static_cast<std::size_t>(zones_[zs.zone]);
+            const Source& src = sources_[zs.source];
+            ZoneStats& s = stats_[zs.zone * numSpecies + zs.species];
+            auto sched = src.scheduleId >= 0 ? schedules_.find(src.scheduleId) : schedules_.end();
+            double mult = sched != schedules_.end() ? sched->second.getValue(step.time) : 1.0;
+            double pressure = node < pressures.size() ? pressures[node]
+                                                      : net.getNode(zones_[zs.zone]).getPressure();
+            // Cutoff sources see the concentration the step started from
+            s.emission += ContaminantSolver::generationRate(
+                              src, step.time, lastConc_[zs.zone * numSpecies + zs.species],
+                              pressure) * mult * dt;
+            if (src.removalRate > 0.0) {
+                double volume = net.getNode(zones_[zs.zone]).getVolume();
+                if (volume <= 0.0) volume = 1.0;
+                s.removal += src.removalRate * volume * concAt(node, zs.species) * dt;
+            }
+        }
+
+        // Exfiltration: outward flow through every link from a zone to ambient
+        const auto& massFlows = step.airflow.massFlows;
+        const std::size_t numLinks = std::min(massFlows.size(),
+                                              static_cast<std::size_t>(net.getLinkCount()));
+        for (std::size_t j = 0; j < numLinks; ++j) {
+            const auto& link = net.getLink(static_cast<int>(j));
+            const double mf = massFlows[j];
+            int from = mf > 0.0 ? link.getNodeFrom() : link.getNodeTo();
+            int to = mf > 0.0 ? link.getNodeTo() : link.getNodeFrom();
+            if (mf == 0.0 || net.getNode(from).isKnownPressure() ||
+                !net.getNode(to).isKnownPressure()) {
+                continue;
+            }
+            double density = net.getNode(from).getDensity();
+            if (density <= 0.0) density = 1.2;
+            const double volFlow = std::abs(mf) / density;
+            for (std::size_t k = 0; k < numSpecies; ++k) {
+                exfiltration_[k] += volFlow * concAt(static_cast<std::size_t>(from), k) * dt;
+            }
+        }
+    }
+
+    for (std::size_t z = 0; z < zones_.size(); ++z) {
+        const std::size_t i = static_cast<std::size_t>(zones_[z]);
+        for (std::size_t k = 0; k < numSpecies; ++k) {
+            double c = concAt(i, k);
+            lastConc_[z * numSpecies + k] = c;
+            if (i >= conc.size() || k >= conc[i].size()) continue;
+            ZoneStats& s = stats_[z * numSpecies + k];
+            s.sum += c;
+            s.count++;
+            if (c > s.peak) {
+                s.peak = c;
+                s.peakTime = step.time;
+            }
+        }
+    }
+}
+
+std::size_t CsmAccumulator::memoryBytes() const {
+    return vectorBytes(zones_) + vectorBytes(zoneSources_) + vectorBytes(stats_) +
+           vectorBytes(exfiltration_) + vectorBytes(lastConc_);
+}
+
+std::vector<CsmSpeciesResult> CsmAccumulator::result() const {
+    std::vector<CsmSpeciesResult> results;
+    if (steps_ == 0 || species_.empty()) return results;
+
+    const Network& net = *net_;
+    const std::size_t numSpecies = species_.size();
+
+    for (std::size_t k = 0; k < numSpecies; ++k) {
+        CsmSpeciesResult sr;
+        sr.speciesId = species_[k].id;
+        sr.speciesName = species_[k].name;
+        sr.totalBuildingEmission = 0.0;
+        sr.totalBuildingRemoval = 0.0;
+        sr.totalExfiltration = exfiltration_[k];
+
+        for (std::size_t z = 0; z < zones_.size(); ++z) {
+            const auto& node = net.getNode(zones_[z]);
+            const ZoneStats& s = stats_[z * numSpecies + k];
+
+            CsmZoneResult zr;
+            zr.zoneId = node.getId();
+            zr.zoneName = node.getName();
+            zr.avgConcentration = s.count > 0 ? s.sum / s.count : 0.0;
+            zr.peakConcentration = s.peak;
+            zr.peakTime = s.peakTime;
+            zr.totalEmission = s.emission;
+            zr.totalRemoval = s.removal;
+            zr.totalFiltered = 0.0;   // link filters are not part of the step results
+            sr.totalBuildingEmission += s.emission;
+            sr.totalBuildingRemoval += s.removal;
+
+            sr.zones.push_back(zr);
+        }
+
+        results.push_back(sr);
+    }
+
+    return results;
+}
+
+// ── CexAccumulator ───────────────────────────────────────────────────
+
+void CexAccumulator::begin(const Network& network, const std::vector<Species>& species,
+                           const OutputSelection& output) {
+    requireWholeNetwork(output, "CexAccumulator");
+    net_ = &network;
+    species_ = species;
+
+    // Exterior openings: links with exactly one ambient end
+    openings_.clear();
+    for (int j = 0; j < network.getLinkCount(); ++j) {
+        const auto& link = network.getLink(j);
+        int nFrom = link.getNodeFrom();
+        int nTo = link.getNodeTo();
+        bool fromAmbient = network.getNode(nFrom).isKnownPressure();
+        bool toAmbient = network.getNode(nTo).isKnownPressure();
+
+        if (fromAmbient && !toAmbient) {
+            openings_.push_back({j, nTo, nFrom});
+        } else if (!fromAmbient && toAmbient) {
+            openings_.push_back({j, nFrom, nTo});
+        }
+    }
+    stats_.assign(openings_.size() * species.size(), OpeningStats{});
+    firstTime_ = lastTime_ = 0.0;
+    steps_ = 0;
+}
+
+void CexAccumulator::onStep(const TimeStepResult& step) {
+    const double dt = step.time - lastTime_;
+    const bool integrate = steps_ > 0 && dt > 0.0;
+    if (steps_++ == 0) firstTime_ = step.time;
+    lastTime_ = step.time;
+
+    const auto& conc = step.contaminant.concentrations;
+    const auto& massFlows = step.airflow.massFlows;
+    const std::size_t numOpenings = openings_.size();
+
+    for (std::size_t o = 0; o < numOpenings; ++o) {
+        const Opening& ext = openings_[o];
+        double mf = 0.0;
+        if (ext.linkIndex < static_cast<int>(massFlows.size())) {
+            mf = massFlows[ext.linkIndex];
+        }
+
+        // Positive flow runs nodeFrom -> nodeTo
+        const auto& link = net_->getLink(ext.linkIndex);
+        double outwardMassFlow = 0.0;
+        if (link.getNodeFrom() == ext.interiorNodeIndex && mf > 0.0) {
+            outwardMassFlow = mf;
+        } else if (link.getNodeTo() == ext.interiorNodeIndex && mf < 0.0) {
+            outwardMassFlow = -mf;
+        }
+
+        const std::vector<double>* zoneConc = nullptr;
+        if (ext.interiorNodeIndex < static_cast<int>(conc.size())) {
+            zoneConc = &conc[ext.interiorNodeIndex];
+        }
+
+        for (std::size_t k = 0; k < species_.size(); ++k) {
+            double c = (zoneConc && k < zoneConc->size()) ? (*zoneConc)[k] : 0.0;
+            double rate = outwardMassFlow * c;
+
+            OpeningStats& s = stats_[k * numOpenings + o];
+            if (rate > s.peak) s.peak = rate;
+            // Trapezoidal integration
+            if (integrate) s.integral += 0.5 * (s.prev + rate) * dt;
+            s.prev = rate;
+        }
+    }
+}
+
+std::size_t CexAccumulator::memoryBytes() const {
+    return vectorBytes(openings_) + vectorBytes(stats_);
+}
+
+std::vector<CexSpeciesResult> CexAccumulator::result() const {
+    std::vector<CexSpeciesResult> results;
+    if (steps_ == 0 || species_.empty()) return results;
+
+    const Network& net = *net_;
+    const std::size_t numOpenings = openings_.size();
+    const double duration = lastTime_ - firstTime_;
+
+    for (std::size_t k = 0; k < species_.size(); ++k) {
+        CexSpeciesResult sr;
+        sr.speciesId = species_[k].id;
+        sr.speciesName = species_[k].name;
+        sr.totalExfiltration = 0.0;
+
+        for (std::size_t o = 0; o < numOpenings; ++o) {
+            const Opening& ext = openings_[o];
+            const OpeningStats& s = stats_[k * numOpenings + o];
+
+            // Contaminant mass flow rate = volumeFlow * concentration,
+            // volumeFlow = massFlow / density of the interior zone
+            double density = net.getNode(ext.interiorNodeIndex).getDensity();
+            if (density <= 0.0) density = 1.2;
+
+            CexOpeningResult op;
+            op.linkId = net.getLink(ext.linkIndex).getId();
+            op.fromNodeIndex = ext.interiorNodeIndex;
+            op.toNodeIndex = ext.ambientNodeIndex;
+            op.fromNodeName = net.getNode(ext.interiorNodeIndex).getName();
+            op.toNodeName = net.getNode(ext.ambientNodeIndex).getName();
+            op.totalMassExfiltrated = s.integral / density;
+            op.peakMassFlowRate = s.peak / density;
+            op.avgMassFlowRate = duration > 0.0 ? op.totalMassExfiltrated / duration : 0.0;
+
+            sr.totalExfiltration += op.totalMassExfiltrated;
+            sr.openings.push_back(op);
+        }
+
+        results.push_back(sr);
+    }
+
+    return results;
+}
+
+// ── EbwAccumulator ───────────────────────────────────────────────────
+
+EbwAccumulator::EbwAccumulator(const std::vector<Occupant>& occupants)
+    : occupants_(occupants) {}
+
+void EbwAccumulator::begin(const Network& network, const std::vector<Species>& species,
+                           const OutputSelection& output) {
+    (void)network;
+    requireWholeNetwork(output, "EbwAccumulator");
+    numSpecies_ = species.size();
+    stats_.assign(occupants_.size() * numSpecies_, ExposureStats{});
+    prevTime_ = 0.0;
+    steps_ = 0;
+}
+
+void EbwAccumulator::onStep(const TimeStepResult& step) {
+    const double dt = step.time - prevTime_;
+    const bool first = steps_++ == 0;
+    prevTime_ = step.time;
+    // Exposure is charged to the end of each interval
+    if (first || dt <= 0.0) return;
+
+    const auto& conc = step.contaminant.concentrations;
+    for (std::size_t o = 0; o < occupants_.size(); ++o) {
+        const Occupant& occ = occupants_[o];
+        int zoneIdx = occ.currentZoneIdx;
+        if (zoneIdx < 0 || zoneIdx >= static_cast<int>(conc.size())) continue;
+
+        const auto& zoneConc = conc[zoneIdx];
+        const std::size_t n = std::min(numSpecies_, zoneConc.size());
+        for (std::size_t s = 0; s < n; ++s) {
+            double c = zoneConc[s];
+            ExposureStats& e = stats_[o * numSpecies_ + s];
+
+            e.dose += occ.breathingRate * c * dt;
+            if (c > e.peak) {
+                e.peak = c;
+                e.peakTime = step.time;
+            }
+            if (c > 1e-15) {
+                e.exposureTime += dt;
+            }
+            e.concSum += c;
+            e.concCount++;
+        }
+    }
+}
+
+std::size_t EbwAccumulator::memoryBytes() const {
+    return vectorBytes(occupants_) + vectorBytes(stats_);
+}
+
+std::vector<OccupantExposure> EbwAccumulator::result() const {
+    std::vector<OccupantExposure> results;
+    if (occupants_.empty() || numSpecies_ == 0 || steps_ < 2) return results;
+
+    for (std::size_t o = 0; o < occupants_.size(); ++o) {
+        const Occupant& occ = occupants_[o];
+        for (std::size_t s = 0; s < numSpecies_; ++s) {
+            const ExposureStats& e = stats_[o * numSpecies_ + s];
+            OccupantExposure ex;
+            ex.occupantId = occ.id;
+            ex.occupantName = occ.name;
+            ex.speciesIndex = static_cast<int>(s);
+            ex.breathingRate = occ.breathingRate;
+            ex.cumulativeDose = e.dose;
+            ex.peakConcentration = e.peak;
+            ex.timeAtPeak = e.peakTime;
+            ex.totalExposureTime = e.exposureTime;
+            ex.meanConcentration = (e.concCount > 0) ? (e.concSum / e.concCount) : 0.0;
+            results.push_back(ex);
+        }
+    }
+    return results;
+}
+
+// ── AchAccumulator ───────────────────────────────────────────────────
+
+void AchAccumulator::begin(const Network& network, const std::vector<Species>& species,
+                           const OutputSelection& output) {
+    (void)species;
+    requireWholeNetwork(output, "AchAccumulator");
+    net_ = &network;
+    zones_.clear();
+    for (int i = 0; i < network.getNodeCount(); ++i) {
+        const auto& node = network.getNode(i);
+        if (!node.isKnownPressure() && node.getVolume() > 0.0) zones_.push_back(i);
+    }
+    stats_.assign(zones_.size(), ZoneStats{});
+    lastFlows_.clear();
+    samples_ = 0;
+}
+
+void AchAccumulator::onStep(const TimeStepResult& step) {
+    const auto& massFlows = step.airflow.massFlows;
+    if (massFlows.empty()) return;  // flows not recorded at this step
+
+    AchReport::computeInflows(*net_, massFlows, airDensity_, inflows_);
+    for (std::size_t z = 0; z < zones_.size(); ++z) {
+        const int i = zones_[z];
+        const double volume = net_->getNode(i).getVolume();
+        const double ach = inflows_.total[i] * 3600.0 / volume;
+
+        ZoneStats& s = stats_[z];
+        s.sum += ach;
+        s.min = samples_ == 0 ? ach : std::min(s.min, ach);
+        s.max = samples_ == 0 ? ach : std::max(s.max, ach);
+        s.mechSum += inflows_.interZone[i] * 3600.0 / volume;
+        s.infiltSum += inflows_.infiltration[i] * 3600.0 / volume;
+    }
+    lastFlows_ = massFlows;
+    samples_++;
+}
+
+std::size_t AchAccumulator::memoryBytes() const {
+    return vectorBytes(zones_) + vectorBytes(stats_) + vectorBytes(lastFlows_) + vectorBytes(inflows_.total) +
+           vectorBytes(inflows_.interZone) + vectorBytes(inflows_.infiltration);
+}
+
+std::vector<AchResult> AchAccumulator::result() const {
+    return AchReport::compute(*net_, lastFlows_, airDensity_);
+}
+
+std::vector<AchStatistics> AchAccumulator::statistics() const {
+    std::vector<AchStatistics> results;
+    const double n = samples_ > 0 ? static_cast<double>(samples_) : 1.0;
+    for (std::size_t z = 0; z < zones_.size(); ++z) {
+        const auto& node = net_->getNode(zones_[z]);
+        const ZoneStats& s = stats_[z];
+
+        AchStatistics r;
+        r.zoneId = node.getId();
+        r.zoneName = node.getName();
+        r.volume = node.getVolume();
+        r.meanAch = s.sum / n;
+        r.minAch = s.min;
+        r.maxAch = s.max;
+        r.meanMechanicalAch = s.mechSum / n;
+        r.meanInfiltrationAch = s.infiltSum / n;
+        r.samples = samples_;
+        results.push_back(r);
+    }
+    return results;
+}
+
+} // namespace contam
@@ -0,0 +1,193 @@
+#pragma once
+#include "core/ResultSink.h"
+#include "core/TransientSimulation.h"
+#include "io/AchReport.h"
+#include "io/CexReport.h"
+#include "io/CsmReport.h"
+#include "io/EbwReport.h"
+#include <cstddef>
+#include <map>
+#include <vector>
+
+namespace contam {
+
+// Single-pass versions of the summary reports. Each accumulator is a
+// ResultSink that folds every recorded step into running totals as the
+// simulation produces it, so the reports no longer need
+// TransientResult::history:
+//
+//   auto csm = std::make_shared<CsmAccumulator>();
+//   sim.addResultSink(csm);
+//   sim.setStoreHistory(false);
+//   sim.run(net);
+//   auto report = csm->result();
+//
+// State is O(zones + links) per species. The history-based compute()
+// functions drive the same accumulators, so both paths give identical
+// reports. Like the history-based versions, result() reads link flows and
+// zone densities from the network, so call it while the network passed to
+// run() is still alive. The accumulators need whole-network steps and
+// throw std::runtime_error from begin() if the output selection filters
+// nodes, links or species.
+
+// ── CSM: zone concentration statistics ──────────────────────────────
+
+class CsmAccumulator : public ResultSink {
+public:
+    // Emission and removal totals come from `sources` (evaluated as the
+    // contaminant solver does, with `schedules`); without them only the
+    // concentration statistics and exfiltration are filled in. Per-step
+    // extra sources (air handlers, occupants) are not counted.
+    explicit CsmAccumulator(const std::vector<Source>& sources = {},
+                            const std::map<int, Schedule>& schedules = {});
+
+    void begin(const Network& network, const std::vector<Species>& species,
+               const OutputSelection& output) override;
+    void onStep(const TimeStepResult& step) override;
+    std::size_t memoryBytes() const override;
+    MemoryComponent memoryComponent() const override { return MemoryComponent::ReportAccumulators; }
+
+    std::vector<CsmSpeciesResult> result() const;
+
+private:
+    struct ZoneStats {
+        double sum = 0.0;
+        int count = 0;
+        double peak = 0.0;
+        double peakTime = 0.0;
+        double emission = 0.0;   // kg
+        double removal = 0.0;    // kg
+    };
+    struct ZoneSource {
+        std::size_t zone;        // index into zones_
+        std::size_t species;
+        std::size_t source;      // index into sources_
+    };
+
+    std::vector<Source> sources_;
+    std::map<int, Schedule> schedules_;
+    const Network* net_ = nullptr;
+    std::vector<Species> species_;
+    std::vector<int> zones_;                 // non-ambient node indices
+    std::vector<ZoneSource> zoneSources_;
+    std::vector<ZoneStats> stats_;           // [zone * numSpecies + species]
+    std::vector<double> exfiltration_;       // kg, per species
+    std::vector<double> lastConc_;           // [zone * numSpecies + species]
+    double lastTime_ = 0.0;
+    std::size_t steps_ = 0;
+};
+
+// ── CEX: per-opening exfiltration ───────────────────────────────────
+
+class CexAccumulator : public ResultSink {
+public:
+    void begin(const Network& network, const std::vector<Species>& species,
+               const OutputSelection& output) override;
+    void onStep(const TimeStepResult& step) override;
+    std::size_t memoryBytes() const override;
+    MemoryComponent memoryComponent() const override { return MemoryComponent::ReportAccumulators; }
+
+    std::vector<CexSpeciesResult> result() const;
+
+private:
+    struct Opening {
+        int linkIndex;
+        int interiorNodeIndex;
+        int ambientNodeIndex;
+    };
+    // Integrals are of outward mass flow * concentration (kg/s * kg/m^3);
+    // result() divides by the interior zone density
+    struct OpeningStats {
+        double integral = 0.0;
+        double peak = 0.0;
+        double prev = 0.0;
+    };
+
+    const Network* net_ = nullptr;
+    std::vector<Species> species_;
+    std::vector<Opening> openings_;
+    std::vector<OpeningStats> stats_;        // [species * numOpenings + opening]
+    double firstTime_ = 0.0;
+    double lastTime_ = 0.0;
+    std::size_t steps_ = 0;
+};
+
+// ── EBW: occupant exposure ──────────────────────────────────────────
+
+class EbwAccumulator : public ResultSink {
+public:
+    // Occupants stay in their currentZoneIdx for the whole run
+    explicit EbwAccumulator(const std::vector<Occupant>& occupants);
+
+    void begin(const Network& network, const std::vector<Species>& species,
+               const OutputSelection& output) override;
+    void onStep(const TimeStepResult& step) override;
+    std::size_t memoryBytes() const override;
+    MemoryComponent memoryComponent() const override { return MemoryComponent::ReportAccumulators; }
+
+    std::vector<OccupantExposure> result() const;
+
+private:
+    struct ExposureStats {
+        double dose = 0.0;
+        double peak = 0.0;
+        double peakTime = 0.0;
+        double exposureTime = 0.0;
+        double concSum = 0.0;
+        int concCount = 0;
+    };
+
+    std::vector<Occupant> occupants_;
+    std::size_t numSpecies_ = 0;
+    std::vector<ExposureStats> stats_;       // [occupant * numSpecies + species]
+    double prevTime_ = 0.0;
+    std::size_t steps_ = 0;
+};
+
+// ── ACH: air change statistics ──────────────────────────────────────
+
+struct AchStatistics {
+    int zoneId;
+    std::string zoneName;
+    double volume;              // m^3
+    double meanAch;             // mean total ACH over steps with flows
+    double minAch;
+    double maxAch;
+    double meanMechanicalAch;
+    double meanInfiltrationAch;
+    std::size_t samples;        // steps that carried mass flows
+};
+
+class AchAccumulator : public ResultSink {
+public:
+    explicit AchAccumulator(double airDensity = 1.2) : airDensity_(airDensity) {}
+
+    void begin(const Network& network, const std::vector<Species>& species,
+               const OutputSelection& output) override;
+    void onStep(const TimeStepResult& step) override;
+    std::size_t memoryBytes() const override;
+    MemoryComponent memoryComponent() const override { return MemoryComponent::ReportAccumulators; }
+
+    // AchReport::compute for the last step that carried mass flows
+    std::vector<AchResult> result() const;
+    std::vector<AchStatistics> statistics() const;
+
+private:
+    struct ZoneStats {
+        double sum = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+        double mechSum = 0.0;
+        double infiltSum = 0.0;
+    };
+
+    const Network* net_ = nullptr;
+    double airDensity_;
+    std::vector<int> zones_;                 // non-ambient nodes with volume
+    std::vector<ZoneStats> stats_;
+    AchInflows inflows_;
+    std::vector<double> lastFlows_;
+    std::size_t samples_ = 0;
+};
+
+} // namespace contam
@@ -0,0 +1,363 @@
+#include "io/ResultPyramid.h"
+#include "utils/ByteStream.h"
+#include "utils/MappedFile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace contam {
+
+// Bytes gathered per write when a spilled level is copied into the file
+static constexpr std::size_t SPILL_COPY_BYTES = 1 << 20;
+
+// ── Building ─────────────────────────────────────────────────────────
+
+ResultPyramid::~ResultPyramid() {
+    // A run that never reached end()
+    bool spilling = false;
+    for (const auto& lv : levels_) spilling = spilling || lv.spill.is_open();
+    if (spilling) removeSpills();
+}
+
+std::string ResultPyramid::spillPath(std::size_t level) const {
+    return path_ + ".spill" + std::to_string(level + 1);
+}
+
+void ResultPyramid::removeSpills() {
+    for (std::size_t L = 0; L < PYRAMID_LEVELS; ++L) {
+        if (levels_[L].spill.is_open()) levels_[L].spill.close();
+        std::remove(spillPath(L).c_str());
+    }
+}
+
+void ResultPyramid::reset() {
+    numSteps_ = 0;
+    const std::size_t S = layout_.size();
+    for (std::size_t L = 0; L < PYRAMID_LEVELS; ++L) {
+        Level& lv = levels_[L];
+        lv = Level{};
+        lv.accMin.resize(S);
+        lv.accMax.resize(S);
+        lv.accSum.resize(S);
+        lv.accCount.resize(S);
+        lv.binMin.resize(S);
+        lv.binMax.resize(S);
+        lv.binMean.resize(S);
+        if (streaming()) {
+            lv.spill.open(spillPath(L), std::ios::binary | std::ios::trunc);
+            if (!lv.spill.is_open()) {
+                throw std::runtime_error("Cannot open spill file: " + spillPath(L));
+            }
+        }
+    }
+}
+
+void ResultPyramid::begin(const Network& network, const std::vector<Species>& species,
+                          const OutputSelection& output) {
+    layout_ = {output.nodeCount(network), output.linkCount(network), output.speciesCount(species)};
+    reset();
+}
+
+void ResultPyramid::onStep(const TimeStepResult& step) {
+    layout_.flatten(step, row_);
+    accumulate(0, step.time, step.time, row_.data(), row_.data(), row_.data(), nullptr);
+    ++numSteps_;
+}
+
+std::size_t ResultPyramid::memoryBytes() const {
+    std::size_t bytes = vectorBytes(row_);
+    for (const auto& level : levels_) {
+        bytes += vectorBytes(level.tStart) + vectorBytes(level.tEnd) + vectorBytes(level.min) +
+                 vectorBytes(level.max) + vectorBytes(level.mean) + vectorBytes(level.accMin) +
+                 vectorBytes(level.accMax) + vectorBytes(level.accSum) + vectorBytes(level.accCount) +
+                 vectorBytes(level.binMin) + vectorBytes(level.binMax) + vectorBytes(level.binMean);
+    }
+    return bytes;
+}
+
+void ResultPyramid::end(bool /*completed*/) {
+    // Close partial bins bottom-up so each one still feeds the level above
+    for (std::size_t L = 0; L < PYRAMID_LEVELS; ++L) flush(L);
+    if (!streaming()) return;
+
+    try {
+        for (std::size_t L = 0; L < PYRAMID_LEVELS; ++L) {
+            levels_[L].spill.close();
+            if (!levels_[L].spill) {
+                throw std::runtime_error("Failed writing spill file: " + spillPath(L));
+            }
+        }
+        writeStreamed();
+    } catch (...) {
+        removeSpills();
+        throw;
+    }
+    removeSpills();
+}
+
+// Fold one child (a raw sample when counts == nullptr, else a bin of the
+// level below) into the pending bin of `level`
+void ResultPyramid::accumulate(std::size_t level, double tStart, double tEnd,
+                               const float* mins, const float* maxs, const float* means,
+                               const uint32_t* counts) {
+    Level& lv = levels_[level];
+    const std::size_t S = layout_.size();
+    if (lv.pending == 0) {
+        lv.pendingStart = tStart;
+        std::fill(lv.accMin.begin(), lv.accMin.end(), std::numeric_limits<float>::infinity());
+        std::fill(lv.accMax.begin(), lv.accMax.end(), -std::numeric_limits<float>::infinity());
+        std::fill(lv.accSum.begin(), lv.accSum.end(), 0.0);
+        std::fill(lv.accCount.begin(), lv.accCount.end(), 0u);
+    }
+    lv.pendingEnd = tEnd;
+
+    for (std::size_t s = 0; s < S; ++s) {
+        uint32_t c = counts ? counts[s] : (std::isnan(means[s]) ? 0u : 1u);
+        if (c == 0) continue;
+        lv.accMin[s] = std::min(lv.accMin[s], mins[s]);
+        lv.accMax[s] = std::max(lv.accMax[s], maxs[s]);
+        lv.accSum[s] += static_cast<double>(means[s]) * c;
+        lv.accCount[s] += c;
+    }
+
+    if (++lv.pending == PYRAMID_FACTOR) flush(level);
+}
+
+void ResultPyramid::flush(std::size_t level) {
+    Level& lv = levels_[level];
+    if (lv.pending == 0) return;
+
+    constexpr float NaN = std::numeric_limits<float>::quiet_NaN();
+    const std::size_t S = layout_.size();
+    for (std::size_t s = 0; s < S; ++s) {
+        const uint32_t c = lv.accCount[s];
+        lv.binMin[s] = c ? lv.accMin[s] : NaN;
+        lv.binMax[s] = c ? lv.accMax[s] : NaN;
+        lv.binMean[s] = c ? static_cast<float>(lv.accSum[s] / c) : NaN;
+    }
+    lv.pending = 0;
+
+    if (streaming()) {
+        auto put = [&lv](const void* data, std::size_t bytes) {
+            lv.spill.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        };
+        put(&lv.pendingStart, sizeof(double));
+        put(&lv.pendingEnd, sizeof(double));
+        put(lv.binMin.data(), S * sizeof(float));
+        put(lv.binMax.data(), S * sizeof(float));
+        put(lv.binMean.data(), S * sizeof(float));
+        ++lv.spilled;
+    } else {
+        lv.tStart.push_back(lv.pendingStart);
+        lv.tEnd.push_back(lv.pendingEnd);
+        lv.min.insert(lv.min.end(), lv.binMin.begin(), lv.binMin.end());
+        lv.max.insert(lv.max.end(), lv.binMax.begin(), lv.binMax.end());
+        lv.mean.insert(lv.mean.end(), lv.binMean.begin(), lv.binMean.end());
+    }
+
+    if (level + 1 < PYRAMID_LEVELS) {
+        accumulate(level + 1, lv.pendingStart, lv.pendingEnd, lv.binMin.data(), lv.binMax.data(),
+                   lv.binMean.data(), lv.accCount.data());
+    }
+}
+
+// ── Access ───────────────────────────────────────────────────────────
+
+std::size_t ResultPyramid::numBins(int level) const {
+    if (level == 0) return numSteps_;
+    if (level < 0 || level > static_cast<int>(PYRAMID_LEVELS)) {
+        throw std::out_of_range("Pyramid level out of range");
+    }
+    return levels_[level - 1].tStart.size();
+}
+
+PyramidBin ResultPyramid::bin(int level, std::size_t index, std::size_t series) const {
+    if (level < 1 || level > static_cast<int>(PYRAMID_LEVELS) || series >= layout_.size() ||
+        index >= levels_[level - 1].tStart.size()) {
+        throw std::out_of_range("Pyramid bin out of range");
+    }
+    const Level& lv = levels_[level - 1];
+    const std::size_t k = index * layout_.size() + series;
+    return {lv.tStart[index], lv.tEnd[index], lv.min[k], lv.max[k], lv.mean[k]};
+}
+
+PyramidQuery ResultPyramid::query(std::size_t series, double t0, double t1,
+                                  std::size_t pixelWidth,
+                                  const ColumnarResultsReader* fullRes) const {
+    if (series >= layout_.size()) {
+        throw std::out_of_range("Pyramid series out of range");
+    }
+    PyramidQuery q;
+    if (t1 < t0) return q;
+
+    auto binRange = [&](const Level& lv) {
+        auto first = std::lower_bound(lv.tEnd.begin(), lv.tEnd.end(), t0) - lv.tEnd.begin();
+        auto last = std::upper_bound(lv.tStart.begin(), lv.tStart.end(), t1) - lv.tStart.begin();
+        return std::make_pair(static_cast<std::size_t>(first),
+                              static_cast<std::size_t>(std::max(first, last)));
+    };
+    auto collect = [&](int level) {
+        auto [first, last] = binRange(levels_[level - 1]);
+        q.level = level;
+        q.bins.reserve(last - first);
+        for (std::size_t i = first; i < last; ++i) q.bins.push_back(bin(level, i, series));
+    };
+
+    for (int level = static_cast<int>(PYRAMID_LEVELS); level >= 1; --level) {
+        auto [first, last] = binRange(levels_[level - 1]);
+        if (last - first >= pixelWidth) {
+            collect(level);
+            return q;
+        }
+    }
+
+    if (fullRes && fullRes->numSeries() == layout_.size()) {
+        const double* times = fullRes->times();
+        const std::size_t n = fullRes->numSteps();
+        const std::size_t first = std::lower_bound(times, times + n, t0) - times;
+        const std::size_t last = std::upper_bound(times, times + n, t1) - times;
+        ColumnarSeries values = fullRes->series(series);
+        q.level = 0;
+        q.bins.reserve(last > first ? last - first : 0);
+        for (std::size_t i = first; i < last; ++i) {
+            q.bins.push_back({times[i], times[i], values[i], values[i], values[i]});
+        }
+        return q;
+    }
+
+    collect(1);
+    return q;
+}
+
+// ── Persistence ──────────────────────────────────────────────────────
+// Layout: magic u32, version u16, factor u16, levels u16, pad u16,
+// numNodes u32, numLinks u32, numSpecies u32, numSteps u64, then per level
+// the arrays tStart, tEnd, min, max, mean (time-major, ByteWriter encoding).
+
+static void putHeader(ByteWriter& w, const ResultSeriesLayout& layout, std::size_t numSteps) {
+    w.put(PYRAMID_MAGIC);
+    w.put(PYRAMID_VERSION);
+    w.put(static_cast<uint16_t>(PYRAMID_FACTOR));
+    w.put(static_cast<uint16_t>(PYRAMID_LEVELS));
+    w.put(static_cast<uint16_t>(0));
+    w.put(static_cast<uint32_t>(layout.numNodes));
+    w.put(static_cast<uint32_t>(layout.numLinks));
+    w.put(static_cast<uint32_t>(layout.numSpecies));
+    w.put(static_cast<uint64_t>(numSteps));
+}
+
+void ResultPyramid::save(const std::string& filepath) const {
+    ByteWriter w;
+    putHeader(w, layout_, numSteps_);
+    for (const auto& lv : levels_) {
+        w.putArray(lv.tStart);
+        w.putArray(lv.tEnd);
+        w.putArray(lv.min);
+        w.putArray(lv.max);
+        w.putArray(lv.mean);
+    }
+
+    std::ofstream out(filepath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Cannot open output file: " + filepath);
+    }
+    out.write(w.buffer().data(), static_cast<std::streamsize>(w.size()));
+    if (!out) {
+        throw std::runtime_error("Failed writing result pyramid: " + filepath);
+    }
+}
+
+// Same layout as save(), with each level's arrays gathered field by field
+// from its spill records a block at a time
+void ResultPyramid::writeStreamed() const {
+    const std::size_t S = layout_.size();
+    const std::size_t record = 2 * sizeof(double) + 3 * S * sizeof(float);
+
+    std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Cannot open output file: " + path_);
+    }
+    ByteWriter head;
+    putHeader(head, layout_, numSteps_);
+    out.write(head.buffer().data(), static_cast<std::streamsize>(head.size()));
+
+    std::vector<char> buf;
+    for (std::size_t L = 0; L < PYRAMID_LEVELS; ++L) {
+        const std::size_t bins = levels_[L].spilled;
+        MappedFile spill(spillPath(L));
+        if (spill.size() < bins * record) {
+            throw std::runtime_error("Result pyramid spill file is truncated: " + spillPath(L));
+        }
+
+        // One array as ByteWriter::putArray writes it: a u32 element count,
+        // then `bytes` from each record starting at `offset`
+        auto putField = [&](std::size_t offset, std::size_t bytes, std::size_t elemSize) {
+            const auto count = static_cast<uint32_t>(bins * (bytes / elemSize));
+            out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            if (bytes == 0) return;
+            const std::size_t block = std::max<std::size_t>(1, SPILL_COPY_BYTES / bytes);
+            for (std::size_t b0 = 0; b0 < bins; b0 += block) {
+                const std::size_t n = std::min(block, bins - b0);
+                buf.resize(n * bytes);
+                for (std::size_t k = 0; k < n; ++k) {
+                    std::memcpy(&buf[k * bytes], spill.data() + (b0 + k) * record + offset, bytes);
+                }
+                out.write(buf.data(), static_cast<std::streamsize>(n * bytes));
+            }
+        };
+        const std::size_t values = S * sizeof(float);
+        putField(0, sizeof(double), sizeof(double));
+        putField(sizeof(double), sizeof(double), sizeof(double));
+        putField(2 * sizeof(double), values, sizeof(float));
+        putField(2 * sizeof(double) + values, values, sizeof(float));
+        putField(2 * sizeof(double) + 2 * values, values, sizeof(float));
+    }
+    if (!out) {
+        throw std::runtime_error("Failed writing result pyramid: " + path_);
+    }
+}
+
+ResultPyramid ResultPyramid::load(const std::string& filepath) {
+    MappedFile file(filepath);
+    ByteReader r(file.data(), file.size(), "Result pyramid");
+
+    if (file.size() < sizeof(uint32_t) || r.get<uint32_t>() != PYRAMID_MAGIC) {
+        throw std::runtime_error("Not a result pyramid file: " + filepath);
+    }
+    const auto version = r.get<uint16_t>();
+    if (version != PYRAMID_VERSION) {
+        throw std::runtime_error("Unsupported result pyramid version " +
+            std::to_string(version) + ": " + filepath);
+    }
+    const auto factor = r.get<uint16_t>();
+    const auto levels = r.get<uint16_t>();
+    r.get<uint16_t>();
+    if (factor != PYRAMID_FACTOR || levels != PYRAMID_LEVELS) {
+        throw std::runtime_error("Unsupported result pyramid shape: " + filepath);
+    }
+
+    ResultPyramid pyr;
+    pyr.layout_.numNodes = r.get<uint32_t>();
+    pyr.layout_.numLinks = r.get<uint32_t>();
+    pyr.layout_.numSpecies = r.get<uint32_t>();
+    pyr.numSteps_ = static_cast<std::size_t>(r.get<uint64_t>());
+    const std::size_t S = pyr.layout_.size();
+    for (auto& lv : pyr.levels_) {
+        lv.tStart = r.getArray<double>();
+        lv.tEnd = r.getArray<double>();
+        lv.min = r.getArray<float>();
+        lv.max = r.getArray<float>();
+        lv.mean = r.getArray<float>();
+        const std::size_t values = lv.tStart.size() * S;
+        if (lv.tEnd.size() != lv.tStart.size() || lv.min.size() != values ||
+            lv.max.size() != values || lv.mean.size() != values) {
+            throw std::runtime_error("Corrupt result pyramid: " + filepath);
+        }
+    }
+    return pyr;
+}
+
+} // namespace contam
@@ -0,0 +1,114 @@
+#pragma once
+#include "core/ResultSink.h"
+#include "io/ColumnarResults.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace contam {
+
+// One downsampled bin of one series
+struct PyramidBin {
+    double tStart;   // time of the first output step in the bin
+    double tEnd;     // time of the last output step in the bin
+    float min;
+    float max;
+    float mean;      // NaN if every sample in the bin was NaN
+};
+
+struct PyramidQuery {
+    int level = 0;   // 0 = full resolution, k = PYRAMID_FACTOR^k steps per bin
+    std::vector<PyramidBin> bins;
+};
+
+static constexpr uint32_t PYRAMID_MAGIC = 0x31505243;  // "CRP1"
+static constexpr uint16_t PYRAMID_VERSION = 1;
+static constexpr std::size_t PYRAMID_FACTOR = 10;
+static constexpr std::size_t PYRAMID_LEVELS = 3;     // x10, x100, x1000
+
+// Min/max/mean pyramid of every result series (ResultSeriesLayout order),
+// built online as output steps stream out. Each level bins
+// PYRAMID_FACTOR bins of the level below, so the whole pyramid costs about
+// 1/9 of the full-resolution data and never needs a pass over the history.
+//
+// Built in memory by default (bin, query and save work once the run ends).
+// A pyramid given a file path is a pure sink: each finished bin is appended
+// to a per-level spill file next to the output, memory holds only the bins
+// being filled, and end() assembles the file and removes the spills. Use
+// load() to query that file.
+class ResultPyramid : public ResultSink {
+public:
+    ResultPyramid() = default;
+
+    // Sink that streams the pyramid to `filepath`
+    explicit ResultPyramid(const std::string& filepath) : path_(filepath) {}
+    ~ResultPyramid() override;
+
+    ResultPyramid(ResultPyramid&&) = default;
+    ResultPyramid& operator=(ResultPyramid&&) = default;
+
+    void begin(const Network& network, const std::vector<Species>& species,
+               const OutputSelection& output) override;
+    void onStep(const TimeStepResult& step) override;
+    void end(bool completed) override;
+    std::size_t memoryBytes() const override;
+
+    const ResultSeriesLayout& layout() const { return layout_; }
+    std::size_t numSteps() const { return numSteps_; }
+    std::size_t numBins(int level) const;   // bins held in memory (level 0: steps)
+
+    PyramidBin bin(int level, std::size_t index, std::size_t series) const;
+
+    // Bins of `series` overlapping [t0, t1] from the coarsest level that still
+    // gives at least `pixelWidth` bins. When even the x10 level is too coarse
+    // the full-resolution samples are returned (level 0) if `fullRes` is
+    // given, otherwise the x10 bins.
+    PyramidQuery query(std::size_t series, double t0, double t1, std::size_t pixelWidth,
+                       const ColumnarResultsReader* fullRes = nullptr) const;
+
+    void save(const std::string& filepath) const;
+    static ResultPyramid load(const std::string& filepath);
+
+private:
+    struct Level {
+        // Completed bins held in memory, time-major: value [bin * numSeries + series]
+        std::vector<double> tStart, tEnd;
+        std::vector<float> min, max, mean;
+
+        // Completed bins streamed to the spill file instead, one record
+        // (tStart, tEnd, min[S], max[S], mean[S]) per bin
+        std::ofstream spill;
+        std::size_t spilled = 0;
+
+        // Bin being filled
+        std::size_t pending = 0;
+        double pendingStart = 0.0, pendingEnd = 0.0;
+        std::vector<float> accMin, accMax;
+        std::vector<double> accSum;
+        std::vector<uint32_t> accCount;
+
+        // Last finished bin, passed on to the level above
+        std::vector<float> binMin, binMax, binMean;
+    };
+
+    std::string path_;
+    ResultSeriesLayout layout_;
+    std::size_t numSteps_ = 0;
+    Level levels_[PYRAMID_LEVELS];
+    std::vector<float> row_;
+
+    bool streaming() const { return !path_.empty(); }
+    std::string spillPath(std::size_t level) const;
+    void removeSpills();
+    void writeStreamed() const;
+
+    void reset();
+    void accumulate(std::size_t level, double tStart, double tEnd,
+                    const float* mins, const float* maxs, const float* means,
+                    const uint32_t* counts);
+    void flush(std::size_t level);
+};
+
+} // namespace contam
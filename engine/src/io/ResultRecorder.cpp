@@ -0,0 +1,78 @@
+#include "io/ResultRecorder.h"
+#include "core/TransientSimulation.h"
+#include <algorithm>
+#include <limits>
+
+namespace contam {
+
+void ResultRecorder::begin(const Network& network, const std::vector<Species>& species,
+                           const OutputSelection& output) {
+    auto r = std::make_shared<RecordedResults>();
+    r->output = output;
+    r->numNodes = output.nodeCount(network);
+    r->numLinks = output.linkCount(network);
+    r->numSpecies = output.speciesCount(species);
+
+    if (expectedSteps_ > 0) {
+        r->times.reserve(expectedSteps_);
+        r->iterations.reserve(expectedSteps_);
+        r->converged.reserve(expectedSteps_);
+        r->pressures.reserve(expectedSteps_ * r->numNodes);
+        r->massFlows.reserve(expectedSteps_ * r->numLinks);
+        r->concentrations.reserve(expectedSteps_ * r->numNodes * r->numSpecies);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        results_ = std::move(r);
+    }
+    completed_ = false;
+    recording_ = true;
+}
+
+std::shared_ptr<const RecordedResults> ResultRecorder::results() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return results_;
+}
+
+// Append `count` values from `src` (zero-filled past its end), or NaN when
+// the variable was not recorded at this step
+static void appendRow(std::vector<double>& dst, const std::vector<double>& src,
+                      std::size_t count, bool recorded) {
+    if (!recorded) {
+        dst.insert(dst.end(), count, std::numeric_limits<double>::quiet_NaN());
+        return;
+    }
+    const std::size_t n = std::min(count, src.size());
+    dst.insert(dst.end(), src.begin(), src.begin() + static_cast<std::ptrdiff_t>(n));
+    dst.insert(dst.end(), count - n, 0.0);
+}
+
+void ResultRecorder::onStep(const TimeStepResult& step) {
+    RecordedResults& r = *results_;
+    r.times.push_back(step.time);
+    r.iterations.push_back(step.airflow.iterations);
+    r.converged.push_back(step.airflow.converged ? 1 : 0);
+    appendRow(r.pressures, step.airflow.pressures, r.numNodes, r.output.hasPressures(step));
+    appendRow(r.massFlows, step.airflow.massFlows, r.numLinks, r.output.hasMassFlows(step));
+
+    const auto& concs = step.contaminant.concentrations;
+    const bool recorded = !concs.empty() || r.output.spec().concentrationInterval == 0.0;
+    static const std::vector<double> none;
+    for (std::size_t i = 0; i < r.numNodes; ++i) {
+        appendRow(r.concentrations, i < concs.size() ? concs[i] : none, r.numSpecies, recorded);
+    }
+}
+
+std::size_t ResultRecorder::memoryBytes() const {
+    const RecordedResults& r = *results_;
+    return vectorBytes(r.times) + vectorBytes(r.iterations) + vectorBytes(r.converged) +
+           vectorBytes(r.pressures) + vectorBytes(r.massFlows) + vectorBytes(r.concentrations);
+}
+
+void ResultRecorder::end(bool completed) {
+    completed_ = completed;
+    recording_ = false;
+}
+
+} // namespace contam
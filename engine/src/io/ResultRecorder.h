@@ -0,0 +1,67 @@
+#pragma once
+#include "core/ResultSink.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace contam {
+
+// Transient results in contiguous row-major arrays, one row per output step.
+// Entities are the recorded ones (see OutputSelection::node/link/species).
+// Variables that were not recorded at a step hold NaN rows.
+struct RecordedResults {
+    OutputSelection output;
+    std::size_t numNodes = 0;
+    std::size_t numLinks = 0;
+    std::size_t numSpecies = 0;
+
+    std::vector<double> times;
+    std::vector<int> iterations;
+    std::vector<std::uint8_t> converged;
+    std::vector<double> pressures;       // [step][node]
+    std::vector<double> massFlows;       // [step][link]
+    std::vector<double> concentrations;  // [step][node][species]
+
+    std::size_t numSteps() const { return times.size(); }
+};
+
+// Sink that records every output step into RecordedResults. Unlike
+// TransientResult::history (one heap block per step and per node), the
+// arrays can be handed out as strided views, e.g. NumPy arrays in pycontam,
+// without copying.
+//
+// Each run records into a freshly allocated RecordedResults, so results
+// obtained from an earlier run stay valid and unchanged. The arrays grow
+// while recording(); only take pointers into them once the run has ended.
+// recording() and results() may be called from other threads during a run.
+class ResultRecorder : public ResultSink {
+public:
+    // `expectedSteps` pre-sizes the arrays (0 = grow as needed)
+    explicit ResultRecorder(std::size_t expectedSteps = 0) : expectedSteps_(expectedSteps) {}
+
+    void begin(const Network& network, const std::vector<Species>& species,
+               const OutputSelection& output) override;
+    void onStep(const TimeStepResult& step) override;
+    void end(bool completed) override;
+    std::size_t memoryBytes() const override;
+    MemoryComponent memoryComponent() const override { return MemoryComponent::History; }
+
+    void setExpectedSteps(std::size_t steps) { expectedSteps_ = steps; }
+    bool recording() const { return recording_.load(); }
+    bool completed() const { return completed_.load(); }
+
+    // Results of the current or most recent run (empty before the first run)
+    std::shared_ptr<const RecordedResults> results() const;
+
+private:
+    std::size_t expectedSteps_;
+    mutable std::mutex mutex_;   // guards the results_ pointer, not its contents
+    std::shared_ptr<RecordedResults> results_ = std::make_shared<RecordedResults>();
+    std::atomic<bool> recording_{false};
+    std::atomic<bool> completed_{false};
+};
+
+} // namespace contam
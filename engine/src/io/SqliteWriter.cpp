@@ -1,6 +1,7 @@
 #ifdef CONTAM_HAS_SQLITE3
 
 #include "io/SqliteWriter.h"
+#include "core/TransientSimulation.h"
 #include <sqlite3.h>
 #include <stdexcept>
 
@@ -8,24 +9,141 @@ namespace contam {
 
 struct SqliteWriter::Impl {
     sqlite3* db = nullptr;
-    sqlite3_stmt* stmtTransient = nullptr;
+    SqliteOptions options;
+    OutputSelection output;
+
+    sqlite3_stmt* stmtNode = nullptr;
+    sqlite3_stmt* stmtLink = nullptr;
+    sqlite3_stmt* stmtSpecies = nullptr;
+    sqlite3_stmt* stmtMeta = nullptr;
+    sqlite3_stmt* stmtSteady = nullptr;
+    sqlite3_stmt* stmtPressure = nullptr;
+    sqlite3_stmt* stmtFlow = nullptr;
+    sqlite3_stmt* stmtConc = nullptr;
+    sqlite3_stmt* stmtStep = nullptr;
+
+    bool inTransaction = false;
+    bool runBegun = false;         // begin() has written a run into the tables
+    std::size_t pendingRows = 0;   // rows in the open transaction
+    std::size_t totalRows = 0;
+    std::vector<float> blobScratch;
 
     ~Impl() {
-        if (stmtTransient) sqlite3_finalize(stmtTransient);
-        if (db) sqlite3_close(db);
+        for (sqlite3_stmt* s : {stmtNode, stmtLink, stmtSpecies, stmtMeta, stmtSteady,
+                                stmtPressure, stmtFlow, stmtConc, stmtStep}) {
+            if (s) sqlite3_finalize(s);
+        }
+        if (db) {
+            if (inTransaction) sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+            sqlite3_close(db);
+        }
+    }
+
+    void check(int rc, const char* what) const {
+        if (rc != SQLITE_OK && rc != SQLITE_DONE && rc != SQLITE_ROW) {
+            throw std::runtime_error(std::string("SqliteWriter: ") + what + ": " + sqlite3_errmsg(db));
+        }
+    }
+
+    void exec(const char* sql) {
+        char* errMsg = nullptr;
+        int rc = sqlite3_exec(db, sql, nullptr, nullptr, &errMsg);
+        if (rc != SQLITE_OK) {
+            std::string err = errMsg ? errMsg : "unknown error";
+            sqlite3_free(errMsg);
+            throw std::runtime_error("SqliteWriter: " + err + " in: " + sql);
+        }
+    }
+
+    sqlite3_stmt* prepare(const char* sql) {
+        sqlite3_stmt* stmt = nullptr;
+        check(sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr), "prepare failed");
+        return stmt;
+    }
+
+    // Execute a bound statement, reset it and count the row against the batch
+    void run(sqlite3_stmt* stmt) {
+        check(sqlite3_step(stmt), "insert failed");
+        sqlite3_reset(stmt);
+        ++totalRows;
+        if (++pendingRows >= options.batchRows) {
+            exec("COMMIT; BEGIN TRANSACTION;");
+            pendingRows = 0;
+        }
     }
+
+    void beginTransaction() {
+        if (inTransaction) return;
+        exec("BEGIN TRANSACTION;");
+        inTransaction = true;
+        pendingRows = 0;
+    }
+
+    void commit() {
+        if (!inTransaction) return;
+        exec("COMMIT;");
+        inTransaction = false;
+        pendingRows = 0;
+    }
+
+    // Empty every table so the next run does not land next to the last one
+    void clearTables() {
+        beginTransaction();
+        exec("DELETE FROM metadata; DELETE FROM nodes; DELETE FROM links;"
+             "DELETE FROM species; DELETE FROM steady_state;");
+        exec(options.schema == SqliteSchema::Long
+                 ? "DELETE FROM transient; DELETE FROM transient_flows; DELETE FROM transient_conc;"
+                 : "DELETE FROM transient_steps;");
+        setMeta("schema", options.schema == SqliteSchema::Long ? "long" : "blob");
+    }
+
+    void setMeta(const std::string& key, const std::string& value) {
+        sqlite3_bind_text(stmtMeta, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmtMeta, 2, value.c_str(), -1, SQLITE_TRANSIENT);
+        run(stmtMeta);
+    }
+
+    void bindArray(sqlite3_stmt* stmt, int col, const double* values, std::size_t n) {
+        if (output.precision() == OutputPrecision::Double) {
+            sqlite3_bind_blob(stmt, col, values, static_cast<int>(n * sizeof(double)), SQLITE_TRANSIENT);
+        } else {
+            blobScratch.assign(values, values + n);
+            sqlite3_bind_blob(stmt, col, blobScratch.data(),
+                              static_cast<int>(n * sizeof(float)), SQLITE_TRANSIENT);
+        }
+    }
+
+    void insertStep(double time, bool converged, int iterations,
+                    const std::vector<double>& pressures, const std::vector<double>& massFlows,
+                    const std::vector<std::vector<double>>& concentrations);
 };
 
-SqliteWriter::SqliteWriter(const std::string& filename)
+SqliteWriter::SqliteWriter(const std::string& filename, const SqliteOptions& options)
     : impl_(std::make_unique<Impl>())
 {
+    impl_->options = options;
     int rc = sqlite3_open(filename.c_str(), &impl_->db);
     if (rc != SQLITE_OK) {
         throw std::runtime_error("SqliteWriter: cannot open database: " + filename);
     }
 
-    // Create tables
-    const char* sql =
+    // WAL keeps readers unblocked and, with synchronous=NORMAL, only syncs at
+    // checkpoints rather than on every commit
+    impl_->exec("PRAGMA journal_mode=WAL;"
+                "PRAGMA synchronous=NORMAL;"
+                "PRAGMA temp_store=MEMORY;"
+                "PRAGMA cache_size=-65536;");
+
+    // The file holds one run: tables left by an earlier run (of either
+    // schema) are dropped along with their indices, then recreated.
+    // Indices are built in finalize().
+    impl_->exec(
+        "DROP TABLE IF EXISTS metadata; DROP TABLE IF EXISTS nodes;"
+        "DROP TABLE IF EXISTS links; DROP TABLE IF EXISTS species;"
+        "DROP TABLE IF EXISTS steady_state; DROP TABLE IF EXISTS transient;"
+        "DROP TABLE IF EXISTS transient_flows; DROP TABLE IF EXISTS transient_conc;"
+        "DROP TABLE IF EXISTS transient_steps;");
+    impl_->exec(
         "CREATE TABLE IF NOT EXISTS metadata ("
         "  key TEXT PRIMARY KEY, value TEXT);"
         "CREATE TABLE IF NOT EXISTS nodes ("
@@ -39,113 +157,192 @@ SqliteWriter::SqliteWriter(const std::string& filename)
         "  decay_rate REAL, outdoor_conc REAL);"
         "CREATE TABLE IF NOT EXISTS steady_state ("
         "  node_id INTEGER, species_id INTEGER, concentration REAL,"
-        "  PRIMARY KEY (node_id, species_id));"
-        "CREATE TABLE IF NOT EXISTS transient ("
-        "  time REAL, node_id INTEGER, pressure REAL);"
-        "CREATE TABLE IF NOT EXISTS transient_flows ("
-        "  time REAL, link_id INTEGER, mass_flow REAL);"
-        "CREATE TABLE IF NOT EXISTS transient_conc ("
-        "  time REAL, node_id INTEGER, species_id INTEGER, concentration REAL);";
-
-    char* errMsg = nullptr;
-    rc = sqlite3_exec(impl_->db, sql, nullptr, nullptr, &errMsg);
-    if (rc != SQLITE_OK) {
-        std::string err = errMsg ? errMsg : "unknown error";
-        sqlite3_free(errMsg);
-        throw std::runtime_error("SqliteWriter: table creation failed: " + err);
+        "  PRIMARY KEY (node_id, species_id));");
+    if (options.schema == SqliteSchema::Long) {
+        impl_->exec(
+            "CREATE TABLE IF NOT EXISTS transient ("
+            "  time REAL, node_id INTEGER, pressure REAL);"
+            "CREATE TABLE IF NOT EXISTS transient_flows ("
+            "  time REAL, link_id INTEGER, mass_flow REAL);"
+            "CREATE TABLE IF NOT EXISTS transient_conc ("
+            "  time REAL, node_id INTEGER, species_id INTEGER, concentration REAL);");
+        impl_->stmtPressure = impl_->prepare("INSERT INTO transient VALUES(?,?,?);");
+        impl_->stmtFlow = impl_->prepare("INSERT INTO transient_flows VALUES(?,?,?);");
+        impl_->stmtConc = impl_->prepare("INSERT INTO transient_conc VALUES(?,?,?,?);");
+    } else {
+        impl_->exec(
+            "CREATE TABLE IF NOT EXISTS transient_steps ("
+            "  time REAL PRIMARY KEY, converged INTEGER, iterations INTEGER,"
+            "  pressures BLOB, mass_flows BLOB, concentrations BLOB);");
+        impl_->stmtStep = impl_->prepare("INSERT OR REPLACE INTO transient_steps VALUES(?,?,?,?,?,?);");
     }
 
-    // Begin transaction for performance
-    sqlite3_exec(impl_->db, "BEGIN TRANSACTION;", nullptr, nullptr, nullptr);
+    impl_->stmtNode = impl_->prepare("INSERT OR REPLACE INTO nodes VALUES(?,?,?,?,?);");
+    impl_->stmtLink = impl_->prepare("INSERT OR REPLACE INTO links VALUES(?,?,?,?);");
+    impl_->stmtSpecies = impl_->prepare("INSERT OR REPLACE INTO species VALUES(?,?,?,?,?);");
+    impl_->stmtMeta = impl_->prepare("INSERT OR REPLACE INTO metadata VALUES(?,?);");
+    impl_->stmtSteady = impl_->prepare("INSERT OR REPLACE INTO steady_state VALUES(?,?,?);");
+
+    impl_->beginTransaction();
+    impl_->setMeta("schema", options.schema == SqliteSchema::Long ? "long" : "blob");
 }
 
 SqliteWriter::~SqliteWriter() = default;
 
+std::size_t SqliteWriter::rowsWritten() const {
+    return impl_->totalRows;
+}
+
 void SqliteWriter::writeMetadata(const Network& net, const std::vector<Species>& species) {
-    // Write nodes
+    impl_->beginTransaction();
+
+    sqlite3_stmt* st = impl_->stmtNode;
     for (int i = 0; i < net.getNodeCount(); ++i) {
         const auto& node = net.getNode(i);
-        std::string sql = "INSERT OR REPLACE INTO nodes VALUES("
-            + std::to_string(node.getId()) + ",'"
-            + node.getName() + "','"
-            + (node.isKnownPressure() ? "Ambient" : "Normal") + "',"
-            + std::to_string(node.getElevation()) + ","
-            + std::to_string(node.getVolume()) + ");";
-        sqlite3_exec(impl_->db, sql.c_str(), nullptr, nullptr, nullptr);
+        sqlite3_bind_int(st, 1, node.getId());
+        sqlite3_bind_text(st, 2, node.getName().c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(st, 3, node.isKnownPressure() ? "Ambient" : "Normal", -1, SQLITE_STATIC);
+        sqlite3_bind_double(st, 4, node.getElevation());
+        sqlite3_bind_double(st, 5, node.getVolume());
+        impl_->run(st);
     }
 
-    // Write links
+    st = impl_->stmtLink;
     for (int i = 0; i < net.getLinkCount(); ++i) {
         const auto& link = net.getLink(i);
         std::string elemType = link.getFlowElement() ? link.getFlowElement()->typeName() : "none";
-        std::string sql = "INSERT OR REPLACE INTO links VALUES("
-            + std::to_string(link.getId()) + ","
-            + std::to_string(link.getNodeFrom()) + ","
-            + std::to_string(link.getNodeTo()) + ",'"
-            + elemType + "');";
-        sqlite3_exec(impl_->db, sql.c_str(), nullptr, nullptr, nullptr);
+        sqlite3_bind_int(st, 1, link.getId());
+        sqlite3_bind_int(st, 2, link.getNodeFrom());
+        sqlite3_bind_int(st, 3, link.getNodeTo());
+        sqlite3_bind_text(st, 4, elemType.c_str(), -1, SQLITE_TRANSIENT);
+        impl_->run(st);
     }
 
-    // Write species
+    st = impl_->stmtSpecies;
     for (const auto& sp : species) {
-        std::string sql = "INSERT OR REPLACE INTO species VALUES("
-            + std::to_string(sp.id) + ",'"
-            + sp.name + "',"
-            + std::to_string(sp.molarMass) + ","
-            + std::to_string(sp.decayRate) + ","
-            + std::to_string(sp.outdoorConc) + ");";
-        sqlite3_exec(impl_->db, sql.c_str(), nullptr, nullptr, nullptr);
+        sqlite3_bind_int(st, 1, sp.id);
+        sqlite3_bind_text(st, 2, sp.name.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_double(st, 3, sp.molarMass);
+        sqlite3_bind_double(st, 4, sp.decayRate);
+        sqlite3_bind_double(st, 5, sp.outdoorConc);
+        impl_->run(st);
+    }
+}
+
+void SqliteWriter::setOutputSelection(const OutputSelection& output) {
+    impl_->output = output;
+    if (impl_->options.schema == SqliteSchema::Blob) {
+        impl_->beginTransaction();
+        impl_->setMeta("blob_format",
+                       output.precision() == OutputPrecision::Double ? "float64" : "float32");
     }
 }
 
 void SqliteWriter::writeSteadyState(const Network& net, const std::vector<double>& concentrations) {
+    (void)net;
+    impl_->beginTransaction();
     // concentrations is flat: [node0_spec0, node0_spec1, ..., node1_spec0, ...]
     // We don't know numSpecies here, so write as single-species if flat
+    sqlite3_stmt* st = impl_->stmtSteady;
     for (size_t i = 0; i < concentrations.size(); ++i) {
-        std::string sql = "INSERT OR REPLACE INTO steady_state VALUES("
-            + std::to_string(i) + ",0,"
-            + std::to_string(concentrations[i]) + ");";
-        sqlite3_exec(impl_->db, sql.c_str(), nullptr, nullptr, nullptr);
+        sqlite3_bind_int64(st, 1, static_cast<sqlite3_int64>(i));
+        sqlite3_bind_int(st, 2, 0);
+        sqlite3_bind_double(st, 3, concentrations[i]);
+        impl_->run(st);
     }
 }
 
-void SqliteWriter::writeTransientStep(double time, const std::vector<double>& pressures,
-                                       const std::vector<double>& massFlows,
-                                       const std::vector<std::vector<double>>& concentrations)
-{
-    // Write pressures
+void SqliteWriter::Impl::insertStep(double time, bool converged, int iterations,
+                                    const std::vector<double>& pressures,
+                                    const std::vector<double>& massFlows,
+                                    const std::vector<std::vector<double>>& concentrations) {
+    beginTransaction();
+
+    if (options.schema == SqliteSchema::Blob) {
+        std::vector<double> flat;
+        for (const auto& nodeConcs : concentrations) {
+            flat.insert(flat.end(), nodeConcs.begin(), nodeConcs.end());
+        }
+        sqlite3_bind_double(stmtStep, 1, time);
+        sqlite3_bind_int(stmtStep, 2, converged ? 1 : 0);
+        sqlite3_bind_int(stmtStep, 3, iterations);
+        // Variables not recorded at this step are NULL
+        if (pressures.empty()) sqlite3_bind_null(stmtStep, 4);
+        else bindArray(stmtStep, 4, pressures.data(), pressures.size());
+        if (massFlows.empty()) sqlite3_bind_null(stmtStep, 5);
+        else bindArray(stmtStep, 5, massFlows.data(), massFlows.size());
+        if (flat.empty()) sqlite3_bind_null(stmtStep, 6);
+        else bindArray(stmtStep, 6, flat.data(), flat.size());
+        run(stmtStep);
+        return;
+    }
+
     for (size_t i = 0; i < pressures.size(); ++i) {
-        std::string sql = "INSERT INTO transient VALUES("
-            + std::to_string(time) + ","
-            + std::to_string(i) + ","
-            + std::to_string(pressures[i]) + ");";
-        sqlite3_exec(impl_->db, sql.c_str(), nullptr, nullptr, nullptr);
+        sqlite3_bind_double(stmtPressure, 1, time);
+        sqlite3_bind_int(stmtPressure, 2, output.node(i));
+        sqlite3_bind_double(stmtPressure, 3, pressures[i]);
+        run(stmtPressure);
     }
 
-    // Write mass flows
     for (size_t i = 0; i < massFlows.size(); ++i) {
-        std::string sql = "INSERT INTO transient_flows VALUES("
-            + std::to_string(time) + ","
-            + std::to_string(i) + ","
-            + std::to_string(massFlows[i]) + ");";
-        sqlite3_exec(impl_->db, sql.c_str(), nullptr, nullptr, nullptr);
+        sqlite3_bind_double(stmtFlow, 1, time);
+        sqlite3_bind_int(stmtFlow, 2, output.link(i));
+        sqlite3_bind_double(stmtFlow, 3, massFlows[i]);
+        run(stmtFlow);
     }
 
-    // Write concentrations
     for (size_t i = 0; i < concentrations.size(); ++i) {
         for (size_t k = 0; k < concentrations[i].size(); ++k) {
-            std::string sql = "INSERT INTO transient_conc VALUES("
-                + std::to_string(time) + ","
-                + std::to_string(i) + ","
-                + std::to_string(k) + ","
-                + std::to_string(concentrations[i][k]) + ");";
-            sqlite3_exec(impl_->db, sql.c_str(), nullptr, nullptr, nullptr);
+            sqlite3_bind_double(stmtConc, 1, time);
+            sqlite3_bind_int(stmtConc, 2, output.node(i));
+            sqlite3_bind_int(stmtConc, 3, output.species(k));
+            sqlite3_bind_double(stmtConc, 4, concentrations[i][k]);
+            run(stmtConc);
         }
     }
 }
 
+void SqliteWriter::writeTransientStep(double time, const std::vector<double>& pressures,
+                                       const std::vector<double>& massFlows,
+                                       const std::vector<std::vector<double>>& concentrations)
+{
+    impl_->insertStep(time, true, 0, pressures, massFlows, concentrations);
+}
+
 void SqliteWriter::finalize() {
-    sqlite3_exec(impl_->db, "COMMIT;", nullptr, nullptr, nullptr);
+    impl_->commit();
+    if (!impl_->options.createIndices) return;
+    if (impl_->options.schema == SqliteSchema::Long) {
+        impl_->exec(
+            "CREATE INDEX IF NOT EXISTS idx_transient_node ON transient(node_id, time);"
+            "CREATE INDEX IF NOT EXISTS idx_transient_flows_link ON transient_flows(link_id, time);"
+            "CREATE INDEX IF NOT EXISTS idx_transient_conc_node"
+            "  ON transient_conc(node_id, species_id, time);");
+    }
+    // transient_steps is keyed by time already
+}
+
+// ── ResultSink ───────────────────────────────────────────────────────
+
+void SqliteWriter::begin(const Network& network, const std::vector<Species>& species,
+                         const OutputSelection& output) {
+    // A writer reused for another run starts again from empty tables
+    if (impl_->runBegun) impl_->clearTables();
+    impl_->runBegun = true;
+    writeMetadata(network, species);
+    setOutputSelection(output);
+}
+
+void SqliteWriter::onStep(const TimeStepResult& step) {
+    impl_->insertStep(step.time, step.airflow.converged, step.airflow.iterations,
+                      step.airflow.pressures, step.airflow.massFlows,
+                      step.contaminant.concentrations);
+}
+
+void SqliteWriter::end(bool completed) {
+    impl_->beginTransaction();
+    impl_->setMeta("completed", completed ? "true" : "false");
+    finalize();
 }
 
 } // namespace contam
@@ -8,21 +8,65 @@
 
 #include "core/Network.h"
 #include "core/Species.h"
+#include "core/OutputSpec.h"
+#include "core/ResultSink.h"
 
 namespace contam {
 
-class SqliteWriter {
+enum class SqliteSchema {
+    Long,   // one row per value: transient, transient_flows, transient_conc
+    Blob    // one row per step in transient_steps, arrays stored as BLOBs
+};
+
+struct SqliteOptions {
+    SqliteSchema schema = SqliteSchema::Long;
+    std::size_t batchRows = 200000;   // rows per committed transaction
+    bool createIndices = true;        // built once in finalize(), after the bulk load
+};
+
+// SQLite result writer. Inserts go through prepared statements with bound
+// parameters inside large transactions; the database runs in WAL mode with
+// synchronous=NORMAL and indices are only created after the data is loaded.
+//
+// A file holds one run: opening it drops the tables an earlier run left
+// there, and begin() empties them again when the writer is reused.
+//
+// Also a ResultSink, so it can be attached to TransientSimulation and write
+// steps as they are produced:
+//   sim.addResultSink(std::make_shared<SqliteWriter>("results.db"));
+//
+// Long schema: transient(time, node_id, pressure),
+//   transient_flows(time, link_id, mass_flow),
+//   transient_conc(time, node_id, species_id, concentration)
+//   with node/link/species columns holding network/species indices.
+// Blob schema: transient_steps(time, converged, iterations, pressures,
+//   mass_flows, concentrations); each array is the step's recorded values in
+//   native byte order, float64 or (with reduced output precision) float32,
+//   concentrations node-major. metadata.blob_format names the element type.
+class SqliteWriter : public ResultSink {
 public:
-    explicit SqliteWriter(const std::string& filename);
-    ~SqliteWriter();
+    explicit SqliteWriter(const std::string& filename, const SqliteOptions& options = {});
+    ~SqliteWriter() override;
 
     void writeMetadata(const Network& net, const std::vector<Species>& species);
+    // Transient steps are reduced by `output` (TransientResult::output); ids
+    // in the transient tables stay network/species indices
+    void setOutputSelection(const OutputSelection& output);
     void writeSteadyState(const Network& net, const std::vector<double>& concentrations);
     void writeTransientStep(double time, const std::vector<double>& pressures,
                            const std::vector<double>& massFlows,
                            const std::vector<std::vector<double>>& concentrations);
+    // Commit outstanding rows and build the indices
     void finalize();
 
+    // ResultSink
+    void begin(const Network& network, const std::vector<Species>& species,
+               const OutputSelection& output) override;
+    void onStep(const TimeStepResult& step) override;
+    void end(bool completed) override;
+
+    std::size_t rowsWritten() const;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
@@ -0,0 +1,203 @@
+#include "io/StreamEventWriter.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+namespace contam {
+
+using json = nlohmann::json;
+
+namespace {
+
+// Recorded positions of `ids` (all recorded entities when empty); `idOf`
+// maps a recorded position to the entity id
+template <typename IdOf>
+std::vector<std::size_t> resolveSeries(const std::vector<int>& ids, std::size_t count,
+                                       IdOf idOf, const char* what) {
+    std::vector<std::size_t> positions;
+    if (ids.empty()) {
+        for (std::size_t k = 0; k < count; ++k) positions.push_back(k);
+        return positions;
+    }
+    for (int id : ids) {
+        std::size_t k = 0;
+        while (k < count && idOf(k) != id) ++k;
+        if (k == count) {
+            throw std::runtime_error(std::string("Stream ") + what + " id " + std::to_string(id) +
+                                     " is not in the recorded output");
+        }
+        positions.push_back(k);
+    }
+    return positions;
+}
+
+json pick(const std::vector<double>& values, const std::vector<std::size_t>& positions) {
+    json a = json::array();
+    for (std::size_t k : positions) {
+        if (k < values.size()) a.push_back(values[k]);
+        else a.push_back(nullptr);
+    }
+    return a;
+}
+
+} // namespace
+
+StreamEventWriter::StreamEventWriter(std::ostream& out, const StreamEventOptions& options)
+    : out_(out), options_(options) {
+    options_.frameStride = std::max<std::size_t>(options_.frameStride, 1);
+    started_ = lastProgress_ = Clock::now();
+}
+
+double StreamEventWriter::elapsed() const {
+    return std::chrono::duration<double>(Clock::now() - started_).count();
+}
+
+void StreamEventWriter::line(const std::string& text) {
+    out_ << text << '\n';
+    out_.flush();
+}
+
+// ── ResultSink ───────────────────────────────────────────────────────
+
+void StreamEventWriter::begin(const Network& network, const std::vector<Species>& species,
+                              const OutputSelection& output) {
+    started_ = lastProgress_ = Clock::now();
+    progressed_ = false;
+    steps_ = timesteps_ = frames_ = 0;
+    hasPending_ = false;
+    iterations_ = 0;
+    maxIterations_ = 0;
+    maxResidual_ = 0.0;
+    unconverged_ = 0;
+
+    nodes_ = resolveSeries(options_.nodeIds, output.nodeCount(network),
+                           [&](std::size_t k) { return network.getNode(output.node(k)).getId(); },
+                           "node");
+    links_ = resolveSeries(options_.linkIds, output.linkCount(network),
+                           [&](std::size_t k) { return network.getLink(output.link(k)).getId(); },
+                           "link");
+    species_ = resolveSeries(options_.speciesIds, output.speciesCount(species),
+                             [&](std::size_t k) { return species[output.species(k)].id; },
+                             "species");
+
+    json ev = {{"event", "start"},
+               {"startTime", options_.startTime},
+               {"endTime", options_.endTime},
+               {"frameStride", options_.frameStride}};
+    json& nodes = ev["nodes"] = json::array();
+    for (std::size_t k : nodes_) nodes.push_back(network.getNode(output.node(k)).getId());
+    json& links = ev["links"] = json::array();
+    for (std::size_t k : links_) links.push_back(network.getLink(output.link(k)).getId());
+    json& sp = ev["species"] = json::array();
+    for (std::size_t k : species_) {
+        const auto& s = species[output.species(k)];
+        sp.push_back({{"id", s.id}, {"name", s.name}});
+    }
+    line(ev.dump());
+}
+
+std::string StreamEventWriter::frame(const TimeStepResult& step) const {
+    json ev = {{"event", "frame"}, {"time", step.time}};
+    if (!step.airflow.pressures.empty()) ev["pressures"] = pick(step.airflow.pressures, nodes_);
+    if (!step.airflow.massFlows.empty()) ev["massFlows"] = pick(step.airflow.massFlows, links_);
+    const auto& conc = step.contaminant.concentrations;
+    if (!conc.empty() && !species_.empty()) {
+        json rows = json::array();
+        for (std::size_t k : nodes_) {
+            rows.push_back(k < conc.size() ? pick(conc[k], species_) : json(nullptr));
+        }
+        ev["concentrations"] = std::move(rows);
+    }
+    return ev.dump();
+}
+
+void StreamEventWriter::onStep(const TimeStepResult& step) {
+    const auto& air = step.airflow;
+    iterations_ += air.iterations;
+    maxIterations_ = std::max(maxIterations_, air.iterations);
+    maxResidual_ = std::max(maxResidual_, air.maxResidual);
+    if (!air.converged) ++unconverged_;
+
+    if (steps_++ % options_.frameStride == 0) {
+        line(frame(step));
+        ++frames_;
+        hasPending_ = false;
+        solverEvent();
+    } else {
+        pending_ = step;
+        hasPending_ = true;
+    }
+}
+
+std::size_t StreamEventWriter::memoryBytes() const {
+    std::size_t bytes = vectorBytes(pending_.airflow.pressures) + vectorBytes(pending_.airflow.massFlows) +
+                        vectorBytes(pending_.contaminant.concentrations);
+    for (const auto& row : pending_.contaminant.concentrations) bytes += vectorBytes(row);
+    return bytes + vectorBytes(nodes_) + vectorBytes(links_) + vectorBytes(species_);
+}
+
+void StreamEventWriter::end(bool completed) {
+    // The last output step is always charted
+    if (hasPending_) {
+        line(frame(pending_));
+        ++frames_;
+        hasPending_ = false;
+        solverEvent();
+    }
+    line(json{{"event", "end"},
+              {"completed", completed},
+              {"outputSteps", steps_},
+              {"frames", frames_},
+              {"elapsed", elapsed()}}.dump());
+}
+
+// ── Progress and diagnostics ─────────────────────────────────────────
+
+bool StreamEventWriter::progress(double time, double endTime) {
+    ++timesteps_;
+    const auto now = Clock::now();
+    const bool last = time >= endTime - 1e-10;
+    if (progressed_ && !last &&
+        std::chrono::duration<double>(now - lastProgress_).count() < options_.minInterval) {
+        return true;
+    }
+    progressed_ = true;
+    lastProgress_ = now;
+
+    const double span = endTime - options_.startTime;
+    const double fraction = span > 0.0 ? std::clamp((time - options_.startTime) / span, 0.0, 1.0) : 1.0;
+    const double secs = elapsed();
+    json ev = {{"event", "progress"},
+               {"time", time},
+               {"fraction", fraction},
+               {"elapsed", secs},
+               {"eta", fraction > 0.0 ? json(secs * (1.0 - fraction) / fraction) : json(nullptr)},
+               {"stepsPerSecond", secs > 0.0 ? json(timesteps_ / secs) : json(nullptr)}};
+    line(ev.dump());
+    return true;
+}
+
+void StreamEventWriter::solved(const SolverResult& result) {
+    ++steps_;
+    iterations_ += result.iterations;
+    maxIterations_ = std::max(maxIterations_, result.iterations);
+    maxResidual_ = std::max(maxResidual_, result.maxResidual);
+    if (!result.converged) ++unconverged_;
+    solverEvent();
+}
+
+void StreamEventWriter::solverEvent() {
+    line(json{{"event", "solver"},
+              {"steps", steps_},
+              {"iterations", iterations_},
+              {"meanIterations", steps_ ? double(iterations_) / steps_ : 0.0},
+              {"maxIterations", maxIterations_},
+              {"maxResidual", maxResidual_},
+              {"unconverged", unconverged_}}.dump());
+}
+
+void StreamEventWriter::error(const std::string& message) {
+    line(json{{"event", "error"}, {"message", message}}.dump());
+}
+
+} // namespace contam
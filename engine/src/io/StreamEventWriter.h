@@ -0,0 +1,95 @@
+#pragma once
+#include "core/ResultSink.h"
+#include "core/Solver.h"
+#include "core/TransientSimulation.h"
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace contam {
+
+struct StreamEventOptions {
+    double startTime = 0.0;       // simulated time range, for progress fractions
+    double endTime = 0.0;
+    double minInterval = 0.25;    // wall seconds between progress events (0: every step)
+    std::size_t frameStride = 1;  // emit a frame every this many output steps
+
+    // Series carried by frames; empty lists select every recorded entity.
+    // Ids must be part of the run's output selection.
+    std::vector<int> nodeIds;
+    std::vector<int> linkIds;
+    std::vector<int> speciesIds;
+};
+
+// Newline-delimited JSON events for hosts that chart a run while it
+// computes. Every line is one object with an "event" member:
+//
+//   start     time range and the node/link/species ids of frame series
+//   progress  time, fraction, elapsed and eta (wall s), stepsPerSecond
+//   frame     time plus pressures/massFlows/concentrations of the selected
+//             series, for every frameStride-th output step and the last one
+//   solver    airflow solver statistics over the output steps so far
+//   end       completed, outputSteps, frames, elapsed
+//   error     message (see error()); after "end" when a transient run throws
+//
+// Each line is flushed as it is written. Progress comes from the
+// simulation's progress callback:
+//
+//   auto events = std::make_shared<StreamEventWriter>(std::cout, options);
+//   sim.addResultSink(events);
+//   sim.setProgressCallback([&](double t, double end) { return events->progress(t, end); });
+class StreamEventWriter : public ResultSink {
+public:
+    explicit StreamEventWriter(std::ostream& out, const StreamEventOptions& options = {});
+
+    void begin(const Network& network, const std::vector<Species>& species,
+               const OutputSelection& output) override;
+    void onStep(const TimeStepResult& step) override;
+    void end(bool completed) override;
+    std::size_t memoryBytes() const override;
+
+    // Per-timestep progress; always returns true (never cancels)
+    bool progress(double time, double endTime);
+
+    // Steady-state runs report their single solve
+    void solved(const SolverResult& result);
+
+    void error(const std::string& message);
+
+    std::size_t frameCount() const { return frames_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::ostream& out_;
+    StreamEventOptions options_;
+    Clock::time_point started_;
+    Clock::time_point lastProgress_;
+    bool progressed_ = false;
+
+    // Positions of the frame series in the recorded step vectors
+    std::vector<std::size_t> nodes_, links_, species_;
+
+    std::size_t steps_ = 0;      // output steps seen
+    std::size_t timesteps_ = 0;  // progress callbacks seen
+    std::size_t frames_ = 0;
+    // Last output step when it was skipped, serialized only if end() charts
+    // it; assignment reuses the buffers, so skipped steps cost a copy
+    TimeStepResult pending_{};
+    bool hasPending_ = false;
+
+    // Airflow solver statistics over the output steps
+    long long iterations_ = 0;
+    int maxIterations_ = 0;
+    double maxResidual_ = 0.0;
+    std::size_t unconverged_ = 0;
+
+    double elapsed() const;
+    void line(const std::string& text);
+    std::string frame(const TimeStepResult& step) const;
+    void solverEvent();
+};
+
+} // namespace contam
@@ -0,0 +1,98 @@
+#include "io/TextTokenizer.h"
+#include <charconv>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+
+namespace contam {
+
+// ── TextSource ───────────────────────────────────────────────────────
+
+TextSource TextSource::fromFile(const std::string& filepath, const std::string& what) {
+    TextSource src;
+    try {
+        src.file_.open(filepath);
+    } catch (const std::runtime_error&) {
+        throw std::runtime_error("Cannot open " + what + ": " + filepath);
+    }
+    src.text_ = std::string_view(src.file_.data(), src.file_.size());
+    return src;
+}
+
+TextSource TextSource::fromString(std::string_view content) {
+    TextSource src;
+    src.text_ = content;
+    return src;
+}
+
+// ── LineTokenizer ────────────────────────────────────────────────────
+
+static inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+bool LineTokenizer::nextLine() {
+    if (pos_ >= text_.size()) return false;
+    size_t end = text_.find('\n', pos_);
+    if (end == std::string_view::npos) end = text_.size();
+    line_ = text_.substr(pos_, end - pos_);
+    pos_ = end + 1;
+    cursor_ = 0;
+    ++lineNum_;
+    return true;
+}
+
+bool LineTokenizer::isBlankOrComment(std::string_view commentChars) const {
+    for (char c : line_) {
+        if (isBlank(c)) continue;
+        return commentChars.find(c) != std::string_view::npos;
+    }
+    return true;
+}
+
+std::string_view LineTokenizer::peekToken() {
+    while (cursor_ < line_.size() && isBlank(line_[cursor_])) ++cursor_;
+    size_t end = cursor_;
+    while (end < line_.size() && !isBlank(line_[end])) ++end;
+    return line_.substr(cursor_, end - cursor_);
+}
+
+bool LineTokenizer::atLineEnd() {
+    return peekToken().empty();
+}
+
+bool LineTokenizer::nextDouble(double& value) {
+    std::string_view tok = peekToken();
+    if (tok.empty()) return false;
+    // from_chars rejects a leading '+', which stream extraction accepted
+    std::string_view num = (tok.front() == '+') ? tok.substr(1) : tok;
+    if (num.empty()) return false;
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto [ptr, ec] = std::from_chars(num.data(), num.data() + num.size(), value);
+    if (ec != std::errc() || ptr != num.data() + num.size()) return false;
+#else
+    // Fallback for standard libraries without floating-point from_chars
+    char buf[64];
+    if (num.size() >= sizeof(buf)) return false;
+    std::memcpy(buf, num.data(), num.size());
+    buf[num.size()] = '\0';
+    char* endp = nullptr;
+    value = std::strtod(buf, &endp);
+    if (endp != buf + num.size()) return false;
+#endif
+    cursor_ += tok.size();
+    return true;
+}
+
+bool LineTokenizer::nextInt(int& value) {
+    std::string_view tok = peekToken();
+    if (tok.empty()) return false;
+    std::string_view num = (tok.front() == '+') ? tok.substr(1) : tok;
+    auto [ptr, ec] = std::from_chars(num.data(), num.data() + num.size(), value);
+    if (ec != std::errc() || ptr != num.data() + num.size()) return false;
+    cursor_ += tok.size();
+    return true;
+}
+
+} // namespace contam
@@ -0,0 +1,67 @@
+#pragma once
+#include "utils/MappedFile.h"
+#include <string>
+#include <string_view>
+
+namespace contam {
+
+// Text input backed either by a memory-mapped file or by a caller-owned string.
+// The view stays valid for the lifetime of the TextSource (or the borrowed string).
+class TextSource {
+public:
+    // Map a file read-only; `what` prefixes the open error ("Cannot open <what>: path")
+    static TextSource fromFile(const std::string& filepath, const std::string& what = "file");
+    static TextSource fromString(std::string_view content);
+
+    std::string_view text() const { return text_; }
+
+private:
+    MappedFile file_;
+    std::string_view text_;
+};
+
+// Zero-copy line/number tokenizer for whitespace-delimited numeric text files
+// (CVF/DVF, WTH, WPC, CTM). Numbers are parsed with std::from_chars directly
+// from the underlying buffer; no per-line strings are created.
+//
+//   LineTokenizer tok(source.text());
+//   while (tok.nextLine()) {
+//       if (tok.isBlankOrComment("#")) continue;
+//       double t;
+//       if (!tok.nextDouble(t)) throw ... tok.lineNumber() ...;
+//   }
+class LineTokenizer {
+public:
+    explicit LineTokenizer(std::string_view text) : text_(text) {}
+
+    // Advance to the next line (LF or CRLF terminated). Returns false at end of input.
+    bool nextLine();
+
+    int lineNumber() const { return lineNum_; }
+    std::string_view line() const { return line_; }
+
+    // True if the line is empty/whitespace or its first non-blank char is in commentChars
+    bool isBlankOrComment(std::string_view commentChars) const;
+    // First character of the raw line ('\0' for an empty line)
+    char firstChar() const { return line_.empty() ? '\0' : line_.front(); }
+
+    // Parse the next whitespace-delimited token of the current line.
+    // Returns false (and leaves the cursor on the token) if there is no token
+    // or it is not a complete number.
+    bool nextDouble(double& value);
+    bool nextInt(int& value);
+
+    // True when only whitespace remains on the current line
+    bool atLineEnd();
+
+private:
+    std::string_view text_;
+    std::string_view line_;
+    size_t pos_ = 0;      // offset of next line in text_
+    size_t cursor_ = 0;   // offset within line_
+    int lineNum_ = 0;
+
+    std::string_view peekToken();
+};
+
+} // namespace contam
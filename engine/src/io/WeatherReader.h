@@ -1,9 +1,10 @@
 #pragma once
 
+#include "io/TextTokenizer.h"
+#include <cctype>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <fstream>
-#include <sstream>
 #include <stdexcept>
 
 namespace contam {
@@ -26,35 +27,40 @@ class WeatherReader {
 public:
     // Read weather file and return sorted records
     static std::vector<WeatherRecord> readFile(const std::string& filepath) {
-        std::ifstream file(filepath);
-        if (!file.is_open()) {
-            throw std::runtime_error("Cannot open weather file: " + filepath);
-        }
+        auto src = TextSource::fromFile(filepath, "weather file");
+        return parse(src.text());
+    }
 
+    static std::vector<WeatherRecord> readString(const std::string& content) {
+        return parse(content);
+    }
+
+    static std::vector<WeatherRecord> parse(std::string_view content) {
         std::vector<WeatherRecord> records;
-        std::string line;
+        LineTokenizer tok(content);
 
         // Skip header lines (lines starting with ! or # or non-numeric)
-        while (std::getline(file, line)) {
-            if (line.empty() || line[0] == '!' || line[0] == '#') continue;
+        while (tok.nextLine()) {
+            char c0 = tok.firstChar();
+            if (c0 == '\0' || c0 == '!' || c0 == '#') continue;
             // Check if line starts with a digit
-            if (std::isdigit(static_cast<unsigned char>(line[0]))) {
-                // Parse data line
-                WeatherRecord rec;
-                std::istringstream iss(line);
-                double tempC;
-                double rhPercent = 50.0;
+            if (!std::isdigit(static_cast<unsigned char>(c0))) continue;
+
+            // Parse data line
+            WeatherRecord rec;
+            double tempC;
+            double rhPercent = 50.0;
 
-                if (iss >> rec.month >> rec.day >> rec.hour >> tempC >> rec.pressure
-                        >> rec.windSpeed >> rec.windDirection) {
-                    rec.temperature = tempC + 273.15; // °C → K
-                    if (iss >> rhPercent) {
-                        rec.humidity = rhPercent / 100.0;
-                    } else {
-                        rec.humidity = 0.5; // default
-                    }
-                    records.push_back(rec);
+            if (tok.nextInt(rec.month) && tok.nextInt(rec.day) && tok.nextInt(rec.hour) &&
+                tok.nextDouble(tempC) && tok.nextDouble(rec.pressure) &&
+                tok.nextDouble(rec.windSpeed) && tok.nextDouble(rec.windDirection)) {
+                rec.temperature = tempC + 273.15; // °C → K
+                if (tok.nextDouble(rhPercent)) {
+                    rec.humidity = rhPercent / 100.0;
+                } else {
+                    rec.humidity = 0.5; // default
                 }
+                records.push_back(rec);
             }
         }
         return records;
@@ -0,0 +1,146 @@
+#include "io/WpcBinary.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace contam {
+
+// ── WpcCursor ────────────────────────────────────────────────────────
+
+void WpcCursor::interpolate(const WpcTableView& table, double t, double* out) {
+    const std::size_t n = table.numRecords;
+    const std::size_t stride = table.stride;
+    if (n == 0 || stride == 0) return;
+
+    auto copyRow = [&](std::size_t i) {
+        std::memcpy(out, table.row(i), stride * sizeof(double));
+    };
+
+    if (n == 1 || t <= table.times[0]) { copyRow(0); return; }
+    if (t >= table.times[n - 1]) { copyRow(n - 1); return; }
+
+    // Resume from the cached interval; fall back to binary search when the
+    // clock moves backwards (e.g. a restarted run).
+    std::size_t i = std::min(index_, n - 2);
+    if (t < table.times[i]) {
+        const double* it = std::upper_bound(table.times, table.times + n, t);
+        i = static_cast<std::size_t>(it - table.times) - 1;
+    } else {
+        while (i + 1 < n - 1 && t > table.times[i + 1]) ++i;
+    }
+    index_ = i;
+
+    double dt = table.times[i + 1] - table.times[i];
+    if (dt < 1e-15) { copyRow(i); return; }
+    double alpha = (t - table.times[i]) / dt;
+
+    const double* r0 = table.row(i);
+    const double* r1 = table.row(i + 1);
+    for (std::size_t j = 0; j < stride; ++j) {
+        out[j] = r0[j] * (1.0 - alpha) + r1[j] * alpha;
+    }
+}
+
+// ── WpcBinary ────────────────────────────────────────────────────────
+
+bool WpcBinary::isRectangular(const std::vector<WpcRecord>& records) {
+    for (const auto& r : records) {
+        if (r.pressures.size() != records.front().pressures.size()) return false;
+    }
+    return true;
+}
+
+WpcPackedTable WpcBinary::pack(const std::vector<WpcRecord>& records) {
+    WpcPackedTable table;
+    if (records.empty()) return table;
+
+    table.stride = records[0].pressures.size();
+    table.numOpenings = table.stride;
+    table.times.reserve(records.size());
+    table.values.reserve(records.size() * table.stride);
+
+    for (size_t r = 0; r < records.size(); ++r) {
+        if (records[r].pressures.size() != table.stride) {
+            throw std::runtime_error("WPC binary: record " + std::to_string(r) + " has " +
+                std::to_string(records[r].pressures.size()) + " columns, expected " +
+                std::to_string(table.stride));
+        }
+        table.times.push_back(records[r].time);
+        table.values.insert(table.values.end(),
+                            records[r].pressures.begin(), records[r].pressures.end());
+    }
+    return table;
+}
+
+void WpcBinary::write(const std::string& filepath, const WpcPackedTable& table) {
+    std::ofstream out(filepath, std::ios::binary);
+    if (!out.is_open()) {
+        throw std::runtime_error("Cannot open WPC binary file for writing: " + filepath);
+    }
+
+    WpcBinaryHeader hdr{};
+    hdr.magic = WPC_BINARY_MAGIC;
+    hdr.version = WPC_BINARY_VERSION;
+    hdr.kind = static_cast<uint16_t>(WpcBinaryKind::Pressure);
+    hdr.numRecords = static_cast<uint32_t>(table.times.size());
+    hdr.numOpenings = static_cast<uint32_t>(table.numOpenings);
+    hdr.numSpecies = static_cast<uint32_t>(table.numSpecies);
+    hdr.stride = static_cast<uint32_t>(table.stride);
+
+    out.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    out.write(reinterpret_cast<const char*>(table.times.data()),
+              static_cast<std::streamsize>(table.times.size() * sizeof(double)));
+    out.write(reinterpret_cast<const char*>(table.values.data()),
+              static_cast<std::streamsize>(table.values.size() * sizeof(double)));
+    if (!out) {
+        throw std::runtime_error("Failed writing WPC binary file: " + filepath);
+    }
+}
+
+void WpcBinary::convertPressureFile(const std::string& textPath, const std::string& binPath) {
+    write(binPath, pack(WpcReader::readPressureFile(textPath)));
+}
+
+bool WpcBinary::isBinaryFile(const std::string& filepath) {
+    std::ifstream in(filepath, std::ios::binary);
+    uint32_t magic = 0;
+    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    return in && magic == WPC_BINARY_MAGIC;
+}
+
+// ── WpcBinaryReader ──────────────────────────────────────────────────
+
+void WpcBinaryReader::open(const std::string& filepath) {
+    file_.open(filepath);
+    if (file_.size() < sizeof(WpcBinaryHeader)) {
+        throw std::runtime_error("WPC binary file too small: " + filepath);
+    }
+    std::memcpy(&header_, file_.data(), sizeof(header_));
+    if (header_.magic != WPC_BINARY_MAGIC) {
+        throw std::runtime_error("Not a WPC binary file: " + filepath);
+    }
+    if (header_.version != WPC_BINARY_VERSION) {
+        throw std::runtime_error("Unsupported WPC binary version " +
+            std::to_string(header_.version) + ": " + filepath);
+    }
+    if (header_.kind != static_cast<uint16_t>(WpcBinaryKind::Pressure) ||
+        header_.stride != header_.numOpenings) {
+        throw std::runtime_error("WPC binary file is not a pressure table (kind " +
+            std::to_string(header_.kind) + "): " + filepath);
+    }
+
+    size_t n = header_.numRecords;
+    size_t expected = sizeof(WpcBinaryHeader) + n * sizeof(double) * (1 + size_t(header_.stride));
+    if (file_.size() < expected) {
+        throw std::runtime_error("WPC binary file truncated: " + filepath);
+    }
+
+    const char* base = file_.data() + sizeof(WpcBinaryHeader);
+    view_.times = reinterpret_cast<const double*>(base);
+    view_.values = reinterpret_cast<const double*>(base + n * sizeof(double));
+    view_.numRecords = n;
+    view_.stride = header_.stride;
+}
+
+} // namespace contam
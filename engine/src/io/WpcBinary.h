@@ -0,0 +1,114 @@
+#pragma once
+#include "io/WpcReader.h"
+#include "utils/MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace contam {
+
+// ── Binary WPC layout ────────────────────────────────────────────────
+// [WpcBinaryHeader][times: double x numRecords][values: double x numRecords*stride]
+// Values are time-major pressures with stride = numOpenings
+// (value[rec*stride + opening]). Native byte order; the header size keeps
+// both arrays 8-byte aligned for mmap access. Only pressure tables are
+// defined; the kind field lets readers reject anything else.
+
+static constexpr uint32_t WPC_BINARY_MAGIC = 0x31425057;  // "WPB1"
+static constexpr uint16_t WPC_BINARY_VERSION = 1;
+
+enum class WpcBinaryKind : uint16_t { Pressure = 0 };
+
+#pragma pack(push, 1)
+struct WpcBinaryHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t kind;          // WpcBinaryKind
+    uint32_t numRecords;
+    uint32_t numOpenings;
+    uint32_t numSpecies;    // always 1
+    uint32_t stride;        // doubles per record
+    uint64_t reserved;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(WpcBinaryHeader) == 32, "WpcBinaryHeader must be 32 bytes");
+
+// Non-owning view of a time-major WPC table
+struct WpcTableView {
+    const double* times = nullptr;
+    const double* values = nullptr;
+    std::size_t numRecords = 0;
+    std::size_t stride = 0;
+
+    bool empty() const { return numRecords == 0; }
+    const double* row(std::size_t i) const { return values + i * stride; }
+};
+
+// Owning packed table (built from parsed text records)
+struct WpcPackedTable {
+    std::vector<double> times;
+    std::vector<double> values;
+    std::size_t stride = 0;
+    std::size_t numOpenings = 0;
+    std::size_t numSpecies = 1;
+
+    WpcTableView view() const {
+        return {times.data(), values.data(), times.size(), stride};
+    }
+};
+
+// Interpolation cursor: remembers the last bracketing interval so that the
+// monotonically advancing simulation clock costs O(1) per lookup.
+// Writes stride values into a caller-provided buffer (no allocation).
+class WpcCursor {
+public:
+    void interpolate(const WpcTableView& table, double t, double* out);
+    void reset() { index_ = 0; }
+
+private:
+    std::size_t index_ = 0;
+};
+
+// Converter between text WPC records and the binary layout
+class WpcBinary {
+public:
+    // True when every record has as many pressures as the first
+    static bool isRectangular(const std::vector<WpcRecord>& records);
+    // Pack parsed records into a fixed-stride table (throws on ragged rows)
+    static WpcPackedTable pack(const std::vector<WpcRecord>& records);
+
+    static void write(const std::string& filepath, const WpcPackedTable& table);
+
+    // Text file -> binary file
+    static void convertPressureFile(const std::string& textPath, const std::string& binPath);
+
+    // True when the file starts with the binary magic
+    static bool isBinaryFile(const std::string& filepath);
+};
+
+// Memory-mapped reader for binary WPC pressure files. open() throws for
+// foreign, truncated or non-pressure files.
+class WpcBinaryReader {
+public:
+    WpcBinaryReader() = default;
+    explicit WpcBinaryReader(const std::string& filepath) { open(filepath); }
+
+    void open(const std::string& filepath);
+
+    WpcBinaryKind kind() const { return static_cast<WpcBinaryKind>(header_.kind); }
+    std::size_t numRecords() const { return header_.numRecords; }
+    std::size_t numOpenings() const { return header_.numOpenings; }
+    std::size_t numSpecies() const { return header_.numSpecies; }
+    std::size_t stride() const { return header_.stride; }
+
+    WpcTableView view() const { return view_; }
+
+private:
+    MappedFile file_;
+    WpcBinaryHeader header_{};
+    WpcTableView view_;
+};
+
+} // namespace contam
@@ -1,34 +1,22 @@
 #include "WpcReader.h"
-#include <fstream>
-#include <sstream>
+#include "io/TextTokenizer.h"
 #include <stdexcept>
 #include <cmath>
 
 namespace contam {
 
-static std::string readFileContent(const std::string& filepath) {
-    std::ifstream f(filepath);
-    if (!f.is_open()) throw std::runtime_error("Cannot open WPC file: " + filepath);
-    std::ostringstream ss;
-    ss << f.rdbuf();
-    return ss.str();
-}
-
-std::vector<WpcRecord> WpcReader::readPressureString(const std::string& content) {
+static std::vector<WpcRecord> parsePressure(std::string_view content) {
     std::vector<WpcRecord> records;
-    std::istringstream iss(content);
-    std::string line;
-    int lineNum = 0;
+    LineTokenizer tok(content);
     double prevTime = -1e30;
+    size_t expectedCols = 0;
 
-    while (std::getline(iss, line)) {
-        ++lineNum;
-        size_t first = line.find_first_not_of(" \t\r");
-        if (first == std::string::npos || line[first] == '#') continue;
+    while (tok.nextLine()) {
+        if (tok.isBlankOrComment("#")) continue;
+        int lineNum = tok.lineNumber();
 
-        std::istringstream ls(line);
         WpcRecord rec;
-        if (!(ls >> rec.time)) {
+        if (!tok.nextDouble(rec.time)) {
             throw std::runtime_error("WPC pressure parse error at line " + std::to_string(lineNum));
         }
         if (rec.time < prevTime) {
@@ -36,38 +24,35 @@ std::vector<WpcRecord> WpcReader::readPressureString(const std::string& content)
         }
         prevTime = rec.time;
 
+        // Size each row from the previous one to avoid regrowth
+        rec.pressures.reserve(expectedCols);
         double v;
-        while (ls >> v) rec.pressures.push_back(v);
+        while (tok.nextDouble(v)) rec.pressures.push_back(v);
         if (rec.pressures.empty()) {
             throw std::runtime_error("WPC pressure: no data columns at line " + std::to_string(lineNum));
         }
+        expectedCols = rec.pressures.size();
         records.push_back(std::move(rec));
     }
     return records;
 }
 
-std::vector<WpcRecord> WpcReader::readPressureFile(const std::string& filepath) {
-    return readPressureString(readFileContent(filepath));
-}
-
-std::vector<WpcConcentration> WpcReader::readConcentrationString(
-    const std::string& content, int numOpenings, int numSpecies)
+static std::vector<WpcConcentration> parseConcentration(
+    std::string_view content, int numOpenings, int numSpecies)
 {
     std::vector<WpcConcentration> records;
-    std::istringstream iss(content);
-    std::string line;
-    int lineNum = 0;
+    LineTokenizer tok(content);
     double prevTime = -1e30;
     int colsExpected = numOpenings * numSpecies;
+    std::vector<double> vals;
+    vals.reserve(colsExpected);
 
-    while (std::getline(iss, line)) {
-        ++lineNum;
-        size_t first = line.find_first_not_of(" \t\r");
-        if (first == std::string::npos || line[first] == '#') continue;
+    while (tok.nextLine()) {
+        if (tok.isBlankOrComment("#")) continue;
+        int lineNum = tok.lineNumber();
 
-        std::istringstream ls(line);
         WpcConcentration rec;
-        if (!(ls >> rec.time)) {
+        if (!tok.nextDouble(rec.time)) {
             throw std::runtime_error("WPC conc parse error at line " + std::to_string(lineNum));
         }
         if (rec.time < prevTime) {
@@ -75,9 +60,9 @@ std::vector<WpcConcentration> WpcReader::readConcentrationString(
         }
         prevTime = rec.time;
 
-        std::vector<double> vals;
+        vals.clear();
         double v;
-        while (ls >> v) vals.push_back(v);
+        while (tok.nextDouble(v)) vals.push_back(v);
         if (static_cast<int>(vals.size()) < colsExpected) {
             throw std::runtime_error("WPC conc: expected " + std::to_string(colsExpected) +
                 " columns at line " + std::to_string(lineNum));
@@ -85,20 +70,34 @@ std::vector<WpcConcentration> WpcReader::readConcentrationString(
 
         rec.concentrations.resize(numOpenings);
         for (int o = 0; o < numOpenings; ++o) {
-            rec.concentrations[o].resize(numSpecies);
-            for (int s = 0; s < numSpecies; ++s) {
-                rec.concentrations[o][s] = vals[o * numSpecies + s];
-            }
+            rec.concentrations[o].assign(vals.begin() + o * numSpecies,
+                                         vals.begin() + (o + 1) * numSpecies);
         }
         records.push_back(std::move(rec));
     }
     return records;
 }
 
+std::vector<WpcRecord> WpcReader::readPressureString(const std::string& content) {
+    return parsePressure(content);
+}
+
+std::vector<WpcRecord> WpcReader::readPressureFile(const std::string& filepath) {
+    auto src = TextSource::fromFile(filepath, "WPC file");
+    return parsePressure(src.text());
+}
+
+std::vector<WpcConcentration> WpcReader::readConcentrationString(
+    const std::string& content, int numOpenings, int numSpecies)
+{
+    return parseConcentration(content, numOpenings, numSpecies);
+}
+
 std::vector<WpcConcentration> WpcReader::readConcentrationFile(
     const std::string& filepath, int numOpenings, int numSpecies)
 {
-    return readConcentrationString(readFileContent(filepath), numOpenings, numSpecies);
+    auto src = TextSource::fromFile(filepath, "WPC file");
+    return parseConcentration(src.text(), numOpenings, numSpecies);
 }
 
 std::vector<double> WpcReader::interpolatePressure(
@@ -1,84 +1,525 @@
 #include "core/Network.h"
 #include "core/Solver.h"
 #include "core/TransientSimulation.h"
+#include "core/BatchSolve.h"
 #include "io/JsonReader.h"
 #include "io/JsonWriter.h"
+#include "io/ModelCache.h"
+#include "io/EngineServer.h"
+#include "io/BatchRunner.h"
+#include "io/JsonStreamWriter.h"
+#include "io/StreamEventWriter.h"
+#include "io/ColumnarResults.h"
+#include "io/ResultPyramid.h"
+#include "io/WpcBinary.h"
+#include "utils/Profiler.h"
+#include "utils/MemoryTracker.h"
 #ifdef CONTAM_HAS_HDF5
+#include "io/Hdf5StreamWriter.h"
 #include "io/Hdf5Writer.h"
 #endif
+#ifdef CONTAM_HAS_SQLITE3
+#include "io/SqliteWriter.h"
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
-void printUsage(const char* progName) {
-    std::cout << "AirSim Studio Engine v0.2.0\n"
-              << "Usage: " << progName << " -i <input.json> -o <output.json> [options]\n"
-              << "\nOptions:\n"
-              << "  -i <file>    Input JSON file (required)\n"
-              << "  -o <file>    Output results JSON file (required)\n"
-              << "  -m <method>  Solver method: 'sur' or 'tr' (default: tr)\n"
+// Help goes to stdout; after a usage error it goes to stderr so nothing
+// lands where results are written
+void printUsage(const char* progName, std::ostream& out = std::cout) {
+    out << "AirSim Studio Engine v0.2.0\n"
+        << "Usage: " << progName << " -i <input.json> -o <output.json> [options]\n"
+        << "       " << progName << " --server [--socket <path>]\n"
+        << "       " << progName << " --wpc-convert <pressures.wpc> <pressures.wpb>\n"
+        << "       " << progName << " --batch <jobs.txt|dir|glob> [-o <dir>] [--threads <n>]\n"
+        << "\nOptions:\n"
+        << "  -i <file>    Input JSON file (required)\n"
+        << "  -o <file>    Output results JSON file (required, '-' for stdout)\n"
+        << "  -m <method>  Solver method: 'sur' or 'tr' (default: tr)\n"
 #ifdef CONTAM_HAS_HDF5
-              << "  --hdf5 <file> Also write results to HDF5 file\n"
+        << "  --hdf5 <file> Also write results to HDF5 file\n"
+#endif
+#ifdef CONTAM_HAS_SQLITE3
+        << "  --sqlite <file> Also write transient results to an SQLite database\n"
+        << "  --sqlite-schema <s> SQLite layout: 'long' (row per value, default) or 'blob' (row per step)\n"
+#endif
+        << "  --cache-dir <dir> Store compiled model caches in <dir> (default: the per-user cache,\n"
+        << "               e.g. ~/.cache/contam/models; pruned to 256 MB and 30 days)\n"
+        << "  --no-cache   Always parse the JSON input; do not read or write a model cache\n"
+        << "  --columnar <file> Also write transient results in the columnar binary format\n"
+        << "  --pyramid <file> Also write a min/max/mean downsampled result pyramid for charting\n"
+        << "  --output-nodes <ids>    Record only these node ids (comma separated)\n"
+        << "  --output-links <ids>    Record only these link ids\n"
+        << "  --output-species <ids>  Record only these species ids\n"
+        << "  --output-interval <var>=<s> Record pressure|massFlow|concentration every <s> seconds (<0: never)\n"
+        << "  --output-window <t0>:<t1>   Record only output steps with t0 <= t <= t1\n"
+        << "  --output-precision <p>  double, float32 or quantized[:digits]\n"
+        << "  --wpc <file>  Per-opening wind pressures for transient runs (text or binary WPC)\n"
+        << "  --wpc-links <ids> Link ids of the WPC file's columns, in column order\n"
+        << "  --wpc-convert <text> <binary> Convert a text WPC pressure file to the binary format and exit\n"
+        << "  --minify     Write compact transient JSON results (no indentation)\n"
+        << "  --stream     Write newline-delimited JSON progress, solver and result frame events to stdout\n"
+        << "  --stream-frames <n>     With --stream, at most about <n> result frames (default 200)\n"
+        << "  --stream-interval <s>   With --stream, wall seconds between progress events (default 0.25)\n"
+        << "  --stream-nodes <ids>    With --stream, node ids charted in frames (default: all recorded)\n"
+        << "  --stream-links <ids>    With --stream, link ids charted in frames\n"
+        << "  --stream-species <ids>  With --stream, species ids charted in frames\n"
+        << "  --server     Serve newline-delimited JSON-RPC on stdin/stdout, keeping the model loaded\n"
+#ifndef _WIN32
+        << "  --socket <path> With --server, listen on a Unix domain socket instead\n"
 #endif
-              << "  -v           Verbose output\n"
-              << "  -h           Show this help\n"
-              << "\nTransient mode is auto-detected when input contains 'species' and/or 'transient' sections.\n";
+        << "  --batch <spec> Run many models: a jobs file (\"<input> [<output>]\" per line), a directory or a glob\n"
+        << "  --threads <n>  Engine threads for batch jobs, sweep variants, link and species loops\n"
+        << "                 (default: hardware threads; 1 = serial)\n"
+        << "  --batch-memory <MB> Cap the estimated memory of batch jobs in flight\n"
+        << "  --batch-summary <file> Write the batch summary as JSON\n"
+        << "  --profile    Time the run's phases; adds a \"profile\" summary to the results and prints it\n"
+        << "  --profile-trace <file> With --profile, also write a Chrome trace-event timeline\n"
+        << "  --diagnostics Rank the nodes and links that slow airflow convergence; adds a\n"
+        << "               \"convergence\" report to the results and prints it\n"
+        << "  --memory-budget <MB> Stop before solving if the predicted memory exceeds <MB>\n"
+        << "               (a run keeping history that also streams results drops the history instead)\n"
+        << "  -v           Verbose output\n"
+        << "  -h, --help   Show this help\n"
+        << "\nIn batch mode -o names the results directory (default: next to each input).\n"
+        << "Output flags override the model's \"output\" section.\n"
+        << "A model with a \"sweep\" section runs every variant and writes per-variant summaries.\n"
+        << "Transient mode is auto-detected when input contains 'species' and/or 'transient' sections.\n"
+        << "--profile, --diagnostics and --memory-budget apply to single steady or transient runs,\n"
+        << "not to sweeps or batches. With -v or --profile the peak memory per component is printed;\n"
+        << "--profile also adds it to the results as \"memory\".\n";
+}
+
+// Numeric option values: the whole text must be a finite number no smaller
+// than `min`, so "abc", "12x" and out-of-range values are usage errors
+static double parseNumber(const std::string& flag, const std::string& text,
+                          double min = -HUGE_VAL) {
+    double value = 0.0;
+    std::size_t used = 0;
+    try {
+        value = std::stod(text, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != text.size() || !std::isfinite(value)) {
+        throw std::invalid_argument(flag + " expects a number, got '" + text + "'");
+    }
+    if (value < min) {
+        throw std::invalid_argument(flag + " must be at least " + std::to_string(static_cast<long long>(min)) +
+                                    ", got '" + text + "'");
+    }
+    return value;
+}
+
+static int parseInteger(const std::string& flag, const std::string& text,
+                        int min = std::numeric_limits<int>::min()) {
+    int value = 0;
+    std::size_t used = 0;
+    try {
+        value = std::stoi(text, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != text.size()) {
+        throw std::invalid_argument(flag + " expects an integer, got '" + text + "'");
+    }
+    if (value < min) {
+        throw std::invalid_argument(flag + " must be at least " + std::to_string(min) + ", got '" +
+                                    text + "'");
+    }
+    return value;
+}
+
+// MB sizes (--memory-budget, --batch-memory) in bytes
+static std::uint64_t parseMegabytes(const std::string& flag, const std::string& text) {
+    const double mb = parseNumber(flag, text, 0.0);
+    if (mb * 1024.0 * 1024.0 >= 18446744073709551615.0) {
+        throw std::invalid_argument(flag + " is out of range: " + text);
+    }
+    return static_cast<std::uint64_t>(mb * 1024.0 * 1024.0);
+}
+
+static std::vector<int> parseIdList(const std::string& flag, const std::string& text) {
+    std::vector<int> ids;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) ids.push_back(parseInteger(flag, item));
+    }
+    return ids;
+}
+
+// Load --wpc pressures, binary or text, onto the links named by --wpc-links
+static void applyWpc(contam::TransientSimulation& sim, const contam::Network& network,
+                     const std::string& file, const std::vector<int>& linkIds) {
+    if (linkIds.empty()) {
+        throw std::runtime_error("--wpc needs --wpc-links <ids> naming the link of each column");
+    }
+    std::vector<int> indices;
+    for (int id : linkIds) {
+        int index = -1;
+        for (int l = 0; l < network.getLinkCount(); ++l) {
+            if (network.getLink(l).getId() == id) { index = l; break; }
+        }
+        if (index < 0) throw std::runtime_error("--wpc-links: unknown link id " + std::to_string(id));
+        indices.push_back(index);
+    }
+
+    std::size_t columns = 0;
+    if (contam::WpcBinary::isBinaryFile(file)) {
+        auto reader = std::make_shared<const contam::WpcBinaryReader>(file);
+        columns = reader->numOpenings();
+        sim.setWpcBinaryPressures(reader);
+    } else {
+        auto records = contam::WpcReader::readPressureFile(file);
+        if (!records.empty()) columns = records.front().pressures.size();
+        sim.setWpcPressures(records);
+    }
+    if (columns != indices.size()) {
+        throw std::runtime_error("WPC file " + file + " has " + std::to_string(columns) +
+                                 " openings but --wpc-links names " + std::to_string(indices.size()));
+    }
+    sim.setWpcLinkIndices(indices);
+}
+
+// Apply one --output-* flag on top of the model's output spec
+static void applyOutputFlag(contam::OutputSpec& spec, const std::string& flag,
+                            const std::string& value) {
+    if (flag == "--output-nodes") {
+        spec.nodeIds = parseIdList(flag, value);
+    } else if (flag == "--output-links") {
+        spec.linkIds = parseIdList(flag, value);
+    } else if (flag == "--output-species") {
+        spec.speciesIds = parseIdList(flag, value);
+    } else if (flag == "--output-interval") {
+        auto eq = value.find('=');
+        if (eq == std::string::npos) {
+            throw std::runtime_error("--output-interval expects <variable>=<seconds>: " + value);
+        }
+        std::string var = value.substr(0, eq);
+        double seconds = parseNumber(flag, value.substr(eq + 1));
+        if (var == "pressure") spec.pressureInterval = seconds;
+        else if (var == "massFlow") spec.massFlowInterval = seconds;
+        else if (var == "concentration") spec.concentrationInterval = seconds;
+        else throw std::runtime_error("Unknown output variable: " + var);
+    } else if (flag == "--output-window") {
+        auto colon = value.find(':');
+        if (colon == std::string::npos) {
+            throw std::runtime_error("--output-window expects <start>:<end>: " + value);
+        }
+        if (colon > 0) spec.windowStart = parseNumber(flag, value.substr(0, colon));
+        if (colon + 1 < value.size()) spec.windowEnd = parseNumber(flag, value.substr(colon + 1));
+    } else if (flag == "--output-precision") {
+        auto colon = value.find(':');
+        spec.precision = contam::parseOutputPrecision(value.substr(0, colon));
+        if (colon != std::string::npos) {
+            spec.significantDigits = parseInteger(flag, value.substr(colon + 1), 1);
+        }
+    } else {
+        throw std::runtime_error("Unknown option: " + flag);
+    }
 }
 
 int main(int argc, char* argv[]) {
     std::string inputFile;
     std::string outputFile;
     std::string hdf5File;
+    std::string columnarFile;
+    std::string sqliteFile;
+    std::string sqliteSchema = "long";
+    std::string pyramidFile;
     contam::SolverMethod method = contam::SolverMethod::TrustRegion;
     bool verbose = false;
+    bool useCache = true;
+    bool minify = false;
+    bool profile = false;
+    bool diagnose = false;
+    std::uint64_t memoryBudget = 0;
+    std::string profileTrace;
+    std::string cacheDir;
+    bool server = false;
+    std::string socketPath;
+    std::string batchSpec;
+    std::string batchSummary;
+    contam::BatchOptions batchOptions;
+    bool stream = false;
+    std::size_t streamFrames = 200;
+    contam::StreamEventOptions streamOptions;
+    std::vector<std::pair<std::string, std::string>> outputFlags;
+    std::string wpcFile;
+    std::vector<int> wpcLinks;
+    std::string wpcConvertFrom;
+    std::string wpcConvertTo;
 
-    for (int i = 1; i < argc; ++i) {
-        std::string arg = argv[i];
-        if (arg == "-i" && i + 1 < argc) {
-            inputFile = argv[++i];
-        } else if (arg == "-o" && i + 1 < argc) {
-            outputFile = argv[++i];
-        } else if (arg == "-m" && i + 1 < argc) {
-            std::string m = argv[++i];
-            if (m == "sur") method = contam::SolverMethod::SubRelaxation;
-            else if (m == "tr") method = contam::SolverMethod::TrustRegion;
-            else {
-                std::cerr << "Unknown solver method: " << m << std::endl;
-                return 1;
+    // Bad option values are usage errors: message and usage on stderr, exit 1
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "-i" && i + 1 < argc) {
+                inputFile = argv[++i];
+            } else if (arg == "-o" && i + 1 < argc) {
+                outputFile = argv[++i];
+            } else if (arg == "-m" && i + 1 < argc) {
+                std::string m = argv[++i];
+                if (m == "sur") method = contam::SolverMethod::SubRelaxation;
+                else if (m == "tr") method = contam::SolverMethod::TrustRegion;
+                else {
+                    std::cerr << "Unknown solver method: " << m << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--hdf5" && i + 1 < argc) {
+                hdf5File = argv[++i];
+    #ifndef CONTAM_HAS_HDF5
+                std::cerr << "Warning: --hdf5 flag ignored (HDF5 support not compiled in)" << std::endl;
+                hdf5File.clear();
+    #endif
+            } else if (arg == "--sqlite" && i + 1 < argc) {
+                sqliteFile = argv[++i];
+    #ifndef CONTAM_HAS_SQLITE3
+                std::cerr << "Warning: --sqlite flag ignored (SQLite support not compiled in)" << std::endl;
+                sqliteFile.clear();
+    #endif
+            } else if (arg == "--sqlite-schema" && i + 1 < argc) {
+                sqliteSchema = argv[++i];
+                if (sqliteSchema != "long" && sqliteSchema != "blob") {
+                    std::cerr << "Unknown SQLite schema: " << sqliteSchema << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--columnar" && i + 1 < argc) {
+                columnarFile = argv[++i];
+            } else if (arg == "--pyramid" && i + 1 < argc) {
+                pyramidFile = argv[++i];
+            } else if (arg == "--batch" && i + 1 < argc) {
+                batchSpec = argv[++i];
+            } else if (arg == "--threads" && i + 1 < argc) {
+                contam::ThreadPool::setSharedThreads(static_cast<unsigned>(parseInteger(arg, argv[++i], 0)));
+            } else if (arg == "--batch-memory" && i + 1 < argc) {
+                batchOptions.memoryBudget = parseMegabytes(arg, argv[++i]);
+            } else if (arg == "--batch-summary" && i + 1 < argc) {
+                batchSummary = argv[++i];
+            } else if (arg == "--stream") {
+                stream = true;
+            } else if (arg == "--stream-frames" && i + 1 < argc) {
+                streamFrames = static_cast<std::size_t>(parseInteger(arg, argv[++i], 1));
+            } else if (arg == "--stream-interval" && i + 1 < argc) {
+                streamOptions.minInterval = parseNumber(arg, argv[++i], 0.0);
+            } else if (arg == "--stream-nodes" && i + 1 < argc) {
+                streamOptions.nodeIds = parseIdList(arg, argv[++i]);
+            } else if (arg == "--stream-links" && i + 1 < argc) {
+                streamOptions.linkIds = parseIdList(arg, argv[++i]);
+            } else if (arg == "--stream-species" && i + 1 < argc) {
+                streamOptions.speciesIds = parseIdList(arg, argv[++i]);
+            } else if (arg.rfind("--output-", 0) == 0 && i + 1 < argc) {
+                outputFlags.emplace_back(arg, argv[++i]);
+                // Check the value now; it is applied once the model is loaded
+                contam::OutputSpec check;
+                applyOutputFlag(check, arg, outputFlags.back().second);
+            } else if (arg == "--wpc" && i + 1 < argc) {
+                wpcFile = argv[++i];
+            } else if (arg == "--wpc-links" && i + 1 < argc) {
+                wpcLinks = parseIdList(arg, argv[++i]);
+            } else if (arg == "--wpc-convert" && i + 2 < argc) {
+                wpcConvertFrom = argv[++i];
+                wpcConvertTo = argv[++i];
+            } else if (arg == "--cache-dir" && i + 1 < argc) {
+                cacheDir = argv[++i];
+            } else if (arg == "--no-cache") {
+                useCache = false;
+            } else if (arg == "--minify") {
+                minify = true;
+            } else if (arg == "--profile") {
+                profile = true;
+            } else if (arg == "--diagnostics") {
+                diagnose = true;
+            } else if (arg == "--memory-budget" && i + 1 < argc) {
+                memoryBudget = parseMegabytes(arg, argv[++i]);
+            } else if (arg == "--profile-trace" && i + 1 < argc) {
+                profile = true;
+                profileTrace = argv[++i];
+            } else if (arg == "--server") {
+                server = true;
+            } else if (arg == "--socket" && i + 1 < argc) {
+                socketPath = argv[++i];
+            } else if (arg == "-v") {
+                verbose = true;
+            } else if (arg == "-h" || arg == "--help") {
+                printUsage(argv[0]);
+                return 0;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n\n";
+        printUsage(argv[0], std::cerr);
+        return 1;
+    }
+
+    if (!wpcConvertFrom.empty()) {
+        try {
+            contam::WpcBinary::convertPressureFile(wpcConvertFrom, wpcConvertTo);
+            if (verbose) std::cout << "WPC pressures written to: " << wpcConvertTo << std::endl;
+            return 0;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (server) {
+        // stdout carries responses only; diagnostics go to stderr
+        try {
+            contam::EngineServer engineServer;
+#ifndef _WIN32
+            if (!socketPath.empty()) {
+                if (verbose) std::cerr << "Listening on " << socketPath << std::endl;
+                engineServer.serveUnixSocket(socketPath);
+                return 0;
             }
-        } else if (arg == "--hdf5" && i + 1 < argc) {
-            hdf5File = argv[++i];
-#ifndef CONTAM_HAS_HDF5
-            std::cerr << "Warning: --hdf5 flag ignored (HDF5 support not compiled in)" << std::endl;
-            hdf5File.clear();
 #endif
-        } else if (arg == "-v") {
-            verbose = true;
-        } else if (arg == "-h") {
-            printUsage(argv[0]);
+            std::ios::sync_with_stdio(false);
+            engineServer.serve(std::cin, std::cout);
             return 0;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (!batchSpec.empty()) {
+        try {
+            auto jobs = contam::collectBatchJobs(batchSpec, outputFile);
+            if (jobs.empty()) {
+                std::cerr << "No model files in " << batchSpec << std::endl;
+                return 1;
+            }
+            batchOptions.method = method;
+            batchOptions.useCache = useCache;
+            batchOptions.cacheDir = cacheDir;
+            if (verbose) {
+                batchOptions.onJobDone = [](const contam::BatchJobResult& r, std::size_t done,
+                                            std::size_t total) {
+                    std::cerr << "[" << done << "/" << total << "] " << r.job.input << ": "
+                              << contam::toString(r.status) << " (" << r.seconds << " s)" << std::endl;
+                };
+            }
+            auto report = contam::runBatch(jobs, batchOptions);
+            contam::printBatchSummary(report, std::cout);
+            if (!batchSummary.empty()) contam::writeBatchSummary(report, batchSummary);
+            if (report.count(contam::BatchJobStatus::Failed) > 0) return 1;
+            return report.count(contam::BatchJobStatus::NotConverged) > 0 ? 2 : 0;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
         }
     }
 
     if (inputFile.empty() || outputFile.empty()) {
-        printUsage(argv[0]);
+        printUsage(argv[0], std::cerr);
         return 1;
     }
 
+    // With results or stream events on stdout, progress and diagnostics go
+    // to stderr
+    const bool toStdout = (outputFile == "-");
+    if (stream && toStdout) {
+        std::cerr << "--stream writes events to stdout; results need an output file" << std::endl;
+        return 1;
+    }
+    std::ostream& info = (toStdout || stream) ? std::cerr : std::cout;
+    std::shared_ptr<contam::StreamEventWriter> events;
+    std::unique_ptr<contam::Profiler> profiler;
+    if (profile) profiler = std::make_unique<contam::Profiler>(!profileTrace.empty());
+    std::unique_ptr<contam::ConvergenceDiagnostics> diagnostics;
+    if (diagnose) diagnostics = std::make_unique<contam::ConvergenceDiagnostics>();
+    std::unique_ptr<contam::MemoryTracker> memory;
+    if (profile || verbose) memory = std::make_unique<contam::MemoryTracker>();
+    const contam::MemoryTracker* memoryResults = profile ? memory.get() : nullptr;
+
+    // Print the convergence, memory and profile reports and write the trace
+    // once the results are out
+    auto printReports = [&]() {
+        if (diagnostics) info << "\nConvergence:\n" << diagnostics->formatText();
+        if (memory) info << "\nMemory:\n" << memory->formatText();
+        if (!profiler) return;
+        profiler->stop();
+        info << "\nProfile:\n" << profiler->formatText();
+        if (!profileTrace.empty()) {
+            profiler->writeChromeTrace(profileTrace);
+            if (verbose) info << "Trace written to: " << profileTrace << std::endl;
+        }
+    };
+
     try {
-        if (verbose) std::cout << "Reading input: " << inputFile << std::endl;
-        auto model = contam::JsonReader::readModelFromFile(inputFile);
+        if (verbose) info << "Reading input: " << inputFile << std::endl;
+        auto model = [&]() {
+            contam::ProfileScope load(profiler.get(), contam::ProfilePhase::Load);
+            return useCache ? contam::ModelCache::loadModel(inputFile, cacheDir)
+                            : contam::JsonReader::readModelFromFile(inputFile);
+        }();
+
+        for (const auto& [flag, value] : outputFlags) {
+            applyOutputFlag(model.outputSpec, flag, value);
+        }
 
         if (verbose) {
-            std::cout << "Network: " << model.network.getNodeCount() << " nodes, "
-                      << model.network.getLinkCount() << " links\n"
-                      << "Unknown pressures: " << model.network.getUnknownCount() << "\n";
+            const auto& ls = model.loadStats;
+            if (ls.fromCache) {
+                info << "Loaded model cache: " << ls.bytes << " bytes in "
+                     << ls.totalSeconds() * 1000.0 << " ms\n";
+            } else {
+                info << "Parsed " << ls.bytes << " bytes in " << ls.totalSeconds() * 1000.0
+                     << " ms (parse " << ls.parseSeconds * 1000.0 << " ms, build "
+                     << ls.buildSeconds * 1000.0 << " ms, " << ls.throughputMBps() << " MB/s)\n";
+            }
+            if (ls.flowElementTemplates > 0) {
+                info << "Flow element templates: " << ls.flowElementTemplates
+                     << " shared by " << ls.sharedElementLinks << " links\n";
+            }
+            info << "Network: " << model.network.getNodeCount() << " nodes, "
+                 << model.network.getLinkCount() << " links\n"
+                 << "Unknown pressures: " << model.network.getUnknownCount() << "\n";
             if (!model.species.empty()) {
-                std::cout << "Species: " << model.species.size() << "\n";
-                std::cout << "Sources: " << model.sources.size() << "\n";
+                info << "Species: " << model.species.size() << "\n";
+                info << "Sources: " << model.sources.size() << "\n";
             }
         }
 
-        if (model.hasTransient || !model.species.empty()) {
+        if (!model.sweep.empty()) {
+            // ── Parametric sweep ──
+            model.transientConfig.airflowMethod = method;
+            contam::BatchProgress progress;
+            if (verbose) {
+                progress = [&info](std::size_t done, std::size_t total) {
+                    info << "\r  variant " << done << "/" << total << std::flush;
+                    return true;
+                };
+            }
+            auto sweep = contam::runSweep(model, contam::ThreadPool::shared(), 0, progress);
+
+            std::size_t ok = 0;
+            for (const auto& v : sweep.variants) ok += v.ok ? 1 : 0;
+            if (verbose) {
+                info << "\nSweep: " << sweep.plan.numVariants << " variants, " << ok << " "
+                     << (sweep.transient ? "completed" : "converged") << " in "
+                     << sweep.wallSeconds << " s" << std::endl;
+            }
+            if (toStdout) {
+                std::cout << contam::JsonWriter::writeSweepToString(model, sweep) << std::endl;
+            } else {
+                contam::JsonWriter::writeSweepToFile(outputFile, model, sweep);
+                if (verbose) info << "Results written to: " << outputFile << std::endl;
+            }
+            return ok == sweep.plan.numVariants ? 0 : 2;
+
+        } else if (model.hasTransient || !model.species.empty()) {
             // ── Transient simulation ──
             if (!model.hasTransient) {
                 model.transientConfig.endTime = 3600.0;
@@ -88,83 +529,151 @@ int main(int argc, char* argv[]) {
             model.transientConfig.airflowMethod = method;
 
             if (verbose) {
-                std::cout << "Running transient simulation: "
-                          << model.transientConfig.startTime << "s to "
-                          << model.transientConfig.endTime << "s (dt="
-                          << model.transientConfig.timeStep << "s)..." << std::endl;
+                info << "Running transient simulation: "
+                     << model.transientConfig.startTime << "s to "
+                     << model.transientConfig.endTime << "s (dt="
+                     << model.transientConfig.timeStep << "s)..." << std::endl;
             }
 
             contam::TransientSimulation sim;
-            sim.setConfig(model.transientConfig);
-            sim.setSpecies(model.species);
-            sim.setSources(model.sources);
-            sim.setSchedules(model.schedules);
-            sim.setZoneTemperatureSchedules(model.zoneTemperatureSchedules);
-            sim.setOccupants(model.occupants);
-            if (!model.weatherData.empty()) {
-                sim.setWeatherData(model.weatherData);
-            }
-            if (!model.ahSystems.empty()) {
-                sim.setAHSystems(model.ahSystems);
-            }
+            contam::configureSimulation(sim, model);
+            sim.setProfiler(profiler.get());
+            sim.setDiagnostics(diagnostics.get());
+            sim.setMemoryTracker(memory.get());
+            sim.setMemoryBudget(memoryBudget);
+            if (!wpcFile.empty()) applyWpc(sim, model.network, wpcFile, wpcLinks);
 
-            if (verbose) {
-                sim.setProgressCallback([](double t, double end) {
-                    std::cout << "\r  t=" << t << "/" << end << "s" << std::flush;
+            if (stream) {
+                const auto& tc = model.transientConfig;
+                streamOptions.startTime = tc.startTime;
+                streamOptions.endTime = tc.endTime;
+                const double outputSteps =
+                    tc.outputInterval > 0.0 ? std::ceil((tc.endTime - tc.startTime) / tc.outputInterval) + 1 : 1;
+                streamOptions.frameStride =
+                    static_cast<std::size_t>(std::ceil(outputSteps / static_cast<double>(streamFrames)));
+                events = std::make_shared<contam::StreamEventWriter>(std::cout, streamOptions);
+                sim.setProgressCallback([&events](double t, double end) {
+                    return events->progress(t, end);
+                });
+            } else if (verbose) {
+                sim.setProgressCallback([&info](double t, double end) {
+                    info << "\r  t=" << t << "/" << end << "s" << std::flush;
                     return true;
                 });
             }
 
-            auto result = sim.run(model.network);
-
-            if (verbose) {
-                std::cout << "\n" << (result.completed ? "Completed" : "Incomplete")
-                          << " (" << result.history.size() << " output steps)" << std::endl;
+            // Stream results as they are produced; no writer needs the history
+            contam::JsonStreamOptions jsonOptions;
+            jsonOptions.minify = minify;
+            auto jsonSink = toStdout
+                ? std::make_shared<contam::JsonStreamWriter>(std::cout, jsonOptions)
+                : std::make_shared<contam::JsonStreamWriter>(outputFile, jsonOptions);
+            jsonSink->setProfile(profiler.get());
+            jsonSink->setDiagnostics(diagnostics.get());
+            jsonSink->setMemory(memoryResults);
+            sim.addResultSink(jsonSink);
+            if (!columnarFile.empty()) {
+                sim.addResultSink(std::make_shared<contam::ColumnarResultsWriter>(columnarFile));
             }
-
-            contam::JsonWriter::writeTransientToFile(outputFile, model.network, result, model.species);
-            if (verbose) std::cout << "Results written to: " << outputFile << std::endl;
-
+            if (!pyramidFile.empty()) {
+                sim.addResultSink(std::make_shared<contam::ResultPyramid>(pyramidFile));
+            }
+#ifdef CONTAM_HAS_SQLITE3
+            if (!sqliteFile.empty()) {
+                contam::SqliteOptions sqliteOptions;
+                sqliteOptions.schema = sqliteSchema == "blob" ? contam::SqliteSchema::Blob
+                                                              : contam::SqliteSchema::Long;
+                sim.addResultSink(std::make_shared<contam::SqliteWriter>(sqliteFile, sqliteOptions));
+            }
+#endif
 #ifdef CONTAM_HAS_HDF5
             if (!hdf5File.empty()) {
-                contam::Hdf5Writer::writeTransient(hdf5File, model.network, model.species, result);
-                if (verbose) std::cout << "HDF5 results written to: " << hdf5File << std::endl;
+                sim.addResultSink(std::make_shared<contam::Hdf5StreamWriter>(hdf5File));
             }
 #endif
+            // Last, so "end" is only sent once every writer has finished
+            if (events) sim.addResultSink(events);
+            sim.setStoreHistory(false);
+            if (verbose) {
+                info << "Predicted memory: " << contam::formatBytes(sim.estimateMemory(model.network).total())
+                     << std::endl;
+            }
+
+            auto result = sim.run(model.network);
+            printReports();
+
+            if (verbose) {
+                info << "\n" << (result.completed ? "Completed" : "Incomplete")
+                     << " (" << jsonSink->stepCount() << " output steps)" << std::endl;
+                if (!toStdout) info << "Results written to: " << outputFile << std::endl;
+                if (!columnarFile.empty()) info << "Columnar results written to: " << columnarFile << std::endl;
+                if (!pyramidFile.empty()) info << "Result pyramid written to: " << pyramidFile << std::endl;
+                if (!sqliteFile.empty()) info << "SQLite results written to: " << sqliteFile << std::endl;
+                if (!hdf5File.empty()) info << "HDF5 results written to: " << hdf5File << std::endl;
+            }
 
             return result.completed ? 0 : 2;
 
         } else {
             // ── Steady-state solve ──
             contam::Solver solver(method);
+            solver.setProfiler(profiler.get());
+            solver.setDiagnostics(diagnostics.get());
+            solver.setMemoryTracker(memory.get());
+            const contam::MemoryEstimate estimate = contam::Solver::estimateMemory(model.network);
+            contam::checkMemoryBudget(estimate, memoryBudget);
+            if (memory) {
+                memory->setPrediction(estimate);
+                memory->set(contam::MemoryComponent::Network, estimate[contam::MemoryComponent::Network]);
+                memory->set(contam::MemoryComponent::Elements, estimate[contam::MemoryComponent::Elements]);
+            }
             if (verbose) {
-                std::cout << "Solving steady-state with "
-                          << (method == contam::SolverMethod::TrustRegion ? "Trust Region" : "Sub-Relaxation")
-                          << " method..." << std::endl;
+                info << "Predicted memory: " << contam::formatBytes(estimate.total()) << std::endl;
+                info << "Solving steady-state with "
+                     << (method == contam::SolverMethod::TrustRegion ? "Trust Region" : "Sub-Relaxation")
+                     << " method..." << std::endl;
             }
 
             auto result = solver.solve(model.network);
+            if (stream) {
+                events = std::make_shared<contam::StreamEventWriter>(std::cout, streamOptions);
+                events->solved(result);
+            }
 
             if (verbose) {
-                std::cout << (result.converged ? "Converged" : "FAILED to converge")
-                          << " in " << result.iterations << " iterations"
-                          << " (max residual: " << result.maxResidual << " kg/s)" << std::endl;
+                info << (result.converged ? "Converged" : "FAILED to converge")
+                     << " in " << result.iterations << " iterations"
+                     << " (max residual: " << result.maxResidual << " kg/s)" << std::endl;
             }
 
-            contam::JsonWriter::writeToFile(outputFile, model.network, result);
-            if (verbose) std::cout << "Results written to: " << outputFile << std::endl;
+            if (profiler) profiler->stop();
+            if (toStdout) {
+                std::cout << contam::JsonWriter::writeToString(model.network, result, 2, profiler.get(),
+                                                               diagnostics.get(), memoryResults)
+                          << std::endl;
+            } else {
+                contam::JsonWriter::writeToFile(outputFile, model.network, result, profiler.get(),
+                                                diagnostics.get(), memoryResults);
+                if (verbose) info << "Results written to: " << outputFile << std::endl;
+            }
+            printReports();
 
 #ifdef CONTAM_HAS_HDF5
             if (!hdf5File.empty()) {
                 contam::Hdf5Writer::writeSteadyState(hdf5File, model.network, result);
-                if (verbose) std::cout << "HDF5 results written to: " << hdf5File << std::endl;
+                if (verbose) info << "HDF5 results written to: " << hdf5File << std::endl;
             }
 #endif
 
+            if (events) events->end(result.converged);
             return result.converged ? 0 : 2;
         }
 
     } catch (const std::exception& e) {
+        if (stream) {
+            if (!events) events = std::make_shared<contam::StreamEventWriter>(std::cout, streamOptions);
+            events->error(e.what());
+        }
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
     }
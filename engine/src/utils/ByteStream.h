@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace contam {
+
+// Append-only native-endian binary buffer used by the binary file formats
+// (model cache, columnar results). Arrays are written as uint32 count + raw data.
+class ByteWriter {
+public:
+    template <typename T>
+    void put(const T& value) { append(&value, sizeof(T)); }
+
+    template <typename T>
+    void putArray(const std::vector<T>& values) {
+        put(static_cast<uint32_t>(values.size()));
+        append(values.data(), values.size() * sizeof(T));
+    }
+
+    // Raw values without a count prefix
+    template <typename T>
+    void putRaw(const T* values, std::size_t count) { append(values, count * sizeof(T)); }
+
+    void putString(const std::string& s) {
+        put(static_cast<uint32_t>(s.size()));
+        append(s.data(), s.size());
+    }
+
+    // Zero-pad to a multiple of `alignment` bytes
+    void align(std::size_t alignment) {
+        std::size_t rem = buf_.size() % alignment;
+        if (rem != 0) buf_.append(alignment - rem, '\0');
+    }
+
+    std::size_t size() const { return buf_.size(); }
+    std::string& buffer() { return buf_; }
+
+private:
+    std::string buf_;
+
+    void append(const void* data, std::size_t n) {
+        buf_.append(static_cast<const char*>(data), n);
+    }
+};
+
+// Bounds-checked reader over a ByteWriter image (typically a mapped file).
+// Values are memcpy'd out, so the source needs no particular alignment.
+class ByteReader {
+public:
+    ByteReader(const char* data, std::size_t size, const char* what = "Binary data")
+        : data_(data), size_(size), what_(what) {}
+
+    template <typename T>
+    T get() {
+        T value;
+        take(&value, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    std::vector<T> getArray() {
+        uint32_t n = get<uint32_t>();
+        if (static_cast<std::size_t>(n) * sizeof(T) > size_ - pos_) truncated();
+        std::vector<T> values(n);
+        take(values.data(), values.size() * sizeof(T));
+        return values;
+    }
+
+    std::string getString() {
+        uint32_t n = get<uint32_t>();
+        if (n > size_ - pos_) truncated();
+        std::string s(data_ + pos_, n);
+        pos_ += n;
+        return s;
+    }
+
+    std::size_t position() const { return pos_; }
+
+private:
+    const char* data_;
+    std::size_t size_;
+    std::size_t pos_ = 0;
+    const char* what_;
+
+    [[noreturn]] void truncated() const {
+        throw std::runtime_error(std::string(what_) + " is truncated");
+    }
+
+    void take(void* out, std::size_t n) {
+        if (n > size_ - pos_) truncated();
+        if (n > 0) std::memcpy(out, data_ + pos_, n);
+        pos_ += n;
+    }
+};
+
+} // namespace contam
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 
 namespace contam {
 
@@ -21,4 +22,9 @@ constexpr double TR_MAX_RADIUS = 1.0e6;      // Pa, maximum trust region radius
 constexpr double TR_ETA1 = 0.25;             // threshold for step rejection
 constexpr double TR_ETA2 = 0.75;             // threshold for radius expansion
 
+// Parallel work sizes (below the minimum a loop stays on the calling thread)
+constexpr std::size_t PARALLEL_LINK_MIN = 4096;    // links per flow evaluation
+constexpr std::size_t PARALLEL_LINK_GRAIN = 1024;  // links per task
+constexpr int PARALLEL_SPECIES_MIN_ZONES = 24;     // zones per independent species solve
+
 } // namespace contam
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace contam {
+
+// Read-only memory-mapped file (POSIX mmap / Win32 file mapping)
+// Move-only RAII handle; the mapping is released on destruction.
+// Empty files are valid and yield data() == nullptr, size() == 0.
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& filepath);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Map a file, replacing any existing mapping. Throws std::runtime_error on failure.
+    void open(const std::string& filepath);
+    void close();
+
+    bool isOpen() const { return open_; }
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    const std::string& path() const { return path_; }
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool open_ = false;
+    std::string path_;
+#ifdef _WIN32
+    void* fileHandle_ = nullptr;
+    void* mapHandle_ = nullptr;
+#endif
+};
+
+} // namespace contam
@@ -0,0 +1,152 @@
+#include "utils/MemoryTracker.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+namespace contam {
+
+using json = nlohmann::json;
+
+namespace {
+
+void raiseTo(std::atomic<std::uint64_t>& peak, std::uint64_t value) {
+    std::uint64_t seen = peak.load(std::memory_order_relaxed);
+    while (value > seen && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+const char* toString(MemoryComponent component) {
+    switch (component) {
+        case MemoryComponent::Network: return "network";
+        case MemoryComponent::Elements: return "elements";
+        case MemoryComponent::SolverWorkspace: return "solverWorkspace";
+        case MemoryComponent::TransportMatrices: return "transportMatrices";
+        case MemoryComponent::History: return "history";
+        case MemoryComponent::ReportAccumulators: return "reportAccumulators";
+        case MemoryComponent::IoBuffers: return "ioBuffers";
+        case MemoryComponent::Count: break;
+    }
+    return "unknown";
+}
+
+std::string formatBytes(std::uint64_t bytes) {
+    static const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    double value = static_cast<double>(bytes);
+    int unit = 0;
+    while (value >= 1024.0 && unit < 4) {
+        value /= 1024.0;
+        ++unit;
+    }
+    char text[32];
+    std::snprintf(text, sizeof(text), unit == 0 ? "%.0f %s" : "%.1f %s", value, units[unit]);
+    return text;
+}
+
+// ── MemoryEstimate ──
+
+std::uint64_t MemoryEstimate::total() const {
+    std::uint64_t sum = 0;
+    for (auto b : bytes) sum += b;
+    return sum;
+}
+
+MemoryComponent MemoryEstimate::largest() const {
+    return static_cast<MemoryComponent>(std::max_element(bytes.begin(), bytes.end()) - bytes.begin());
+}
+
+json MemoryEstimate::toJson() const {
+    json components = json::object();
+    for (int c = 0; c < static_cast<int>(MemoryComponent::Count); ++c) {
+        if (bytes[c] > 0) components[toString(static_cast<MemoryComponent>(c))] = bytes[c];
+    }
+    return {{"totalBytes", total()}, {"components", std::move(components)}};
+}
+
+void checkMemoryBudget(const MemoryEstimate& estimate, std::uint64_t budget) {
+    if (budget == 0 || estimate.total() <= budget) return;
+    const MemoryComponent largest = estimate.largest();
+    throw std::runtime_error("Memory budget exceeded: the run needs an estimated " + formatBytes(estimate.total()) +
+                             " (largest: " + toString(largest) + " " + formatBytes(estimate[largest]) +
+                             ") but the budget is " + formatBytes(budget));
+}
+
+// ── MemoryTracker ──
+
+void MemoryTracker::allocate(MemoryComponent component, std::uint64_t bytes) {
+    const int c = static_cast<int>(component);
+    const std::uint64_t now = current_[c].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    raisePeaks(c, now, total_.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+}
+
+void MemoryTracker::release(MemoryComponent component, std::uint64_t bytes) {
+    current_[static_cast<int>(component)].fetch_sub(bytes, std::memory_order_relaxed);
+    total_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void MemoryTracker::set(MemoryComponent component, std::uint64_t bytes) {
+    const int c = static_cast<int>(component);
+    const std::uint64_t old = current_[c].exchange(bytes, std::memory_order_relaxed);
+    if (bytes >= old) {
+        raisePeaks(c, bytes, total_.fetch_add(bytes - old, std::memory_order_relaxed) + (bytes - old));
+    } else {
+        total_.fetch_sub(old - bytes, std::memory_order_relaxed);
+    }
+}
+
+void MemoryTracker::raisePeaks(int component, std::uint64_t componentBytes, std::uint64_t totalBytes) {
+    raiseTo(peak_[component], componentBytes);
+    raiseTo(peakTotal_, totalBytes);
+}
+
+std::uint64_t MemoryTracker::current(MemoryComponent component) const {
+    return current_[static_cast<int>(component)].load(std::memory_order_relaxed);
+}
+
+std::uint64_t MemoryTracker::peak(MemoryComponent component) const {
+    return peak_[static_cast<int>(component)].load(std::memory_order_relaxed);
+}
+
+json MemoryTracker::summary() const {
+    json components = json::object();
+    for (int c = 0; c < NUM_COMPONENTS; ++c) {
+        const auto id = static_cast<MemoryComponent>(c);
+        if (peak(id) == 0 && prediction_[id] == 0) continue;
+        json entry{{"peakBytes", peak(id)}, {"currentBytes", current(id)}};
+        if (hasPrediction_) entry["predictedBytes"] = prediction_[id];
+        components[toString(id)] = std::move(entry);
+    }
+    json j{{"peakBytes", peakTotal()}, {"currentBytes", currentTotal()}};
+    if (hasPrediction_) j["predictedBytes"] = prediction_.total();
+    j["components"] = std::move(components);
+    return j;
+}
+
+std::string MemoryTracker::formatText() const {
+    std::vector<MemoryComponent> order;
+    for (int c = 0; c < NUM_COMPONENTS; ++c) {
+        const auto id = static_cast<MemoryComponent>(c);
+        if (peak(id) > 0 || prediction_[id] > 0) order.push_back(id);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [this](MemoryComponent a, MemoryComponent b) { return peak(a) > peak(b); });
+
+    std::string out;
+    char line[128];
+    std::snprintf(line, sizeof(line), "%-20s %12s %12s %12s\n", "Component", "Peak", "Current",
+                  hasPrediction_ ? "Predicted" : "");
+    out += line;
+    auto row = [&](const char* name, std::uint64_t peakBytes, std::uint64_t currentBytes, std::uint64_t predicted) {
+        std::snprintf(line, sizeof(line), "%-20s %12s %12s %12s\n", name, formatBytes(peakBytes).c_str(),
+                      formatBytes(currentBytes).c_str(), hasPrediction_ ? formatBytes(predicted).c_str() : "");
+        out += line;
+    };
+    for (MemoryComponent id : order) row(toString(id), peak(id), current(id), prediction_[id]);
+    row("total", peakTotal(), currentTotal(), prediction_.total());
+    return out;
+}
+
+} // namespace contam
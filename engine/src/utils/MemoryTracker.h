@@ -0,0 +1,124 @@
+#pragma once
+
+#include <nlohmann/json_fwd.hpp>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace contam {
+
+// What a run's memory is spent on
+enum class MemoryComponent : int {
+    Network,            // nodes, links and the node id index
+    Elements,           // flow elements, shared templates once
+    SolverWorkspace,    // airflow Jacobian, triplets, factorization
+    TransportMatrices,  // dense transport systems, one per species in flight
+    History,            // stored time steps and in-memory recorders
+    ReportAccumulators, // single-pass report sinks
+    IoBuffers,          // writer buffers, spill rows and pending frames
+    Count
+};
+
+const char* toString(MemoryComponent component);
+
+// "1.5 MB" style size
+std::string formatBytes(std::uint64_t bytes);
+
+// Heap bytes of a vector's storage
+template <typename T>
+std::uint64_t vectorBytes(const std::vector<T>& v) {
+    return v.capacity() * sizeof(T);
+}
+
+// Bytes per component, either predicted before a run or measured
+struct MemoryEstimate {
+    std::array<std::uint64_t, static_cast<int>(MemoryComponent::Count)> bytes{};
+
+    std::uint64_t& operator[](MemoryComponent c) { return bytes[static_cast<int>(c)]; }
+    std::uint64_t operator[](MemoryComponent c) const { return bytes[static_cast<int>(c)]; }
+    std::uint64_t total() const;
+    MemoryComponent largest() const;
+
+    // { totalBytes, components: { name: bytes } }, zero components omitted
+    nlohmann::json toJson() const;
+};
+
+// Throws std::runtime_error naming the largest component when `estimate`
+// exceeds `budget` bytes (0 = no budget)
+void checkMemoryBudget(const MemoryEstimate& estimate, std::uint64_t budget);
+
+// Current and peak bytes per component of one run. Components report what
+// they hold through allocate()/release() or set(); the tracker keeps the
+// peak of each component and of their sum. Updates are lock-free and safe
+// from pool threads. Like Profiler, components take a MemoryTracker* that is
+// null when nothing is tracked.
+//
+//   MemoryTracker memory;
+//   sim.setMemoryTracker(&memory);
+//   sim.run(network);
+//   results["memory"] = memory.summary();
+class MemoryTracker {
+public:
+    MemoryTracker() = default;
+    MemoryTracker(const MemoryTracker&) = delete;
+    MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+    void allocate(MemoryComponent component, std::uint64_t bytes);
+    void release(MemoryComponent component, std::uint64_t bytes);
+    // Replace the component's current bytes (e.g. a buffer polled for its size)
+    void set(MemoryComponent component, std::uint64_t bytes);
+
+    std::uint64_t current(MemoryComponent component) const;
+    std::uint64_t peak(MemoryComponent component) const;
+    std::uint64_t currentTotal() const { return total_.load(std::memory_order_relaxed); }
+    std::uint64_t peakTotal() const { return peakTotal_.load(std::memory_order_relaxed); }
+
+    // Prediction made before the run, reported next to the measurements
+    void setPrediction(const MemoryEstimate& estimate) { prediction_ = estimate; hasPrediction_ = true; }
+    bool hasPrediction() const { return hasPrediction_; }
+    const MemoryEstimate& prediction() const { return prediction_; }
+
+    // { peakBytes, currentBytes, predictedBytes, components: { name:
+    //   { peakBytes, currentBytes, predictedBytes } } }
+    // Components never used or predicted are omitted.
+    nlohmann::json summary() const;
+    // Component table, largest peak first
+    std::string formatText() const;
+
+private:
+    static constexpr int NUM_COMPONENTS = static_cast<int>(MemoryComponent::Count);
+
+    std::array<std::atomic<std::uint64_t>, NUM_COMPONENTS> current_{};
+    std::array<std::atomic<std::uint64_t>, NUM_COMPONENTS> peak_{};
+    std::atomic<std::uint64_t> total_{0};
+    std::atomic<std::uint64_t> peakTotal_{0};
+    MemoryEstimate prediction_;
+    bool hasPrediction_ = false;
+
+    void raisePeaks(int component, std::uint64_t componentBytes, std::uint64_t totalBytes);
+};
+
+// Holds `bytes` of `component` for the enclosing block; does nothing
+// without a tracker
+class MemoryScope {
+public:
+    MemoryScope(MemoryTracker* tracker, MemoryComponent component, std::uint64_t bytes)
+        : tracker_(tracker), component_(component), bytes_(bytes) {
+        if (tracker_) tracker_->allocate(component_, bytes_);
+    }
+    ~MemoryScope() {
+        if (tracker_) tracker_->release(component_, bytes_);
+    }
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemoryTracker* tracker_;
+    MemoryComponent component_;
+    std::uint64_t bytes_;
+};
+
+} // namespace contam
@@ -0,0 +1,198 @@
+#include "utils/Profiler.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <bitset>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace contam {
+
+using json = nlohmann::json;
+
+namespace {
+
+// Small per-process thread numbers for trace tracks and the thread count
+int32_t threadIndex() {
+    static std::atomic<int32_t> next{0};
+    thread_local int32_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+} // namespace
+
+const char* toString(ProfilePhase phase) {
+    switch (phase) {
+        case ProfilePhase::Load: return "load";
+        case ProfilePhase::Setup: return "setup";
+        case ProfilePhase::Boundary: return "boundary";
+        case ProfilePhase::Controls: return "controls";
+        case ProfilePhase::AirflowAssemble: return "airflow.assemble";
+        case ProfilePhase::AirflowFactor: return "airflow.factor";
+        case ProfilePhase::AirflowSolve: return "airflow.solve";
+        case ProfilePhase::TransportAssemble: return "transport.assemble";
+        case ProfilePhase::TransportSolve: return "transport.solve";
+        case ProfilePhase::Output: return "output";
+        case ProfilePhase::Count: break;
+    }
+    return "unknown";
+}
+
+const char* toString(ProfileCounter counter) {
+    switch (counter) {
+        case ProfileCounter::TimeSteps: return "timeSteps";
+        case ProfileCounter::AirflowSolves: return "airflowSolves";
+        case ProfileCounter::NewtonIterations: return "newtonIterations";
+        case ProfileCounter::LinearIterations: return "linearIterations";
+        case ProfileCounter::Factorizations: return "factorizations";
+        case ProfileCounter::OrderingCacheHits: return "orderingCacheHits";
+        case ProfileCounter::OrderingCacheMisses: return "orderingCacheMisses";
+        case ProfileCounter::TransportSolves: return "transportSolves";
+        case ProfileCounter::Allocations: return "allocations";
+        case ProfileCounter::AllocatedBytes: return "allocatedBytes";
+        case ProfileCounter::Count: break;
+    }
+    return "unknown";
+}
+
+Profiler::Profiler(bool trace)
+    : trace_(trace), origin_(Clock::now())
+{
+    for (auto& v : nanos_) v.store(0, std::memory_order_relaxed);
+    for (auto& v : calls_) v.store(0, std::memory_order_relaxed);
+    for (auto& v : counters_) v.store(0, std::memory_order_relaxed);
+}
+
+void Profiler::add(ProfilePhase phase, int64_t startNs, int64_t endNs) {
+    const int p = static_cast<int>(phase);
+    nanos_[p].fetch_add(endNs - startNs, std::memory_order_relaxed);
+    calls_[p].fetch_add(1, std::memory_order_relaxed);
+
+    const int32_t thread = threadIndex();
+    const uint64_t bit = uint64_t{1} << std::min(thread, 63);
+    if (!(threadMask_.load(std::memory_order_relaxed) & bit)) {
+        threadMask_.fetch_or(bit, std::memory_order_relaxed);
+    }
+
+    if (!trace_) return;
+    std::lock_guard<std::mutex> lock(traceMutex_);
+    if (events_.size() >= MAX_TRACE_EVENTS) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    events_.push_back({startNs, endNs - startNs, thread, phase});
+}
+
+void Profiler::stop() {
+    int64_t running = -1;
+    stoppedAt_.compare_exchange_strong(running, now());
+}
+
+double Profiler::seconds(ProfilePhase phase) const {
+    return nanos_[static_cast<int>(phase)].load(std::memory_order_relaxed) * 1e-9;
+}
+
+int64_t Profiler::calls(ProfilePhase phase) const {
+    return calls_[static_cast<int>(phase)].load(std::memory_order_relaxed);
+}
+
+int64_t Profiler::counter(ProfileCounter c) const {
+    return counters_[static_cast<int>(c)].load(std::memory_order_relaxed);
+}
+
+double Profiler::wallSeconds() const {
+    int64_t end = stoppedAt_.load();
+    return (end >= 0 ? end : now()) * 1e-9;
+}
+
+std::size_t Profiler::traceEventCount() const {
+    std::lock_guard<std::mutex> lock(traceMutex_);
+    return events_.size();
+}
+
+json Profiler::summary() const {
+    const double wall = wallSeconds();
+    json phases = json::object();
+    double profiled = 0.0;
+    for (int p = 0; p < NUM_PHASES; ++p) {
+        const auto phase = static_cast<ProfilePhase>(p);
+        if (calls(phase) == 0) continue;
+        const double s = seconds(phase);
+        profiled += s;
+        phases[toString(phase)] = {{"seconds", s}, {"calls", calls(phase)},
+                                   {"share", wall > 0.0 ? s / wall : 0.0}};
+    }
+    json counters = json::object();
+    for (int c = 0; c < NUM_COUNTERS; ++c) {
+        const auto id = static_cast<ProfileCounter>(c);
+        counters[toString(id)] = counter(id);
+    }
+
+    json j;
+    j["wallSeconds"] = wall;
+    j["profiledSeconds"] = profiled;
+    j["threads"] = std::bitset<64>(threadMask_.load()).count();
+    j["phases"] = std::move(phases);
+    j["counters"] = std::move(counters);
+    if (trace_) {
+        j["traceEvents"] = traceEventCount();
+        j["droppedTraceEvents"] = droppedTraceEvents();
+    }
+    return j;
+}
+
+std::string Profiler::formatText() const {
+    const double wall = wallSeconds();
+    std::vector<ProfilePhase> order;
+    for (int p = 0; p < NUM_PHASES; ++p) {
+        if (calls(static_cast<ProfilePhase>(p)) > 0) order.push_back(static_cast<ProfilePhase>(p));
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [this](ProfilePhase a, ProfilePhase b) { return seconds(a) > seconds(b); });
+
+    std::string out;
+    char line[128];
+    std::snprintf(line, sizeof(line), "%-20s %12s %10s %7s\n", "Phase", "Time (ms)", "Calls", "Share");
+    out += line;
+    for (ProfilePhase phase : order) {
+        std::snprintf(line, sizeof(line), "%-20s %12.3f %10lld %6.1f%%\n", toString(phase),
+                      seconds(phase) * 1e3, static_cast<long long>(calls(phase)),
+                      wall > 0.0 ? 100.0 * seconds(phase) / wall : 0.0);
+        out += line;
+    }
+    std::snprintf(line, sizeof(line), "%-20s %12.3f\n", "wall", wall * 1e3);
+    out += line;
+    for (int c = 0; c < NUM_COUNTERS; ++c) {
+        const auto id = static_cast<ProfileCounter>(c);
+        std::snprintf(line, sizeof(line), "%-20s %12lld\n", toString(id),
+                      static_cast<long long>(counter(id)));
+        out += line;
+    }
+    return out;
+}
+
+void Profiler::writeChromeTrace(const std::string& filepath) const {
+    std::ofstream out(filepath);
+    if (!out) throw std::runtime_error("Cannot open trace file: " + filepath);
+
+    std::lock_guard<std::mutex> lock(traceMutex_);
+    // Timestamps are microseconds; written by hand to keep large traces cheap
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+        << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"contam_engine\"}}";
+    char line[160];
+    for (const auto& e : events_) {
+        const char* name = toString(e.phase);
+        const char* dot = std::strchr(name, '.');
+        const std::string category = dot ? std::string(name, dot) : std::string(name);
+        std::snprintf(line, sizeof(line),
+                      ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                      "\"ts\":%.3f,\"dur\":%.3f}",
+                      name, category.c_str(), static_cast<int>(e.thread), e.start * 1e-3, e.duration * 1e-3);
+        out << line;
+    }
+    out << "\n]}\n";
+    if (!out) throw std::runtime_error("Failed writing trace file: " + filepath);
+}
+
+} // namespace contam
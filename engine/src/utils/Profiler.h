@@ -0,0 +1,143 @@
+#pragma once
+
+#include <nlohmann/json_fwd.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace contam {
+
+// Timed phases of a run. Phases are leaves: none is timed inside another,
+// so their times add up to the profiled work (summed over threads when
+// species are solved side by side).
+enum class ProfilePhase : int {
+    Load,               // model parse or cache load
+    Setup,              // run start: output selection, WPC tables, solver state
+    Boundary,           // weather, schedules, WPC pressures, AHS and occupant sources
+    Controls,           // sensors, controllers, actuators
+    AirflowAssemble,    // densities, link flows, Jacobian and residual
+    AirflowFactor,      // preconditioner / LU factorization
+    AirflowSolve,       // linear solve and pressure update
+    TransportAssemble,  // implicit Euler system
+    TransportSolve,     // dense solve and concentration update
+    Output,             // recording steps: history and result sinks
+    Count
+};
+
+enum class ProfileCounter : int {
+    TimeSteps,
+    AirflowSolves,
+    NewtonIterations,
+    LinearIterations,     // BiCGSTAB iterations (direct solves add none)
+    Factorizations,
+    OrderingCacheHits,    // airflow solves reusing the cached equation ordering
+    OrderingCacheMisses,
+    TransportSolves,      // species (or coupled) systems solved
+    Allocations,          // model-sized solver work buffers allocated
+    AllocatedBytes,
+    Count
+};
+
+const char* toString(ProfilePhase phase);
+const char* toString(ProfileCounter counter);
+
+// Low-overhead phase timer and counters for one run. Components take a
+// Profiler* that is null when profiling is off, so an unprofiled run pays a
+// single branch per scope. Accumulation is lock-free and safe from pool
+// threads; with tracing on, every timed scope is also kept (up to
+// MAX_TRACE_EVENTS) for a Chrome trace-event file.
+//
+//   Profiler profiler(true);
+//   sim.setProfiler(&profiler);
+//   sim.run(network);
+//   profiler.stop();
+//   results["profile"] = profiler.summary();
+//   profiler.writeChromeTrace("run.trace.json");   // chrome://tracing, Perfetto
+class Profiler {
+public:
+    static constexpr std::size_t MAX_TRACE_EVENTS = 1000000;
+
+    explicit Profiler(bool trace = false);
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    bool tracing() const { return trace_; }
+
+    // Nanoseconds since construction
+    int64_t now() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - origin_).count();
+    }
+
+    void add(ProfilePhase phase, int64_t startNs, int64_t endNs);
+    void count(ProfileCounter counter, int64_t n = 1) {
+        counters_[static_cast<int>(counter)].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    // Ends the wall-clock span (otherwise it runs until summary())
+    void stop();
+
+    double seconds(ProfilePhase phase) const;
+    int64_t calls(ProfilePhase phase) const;
+    int64_t counter(ProfileCounter counter) const;
+    double wallSeconds() const;
+    std::size_t traceEventCount() const;
+    std::size_t droppedTraceEvents() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // { wallSeconds, profiledSeconds, threads, phases: { name: { seconds,
+    //   calls, share } }, counters: { name: n }, traceEvents, droppedTraceEvents }
+    // Phases that never ran are omitted; share is of the wall time.
+    nlohmann::json summary() const;
+    // Phase table, slowest first
+    std::string formatText() const;
+
+    // Chrome trace-event JSON (complete "X" events, one track per thread).
+    // Throws std::runtime_error if the file cannot be written.
+    void writeChromeTrace(const std::string& filepath) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr int NUM_PHASES = static_cast<int>(ProfilePhase::Count);
+    static constexpr int NUM_COUNTERS = static_cast<int>(ProfileCounter::Count);
+
+    struct TraceEvent {
+        int64_t start;
+        int64_t duration;
+        int32_t thread;
+        ProfilePhase phase;
+    };
+
+    bool trace_;
+    Clock::time_point origin_;
+    std::atomic<int64_t> stoppedAt_{-1};
+    std::array<std::atomic<int64_t>, NUM_PHASES> nanos_{};
+    std::array<std::atomic<int64_t>, NUM_PHASES> calls_{};
+    std::array<std::atomic<int64_t>, NUM_COUNTERS> counters_{};
+    mutable std::mutex traceMutex_;
+    std::vector<TraceEvent> events_;
+    std::atomic<uint64_t> threadMask_{0};   // threads that recorded a scope (first 64)
+    std::atomic<std::size_t> dropped_{0};
+};
+
+// Times the enclosing block as `phase`; does nothing without a profiler
+class ProfileScope {
+public:
+    ProfileScope(Profiler* profiler, ProfilePhase phase)
+        : profiler_(profiler), phase_(phase), start_(profiler ? profiler->now() : 0) {}
+    ~ProfileScope() {
+        if (profiler_) profiler_->add(phase_, start_, profiler_->now());
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    Profiler* profiler_;
+    ProfilePhase phase_;
+    int64_t start_;
+};
+
+} // namespace contam
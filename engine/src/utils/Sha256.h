@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace contam {
+
+using Sha256Digest = std::array<uint8_t, 32>;
+
+// SHA-256 (FIPS 180-4). Used where a content key must not collide, e.g.
+// the model cache.
+//
+//   Sha256 h;
+//   h.update(data, size);
+//   Sha256Digest digest = h.finish();
+class Sha256 {
+public:
+    Sha256() { reset(); }
+
+    void reset();
+    void update(const void* data, std::size_t size);
+    // Pads, returns the digest and resets for the next message
+    Sha256Digest finish();
+
+    static Sha256Digest hash(std::string_view text);
+    // Lower-case hex, 64 characters
+    static std::string toHex(const Sha256Digest& digest);
+
+private:
+    std::array<uint32_t, 8> state_{};
+    std::array<uint8_t, 64> block_{};
+    std::size_t blockSize_ = 0;
+    uint64_t totalBytes_ = 0;
+
+    void compress(const uint8_t* block);
+};
+
+} // namespace contam
@@ -0,0 +1,286 @@
+#include "utils/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+
+namespace contam {
+
+namespace {
+
+// Pool and index of the worker running on this thread
+thread_local const ThreadPool* tlsPool = nullptr;
+thread_local int tlsWorker = -1;
+
+unsigned resolveThreads(unsigned threads) {
+    return threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+// ── Shared pool ──────────────────────────────────────────────────────
+
+std::mutex sharedMutex;
+std::unique_ptr<ThreadPool> sharedPool;
+std::atomic<ThreadPool*> sharedPtr{nullptr};
+unsigned sharedThreadCount = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned threads) {
+    start(resolveThreads(threads));
+}
+
+ThreadPool::ThreadPool(unsigned workers, NoWorkers) {
+    start(workers);
+}
+
+void ThreadPool::start(unsigned workers) {
+    // Every queue exists before a worker can look for work to steal
+    queues_.reserve(workers);
+    for (unsigned i = 0; i < workers; ++i) queues_.push_back(std::make_unique<WorkerQueue>());
+    workers_.reserve(workers);
+    for (unsigned i = 0; i < workers; ++i) {
+        workers_.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& w : workers_) w.join();
+}
+
+ThreadPool& ThreadPool::shared() {
+    if (ThreadPool* pool = sharedPtr.load(std::memory_order_acquire)) return *pool;
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    if (!sharedPool) {
+        sharedPool.reset(new ThreadPool(resolveThreads(sharedThreadCount) - 1, NoWorkers{}));
+        sharedPtr.store(sharedPool.get(), std::memory_order_release);
+    }
+    return *sharedPool;
+}
+
+void ThreadPool::setSharedThreads(unsigned threads) {
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    sharedThreadCount = threads;
+    if (sharedPool && sharedPool->concurrency() != resolveThreads(threads)) {
+        sharedPtr.store(nullptr, std::memory_order_release);
+        sharedPool.reset();
+    }
+}
+
+unsigned ThreadPool::sharedThreads() {
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    return resolveThreads(sharedThreadCount);
+}
+
+int ThreadPool::workerIndex() const {
+    return tlsPool == this ? tlsWorker : -1;
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    // Counted before it is queued so a sleeping worker never misses it
+    pending_.fetch_add(1);
+    const int self = workerIndex();
+    if (self >= 0) {
+        std::lock_guard<std::mutex> lock(queues_[self]->mutex);
+        queues_[self]->tasks.push_back(std::move(task));
+    } else {
+        std::lock_guard<std::mutex> lock(injectionMutex_);
+        injection_.push_back(std::move(task));
+    }
+    { std::lock_guard<std::mutex> lock(sleepMutex_); }
+    wake_.notify_one();
+}
+
+bool ThreadPool::runOne() {
+    std::function<void()> task;
+    const int self = workerIndex();
+
+    // Own work newest first: its data is most likely still in cache
+    if (self >= 0) {
+        std::lock_guard<std::mutex> lock(queues_[self]->mutex);
+        auto& own = queues_[self]->tasks;
+        if (!own.empty()) {
+            task = std::move(own.back());
+            own.pop_back();
+        }
+    }
+    if (!task) {
+        std::lock_guard<std::mutex> lock(injectionMutex_);
+        if (!injection_.empty()) {
+            task = std::move(injection_.front());
+            injection_.pop_front();
+        }
+    }
+    // Steal the oldest task of another worker, starting after our own deque
+    const std::size_t n = queues_.size();
+    for (std::size_t k = 0; !task && k < n; ++k) {
+        const std::size_t victim = (static_cast<std::size_t>(self + 1) + k) % n;
+        if (static_cast<int>(victim) == self) continue;
+        std::lock_guard<std::mutex> lock(queues_[victim]->mutex);
+        auto& other = queues_[victim]->tasks;
+        if (!other.empty()) {
+            task = std::move(other.front());
+            other.pop_front();
+        }
+    }
+    if (!task) return false;
+
+    pending_.fetch_sub(1);
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(unsigned index) {
+    tlsPool = this;
+    tlsWorker = static_cast<int>(index);
+    for (;;) {
+        if (runOne()) continue;
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this] { return stop_ || pending_.load() > 0; });
+        if (stop_ && pending_.load() == 0) return;  // stopping and drained
+    }
+}
+
+namespace {
+
+// State shared by the caller and the helper tasks of one parallelFor(). Helpers
+// can start after the caller has returned, so it lives on the heap.
+struct ParallelForState {
+    std::size_t count = 0;
+    const std::function<void(std::size_t)>* fn = nullptr;
+    std::atomic<std::size_t> next{0};
+    std::mutex mutex;
+    std::condition_variable done;
+    unsigned active = 0;
+    std::exception_ptr error;
+
+    void work() {
+        for (;;) {
+            const std::size_t i = next.fetch_add(1);
+            if (i >= count) return;
+            try {
+                (*fn)(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) error = std::current_exception();
+                next.store(count);
+            }
+        }
+    }
+};
+
+} // namespace
+
+void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t)>& fn,
+                             unsigned maxParallel) {
+    if (count == 0) return;
+    unsigned helpers = size();
+    if (maxParallel > 0) helpers = std::min(helpers, maxParallel - 1);
+    helpers = static_cast<unsigned>(std::min<std::size_t>(helpers, count - 1));
+
+    if (helpers == 0) {
+        for (std::size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    auto state = std::make_shared<ParallelForState>();
+    state->count = count;
+    state->fn = &fn;
+
+    for (unsigned h = 0; h < helpers; ++h) {
+        submit([state] {
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                ++state->active;
+            }
+            // Once the caller has seen every index claimed, this only reads
+            // the counter and never touches fn
+            state->work();
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                --state->active;
+            }
+            state->done.notify_all();
+        });
+    }
+
+    state->work();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&] { return state->active == 0; });
+    if (state->error) std::rethrow_exception(state->error);
+}
+
+void ThreadPool::parallelForRange(std::size_t count, std::size_t grain,
+                                  const std::function<void(std::size_t, std::size_t)>& fn,
+                                  unsigned maxParallel) {
+    if (count == 0) return;
+    grain = std::max<std::size_t>(grain, 1);
+    const std::size_t chunks = (count + grain - 1) / grain;
+    if (chunks == 1 || size() == 0 || maxParallel == 1) {
+        fn(0, count);
+        return;
+    }
+    parallelFor(chunks, [&](std::size_t c) {
+        fn(c * grain, std::min(count, (c + 1) * grain));
+    }, maxParallel);
+}
+
+// ── TaskGroup ────────────────────────────────────────────────────────
+
+void TaskGroup::State::fail(std::exception_ptr e) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!error) error = e;
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool) : pool_(pool), state_(std::make_shared<State>()) {}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    if (pool_.size() == 0) {
+        try {
+            task();
+        } catch (...) {
+            state_->fail(std::current_exception());
+        }
+        return;
+    }
+
+    state_->outstanding.fetch_add(1);
+    pool_.submit([state = state_, task = std::move(task)] {
+        try {
+            task();
+        } catch (...) {
+            state->fail(std::current_exception());
+        }
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->outstanding.fetch_sub(1) == 1) state->done.notify_all();
+    });
+}
+
+void TaskGroup::wait() {
+    while (state_->outstanding.load() > 0) {
+        // Help with queued work (ours or anyone's) instead of blocking a thread
+        if (pool_.runOne()) continue;
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        state_->done.wait_for(lock, std::chrono::microseconds(200),
+                              [this] { return state_->outstanding.load() == 0; });
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        std::swap(error, state_->error);
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+} // namespace contam
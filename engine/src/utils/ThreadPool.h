@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace contam {
+
+// Work-stealing worker pool shared by the engine's parallel loops (link
+// evaluation, per-species transport, batch solves, sweeps and batch runs).
+//
+// Every worker owns a deque: tasks submitted from a worker go to the back of
+// its own deque and are run newest first, idle workers steal the oldest task
+// from the front of another worker's deque. Tasks submitted from outside the
+// pool go through a shared injection queue.
+//
+// parallelFor() hands out indices from a shared counter; the calling thread
+// works through them as well and only waits for helpers that actually
+// started, so nested parallelFor() calls from inside a worker never
+// deadlock. A pool without workers runs everything on the calling thread.
+class ThreadPool {
+public:
+    // threads = worker threads; 0 uses std::thread::hardware_concurrency()
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+    // Threads that can work on one parallelFor(): the workers and the caller
+    unsigned concurrency() const { return size() + 1; }
+
+    // Run fn(i) for every i in [0, count) and wait for all of them. At most
+    // `maxParallel` calls run at once (0 = pool size + caller). The first
+    // exception thrown by fn stops the remaining indices and is rethrown.
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& fn,
+                     unsigned maxParallel = 0);
+
+    // Run fn(begin, end) over [0, count) in chunks of `grain` indices. Loops
+    // of a single chunk run inline without touching the pool.
+    void parallelForRange(std::size_t count, std::size_t grain,
+                          const std::function<void(std::size_t, std::size_t)>& fn,
+                          unsigned maxParallel = 0);
+
+    // Process-wide pool. Its size comes from setSharedThreads(), by default
+    // one thread per hardware thread (counting the caller).
+    static ThreadPool& shared();
+
+    // Total threads of the shared pool including the calling thread;
+    // 0 = hardware threads, 1 = run everything serially. Call it while no
+    // parallel work is running (e.g. at start-up): a pool of another size is
+    // replaced.
+    static void setSharedThreads(unsigned threads);
+    static unsigned sharedThreads();
+
+private:
+    friend class TaskGroup;
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    struct NoWorkers {};
+    ThreadPool(unsigned workers, NoWorkers);
+    void start(unsigned workers);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;   // one per worker
+    std::deque<std::function<void()>> injection_;        // tasks from outside the pool
+    std::mutex injectionMutex_;
+    std::vector<std::thread> workers_;
+
+    std::atomic<std::size_t> pending_{0};   // queued tasks not yet taken
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+
+    void submit(std::function<void()> task);
+    // Take and run one queued task: own deque, injection queue, then steal
+    bool runOne();
+    void workerLoop(unsigned index);
+    // Index of the calling thread among this pool's workers, -1 for others
+    int workerIndex() const;
+};
+
+// Tasks spawned on a pool and waited for together:
+//
+//   TaskGroup group;
+//   group.run([&] { solveZone(a); });
+//   group.run([&] { solveZone(b); });
+//   group.wait();
+//
+// wait() runs queued tasks while it waits, so groups can nest inside pool
+// tasks. The first exception thrown by a task is rethrown from wait(). On a
+// pool without workers run() executes the task immediately.
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool = ThreadPool::shared());
+    ~TaskGroup();   // waits; exceptions not collected by wait() are dropped
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(std::function<void()> task);
+    void wait();
+
+private:
+    struct State {
+        std::atomic<std::size_t> outstanding{0};
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+
+        void fail(std::exception_ptr e);
+    };
+
+    ThreadPool& pool_;
+    std::shared_ptr<State> state_;
+};
+
+} // namespace contam
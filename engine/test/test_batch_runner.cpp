@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "test_thread_pool.h"
+#include "io/BatchRunner.h"
+#include "io/JsonReader.h"
+#include "io/JsonStreamWriter.h"
+#include "core/BatchSolve.h"
+#include <nlohmann/json.hpp>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace contam;
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+static const char* STEADY_MODEL = R"({
+    "nodes": [
+        { "id": 0, "name": "Outdoor", "type": "ambient", "temperature": 273.15 },
+        { "id": 1, "name": "Room", "temperature": 293.15, "volume": 50.0 }
+    ],
+    "links": [
+        { "id": 1, "from": 0, "to": 1, "elevation": 0.5,
+          "element": { "type": "PowerLawOrifice", "C": 0.002, "n": 0.65 } },
+        { "id": 2, "from": 1, "to": 0, "elevation": 2.5,
+          "element": { "type": "PowerLawOrifice", "C": 0.002, "n": 0.65 } }
+    ]
+})";
+
+// Fresh directory under the gtest temp dir
+static fs::path batchDir(const std::string& name) {
+    fs::path dir = fs::path(testing::TempDir()) / name;
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+static void writeText(const fs::path& path, const std::string& content) {
+    std::ofstream f(path);
+    f << content;
+}
+
+TEST(BatchRunner, CollectJobs) {
+    fs::path dir = batchDir("batch_collect");
+    writeText(dir / "a.json", STEADY_MODEL);
+    writeText(dir / "b.json", STEADY_MODEL);
+    writeText(dir / "a.results.json", "{}");
+    writeText(dir / "notes.txt", "");
+
+    auto all = collectBatchJobs(dir.string());
+    ASSERT_EQ(all.size(), 2u);
+    EXPECT_EQ(fs::path(all[0].output).filename(), "a.results.json");
+
+    auto globbed = collectBatchJobs((dir / "b*.json").string(), (dir / "out").string());
+    ASSERT_EQ(globbed.size(), 1u);
+    EXPECT_EQ(fs::path(globbed[0].output), dir / "out" / "b.results.json");
+
+    writeText(dir / "jobs.txt", "# comment\n\na.json\nb.json custom/b-out.json\n");
+    auto listed = collectBatchJobs((dir / "jobs.txt").string());
+    ASSERT_EQ(listed.size(), 2u);
+    EXPECT_EQ(fs::path(listed[0].input), dir / "a.json");
+    EXPECT_EQ(fs::path(listed[1].output), dir / "custom" / "b-out.json");
+
+    writeText(dir / "dup.txt", "a.json out.json\nb.json out.json\n");
+    EXPECT_THROW(collectBatchJobs((dir / "dup.txt").string()), std::runtime_error);
+    writeText(dir / "bad.txt", "a.json x.json extra\n");
+    EXPECT_THROW(collectBatchJobs((dir / "bad.txt").string()), std::runtime_error);
+}
+
+TEST(BatchRunner, RunsJobsAndReportsFailures) {
+    fs::path dir = batchDir("batch_run");
+    for (int i = 0; i < 6; ++i) writeText(dir / ("steady" + std::to_string(i) + ".json"), STEADY_MODEL);
+    json transient = json::parse(STEADY_MODEL);
+    transient["species"] = {{{"id", 0}, {"name", "CO2"}, {"molarMass", 0.044}}};
+    transient["transient"] = {{"endTime", 600}, {"timeStep", 60}, {"outputInterval", 300}};
+    writeText(dir / "transient.json", transient.dump());
+    writeText(dir / "broken.json", "{ not json");
+
+    auto jobs = collectBatchJobs(dir.string(), (dir / "results").string());
+    ASSERT_EQ(jobs.size(), 8u);
+
+    test::SharedThreadsScope threads(4);
+    BatchOptions options;
+    options.threads = 3;
+    options.memoryBudget = 2 * estimateJobBytes(jobs[0].input);   // two jobs at a time
+    options.useCache = false;
+    std::size_t callbacks = 0;
+    options.onJobDone = [&](const BatchJobResult&, std::size_t done, std::size_t total) {
+        ++callbacks;
+        EXPECT_LE(done, total);
+    };
+    BatchReport report = runBatch(jobs, options);
+
+    EXPECT_EQ(callbacks, 8u);
+    EXPECT_EQ(report.threads, 3u);
+    EXPECT_EQ(report.count(BatchJobStatus::Ok), 7u);
+    EXPECT_EQ(report.count(BatchJobStatus::Failed), 1u);
+    for (const auto& r : report.jobs) {
+        const bool broken = fs::path(r.job.input).filename() == "broken.json";
+        EXPECT_EQ(r.status == BatchJobStatus::Failed, broken) << r.job.input;
+        if (broken) {
+            EXPECT_FALSE(r.message.empty());
+            continue;
+        }
+        ASSERT_TRUE(fs::exists(r.job.output)) << r.job.output;
+        json out = json::parse(std::ifstream(r.job.output));
+        if (r.transient) {
+            EXPECT_EQ(r.outputSteps, 3u);
+            EXPECT_EQ(out["timeSeries"].size(), 3u);
+        } else {
+            EXPECT_GT(r.iterations, 0);
+            EXPECT_TRUE(out["solver"]["converged"].get<bool>());
+        }
+    }
+
+    json summary = json::parse(batchSummaryJson(report));
+    EXPECT_EQ(summary["ok"], 7);
+    EXPECT_EQ(summary["failed"], 1);
+    EXPECT_EQ(summary["jobs"].size(), 8u);
+}
+
+TEST(BatchRunner, AdmitsRunsByModelEstimate) {
+    fs::path dir = batchDir("batch_admit");
+    writeText(dir / "steady.json", STEADY_MODEL);
+    json transient = json::parse(STEADY_MODEL);
+    transient["species"] = {{{"id", 0}, {"name", "CO2"}, {"molarMass", 0.044}}};
+    transient["transient"] = {{"endTime", 600}, {"timeStep", 60}, {"outputInterval", 60}};
+    writeText(dir / "transient.json", transient.dump());
+
+    auto jobs = collectBatchJobs(dir.string());
+    ASSERT_EQ(jobs.size(), 2u);
+    BatchOptions options;
+    options.threads = 2;
+    options.memoryBudget = 1;   // every run alone
+    options.useCache = false;
+    BatchReport report = runBatch(jobs, options);
+    ASSERT_EQ(report.count(BatchJobStatus::Ok), 2u);
+
+    // Once parsed, a job holds the model's own prediction, not the file-size guess
+    for (const auto& r : report.jobs) {
+        ModelInput model = JsonReader::readModelFromFile(r.job.input);
+        std::uint64_t expected = 0;
+        if (r.transient) {
+            TransientSimulation sim;
+            configureSimulation(sim, model);
+            std::ostringstream out;
+            sim.addResultSink(std::make_shared<JsonStreamWriter>(out));
+            sim.setStoreHistory(false);
+            expected = sim.estimateMemory(model.network).total();
+        } else {
+            expected = Solver::estimateMemory(model.network).total();
+        }
+        EXPECT_EQ(r.reservedBytes, expected) << r.job.input;
+        EXPECT_NE(r.reservedBytes, estimateJobBytes(r.job.input));
+    }
+}
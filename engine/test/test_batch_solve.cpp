@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+#include "test_thread_pool.h"
+#include "core/BatchSolve.h"
+#include "io/JsonReader.h"
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+using namespace contam;
+
+static const std::string BATCH_MODEL_JSON = R"({
+    "flowElements": { "crack": { "type": "PowerLawOrifice", "C": 0.001, "n": 0.65 } },
+    "nodes": [
+        { "id": 0, "name": "Outdoor", "type": "ambient", "temperature": 283.15 },
+        { "id": 1, "name": "Room A", "temperature": 293.15, "volume": 50.0 },
+        { "id": 2, "name": "Room B", "temperature": 295.15, "volume": 30.0 }
+    ],
+    "links": [
+        { "id": 10, "from": 0, "to": 1, "elevation": 0.5, "element": "crack" },
+        { "id": 11, "from": 1, "to": 2, "elevation": 1.5, "element": "crack" },
+        { "id": 12, "from": 2, "to": 0, "elevation": 2.5, "element": "crack" }
+    ],
+    "species": [ { "id": 0, "name": "CO2", "molarMass": 0.044 } ],
+    "sources": [ { "zoneId": 1, "speciesId": 0, "generationRate": 1e-5 } ],
+    "transient": { "endTime": 600, "timeStep": 60, "outputInterval": 60 }
+})";
+
+// ── ThreadPool ───────────────────────────────────────────────────────
+
+TEST(ThreadPool, ParallelForVisitsEveryIndexOnce) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> hits(1000);
+    pool.parallelFor(hits.size(), [&](std::size_t i) { hits[i]++; });
+    for (const auto& h : hits) EXPECT_EQ(h.load(), 1);
+}
+
+TEST(ThreadPool, NestedCallsAndExceptions) {
+    ThreadPool pool(2);
+    std::atomic<int> total{0};
+    pool.parallelFor(8, [&](std::size_t) {
+        pool.parallelFor(8, [&](std::size_t) { total++; });
+    });
+    EXPECT_EQ(total.load(), 64);
+
+    EXPECT_THROW(pool.parallelFor(100, [](std::size_t i) {
+        if (i == 3) throw std::runtime_error("boom");
+    }), std::runtime_error);
+}
+
+TEST(ThreadPool, TaskGroupsNestAndRethrow) {
+    ThreadPool pool(3);
+    std::atomic<int> leaves{0};
+    TaskGroup outer(pool);
+    for (int i = 0; i < 6; ++i) {
+        outer.run([&] {
+            TaskGroup inner(pool);
+            for (int j = 0; j < 6; ++j) inner.run([&] { leaves++; });
+            inner.wait();
+        });
+    }
+    outer.wait();
+    EXPECT_EQ(leaves.load(), 36);
+
+    TaskGroup failing(pool);
+    failing.run([] { throw std::runtime_error("boom"); });
+    failing.run([&] { leaves++; });
+    EXPECT_THROW(failing.wait(), std::runtime_error);
+    EXPECT_EQ(leaves.load(), 37);
+}
+
+TEST(ThreadPool, SharedPoolRunsSeriallyWithOneThread) {
+    test::SharedThreadsScope threads(1);
+    EXPECT_EQ(ThreadPool::shared().size(), 0u);
+    EXPECT_EQ(ThreadPool::sharedThreads(), 1u);
+    const auto caller = std::this_thread::get_id();
+    bool sameThread = true;
+    ThreadPool::shared().parallelFor(50, [&](std::size_t) {
+        sameThread = sameThread && std::this_thread::get_id() == caller;
+    });
+    EXPECT_TRUE(sameThread);
+
+    ThreadPool::setSharedThreads(3);
+    EXPECT_EQ(ThreadPool::shared().concurrency(), 3u);
+}
+
+TEST(ThreadPool, ParallelLinkEvaluationMatchesSerial) {
+    // Enough links to cross the parallel threshold
+    nlohmann::json j;
+    j["flowElements"]["crack"] = {{"type", "PowerLawOrifice"}, {"C", 0.001}, {"n", 0.65}};
+    j["nodes"] = {{{"id", 0}, {"name", "Outdoor"}, {"type", "ambient"}, {"temperature", 283.15}}};
+    j["links"] = nlohmann::json::array();
+    const int zones = 1500;
+    int linkId = 1;
+    for (int z = 1; z <= zones; ++z) {
+        j["nodes"].push_back({{"id", z}, {"name", "Z" + std::to_string(z)},
+                              {"temperature", 290.15 + (z % 7)}, {"volume", 40.0}});
+        j["links"].push_back({{"id", linkId++}, {"from", 0}, {"to", z}, {"elevation", 0.5}, {"element", "crack"}});
+        j["links"].push_back({{"id", linkId++}, {"from", z}, {"to", 0}, {"elevation", 2.5}, {"element", "crack"}});
+        if (z < zones) {
+            j["links"].push_back({{"id", linkId++}, {"from", z}, {"to", z + 1}, {"elevation", 1.5}, {"element", "crack"}});
+        }
+    }
+    auto model = JsonReader::readModelFromString(j.dump());
+    ASSERT_GE(model.network.getLinkCount(), 4096);
+
+    test::SharedThreadsScope threads(4);
+    Network serialNet = model.network, parallelNet = model.network;
+    Solver serial, parallel;
+    serial.setMaxParallel(1);
+    auto a = serial.solve(serialNet);
+    auto b = parallel.solve(parallelNet);
+
+    ASSERT_TRUE(a.converged);
+    EXPECT_EQ(a.iterations, b.iterations);
+    EXPECT_EQ(a.pressures, b.pressures);
+    EXPECT_EQ(a.massFlows, b.massFlows);
+}
+
+// ── Batch solves and runs ────────────────────────────────────────────
+
+TEST(BatchSolve, MatchesIndividualSolves) {
+    auto model = JsonReader::readModelFromString(BATCH_MODEL_JSON);
+    auto params = parseBatchParameters({"ambient_temperature", "orifice_c:12"}, model.network);
+    const std::vector<double> values = {
+        283.15, 0.001,
+        263.15, 0.002,
+        303.15, 0.0005,
+    };
+
+    ThreadPool pool(3);
+    auto batch = solveMany(model.network, params, values.data(), 3, pool);
+    ASSERT_EQ(batch.numSets, 3u);
+    ASSERT_EQ(batch.pressures.size(), 9u);
+
+    for (std::size_t s = 0; s < 3; ++s) {
+        Network net = model.network;
+        params[0].apply(net, values[s * 2]);
+        params[1].apply(net, values[s * 2 + 1]);
+        Solver solver;
+        auto r = solver.solve(net);
+        EXPECT_EQ(batch.converged[s], r.converged ? 1 : 0);
+        for (std::size_t i = 0; i < 3; ++i) {
+            EXPECT_EQ(batch.pressures[s * 3 + i], r.pressures[i]);
+            EXPECT_EQ(batch.massFlows[s * 3 + i], r.massFlows[i]);
+        }
+    }
+    // The cold case drives more stack flow than the warm one
+    EXPECT_GT(std::abs(batch.massFlows[3]), std::abs(batch.massFlows[6]));
+    // The base network is untouched
+    EXPECT_DOUBLE_EQ(model.network.getNode(0).getTemperature(), 283.15);
+}
+
+TEST(BatchSolve, RunManyStacksResults) {
+    auto model = JsonReader::readModelFromString(BATCH_MODEL_JSON);
+    auto params = parseBatchParameters({"node_temperature:1"}, model.network);
+    const std::vector<double> values = {293.15, 298.15};
+
+    std::size_t reports = 0;
+    auto batch = runMany(model, params, values.data(), 2, ThreadPool::shared(), 0,
+                         [&](std::size_t done, std::size_t total) {
+                             EXPECT_EQ(total, 2u);
+                             reports = done;
+                             return true;
+                         });
+    EXPECT_EQ(reports, 2u);
+    ASSERT_EQ(batch.numSteps, 11u);
+    ASSERT_EQ(batch.concentrations.size(), 2u * 11u * 3u * 1u);
+    EXPECT_EQ(batch.completed[0], 1);
+    EXPECT_EQ(batch.completed[1], 1);
+    EXPECT_DOUBLE_EQ(batch.times.back(), 600.0);
+
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+    auto single = sim.run(model.network);
+    EXPECT_EQ(batch.concentrations[(10 * 3 + 1) * 1], single.history[10].contaminant.concentrations[1][0]);
+    EXPECT_NE(batch.concentrations[(11 + 10) * 3 + 1], batch.concentrations[10 * 3 + 1]);
+}
+
+TEST(BatchSolve, ProgressCancelsRemainingSets) {
+    auto model = JsonReader::readModelFromString(BATCH_MODEL_JSON);
+    auto params = parseBatchParameters({"wind_speed"}, model.network);
+    const std::vector<double> values(6, 0.0);
+    ThreadPool pool(1);
+    auto batch = solveMany(model.network, params, values.data(), 6, pool,
+                           SolverMethod::TrustRegion, 1,
+                           [](std::size_t done, std::size_t) { return done < 2; });
+    EXPECT_EQ(batch.converged[1], 1);
+    EXPECT_EQ(batch.converged[5], 0);
+    EXPECT_TRUE(std::isnan(batch.pressures[5 * 3 + 1]));
+}
+
+TEST(BatchSolve, RejectsUnknownParameters) {
+    auto model = JsonReader::readModelFromString(BATCH_MODEL_JSON);
+    EXPECT_THROW(BatchParameter::parse("humidity", model.network), std::runtime_error);
+    EXPECT_THROW(BatchParameter::parse("node_temperature:9", model.network), std::runtime_error);
+    EXPECT_THROW(BatchParameter::parse("orifice_c:x", model.network), std::runtime_error);
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "contam_capi.h"
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const char* CAPI_MODEL = R"({
+    "nodes": [
+        { "id": 0, "name": "Outdoor", "type": "ambient", "temperature": 273.15 },
+        { "id": 5, "name": "Room", "temperature": 293.15, "volume": 50.0 }
+    ],
+    "links": [
+        { "id": 1, "from": 0, "to": 5, "elevation": 0.5,
+          "element": { "type": "PowerLawOrifice", "C": 0.002, "n": 0.65 } },
+        { "id": 2, "from": 5, "to": 0, "elevation": 2.5,
+          "element": { "type": "PowerLawOrifice", "C": 0.002, "n": 0.65 } }
+    ],
+    "species": [ { "id": 0, "name": "CO2", "molarMass": 0.044 } ],
+    "sources": [ { "zoneId": 5, "speciesId": 0, "generationRate": 1e-5 } ],
+    "transient": { "endTime": 600, "timeStep": 60, "outputInterval": 120 }
+})";
+
+static contam_model* loadModel() {
+    contam_model* model = nullptr;
+    EXPECT_EQ(contam_model_load_json(CAPI_MODEL, std::strlen(CAPI_MODEL), &model), CONTAM_OK);
+    return model;
+}
+
+TEST(CApi, LoadSolveAndBuffers) {
+    EXPECT_EQ(contam_api_version() >> 16, 1u);
+    contam_model* model = loadModel();
+    ASSERT_NE(model, nullptr);
+    EXPECT_EQ(contam_model_node_count(model), 2u);
+
+    size_t count = 0;
+    int32_t ids[2];
+    ASSERT_EQ(contam_model_node_ids(model, ids, 2, &count), CONTAM_OK);
+    EXPECT_EQ(ids[1], 5);
+
+    contam_solve_info info{};
+    ASSERT_EQ(contam_solve(model, CONTAM_METHOD_TRUST_REGION, &info), CONTAM_OK);
+    EXPECT_EQ(info.converged, 1);
+
+    // Sizing call, then the copy
+    EXPECT_EQ(contam_model_mass_flows(model, nullptr, 0, &count), CONTAM_ERROR_BUFFER_TOO_SMALL);
+    ASSERT_EQ(count, 2u);
+    std::vector<double> flows(count);
+    ASSERT_EQ(contam_model_mass_flows(model, flows.data(), flows.size(), &count), CONTAM_OK);
+    EXPECT_NEAR(flows[0], flows[1], 1e-6);   // in low, out high
+    EXPECT_GT(flows[0], 0.0);
+
+    // Warmer outdoors: less stack flow; the solve starts from the last answer
+    ASSERT_EQ(contam_model_set_ambient_temperature(model, 288.15), CONTAM_OK);
+    ASSERT_EQ(contam_solve(model, CONTAM_METHOD_TRUST_REGION, &info), CONTAM_OK);
+    double warmer[2];
+    ASSERT_EQ(contam_model_mass_flows(model, warmer, 2, &count), CONTAM_OK);
+    EXPECT_LT(warmer[0], flows[0]);
+
+    // Cache image round trip
+    ASSERT_EQ(contam_model_save_cache(model, nullptr, 0, &count), CONTAM_ERROR_BUFFER_TOO_SMALL);
+    std::vector<char> image(count);
+    ASSERT_EQ(contam_model_save_cache(model, image.data(), image.size(), &count), CONTAM_OK);
+    contam_model* cached = nullptr;
+    ASSERT_EQ(contam_model_load_cache(image.data(), image.size(), &cached), CONTAM_OK);
+    EXPECT_EQ(contam_model_link_count(cached), 2u);
+    contam_model_free(cached);
+
+    EXPECT_EQ(contam_model_set_node_temperature(model, 42, 300.0), CONTAM_ERROR_INVALID_ARGUMENT);
+    EXPECT_NE(std::string(contam_last_error()).find("42"), std::string::npos);
+    EXPECT_EQ(contam_model_load_json("{", 1, &cached), CONTAM_ERROR_PARSE);
+    EXPECT_EQ(contam_model_load_file("/nonexistent/model.json", &cached), CONTAM_ERROR_IO);
+    EXPECT_EQ(contam_model_load_cache("junk", 4, &cached), CONTAM_ERROR_PARSE);
+    contam_model_free(model);
+}
+
+TEST(CApi, TransientStepAndRun) {
+    contam_model* model = loadModel();
+    contam_transient* run = nullptr;
+    ASSERT_EQ(contam_transient_start(model, 1, &run), CONTAM_OK);
+    contam_model_free(model);   // the run holds its own copy
+
+    int32_t hasStep = 0;
+    ASSERT_EQ(contam_transient_advance(run, &hasStep), CONTAM_OK) << contam_last_error();
+    EXPECT_EQ(hasStep, 1);
+    EXPECT_DOUBLE_EQ(contam_transient_time(run), 120.0);
+    double conc[2];
+    size_t count = 0;
+    ASSERT_EQ(contam_transient_concentrations(run, conc, 2, &count), CONTAM_OK);
+    EXPECT_GT(conc[1], 0.0);
+
+    int32_t completed = 0;
+    ASSERT_EQ(contam_transient_run(run, &completed), CONTAM_OK);
+    EXPECT_EQ(completed, 1);
+    ASSERT_EQ(contam_transient_step_count(run), 6u);
+    std::vector<double> series(6 * 2);
+    ASSERT_EQ(contam_transient_series_concentrations(run, series.data(), series.size(), &count), CONTAM_OK);
+    EXPECT_GT(series[5 * 2 + 1], series[1 * 2 + 1]);
+    ASSERT_EQ(contam_transient_advance(run, &hasStep), CONTAM_OK);
+    EXPECT_EQ(hasStep, 0);
+    contam_transient_free(run);
+}
+
+TEST(CApi, HandlesOnSeparateThreads) {
+    std::vector<std::thread> threads;
+    std::vector<int> converged(4, 0);
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t, &converged] {
+            contam_model* model = nullptr;
+            if (contam_model_load_json(CAPI_MODEL, std::strlen(CAPI_MODEL), &model) != CONTAM_OK) return;
+            contam_model_set_ambient_temperature(model, 263.15 + 5.0 * t);
+            contam_solve_info info{};
+            contam_solve(model, CONTAM_METHOD_TRUST_REGION, &info);
+            converged[t] = info.converged;
+            contam_model_free(model);
+        });
+    }
+    for (auto& th : threads) th.join();
+    for (int c : converged) EXPECT_EQ(c, 1);
+}
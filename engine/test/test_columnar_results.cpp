@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include "test_models.h"
+#include "core/BatchSolve.h"
+#include "io/ColumnarResults.h"
+#include "io/JsonReader.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+
+using namespace contam;
+using json = nlohmann::json;
+
+static std::string tempPath(const std::string& name) {
+    return testing::TempDir() + name;
+}
+
+TEST(ColumnarResults, SinkMatchesHistory) {
+    json doc = test::threeRoomModel();
+    auto model = JsonReader::readModelFromJson(doc);
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+    const std::string path = tempPath("columnar_sink.crs");
+    sim.addResultSink(std::make_shared<ColumnarResultsWriter>(path));
+    auto result = sim.run(model.network);
+    ASSERT_TRUE(result.completed);
+
+    ColumnarResultsReader reader(path);
+    EXPECT_TRUE(reader.completed());
+    ASSERT_EQ(reader.numSteps(), result.history.size());
+    EXPECT_EQ(reader.numSeries(), 3u + 3u + 3u * 2u);
+    ASSERT_EQ(reader.nodes().size(), 3u);
+    EXPECT_EQ(reader.nodes()[1].name, "Room A");
+    EXPECT_TRUE(reader.nodes()[0].ambient);
+    EXPECT_EQ(reader.links()[2].fromId, 2);
+    EXPECT_EQ(reader.links()[2].toId, 0);
+    EXPECT_EQ(reader.species()[1].name, "HCHO");
+    EXPECT_EQ(reader.nodeIndex(2), 2);
+    EXPECT_EQ(reader.linkIndex(11), 1);
+    EXPECT_EQ(reader.speciesIndex(5), 1);
+    EXPECT_EQ(reader.speciesIndex(7), -1);
+
+    for (size_t k = 0; k < result.history.size(); ++k) {
+        const auto& step = result.history[k];
+        EXPECT_DOUBLE_EQ(reader.times()[k], step.time);
+        EXPECT_EQ(reader.iterations()[k], step.airflow.iterations);
+        EXPECT_EQ(reader.converged()[k] != 0, step.airflow.converged);
+        for (size_t i = 0; i < 3; ++i) {
+            EXPECT_FLOAT_EQ(reader.pressure(i)[k], static_cast<float>(step.airflow.pressures[i]));
+            EXPECT_FLOAT_EQ(reader.massFlow(i)[k], static_cast<float>(step.airflow.massFlows[i]));
+            for (size_t s = 0; s < 2; ++s) {
+                EXPECT_FLOAT_EQ(reader.concentration(i, s)[k],
+                                static_cast<float>(step.contaminant.concentrations[i][s]));
+            }
+        }
+    }
+
+    // One zone's history is a single contiguous slice
+    auto co2 = reader.concentration(1, 0);
+    EXPECT_EQ(co2.size, reader.numSteps());
+    EXPECT_GT(co2[co2.size - 1], co2[0]);
+    EXPECT_EQ(reader.seriesEntry(3 + 3 + 1 * 2 + 0).variable,
+              static_cast<uint16_t>(ColumnarVariable::Concentration));
+    EXPECT_THROW(reader.concentration(3, 0), std::out_of_range);
+    EXPECT_THROW(reader.massFlow(3), std::out_of_range);
+
+    std::ifstream spill(path + ".spill");
+    EXPECT_FALSE(spill.good());
+    std::remove(path.c_str());
+}
+
+// More series than one transpose tile and more steps than one row block
+TEST(ColumnarResults, TransposesAcrossTiles) {
+    Network network;
+    const std::size_t nodes = 100, steps = 20000;
+    for (std::size_t i = 0; i < nodes; ++i) {
+        network.addNode(Node(static_cast<int>(i), "n" + std::to_string(i)));
+    }
+    // Exact in float32: (step % 4096) * 128 + node
+    auto value = [](std::size_t k, std::size_t i) { return static_cast<double>((k % 4096) * 128 + i); };
+
+    const std::string path = tempPath("columnar_tiles.crs");
+    {
+        ColumnarResultsWriter writer(path);
+        writer.begin(network, {}, OutputSelection{});
+        TimeStepResult step{};
+        step.airflow.pressures.resize(nodes);
+        for (std::size_t k = 0; k < steps; ++k) {
+            step.time = static_cast<double>(k);
+            for (std::size_t i = 0; i < nodes; ++i) step.airflow.pressures[i] = value(k, i);
+            writer.onStep(step);
+        }
+        writer.end(true);
+    }
+
+    ColumnarResultsReader reader(path);
+    ASSERT_EQ(reader.numSteps(), steps);
+    ASSERT_EQ(reader.numSeries(), nodes);
+    std::size_t mismatches = 0;
+    for (std::size_t i = 0; i < nodes; ++i) {
+        auto series = reader.pressure(i);
+        for (std::size_t k = 0; k < steps; ++k) {
+            mismatches += series[k] == static_cast<float>(value(k, i)) ? 0 : 1;
+        }
+    }
+    EXPECT_EQ(mismatches, 0u);
+    std::remove(path.c_str());
+}
+
+TEST(ColumnarResults, EmptyAndIncompleteRun) {
+    json doc = test::threeRoomModel();
+    auto model = JsonReader::readModelFromJson(doc);
+    TransientResult result;
+    result.completed = false;
+    const std::string path = tempPath("columnar_empty.crs");
+    ColumnarResultsWriter::write(path, model.network, model.species, result);
+
+    ColumnarResultsReader reader(path);
+    EXPECT_FALSE(reader.completed());
+    EXPECT_EQ(reader.numSteps(), 0u);
+    EXPECT_TRUE(reader.pressure(1).empty());
+    std::remove(path.c_str());
+}
+
+TEST(ColumnarResults, RejectsForeignFile) {
+    const std::string path = tempPath("columnar_foreign.crs");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << std::string(128, 'x');
+    }
+    EXPECT_THROW(ColumnarResultsReader reader(path), std::runtime_error);
+    std::remove(path.c_str());
+}
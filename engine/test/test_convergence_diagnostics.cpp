@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include "core/BatchSolve.h"
+#include "core/ConvergenceDiagnostics.h"
+#include "core/Solver.h"
+#include "core/TransientSimulation.h"
+#include "io/JsonReader.h"
+#include "io/JsonStreamWriter.h"
+#include "io/JsonWriter.h"
+#include "io/ModelGenerator.h"
+#include <nlohmann/json.hpp>
+#include <cmath>
+#include <sstream>
+
+using namespace contam;
+using json = nlohmann::json;
+
+// A fan pressurizes room A; rooms B and C leak alike to outdoors, so the
+// wall between them carries no pressure difference (linear regime)
+static const std::string QUIET_MODEL_JSON = R"({
+    "ambient": { "temperature": 293.15 },
+    "nodes": [
+        { "id": 0, "name": "Outdoor", "type": "ambient", "temperature": 293.15 },
+        { "id": 1, "name": "Room A", "temperature": 293.15, "volume": 30.0 },
+        { "id": 2, "name": "Room B", "temperature": 293.15, "volume": 30.0 },
+        { "id": 3, "name": "Room C", "temperature": 293.15, "volume": 30.0 }
+    ],
+    "links": [
+        { "id": 1, "from": 0, "to": 1, "elevation": 1.0,
+          "element": { "type": "Fan", "maxFlow": 0.02, "shutoffPressure": 200.0 } },
+        { "id": 2, "from": 1, "to": 0, "elevation": 1.0,
+          "element": { "type": "PowerLawOrifice", "C": 0.01, "n": 0.65 } },
+        { "id": 3, "from": 2, "to": 0, "elevation": 1.0,
+          "element": { "type": "PowerLawOrifice", "C": 0.004, "n": 0.65 } },
+        { "id": 4, "from": 3, "to": 0, "elevation": 1.0,
+          "element": { "type": "PowerLawOrifice", "C": 0.004, "n": 0.65 } },
+        { "id": 5, "from": 2, "to": 3, "elevation": 1.0,
+          "element": { "type": "PowerLawOrifice", "C": 0.001, "n": 0.65 } }
+    ]
+})";
+
+TEST(ConvergenceDiagnostics, ConvergedSolve) {
+    Network network = JsonReader::readFromString(QUIET_MODEL_JSON);
+    ConvergenceDiagnostics diagnostics;
+    Solver solver(SolverMethod::SubRelaxation);
+    solver.setDiagnostics(&diagnostics);
+    SolverResult r = solver.solve(network);
+    ASSERT_TRUE(r.converged);
+
+    EXPECT_EQ(diagnostics.solveCount(), 1);
+    EXPECT_EQ(diagnostics.unconvergedCount(), 0);
+    EXPECT_EQ(diagnostics.totalIterations(), r.iterations);
+    // Every iteration before convergence had exactly one worst node
+    int64_t worst = 0;
+    for (const auto& n : diagnostics.nodeStats()) worst += n.worstIterations;
+    EXPECT_EQ(worst, r.iterations - 1);
+    EXPECT_EQ(diagnostics.nodeStats()[0].worstIterations, 0);   // ambient
+
+    json report = diagnostics.report();
+    EXPECT_EQ(report["conditioning"]["method"], "lu1Norm");
+    EXPECT_GE(report["conditioning"]["max"].get<double>(), 1.0);
+    ASSERT_EQ(report["slowestSolves"].size(), 1u);
+    EXPECT_TRUE(report["slowestSolves"][0]["converged"].get<bool>());
+
+    // The B-C wall is pressure balanced; A is pressurized and the fan never
+    // counts
+    EXPECT_EQ(diagnostics.linkStats()[4].linearSolves, 1);
+    EXPECT_EQ(diagnostics.linkStats()[1].linearSolves, 0);
+    EXPECT_EQ(diagnostics.linkStats()[0].linearSolves, 0);
+    bool listed = false;
+    for (const auto& l : report["links"]) listed = listed || l["id"].get<int>() == 5;
+    EXPECT_TRUE(listed);
+}
+
+TEST(ConvergenceDiagnostics, RanksStalledSolve) {
+    // Stacked floors stall the trust-region step (see ModelGenerator)
+    ModelGeneratorOptions o;
+    o.species = 0;
+    json j = generateModel(o);
+    Network network = JsonReader::readModelFromJson(j).network;
+
+    ConvergenceDiagnostics diagnostics;
+    Solver solver(SolverMethod::TrustRegion);
+    solver.setDiagnostics(&diagnostics);
+    SolverResult r = solver.solve(network);
+    ASSERT_FALSE(r.converged);
+
+    json report = diagnostics.report();
+    EXPECT_EQ(report["unconverged"].get<int>(), 1);
+    ASSERT_FALSE(report["nodes"].empty());
+    // Ranked worst first, shares of all iterations
+    double share = 0.0;
+    for (std::size_t k = 0; k < report["nodes"].size(); ++k) {
+        if (k > 0) {
+            EXPECT_LE(report["nodes"][k]["worstIterations"].get<int>(),
+                      report["nodes"][k - 1]["worstIterations"].get<int>());
+        }
+        share += report["nodes"][k]["share"].get<double>();
+    }
+    EXPECT_LE(share, 1.0 + 1e-12);
+    const auto& slow = report["slowestSolves"][0];
+    EXPECT_FALSE(slow["converged"].get<bool>());
+    EXPECT_EQ(slow["iterations"].get<int>(), r.iterations);
+    EXPECT_TRUE(slow.contains("worstNode"));
+    EXPECT_FALSE(diagnostics.formatText().empty());
+}
+
+TEST(ConvergenceDiagnostics, AggregatesTransientRun) {
+    ModelGeneratorOptions o;
+    o.floors = 3;
+    o.zonesPerFloor = 6;
+    o.hours = 1.0;
+    json j = generateModel(o);
+    ModelInput model = JsonReader::readModelFromJson(j);
+
+    ConvergenceDiagnostics::Options options;
+    options.slowestSolves = 3;
+    options.conditionDenseMax = 10;   // force the diagonal estimate
+    ConvergenceDiagnostics diagnostics(options);
+
+    std::ostringstream out;
+    auto sink = std::make_shared<JsonStreamWriter>(out);
+    sink->setDiagnostics(&diagnostics);
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+    sim.setDiagnostics(&diagnostics);
+    sim.addResultSink(sink);
+    sim.setStoreHistory(false);
+    ASSERT_TRUE(sim.run(model.network).completed);
+
+    EXPECT_EQ(diagnostics.solveCount(), 13);   // initial + 12 steps
+    json doc = json::parse(out.str());
+    ASSERT_TRUE(doc.contains("convergence"));
+    const auto& report = doc["convergence"];
+    EXPECT_EQ(report["solves"].get<int>(), 13);
+    EXPECT_EQ(report["conditioning"]["method"], "diagonalRatio");
+    ASSERT_EQ(report["slowestSolves"].size(), 3u);
+    for (const auto& s : report["slowestSolves"]) {
+        const double t = s["time"].get<double>();
+        EXPECT_NEAR(std::fmod(t, 300.0), 0.0, 1e-9);
+        EXPECT_LE(t, 3600.0);
+    }
+
+    // Steady results carry the report too
+    Solver solver(SolverMethod::SubRelaxation);
+    ConvergenceDiagnostics steady;
+    solver.setDiagnostics(&steady);
+    SolverResult r = solver.solve(model.network);
+    json written = json::parse(JsonWriter::writeToString(model.network, r, -1, nullptr, &steady));
+    EXPECT_EQ(written["convergence"]["solves"].get<int>(), 1);
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include "io/EngineServer.h"
+#include <nlohmann/json.hpp>
+#include <sstream>
+
+using namespace contam;
+using json = nlohmann::json;
+
+static const char* SERVER_MODEL = R"({
+    "nodes": [
+        { "id": 0, "name": "Outdoor", "type": "ambient", "temperature": 273.15 },
+        { "id": 1, "name": "Room", "temperature": 293.15, "volume": 50.0 }
+    ],
+    "links": [
+        { "id": 10, "from": 0, "to": 1, "elevation": 0.5,
+          "element": { "type": "PowerLawOrifice", "C": 0.002, "n": 0.65 } },
+        { "id": 11, "from": 1, "to": 0, "elevation": 2.5,
+          "element": { "type": "PowerLawOrifice", "C": 0.002, "n": 0.65 } }
+    ]
+})";
+
+static json call(EngineServer& server, const std::string& method, const json& params, int id = 1) {
+    json request = {{"jsonrpc", "2.0"}, {"id", id}, {"method", method}, {"params", params}};
+    return json::parse(server.handle(request.dump()));
+}
+
+TEST(EngineServer, LoadPatchAndResolve) {
+    EngineServer server;
+    auto loaded = call(server, "load", {{"model", json::parse(SERVER_MODEL)}});
+    EXPECT_EQ(loaded["result"]["nodes"], 2);
+    EXPECT_FALSE(loaded["result"]["transient"].get<bool>());
+
+    auto first = call(server, "solve", json::object(), 2);
+    EXPECT_EQ(first["id"], 2);
+    const auto& links = first["result"]["output"]["links"];
+    const double flowBefore = links[0]["massFlow"].get<double>();
+    EXPECT_GT(flowBefore, 0.0);
+
+    // Double the upper opening and warm the outdoors: both change the flow
+    auto patched = call(server, "patch", {{"patches", {
+        {{"op", "setElement"}, {"linkId", 11},
+         {"element", {{"type", "PowerLawOrifice"}, {"C", 0.004}, {"n", 0.65}}}},
+        {{"op", "setAmbient"}, {"temperature", 263.15}},
+    }}});
+    EXPECT_EQ(patched["result"]["applied"], 2);
+
+    auto second = call(server, "solve", json::object());
+    EXPECT_GT(second["result"]["output"]["links"][0]["massFlow"].get<double>(), flowBefore);
+    EXPECT_TRUE(second["result"]["output"]["solver"]["converged"].get<bool>());
+
+    // Re-solving an unchanged model starts at its solution
+    auto third = call(server, "solve", json::object());
+    EXPECT_LE(third["result"]["output"]["solver"]["iterations"].get<int>(), 1);
+}
+
+TEST(EngineServer, ExecuteRunsSweep) {
+    EngineServer server;
+    json model = json::parse(SERVER_MODEL);
+    model["sweep"] = {{"method", "grid"},
+                      {"parameters", {{{"name", "orifice_c:11"}, {"values", {0.002, 0.004, 0.008}}}}}};
+
+    // The same document as `contam_engine` writes for a sweep, not a single solve
+    auto executed = call(server, "execute", {{"model", model}});
+    const auto& doc = executed["result"];
+    ASSERT_TRUE(doc.contains("sweep")) << doc.dump();
+    EXPECT_EQ(doc["sweep"]["variants"], 3);
+    EXPECT_EQ(doc["sweep"]["ok"], 3);
+    EXPECT_FALSE(doc["sweep"]["transient"].get<bool>());
+    ASSERT_EQ(doc["variants"].size(), 3u);
+    EXPECT_EQ(doc["variants"][2]["values"][0], 0.008);
+    EXPECT_TRUE(doc["variants"][2]["converged"].get<bool>());
+}
+
+TEST(EngineServer, TransientRunAndErrors) {
+    EngineServer server;
+    json model = json::parse(SERVER_MODEL);
+    model["species"] = {{{"id", 0}, {"name", "CO2"}, {"molarMass", 0.044}}};
+    model["sources"] = {{{"zoneId", 1}, {"speciesId", 0}, {"generationRate", 1e-5}}};
+    model["transient"] = {{"endTime", 600}, {"timeStep", 60}, {"outputInterval", 300}};
+
+    // execute returns the CLI document itself
+    auto executed = call(server, "execute", {{"model", model}});
+    EXPECT_TRUE(executed["result"]["completed"].get<bool>());
+    EXPECT_EQ(executed["result"]["timeSeries"].size(), 3u);
+
+    call(server, "patch", {{"patches", {{{"op", "removeSource"}, {"index", 0}},
+                                        {{"op", "setTransient"}, {"endTime", 1200}}}}});
+    auto ran = call(server, "run", json::object());
+    EXPECT_EQ(ran["result"]["output"]["timeSeries"].size(), 5u);
+
+    EXPECT_EQ(call(server, "nope", json::object())["error"]["code"], -32601);
+    EXPECT_EQ(call(server, "patch", {{"patches", {{{"op", "setNode"}, {"nodeId", 99}}}}})["error"]["code"],
+              -32602);
+    EXPECT_EQ(json::parse(server.handle("{not json"))["error"]["code"], -32700);
+    EXPECT_TRUE(server.handle(R"({"jsonrpc":"2.0","method":"status"})").empty());  // notification
+
+    std::istringstream in("\n" + json{{"jsonrpc", "2.0"}, {"id", "a"}, {"method", "shutdown"}}.dump() +
+                          "\n" + json{{"jsonrpc", "2.0"}, {"id", "b"}, {"method", "status"}}.dump() + "\n");
+    std::ostringstream out;
+    server.serve(in, out);
+    EXPECT_TRUE(server.shutdownRequested());
+    EXPECT_EQ(out.str(), "{\"jsonrpc\":\"2.0\",\"id\":\"a\",\"result\":null}\n");
+}
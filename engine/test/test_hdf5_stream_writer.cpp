@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include "test_models.h"
+#include "core/BatchSolve.h"
+
+#ifdef CONTAM_HAS_HDF5
+
+#include "io/Hdf5StreamWriter.h"
+#include "io/Hdf5File.h"
+#include "io/Hdf5Writer.h"
+#include "io/JsonReader.h"
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+using namespace contam;
+using json = nlohmann::json;
+
+// The three-room model with CO2 only, run for 50 output steps
+static ModelInput hdf5Model() {
+    json doc = test::threeRoomModel();
+    doc["species"].erase(1);
+    doc["transient"]["endTime"] = 3000;
+    return JsonReader::readModelFromJson(doc);
+}
+
+TEST(Hdf5StreamWriter, AppendsChunksDuringRun) {
+    auto model = hdf5Model();
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+
+    const std::string path = testing::TempDir() + "stream_writer.h5";
+    Hdf5StreamOptions options;
+    options.maxTimeChunk = 8;   // 51 steps -> six full chunks and a partial one
+    auto sink = std::make_shared<Hdf5StreamWriter>(path, options);
+    sim.addResultSink(sink);
+    auto result = sim.run(model.network);
+    ASSERT_TRUE(result.completed);
+    EXPECT_EQ(sink->timeChunk(), 8u);
+    EXPECT_EQ(sink->stepCount(), result.history.size());
+
+    hdf5::Handle file = hdf5::openFile(path);
+    auto dataset = [&](const char* name) { return hdf5::openDataset(file.get(), name); };
+    const std::size_t nNodes = static_cast<std::size_t>(model.network.getNodeCount());
+
+    const auto times = hdf5::readDataset<double>(dataset("time").get());
+    ASSERT_EQ(times.size(), 51u);
+    EXPECT_DOUBLE_EQ(times.back(), 3000.0);
+
+    const auto pressures = hdf5::readDataset<double>(dataset("pressures").get());
+    ASSERT_EQ(pressures.size(), 51 * nNodes);
+    EXPECT_DOUBLE_EQ(pressures[20 * nNodes + 1], result.history[20].airflow.pressures[1]);
+
+    const auto conc = hdf5::readDataset<double>(dataset("concentrations").get());
+    EXPECT_EQ(hdf5::datasetDims(dataset("concentrations").get()),
+              std::vector<hsize_t>({51, nNodes, 1}));
+    EXPECT_DOUBLE_EQ(conc[50 * nNodes + 1], result.history[50].contaminant.concentrations[1][0]);
+
+    // Chunked along time with shuffle + deflate
+    hdf5::Handle ds = dataset("pressures");
+    hdf5::Handle props(H5Dget_create_plist(ds.get()), H5Pclose, "get dataset properties");
+    hsize_t chunk[2] = {0, 0};
+    ASSERT_EQ(H5Pget_chunk(props.get(), 2, chunk), 2);
+    EXPECT_EQ(chunk[0], 8u);
+    EXPECT_EQ(chunk[1], nNodes);
+    EXPECT_EQ(H5Pget_nfilters(props.get()), 2);
+
+    hdf5::Handle meta = hdf5::openGroup(file.get(), "metadata");
+    EXPECT_EQ(hdf5::readIntAttribute(meta.get(), "completed"), 1);
+    EXPECT_EQ(hdf5::readIntAttribute(meta.get(), "timeSteps"), 51);
+    std::remove(path.c_str());
+}
+
+// Equal values, or both NaN (rows for variables that were not due)
+static void expectSameValues(const std::vector<double>& a, const std::vector<double>& b,
+                             const char* name) {
+    ASSERT_EQ(a.size(), b.size()) << name;
+    for (std::size_t k = 0; k < a.size(); ++k) {
+        if (std::isnan(a[k])) {
+            EXPECT_TRUE(std::isnan(b[k])) << name << "[" << k << "]";
+        } else {
+            EXPECT_EQ(a[k], b[k]) << name << "[" << k << "]";
+        }
+    }
+}
+
+// What `contam_engine --hdf5` relies on: streaming without keeping the
+// history produces the same file contents as Hdf5Writer after the run
+TEST(Hdf5StreamWriter, MatchesHdf5WriterWithoutHistory) {
+    json doc = test::threeRoomModel();
+    doc["transient"]["endTime"] = 1800;
+    doc["output"] = json::parse(R"({
+        "links": [12, 11],
+        "intervals": { "pressure": 120, "concentration": 180 },
+        "precision": "float32"
+    })");
+    auto model = JsonReader::readModelFromJson(doc);
+
+    const std::string referencePath = testing::TempDir() + "stream_reference.h5";
+    {
+        TransientSimulation sim;
+        configureSimulation(sim, model);
+        auto result = sim.run(model.network);
+        ASSERT_TRUE(result.completed);
+        Hdf5Writer::writeTransient(referencePath, model.network, model.species, result);
+    }
+
+    const std::string streamPath = testing::TempDir() + "stream_nohistory.h5";
+    {
+        auto network = model.network;
+        TransientSimulation sim;
+        configureSimulation(sim, model);
+        sim.setStoreHistory(false);
+        Hdf5StreamOptions options;
+        options.maxTimeChunk = 4;
+        sim.addResultSink(std::make_shared<Hdf5StreamWriter>(streamPath, options));
+        auto result = sim.run(network);
+        ASSERT_TRUE(result.completed);
+        EXPECT_TRUE(result.history.empty());
+    }
+
+    hdf5::Handle reference = hdf5::openFile(referencePath);
+    hdf5::Handle streamed = hdf5::openFile(streamPath);
+    for (const char* name : {"time", "pressures", "massFlows", "concentrations"}) {
+        hdf5::Handle a = hdf5::openDataset(reference.get(), name);
+        hdf5::Handle b = hdf5::openDataset(streamed.get(), name);
+        EXPECT_EQ(hdf5::datasetDims(a.get()), hdf5::datasetDims(b.get())) << name;
+        EXPECT_EQ(hdf5::datasetTypeSize(a.get()), hdf5::datasetTypeSize(b.get())) << name;
+        expectSameValues(hdf5::readDataset<double>(a.get()), hdf5::readDataset<double>(b.get()), name);
+    }
+    for (const char* name : {"nodeIds", "linkIds"}) {
+        EXPECT_EQ(hdf5::readDataset<int>(hdf5::openDataset(reference.get(), name).get()),
+                  hdf5::readDataset<int>(hdf5::openDataset(streamed.get(), name).get()))
+            << name;
+    }
+    for (const char* name : {"nodeNames", "speciesNames"}) {
+        EXPECT_EQ(hdf5::readStrings(hdf5::openDataset(reference.get(), name).get()),
+                  hdf5::readStrings(hdf5::openDataset(streamed.get(), name).get()))
+            << name;
+    }
+    hdf5::Handle metaA = hdf5::openGroup(reference.get(), "metadata");
+    hdf5::Handle metaB = hdf5::openGroup(streamed.get(), "metadata");
+    for (const char* name : {"completed", "timeSteps", "nodeCount", "linkCount", "speciesCount"}) {
+        EXPECT_EQ(hdf5::readIntAttribute(metaA.get(), name), hdf5::readIntAttribute(metaB.get(), name))
+            << name;
+    }
+    std::remove(referencePath.c_str());
+    std::remove(streamPath.c_str());
+}
+
+#endif // CONTAM_HAS_HDF5
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "test_models.h"
+#include "core/BatchSolve.h"
+
+#ifdef CONTAM_HAS_HDF5
+
+#include "io/Hdf5Writer.h"
+#include "io/Hdf5File.h"
+#include "io/JsonReader.h"
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace contam;
+using json = nlohmann::json;
+
+// The three-room model with an HCHO source in Room B, recording Room B,
+// links 12 and 11 and HCHO; pressures and concentrations every other step
+static ModelInput selectionModel(const std::string& precision) {
+    json doc = test::threeRoomModel();
+    doc["sources"] = json::parse(R"([ { "zoneId": 2, "speciesId": 5, "generationRate": 1e-6 } ])");
+    doc["output"] = json::parse(R"({
+        "nodes": [2],
+        "links": [12, 11],
+        "species": [5],
+        "intervals": { "pressure": 120, "massFlow": 0, "concentration": 120 },
+        "window": { "start": 120, "end": 480 }
+    })");
+    doc["output"]["precision"] = precision;
+    return JsonReader::readModelFromJson(doc);
+}
+
+static TransientResult runModel(ModelInput& model) {
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+    return sim.run(model.network);
+}
+
+TEST(Hdf5Writer, SteadyStateLayout) {
+    json doc = test::threeRoomModel();
+    auto model = JsonReader::readModelFromJson(doc);
+    Solver solver;
+    auto result = solver.solve(model.network);
+    ASSERT_TRUE(result.converged);
+
+    const std::string path = testing::TempDir() + "hdf5_writer_steady.h5";
+    Hdf5Writer::writeSteadyState(path, model.network, result);
+    hdf5::Handle file = hdf5::openFile(path);
+
+    hdf5::Handle meta = hdf5::openGroup(file.get(), "metadata");
+    EXPECT_EQ(hdf5::readIntAttribute(meta.get(), "nodeCount"), model.network.getNodeCount());
+    EXPECT_EQ(hdf5::readIntAttribute(meta.get(), "converged"), 1);
+
+    hdf5::Handle nodes = hdf5::openGroup(file.get(), "nodes");
+    const auto names = hdf5::readStrings(hdf5::openDataset(nodes.get(), "name").get());
+    const auto pressures = hdf5::readDataset<double>(hdf5::openDataset(nodes.get(), "pressure").get());
+    ASSERT_EQ(names.size(), static_cast<size_t>(model.network.getNodeCount()));
+    ASSERT_EQ(pressures.size(), names.size());
+    for (size_t i = 0; i < names.size(); ++i) {
+        EXPECT_EQ(names[i], model.network.getNode(static_cast<int>(i)).getName());
+        EXPECT_DOUBLE_EQ(pressures[i], model.network.getNode(static_cast<int>(i)).getPressure());
+    }
+
+    hdf5::Handle links = hdf5::openGroup(file.get(), "links");
+    const auto flows = hdf5::readDataset<double>(hdf5::openDataset(links.get(), "massFlow").get());
+    ASSERT_EQ(flows.size(), static_cast<size_t>(model.network.getLinkCount()));
+    EXPECT_DOUBLE_EQ(flows[0], model.network.getLink(0).getMassFlow());
+    std::remove(path.c_str());
+}
+
+TEST(Hdf5Writer, SelectionRoundTrip) {
+    auto model = selectionModel("double");
+    auto result = runModel(model);
+    ASSERT_TRUE(result.completed);
+    ASSERT_EQ(result.history.size(), 7u);   // t = 120 .. 480
+
+    const std::string path = testing::TempDir() + "hdf5_writer_selection.h5";
+    Hdf5Writer::writeTransient(path, model.network, model.species, result);
+    hdf5::Handle file = hdf5::openFile(path);
+
+    hdf5::Handle meta = hdf5::openGroup(file.get(), "metadata");
+    EXPECT_EQ(hdf5::readIntAttribute(meta.get(), "nodeCount"), 1);
+    EXPECT_EQ(hdf5::readIntAttribute(meta.get(), "linkCount"), 2);
+    EXPECT_EQ(hdf5::readIntAttribute(meta.get(), "speciesCount"), 1);
+    EXPECT_EQ(hdf5::readIntAttribute(meta.get(), "timeSteps"), 7);
+    EXPECT_EQ(hdf5::readIntAttribute(meta.get(), "completed"), 1);
+
+    auto dataset = [&](const char* name) { return hdf5::openDataset(file.get(), name); };
+
+    // Labels follow the selection order, not the network order
+    EXPECT_EQ(hdf5::readDataset<int>(dataset("nodeIds").get()), std::vector<int>({2}));
+    EXPECT_EQ(hdf5::readDataset<int>(dataset("linkIds").get()), std::vector<int>({12, 11}));
+    EXPECT_EQ(hdf5::readStrings(dataset("nodeNames").get()), std::vector<std::string>({"Room B"}));
+    EXPECT_EQ(hdf5::readStrings(dataset("speciesNames").get()), std::vector<std::string>({"HCHO"}));
+
+    // [steps x nodes], [steps x links], [steps x nodes x species]
+    EXPECT_EQ(hdf5::datasetDims(dataset("time").get()), std::vector<hsize_t>({7}));
+    EXPECT_EQ(hdf5::datasetDims(dataset("pressures").get()), std::vector<hsize_t>({7, 1}));
+    EXPECT_EQ(hdf5::datasetDims(dataset("massFlows").get()), std::vector<hsize_t>({7, 2}));
+    EXPECT_EQ(hdf5::datasetDims(dataset("concentrations").get()), std::vector<hsize_t>({7, 1, 1}));
+
+    const auto times = hdf5::readDataset<double>(dataset("time").get());
+    const auto pressures = hdf5::readDataset<double>(dataset("pressures").get());
+    const auto flows = hdf5::readDataset<double>(dataset("massFlows").get());
+    const auto conc = hdf5::readDataset<double>(dataset("concentrations").get());
+    ASSERT_EQ(times.size(), 7u);
+    ASSERT_EQ(pressures.size(), 7u);
+    ASSERT_EQ(flows.size(), 14u);
+    ASSERT_EQ(conc.size(), 7u);
+
+    for (size_t k = 0; k < 7; ++k) {
+        const auto& step = result.history[k];
+        EXPECT_DOUBLE_EQ(times[k], step.time);
+
+        // Mass flows every step
+        EXPECT_DOUBLE_EQ(flows[2 * k], step.airflow.massFlows[0]);
+        EXPECT_DOUBLE_EQ(flows[2 * k + 1], step.airflow.massFlows[1]);
+
+        // Pressures and concentrations every 120 s, NaN rows in between
+        if (k % 2 == 0) {
+            EXPECT_DOUBLE_EQ(pressures[k], step.airflow.pressures[0]) << step.time;
+            EXPECT_DOUBLE_EQ(conc[k], step.contaminant.concentrations[0][0]) << step.time;
+        } else {
+            EXPECT_TRUE(std::isnan(pressures[k])) << step.time;
+            EXPECT_TRUE(std::isnan(conc[k])) << step.time;
+        }
+    }
+    std::remove(path.c_str());
+}
+
+TEST(Hdf5Writer, Float32SelectionWritesFloats) {
+    auto model = selectionModel("float32");
+    auto result = runModel(model);
+    ASSERT_TRUE(result.completed);
+
+    const std::string path = testing::TempDir() + "hdf5_writer_float.h5";
+    Hdf5Writer::writeTransient(path, model.network, model.species, result);
+    hdf5::Handle file = hdf5::openFile(path);
+    auto dataset = [&](const char* name) { return hdf5::openDataset(file.get(), name); };
+
+    // Results as float, time kept as double
+    EXPECT_EQ(hdf5::datasetTypeSize(dataset("pressures").get()), sizeof(float));
+    EXPECT_EQ(hdf5::datasetTypeSize(dataset("massFlows").get()), sizeof(float));
+    EXPECT_EQ(hdf5::datasetTypeSize(dataset("concentrations").get()), sizeof(float));
+    EXPECT_EQ(hdf5::datasetTypeSize(dataset("time").get()), sizeof(double));
+
+    const auto flows = hdf5::readDataset<float>(dataset("massFlows").get());
+    const auto pressures = hdf5::readDataset<float>(dataset("pressures").get());
+    ASSERT_EQ(flows.size(), 2 * result.history.size());
+    EXPECT_EQ(flows[1], static_cast<float>(result.history[0].airflow.massFlows[1]));
+    EXPECT_TRUE(std::isnan(pressures[1]));
+    std::remove(path.c_str());
+}
+
+#endif // CONTAM_HAS_HDF5
@@ -3,6 +3,8 @@
 #include "io/JsonWriter.h"
 #include "core/Solver.h"
 #include <nlohmann/json.hpp>
+#include <cstdio>
+#include <fstream>
 
 using namespace contam;
 using json = nlohmann::json;
@@ -157,3 +159,45 @@ TEST(EndToEndTest, SolveFromJson) {
     EXPECT_TRUE(result.converged);
     EXPECT_LT(result.maxResidual, CONVERGENCE_TOL);
 }
+
+TEST(JsonReaderTest, NamedTemplatesAreShared) {
+    auto model = JsonReader::readModelFromString(SAMPLE_JSON);
+    const auto& net = model.network;
+    // Links 1 and 3 both reference "crack_small"
+    EXPECT_EQ(net.getLink(0).getFlowElement(), net.getLink(2).getFlowElement());
+    EXPECT_NE(net.getLink(0).getFlowElement(), net.getLink(1).getFlowElement());
+    EXPECT_EQ(model.loadStats.flowElementTemplates, 2);
+    EXPECT_EQ(model.loadStats.sharedElementLinks, 3);
+    EXPECT_EQ(model.loadStats.bytes, SAMPLE_JSON.size());
+}
+
+TEST(JsonReaderTest, ReadModelFromFileMatchesString) {
+    const std::string path = "_test_json_reader.json";
+    {
+        std::ofstream f(path);
+        f << SAMPLE_JSON;
+    }
+    auto fromFile = JsonReader::readModelFromFile(path);
+    auto fromString = JsonReader::readModelFromString(SAMPLE_JSON);
+    std::remove(path.c_str());
+
+    ASSERT_EQ(fromFile.network.getLinkCount(), fromString.network.getLinkCount());
+    EXPECT_EQ(fromFile.loadStats.bytes, SAMPLE_JSON.size());
+    EXPECT_GE(fromFile.loadStats.throughputMBps(), 0.0);
+
+    Solver solver;
+    auto a = solver.solve(fromFile.network);
+    auto b = solver.solve(fromString.network);
+    ASSERT_EQ(a.massFlows.size(), b.massFlows.size());
+    for (size_t i = 0; i < a.massFlows.size(); ++i) {
+        EXPECT_DOUBLE_EQ(a.massFlows[i], b.massFlows[i]);
+    }
+}
+
+TEST(JsonReaderTest, MissingFileAndUnknownReference) {
+    EXPECT_THROW(JsonReader::readModelFromFile("_no_such_model.json"), std::runtime_error);
+
+    json j = json::parse(SAMPLE_JSON);
+    j["links"][0]["element"] = "no_such_template";
+    EXPECT_THROW(JsonReader::readFromString(j.dump()), std::runtime_error);
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include "test_models.h"
+#include "core/BatchSolve.h"
+#include "io/JsonStreamWriter.h"
+#include "io/JsonReader.h"
+#include "io/JsonWriter.h"
+#include <nlohmann/json.hpp>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+using namespace contam;
+using json = nlohmann::json;
+
+// The three-room model recorded every 120 s, with a name that needs escaping
+static ModelInput streamModel() {
+    json doc = test::threeRoomModel();
+    doc["nodes"][1]["name"] = "Room \"A\"";
+    doc["transient"]["outputInterval"] = 120;
+    return JsonReader::readModelFromJson(doc);
+}
+
+TEST(JsonStreamWriter, MatchesDomWriter) {
+    auto model = streamModel();
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+    auto result = sim.run(model.network);
+    ASSERT_TRUE(result.completed);
+
+    std::ostringstream out;
+    JsonStreamWriter::writeTransient(out, model.network, result, model.species);
+
+    json streamed = json::parse(out.str());
+    json dom = json::parse(JsonWriter::writeTransientToString(model.network, result, model.species));
+    EXPECT_EQ(streamed, dom);
+}
+
+TEST(JsonStreamWriter, SinkWithoutHistory) {
+    auto model = streamModel();
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+
+    std::ostringstream out;
+    JsonStreamOptions options;
+    options.minify = true;
+    auto sink = std::make_shared<JsonStreamWriter>(out, options);
+    sim.addResultSink(sink);
+    sim.setStoreHistory(false);
+
+    auto result = sim.run(model.network);
+    EXPECT_TRUE(result.completed);
+    EXPECT_TRUE(result.history.empty());
+
+    const std::string text = out.str();
+    EXPECT_EQ(text.find('\n'), std::string::npos);
+    json j = json::parse(text);
+    EXPECT_TRUE(j["completed"].get<bool>());
+    // t = 0, 120, 240, 360, 480, 600
+    EXPECT_EQ(j["totalSteps"].get<size_t>(), 6u);
+    EXPECT_EQ(sink->stepCount(), 6u);
+    EXPECT_EQ(j["nodes"][1]["name"].get<std::string>(), "Room \"A\"");
+    EXPECT_DOUBLE_EQ(j["timeSeries"][5]["time"].get<double>(), 600.0);
+    EXPECT_EQ(j["timeSeries"][5]["concentrations"].size(), 3u);
+}
+
+TEST(JsonStreamWriter, NumberFormatting) {
+    Network network;
+    network.addNode(Node(0, "Out", NodeType::Ambient));
+
+    TransientResult result;
+    result.completed = false;
+    SolverResult air;
+    air.converged = true;
+    air.iterations = 3;
+    air.pressures = {0.1, 60.0, 1e-300, std::numeric_limits<double>::quiet_NaN()};
+    result.history.push_back({60.0, air, {60.0, {}}});
+
+    std::ostringstream out;
+    JsonStreamOptions options;
+    options.minify = true;
+    JsonStreamWriter::writeTransient(out, network, result, {}, options);
+
+    const std::string text = out.str();
+    EXPECT_NE(text.find("\"pressures\":[0.1,60.0,1e-300,null]"), std::string::npos) << text;
+    EXPECT_NE(text.find("\"time\":60.0"), std::string::npos);
+    EXPECT_NE(text.find("\"completed\":false"), std::string::npos);
+}
+
+namespace {
+
+// Stops the run with an exception at the given output step
+class ThrowingSink : public ResultSink {
+public:
+    explicit ThrowingSink(std::size_t throwAt) : throwAt_(throwAt) {}
+    void onStep(const TimeStepResult&) override {
+        if (++steps_ == throwAt_) throw std::runtime_error("sink failed");
+    }
+    void end(bool completed) override { ended_ = true; completed_ = completed; }
+    bool ended_ = false;
+    bool completed_ = true;
+
+private:
+    std::size_t throwAt_;
+    std::size_t steps_ = 0;
+};
+
+} // namespace
+
+TEST(JsonStreamWriter, ThrowingRunLeavesValidDocument) {
+    auto model = streamModel();
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+    std::ostringstream out;
+    auto writer = std::make_shared<JsonStreamWriter>(out);
+    auto thrower = std::make_shared<ThrowingSink>(3);
+    sim.addResultSink(writer);
+    sim.addResultSink(thrower);
+    sim.setStoreHistory(false);
+
+    EXPECT_THROW(sim.run(model.network), std::runtime_error);
+    EXPECT_FALSE(sim.isRunning());
+    EXPECT_TRUE(thrower->ended_);
+    EXPECT_FALSE(thrower->completed_);
+
+    json j = json::parse(out.str());
+    EXPECT_FALSE(j["completed"].get<bool>());
+    EXPECT_EQ(j["totalSteps"].get<size_t>(), 3u);
+    EXPECT_EQ(j["timeSeries"].size(), 3u);
+}
+
+TEST(JsonStreamWriter, DestructorClosesDocument) {
+    auto model = streamModel();
+    std::ostringstream out;
+    {
+        JsonStreamWriter writer(out);
+        writer.begin(model.network, model.species, OutputSelection{});
+    }
+    json j = json::parse(out.str());
+    EXPECT_FALSE(j["completed"].get<bool>());
+    EXPECT_EQ(j["totalSteps"].get<size_t>(), 0u);
+}
+
+TEST(JsonStreamWriter, ReportsDroppedHistory) {
+    auto model = streamModel();
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+    std::ostringstream out;
+    sim.addResultSink(std::make_shared<JsonStreamWriter>(out));
+    const MemoryEstimate full = sim.estimateMemory(model.network);
+    sim.setMemoryBudget(full.total() - full[MemoryComponent::History] / 2);
+
+    auto result = sim.run(model.network);
+    ASSERT_TRUE(result.historyDropped);
+    json j = json::parse(out.str());
+    EXPECT_TRUE(j["completed"].get<bool>());
+    EXPECT_TRUE(j["historyDropped"].get<bool>());
+}
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include "core/BatchSolve.h"
+#include "core/TransientSimulation.h"
+#include "elements/PowerLawOrifice.h"
+#include "io/JsonReader.h"
+#include "io/JsonStreamWriter.h"
+#include "io/ModelGenerator.h"
+#include "io/ReportAccumulators.h"
+#include "utils/MemoryTracker.h"
+#include <nlohmann/json.hpp>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+using namespace contam;
+using json = nlohmann::json;
+
+namespace {
+
+ModelInput smallModel(int species = 2) {
+    ModelGeneratorOptions o;
+    o.floors = 3;
+    o.zonesPerFloor = 6;
+    o.species = species;
+    o.hours = 1.0;
+    json j = generateModel(o);
+    return JsonReader::readModelFromJson(j);
+}
+
+} // namespace
+
+TEST(MemoryTracker, PeaksAndScopes) {
+    { MemoryScope none(nullptr, MemoryComponent::History, 100); }
+
+    MemoryTracker memory;
+    memory.set(MemoryComponent::Network, 1000);
+    {
+        MemoryScope a(&memory, MemoryComponent::TransportMatrices, 400);
+        MemoryScope b(&memory, MemoryComponent::TransportMatrices, 400);
+        EXPECT_EQ(memory.currentTotal(), 1800u);
+    }
+    memory.set(MemoryComponent::Network, 600);
+    memory.allocate(MemoryComponent::History, 100);
+
+    EXPECT_EQ(memory.current(MemoryComponent::TransportMatrices), 0u);
+    EXPECT_EQ(memory.peak(MemoryComponent::TransportMatrices), 800u);
+    EXPECT_EQ(memory.peak(MemoryComponent::Network), 1000u);
+    EXPECT_EQ(memory.currentTotal(), 700u);
+    EXPECT_EQ(memory.peakTotal(), 1800u);   // peak of the sum, not the sum of peaks
+
+    json s = memory.summary();
+    EXPECT_EQ(s["peakBytes"].get<std::uint64_t>(), 1800u);
+    EXPECT_EQ(s["components"]["transportMatrices"]["peakBytes"].get<std::uint64_t>(), 800u);
+    EXPECT_FALSE(s["components"].contains("ioBuffers"));   // never used
+    EXPECT_FALSE(s.contains("predictedBytes"));
+    EXPECT_NE(memory.formatText().find("total"), std::string::npos);
+    EXPECT_EQ(formatBytes(1536), "1.5 KB");
+}
+
+TEST(MemoryTracker, SharedElementsCountOnce) {
+    Network net;
+    for (int id = 1; id <= 3; ++id) {
+        Node node(id, "N" + std::to_string(id), id == 1 ? NodeType::Ambient : NodeType::Normal);
+        net.addNode(node);
+    }
+    auto element = std::make_shared<const PowerLawOrifice>(0.01, 0.65);
+    for (int k = 0; k < 2; ++k) {
+        Link link(k + 1, k, k + 1, 0.0);
+        link.setSharedFlowElement(element);
+        net.addLink(std::move(link));
+    }
+    EXPECT_EQ(net.elementMemoryBytes(), element->memoryBytes());
+    EXPECT_GE(net.memoryBytes(), 3 * sizeof(Node) + 2 * sizeof(Link));
+}
+
+TEST(MemoryTracker, TransientRunTracksComponents) {
+    ModelInput model = smallModel();
+    MemoryTracker memory;
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+    sim.setMemoryTracker(&memory);
+    auto csm = std::make_shared<CsmAccumulator>();
+    std::ostringstream out;
+    auto writer = std::make_shared<JsonStreamWriter>(out);
+    writer->setMemory(&memory);
+    sim.addResultSink(csm);
+    sim.addResultSink(writer);
+    const MemoryEstimate predicted = sim.estimateMemory(model.network);
+    TransientResult result = sim.run(model.network);
+    ASSERT_TRUE(result.completed);
+    EXPECT_FALSE(result.historyDropped);
+
+    for (auto c : {MemoryComponent::Network, MemoryComponent::Elements, MemoryComponent::SolverWorkspace,
+                   MemoryComponent::TransportMatrices, MemoryComponent::History,
+                   MemoryComponent::ReportAccumulators, MemoryComponent::IoBuffers}) {
+        EXPECT_GT(memory.peak(c), 0u) << toString(c);
+    }
+    // Solves are over; the stored history is still held
+    EXPECT_EQ(memory.current(MemoryComponent::SolverWorkspace), 0u);
+    EXPECT_EQ(memory.current(MemoryComponent::TransportMatrices), 0u);
+    ASSERT_TRUE(memory.hasPrediction());
+    EXPECT_EQ(memory.prediction().total(), predicted.total());
+
+    // The prediction is of the right size for what is counted exactly
+    EXPECT_EQ(predicted[MemoryComponent::Network], memory.peak(MemoryComponent::Network));
+    // At least one dense system, at most one per species in flight
+    EXPECT_GE(memory.peak(MemoryComponent::TransportMatrices),
+              ContaminantSolver::systemBytes(model.network.getUnknownCount()));
+    EXPECT_LE(memory.peak(MemoryComponent::TransportMatrices), predicted[MemoryComponent::TransportMatrices]);
+    const double history = static_cast<double>(memory.peak(MemoryComponent::History));
+    EXPECT_GT(history, 0.5 * predicted[MemoryComponent::History]);
+    EXPECT_LT(history, 2.0 * predicted[MemoryComponent::History]);
+
+    json doc = json::parse(out.str());
+    ASSERT_TRUE(doc.contains("memory"));
+    EXPECT_GT(doc["memory"]["components"]["history"]["peakBytes"].get<std::uint64_t>(), 0u);
+    EXPECT_EQ(doc["memory"]["predictedBytes"].get<std::uint64_t>(), predicted.total());
+}
+
+TEST(MemoryTracker, BudgetDropsHistoryOrStops) {
+    ModelInput model = smallModel();
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+    const MemoryEstimate full = sim.estimateMemory(model.network);
+    ASSERT_GT(full[MemoryComponent::History], 0u);
+    const std::uint64_t budget = full.total() - full[MemoryComponent::History] / 2;
+
+    // No sink sees the steps: nothing can give way
+    sim.setMemoryBudget(budget);
+    try {
+        sim.run(model.network);
+        FAIL() << "expected the budget to stop the run";
+    } catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string(e.what()).find("Memory budget exceeded"), std::string::npos);
+    }
+    EXPECT_FALSE(sim.isRunning());
+
+    // A streaming sink lets the run go ahead without history
+    auto csm = std::make_shared<CsmAccumulator>();
+    sim.addResultSink(csm);
+    TransientResult result = sim.run(model.network);
+    EXPECT_TRUE(result.completed);
+    EXPECT_TRUE(result.historyDropped);
+    EXPECT_TRUE(result.history.empty());
+    EXPECT_FALSE(csm->result().empty());
+
+    // Still over it without any history
+    sim.setMemoryBudget(full[MemoryComponent::Network]);
+    EXPECT_THROW(sim.run(model.network), std::runtime_error);
+
+    sim.setMemoryBudget(0);
+    EXPECT_FALSE(sim.run(model.network).historyDropped);
+}
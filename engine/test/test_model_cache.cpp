@@ -0,0 +1,282 @@
+#include <gtest/gtest.h>
+#include "io/ModelCache.h"
+#include "io/JsonReader.h"
+#include "core/Solver.h"
+#include "elements/UVGIFilter.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace contam;
+
+static std::string tempPath(const std::string& ext) {
+    return std::string("_test_model_cache") + ext;
+}
+
+static void writeText(const std::string& path, const std::string& content) {
+    std::ofstream f(path);
+    f << content;
+}
+
+static const std::string MODEL_JSON = R"({
+    "ambient": { "temperature": 278.15, "windSpeed": 4.0, "windDirection": 90.0 },
+    "flowElements": {
+        "crack": { "type": "PowerLawOrifice", "leakageArea": 0.002 },
+        "fan":   { "type": "Fan", "coeffs": [150.0, -800.0, -2000.0] },
+        "uv":    { "type": "UVGIFilter", "C": 0.01, "n": 0.5, "k": 0.05,
+                   "irradiance": 10.0, "tempCoeffs": [1.0, 0.01], "flowCoeffs": [0.9] },
+        "carbon": { "type": "SimpleGaseousFilter", "C": 0.02, "n": 0.6,
+                    "loadingTable": [ {"loading": 0.0, "efficiency": 0.9},
+                                      {"loading": 1.0, "efficiency": 0.1} ] }
+    },
+    "nodes": [
+        { "id": 0, "name": "Outdoor", "type": "ambient", "wallAzimuth": 45.0,
+          "windPressureProfile": [ {"angle": 0, "cp": 0.6}, {"angle": 180, "cp": -0.3} ] },
+        { "id": 1, "name": "Living", "temperature": 294.15, "volume": 80.0 },
+        { "id": 2, "name": "Bed", "temperature": 293.15, "volume": 40.0, "elevation": 3.0 }
+    ],
+    "links": [
+        { "id": 1, "from": 0, "to": 1, "elevation": 1.0, "element": "crack" },
+        { "id": 2, "from": 1, "to": 2, "elevation": 2.5,
+          "element": { "type": "TwoWayFlow", "Cd": 0.6, "area": 1.8 } },
+        { "id": 3, "from": 2, "to": 0, "elevation": 4.0, "element": "crack" },
+        { "id": 4, "from": 0, "to": 1, "elevation": 1.0, "element": "fan" },
+        { "id": 5, "from": 1, "to": 0, "elevation": 1.0, "element": "uv" },
+        { "id": 6, "from": 2, "to": 0, "elevation": 4.0, "element": "carbon" }
+    ],
+    "species": [ { "id": 1, "name": "CO2", "molarMass": 0.044, "outdoorConcentration": 7e-4 } ],
+    "sources": [ { "zoneId": 1, "speciesId": 1, "generationRate": 5e-6, "scheduleId": 7 },
+                 { "zoneId": 2, "speciesId": 1, "type": "Burst", "burstMass": 0.01,
+                   "burstTime": 600.0, "burstDuration": 60.0 } ],
+    "schedules": [ { "id": 7, "name": "occ", "points": [
+        {"time": 3600, "value": 0.0}, {"time": 0, "value": 1.0}, {"time": 1800, "value": 0.5} ] } ],
+    "zoneTemperatureSchedules": [ { "nodeId": 2, "scheduleId": 7 } ],
+    "transient": { "endTime": 7200, "timeStep": 30, "airflowMethod": "subRelaxation" },
+    "weather": { "records": [
+        { "month": 1, "day": 1, "hour": 1, "temperature": 270.0, "windSpeed": 2.0 },
+        { "month": 1, "day": 1, "hour": 2, "temperature": 271.0, "humidity": 0.8 } ] },
+    "ahsSystems": [ { "id": 1, "name": "AHU", "supplyZones": [ {"zoneId": 1, "fraction": 0.7},
+                                                               {"zoneId": 2, "fraction": 0.3} ],
+                      "returnZones": [ {"zoneId": 1} ] } ],
+    "occupants": [ { "id": 1, "name": "Alice", "zoneId": 2, "breathingRate": 1.5e-4 } ]
+})";
+
+// ── In-memory image ──────────────────────────────────────────────────
+
+TEST(ModelCache, RoundTripPreservesModel) {
+    auto original = JsonReader::readModelFromString(MODEL_JSON);
+    auto image = ModelCache::serialize(original, ModelCache::contentHash(MODEL_JSON), MODEL_JSON.size());
+    auto restored = ModelCache::deserialize(image);
+
+    const auto& a = original.network;
+    const auto& b = restored.network;
+    ASSERT_EQ(a.getNodeCount(), b.getNodeCount());
+    ASSERT_EQ(a.getLinkCount(), b.getLinkCount());
+    EXPECT_EQ(b.getNode(1).getName(), "Living");
+    EXPECT_EQ(b.getNode(0).getType(), NodeType::Ambient);
+    EXPECT_DOUBLE_EQ(b.getNode(0).getCpAtWindDirection(135.0), a.getNode(0).getCpAtWindDirection(135.0));
+    EXPECT_DOUBLE_EQ(b.getWindSpeed(), 4.0);
+    for (int i = 0; i < a.getLinkCount(); ++i) {
+        EXPECT_EQ(b.getLink(i).getFlowElement()->typeName(), a.getLink(i).getFlowElement()->typeName());
+    }
+    // Shared templates stay shared
+    EXPECT_EQ(b.getLink(0).getFlowElement(), b.getLink(2).getFlowElement());
+
+    auto* uv = dynamic_cast<const UVGIFilter*>(b.getLink(4).getFlowElement());
+    ASSERT_NE(uv, nullptr);
+    EXPECT_EQ(uv->getParams().tempCoeffs.size(), 2u);
+    EXPECT_DOUBLE_EQ(uv->getParams().flowCoeffs[0], 0.9);
+
+    // Identical airflow solution
+    Solver solver;
+    auto ra = solver.solve(original.network);
+    auto rb = solver.solve(restored.network);
+    ASSERT_EQ(ra.massFlows.size(), rb.massFlows.size());
+    for (size_t i = 0; i < ra.massFlows.size(); ++i) {
+        EXPECT_DOUBLE_EQ(ra.massFlows[i], rb.massFlows[i]);
+    }
+
+    ASSERT_EQ(restored.species.size(), 1u);
+    EXPECT_EQ(restored.species[0].name, "CO2");
+    ASSERT_EQ(restored.sources.size(), 2u);
+    EXPECT_EQ(restored.sources[1].type, SourceType::Burst);
+    ASSERT_EQ(restored.schedules.count(7), 1u);
+    EXPECT_DOUBLE_EQ(restored.schedules[7].getValue(900.0), original.schedules[7].getValue(900.0));
+    EXPECT_EQ(restored.zoneTemperatureSchedules.at(2), 7);
+    EXPECT_TRUE(restored.hasTransient);
+    EXPECT_EQ(restored.transientConfig.airflowMethod, SolverMethod::SubRelaxation);
+    EXPECT_DOUBLE_EQ(restored.transientConfig.endTime, 7200.0);
+    ASSERT_EQ(restored.weatherData.size(), 2u);
+    EXPECT_DOUBLE_EQ(restored.weatherData[1].humidity, 0.8);
+    ASSERT_EQ(restored.ahSystems.size(), 1u);
+    ASSERT_EQ(restored.ahSystems[0].supplyZones.size(), 2u);
+    EXPECT_DOUBLE_EQ(restored.ahSystems[0].supplyZones[1].fraction, 0.3);
+    ASSERT_EQ(restored.occupants.size(), 1u);
+    EXPECT_EQ(restored.occupants[0].currentZoneIdx, 2);
+}
+
+TEST(ModelCache, RejectsForeignAndTruncatedImages) {
+    EXPECT_THROW(ModelCache::deserialize(std::string(64, 'x')), std::runtime_error);
+
+    auto image = ModelCache::serialize(JsonReader::readModelFromString(MODEL_JSON));
+    image.resize(image.size() / 2);
+    EXPECT_THROW(ModelCache::deserialize(image), std::runtime_error);
+}
+
+// ── Cache files keyed by content hash ────────────────────────────────
+
+TEST(ModelCache, LoadModelReusesMatchingCache) {
+    namespace fs = std::filesystem;
+    std::string json = tempPath(".json");
+    std::string dir = tempPath("_dir");
+    fs::remove_all(dir);
+    writeText(json, MODEL_JSON);
+
+    auto first = ModelCache::loadModel(json, dir);
+    EXPECT_FALSE(first.loadStats.fromCache);
+    EXPECT_TRUE(fs::exists(ModelCache::cachePathFor(ModelCache::contentHash(MODEL_JSON), dir)));
+    auto second = ModelCache::loadModel(json, dir);
+    EXPECT_TRUE(second.loadStats.fromCache);
+    EXPECT_EQ(second.network.getLinkCount(), first.network.getLinkCount());
+
+    // Editing the model invalidates the cache
+    writeText(json, MODEL_JSON.substr(0, MODEL_JSON.size() - 1) + ", \"extra\": 1 }");
+    auto third = ModelCache::loadModel(json, dir);
+    EXPECT_FALSE(third.loadStats.fromCache);
+
+    std::remove(json.c_str());
+    fs::remove_all(dir);
+}
+
+TEST(ModelCache, EditedValueRejectsCache) {
+    namespace fs = std::filesystem;
+    std::string json = tempPath("_edit.json");
+    std::string dir = tempPath("_edit_dir");
+    fs::remove_all(dir);
+    writeText(json, MODEL_JSON);
+    EXPECT_DOUBLE_EQ(ModelCache::loadModel(json, dir).network.getNode(1).getVolume(), 80.0);
+
+    // Same length, one value changed
+    std::string edited = MODEL_JSON;
+    edited.replace(edited.find("\"volume\": 80.0") + 10, 4, "81.0");
+    ASSERT_EQ(edited.size(), MODEL_JSON.size());
+    writeText(json, edited);
+    auto model = ModelCache::loadModel(json, dir);
+    EXPECT_FALSE(model.loadStats.fromCache);
+    EXPECT_DOUBLE_EQ(model.network.getNode(1).getVolume(), 81.0);
+
+    std::remove(json.c_str());
+    fs::remove_all(dir);
+}
+
+TEST(ModelCache, StaleHashOrSizeIsIgnored) {
+    std::string cache = tempPath(".cmc");
+    auto model = JsonReader::readModelFromString(MODEL_JSON);
+    const Sha256Digest hash = ModelCache::contentHash(MODEL_JSON);
+    ModelCache::write(cache, model, hash, MODEL_JSON.size());
+
+    ModelInput loaded;
+    EXPECT_FALSE(ModelCache::tryRead(cache, ModelCache::contentHash("other"), MODEL_JSON.size(), loaded));
+    EXPECT_FALSE(ModelCache::tryRead(cache, hash, MODEL_JSON.size() + 1, loaded));
+    EXPECT_TRUE(ModelCache::tryRead(cache, hash, MODEL_JSON.size(), loaded));
+    EXPECT_EQ(loaded.network.getNodeCount(), 3);
+    EXPECT_FALSE(ModelCache::tryRead(tempPath("_missing.cmc"), hash, MODEL_JSON.size(), loaded));
+    std::remove(cache.c_str());
+}
+
+TEST(ModelCache, ContentHashIsSha256) {
+    EXPECT_EQ(Sha256::toHex(ModelCache::contentHash("abc")),
+              "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    EXPECT_EQ(Sha256::toHex(ModelCache::contentHash("")),
+              "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    // Multi-block input fed in uneven pieces
+    std::string text(1000, 'a');
+    Sha256 h;
+    h.update(text.data(), 3);
+    h.update(text.data() + 3, 700);
+    h.update(text.data() + 703, 297);
+    EXPECT_EQ(h.finish(), ModelCache::contentHash(text));
+
+    std::string model = MODEL_JSON;
+    const Sha256Digest before = ModelCache::contentHash(model);
+    model[model.size() - 3] = ' ';
+    EXPECT_NE(ModelCache::contentHash(model), before);
+}
+
+TEST(ModelCache, PruneDropsOldAndLeastRecentlyUsed) {
+    namespace fs = std::filesystem;
+    std::string dir = tempPath("_prune");
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const auto now = fs::file_time_type::clock::now();
+    auto make = [&](const std::string& name, std::chrono::hours age) {
+        std::string path = (fs::path(dir) / name).string();
+        writeText(path, std::string(1000, 'x'));
+        fs::last_write_time(path, now - age);
+        return path;
+    };
+    std::string expired = make("a.cmc", std::chrono::hours(24 * 40));
+    std::string older = make("b.cmc", std::chrono::hours(3));
+    std::string newer = make("c.cmc", std::chrono::hours(1));
+    std::string other = make("notes.txt", std::chrono::hours(24 * 40));
+
+    ModelCache::prune(dir, 1500, 30);
+    EXPECT_FALSE(fs::exists(expired));
+    EXPECT_FALSE(fs::exists(older));
+    EXPECT_TRUE(fs::exists(newer));
+    EXPECT_TRUE(fs::exists(other));   // only cache files are touched
+    fs::remove_all(dir);
+}
+
+TEST(ModelCache, PruneKeepsEntryJustWritten) {
+    namespace fs = std::filesystem;
+    std::string dir = tempPath("_keep");
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const auto now = fs::file_time_type::clock::now();
+    std::string old = (fs::path(dir) / "a.cmc").string();
+    std::string fresh = (fs::path(dir) / "b.cmc").string();
+    std::string stale = (fs::path(dir) / "b.cmc.123.abc.tmp").string();
+    writeText(old, std::string(1000, 'x'));
+    fs::last_write_time(old, now - std::chrono::hours(2));
+    writeText(fresh, std::string(4000, 'x'));
+    writeText(stale, std::string(10, 'x'));
+    fs::last_write_time(stale, now - std::chrono::hours(2));
+
+    // The new entry alone is over the cap; it stays, everything else goes
+    ModelCache::prune(dir, 1500, 30, fresh);
+    EXPECT_FALSE(fs::exists(old));
+    EXPECT_TRUE(fs::exists(fresh));
+    EXPECT_FALSE(fs::exists(stale));
+    fs::remove_all(dir);
+}
+
+TEST(ModelCache, ConcurrentWritersUseSeparateTempFiles) {
+    namespace fs = std::filesystem;
+    std::string dir = tempPath("_concurrent");
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    auto model = JsonReader::readModelFromString(MODEL_JSON);
+    const Sha256Digest hash = ModelCache::contentHash(MODEL_JSON);
+    const std::string cache = ModelCache::cachePathFor(hash, dir);
+
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 4; ++i) {
+        writers.emplace_back([&] {
+            for (int k = 0; k < 10; ++k) ModelCache::write(cache, model, hash, MODEL_JSON.size());
+        });
+    }
+    for (auto& t : writers) t.join();
+
+    ModelInput loaded;
+    EXPECT_TRUE(ModelCache::tryRead(cache, hash, MODEL_JSON.size(), loaded));
+    EXPECT_EQ(loaded.network.getNodeCount(), 3);
+    for (const auto& item : fs::directory_iterator(dir)) {
+        EXPECT_NE(item.path().extension(), ".tmp") << item.path();
+    }
+    fs::remove_all(dir);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "core/BatchSolve.h"
+#include "core/Solver.h"
+#include "core/TransientSimulation.h"
+#include "io/JsonReader.h"
+#include "io/ModelGenerator.h"
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+
+using namespace contam;
+
+namespace {
+
+ModelGeneratorOptions smallBuilding() {
+    ModelGeneratorOptions o;
+    o.floors = 12;           // two facade bands
+    o.zonesPerFloor = 8;     // two corridor segments
+    o.species = 2;
+    o.ahsSystems = 2;
+    o.hours = 2.0;
+    return o;
+}
+
+} // namespace
+
+TEST(ModelGenerator, SameSeedGivesSameModel) {
+    ModelGeneratorOptions o = smallBuilding();
+    EXPECT_EQ(generateModel(o).dump(), generateModel(o).dump());
+    ModelGeneratorOptions other = o;
+    other.seed = 2;
+    EXPECT_NE(generateModel(o).dump(), generateModel(other).dump());
+}
+
+TEST(ModelGenerator, CountsAndReferences) {
+    ModelGeneratorOptions o = smallBuilding();
+    nlohmann::json j = generateModel(o);
+
+    // 2 bands x 4 facades + 12 floors x (2 corridor + 8 office + 2 stair + 1 shaft)
+    const int nodes = 8 + 12 * 13;
+    ASSERT_EQ(static_cast<int>(j["nodes"].size()), nodes);
+    for (int i = 0; i < nodes; ++i) EXPECT_EQ(j["nodes"][i]["id"].get<int>(), i);
+    for (std::size_t i = 0; i < j["links"].size(); ++i) {
+        EXPECT_EQ(j["links"][i]["id"].get<std::size_t>(), i + 1);
+    }
+    EXPECT_EQ(j["occupants"].size(), 12u * 8u);
+    EXPECT_EQ(j["ahsSystems"].size(), 2u);
+    EXPECT_EQ(j["controls"]["actuators"].size(), 12u);
+
+    ModelInput model = JsonReader::readModelFromJson(j);
+    const Network& net = model.network;
+    EXPECT_EQ(net.getNodeCount(), nodes);
+    for (const auto& ahs : model.ahSystems) {
+        double fraction = 0.0;
+        for (const auto& zone : ahs.supplyZones) {
+            ASSERT_LT(zone.zoneId, nodes);
+            EXPECT_FALSE(net.getNode(zone.zoneId).isKnownPressure());
+            fraction += zone.fraction;
+        }
+        EXPECT_NEAR(fraction, 1.0, 1e-9);
+    }
+    for (const auto& occ : model.occupants) {
+        ASSERT_TRUE(model.schedules.count(occ.scheduleId));
+        EXPECT_EQ(model.schedules.at(occ.scheduleId).getValue(0.0), occ.currentZoneIdx);
+    }
+    // Every actuator drives a fan link
+    for (const auto& a : j["controls"]["actuators"]) {
+        int link = a["linkIdx"].get<int>();
+        ASSERT_LT(link, net.getLinkCount());
+        EXPECT_EQ(net.getLink(link).getFlowElement()->typeName(), "Fan");
+    }
+}
+
+TEST(ModelGenerator, SteadyAndTransientSolve) {
+    nlohmann::json j = generateModel(smallBuilding());
+    ModelInput model = JsonReader::readModelFromJson(j);
+    Network steady = model.network;
+    SolverResult r = Solver(SolverMethod::SubRelaxation).solve(steady);
+    EXPECT_TRUE(r.converged);
+
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+    TransientResult t = sim.run(model.network);
+    EXPECT_TRUE(t.completed);
+    ASSERT_FALSE(t.history.empty());
+    for (const auto& step : t.history) EXPECT_TRUE(step.airflow.converged);
+}
+
+TEST(ModelGenerator, RejectsBadOptions) {
+    ModelGeneratorOptions o;
+    o.floors = 0;
+    EXPECT_THROW(generateModel(o), std::runtime_error);
+    o = ModelGeneratorOptions{};
+    o.ahsSystems = o.floors + 1;
+    EXPECT_THROW(generateModel(o), std::runtime_error);
+    o = ModelGeneratorOptions{};
+    o.airflowMethod = "newton";
+    EXPECT_THROW(generateModel(o), std::runtime_error);
+}
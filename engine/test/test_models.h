@@ -0,0 +1,34 @@
+#pragma once
+// Small models shared by the result writer tests
+
+#include <nlohmann/json.hpp>
+
+namespace contam::test {
+
+// Outdoor (0), "Room A" (1) and "Room B" (2) joined in a loop by cracks
+// 10 (0->1), 11 (1->2) and 12 (2->0); species CO2 (id 0) and HCHO (id 5)
+// with a CO2 source in Room A; 600 s in 60 s steps, every step recorded.
+// Tests adjust the document before reading it.
+inline nlohmann::json threeRoomModel() {
+    return nlohmann::json::parse(R"({
+        "flowElements": { "crack": { "type": "PowerLawOrifice", "C": 0.001, "n": 0.65 } },
+        "nodes": [
+            { "id": 0, "name": "Outdoor", "type": "ambient", "temperature": 283.15 },
+            { "id": 1, "name": "Room A", "temperature": 293.15, "volume": 50.0 },
+            { "id": 2, "name": "Room B", "temperature": 295.15, "volume": 30.0 }
+        ],
+        "links": [
+            { "id": 10, "from": 0, "to": 1, "elevation": 0.5, "element": "crack" },
+            { "id": 11, "from": 1, "to": 2, "elevation": 1.5, "element": "crack" },
+            { "id": 12, "from": 2, "to": 0, "elevation": 2.5, "element": "crack" }
+        ],
+        "species": [
+            { "id": 0, "name": "CO2", "molarMass": 0.044 },
+            { "id": 5, "name": "HCHO", "molarMass": 0.030 }
+        ],
+        "sources": [ { "zoneId": 1, "speciesId": 0, "generationRate": 1e-5 } ],
+        "transient": { "endTime": 600, "timeStep": 60, "outputInterval": 60 }
+    })");
+}
+
+} // namespace contam::test
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include "test_models.h"
+#include "core/BatchSolve.h"
+#include "core/OutputSpec.h"
+#include "io/ColumnarResults.h"
+#include "io/JsonReader.h"
+#include "io/JsonStreamWriter.h"
+#include "io/JsonWriter.h"
+#include "io/ModelCache.h"
+#include <nlohmann/json.hpp>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+
+using namespace contam;
+using json = nlohmann::json;
+
+// The three-room model with an HCHO source in Room B, recording Room B,
+// links 12 and 11 and HCHO
+static ModelInput outputModel() {
+    json doc = test::threeRoomModel();
+    doc["sources"] = json::parse(R"([ { "zoneId": 2, "speciesId": 5, "generationRate": 1e-6 } ])");
+    doc["output"] = json::parse(R"({
+        "nodes": [2],
+        "links": [12, 11],
+        "species": [5],
+        "intervals": { "pressure": 120, "massFlow": 0, "concentration": 0 },
+        "window": { "start": 120, "end": 480 },
+        "precision": "quantized",
+        "significantDigits": 3
+    })");
+    return JsonReader::readModelFromJson(doc);
+}
+
+TEST(OutputSpec, ParsedFromModelAndCache) {
+    auto model = outputModel();
+    const auto& spec = model.outputSpec;
+    EXPECT_EQ(spec.nodeIds, std::vector<int>({2}));
+    EXPECT_EQ(spec.linkIds, std::vector<int>({12, 11}));
+    EXPECT_DOUBLE_EQ(spec.pressureInterval, 120.0);
+    EXPECT_DOUBLE_EQ(spec.windowEnd, 480.0);
+    EXPECT_EQ(spec.precision, OutputPrecision::Quantized);
+    EXPECT_FALSE(spec.isDefault());
+    EXPECT_TRUE(OutputSpec{}.isDefault());
+
+    auto restored = ModelCache::deserialize(ModelCache::serialize(model));
+    EXPECT_EQ(restored.outputSpec.linkIds, spec.linkIds);
+    EXPECT_EQ(restored.outputSpec.significantDigits, 3);
+    EXPECT_DOUBLE_EQ(restored.outputSpec.windowStart, 120.0);
+
+    EXPECT_THROW(parseOutputPrecision("half"), std::runtime_error);
+}
+
+TEST(OutputSpec, HistoryIsReduced) {
+    auto model = outputModel();
+    auto full = outputModel();
+    full.outputSpec = OutputSpec{};
+
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+    auto result = sim.run(model.network);
+    TransientSimulation referenceSim;
+    configureSimulation(referenceSim, full);
+    auto reference = referenceSim.run(full.network);
+    ASSERT_TRUE(result.completed);
+
+    // t = 120 .. 480 of 0 .. 600
+    ASSERT_EQ(result.history.size(), 7u);
+    ASSERT_EQ(reference.history.size(), 11u);
+    EXPECT_DOUBLE_EQ(result.history.front().time, 120.0);
+    EXPECT_DOUBLE_EQ(result.history.back().time, 480.0);
+
+    for (size_t k = 0; k < result.history.size(); ++k) {
+        const auto& step = result.history[k];
+        const auto& ref = reference.history[k + 2];
+        // Pressures every 120 s, starting at the first recorded step
+        EXPECT_EQ(step.airflow.pressures.size(), k % 2 == 0 ? 1u : 0u) << step.time;
+        ASSERT_EQ(step.airflow.massFlows.size(), 2u);
+        EXPECT_DOUBLE_EQ(step.airflow.massFlows[0], result.output.round(ref.airflow.massFlows[2]));
+        EXPECT_DOUBLE_EQ(step.airflow.massFlows[1], result.output.round(ref.airflow.massFlows[1]));
+        ASSERT_EQ(step.contaminant.concentrations.size(), 1u);
+        ASSERT_EQ(step.contaminant.concentrations[0].size(), 1u);
+        EXPECT_NEAR(step.contaminant.concentrations[0][0], ref.contaminant.concentrations[2][1],
+                    std::abs(ref.contaminant.concentrations[2][1]) * 5e-3);
+    }
+    EXPECT_EQ(result.output.node(0), 2);
+    EXPECT_EQ(result.output.link(0), 2);
+    EXPECT_EQ(result.output.species(0), 1);
+}
+
+TEST(OutputSpec, Rounding) {
+    Network network;
+    OutputSpec spec;
+    spec.precision = OutputPrecision::Quantized;
+    spec.significantDigits = 3;
+    OutputSelection quantized(spec, network, {});
+    EXPECT_DOUBLE_EQ(quantized.round(0.0123456), 0.0123);
+    EXPECT_DOUBLE_EQ(quantized.round(-98765.0), -98800.0);
+    EXPECT_DOUBLE_EQ(quantized.round(0.0), 0.0);
+    EXPECT_NEAR(quantized.round(1.23456e-305), 1.23e-305, 1e-318);
+
+    spec.precision = OutputPrecision::Float32;
+    OutputSelection single(spec, network, {});
+    EXPECT_EQ(single.round(0.1), static_cast<double>(0.1f));
+}
+
+TEST(OutputSpec, WritersLabelSubset) {
+    auto model = outputModel();
+    model.outputSpec.precision = OutputPrecision::Double;
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+
+    std::ostringstream streamed;
+    sim.addResultSink(std::make_shared<JsonStreamWriter>(streamed));
+    const std::string columnar = testing::TempDir() + "output_spec.crs";
+    sim.addResultSink(std::make_shared<ColumnarResultsWriter>(columnar));
+    auto result = sim.run(model.network);
+
+    json j = json::parse(streamed.str());
+    EXPECT_EQ(j, json::parse(JsonWriter::writeTransientToString(model.network, result, model.species)));
+    ASSERT_EQ(j["nodes"].size(), 1u);
+    EXPECT_EQ(j["nodes"][0]["name"].get<std::string>(), "Room B");
+    ASSERT_EQ(j["links"].size(), 2u);
+    EXPECT_EQ(j["links"][0]["id"].get<int>(), 12);
+    EXPECT_EQ(j["links"][0]["to"].get<int>(), 0);
+    EXPECT_EQ(j["species"][0]["name"].get<std::string>(), "HCHO");
+    EXPECT_TRUE(j["timeSeries"][0]["airflow"].contains("pressures"));
+    EXPECT_FALSE(j["timeSeries"][1]["airflow"].contains("pressures"));
+
+    ColumnarResultsReader reader(columnar);
+    EXPECT_EQ(reader.numSeries(), 1u + 2u + 1u);
+    EXPECT_EQ(reader.links()[1].id, 11);
+    EXPECT_TRUE(std::isnan(reader.pressure(0)[1]));
+    std::remove(columnar.c_str());
+}
+
+TEST(OutputSpec, UnknownIdsRejected) {
+    auto model = outputModel();
+    model.outputSpec.speciesIds = {7};
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+    EXPECT_THROW(sim.run(model.network), std::runtime_error);
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "core/BatchSolve.h"
+#include "core/Solver.h"
+#include "core/TransientSimulation.h"
+#include "io/JsonReader.h"
+#include "io/JsonStreamWriter.h"
+#include "io/JsonWriter.h"
+#include "io/ModelGenerator.h"
+#include "utils/Profiler.h"
+#include <nlohmann/json.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace contam;
+using json = nlohmann::json;
+
+namespace {
+
+ModelInput smallModel(int species = 2) {
+    ModelGeneratorOptions o;
+    o.floors = 3;
+    o.zonesPerFloor = 6;
+    o.species = species;
+    o.hours = 1.0;
+    json j = generateModel(o);
+    return JsonReader::readModelFromJson(j);
+}
+
+} // namespace
+
+TEST(Profiler, ScopesAccumulateAndNullIsNoOp) {
+    { ProfileScope none(nullptr, ProfilePhase::Output); }
+
+    Profiler profiler;
+    for (int k = 0; k < 3; ++k) {
+        ProfileScope scope(&profiler, ProfilePhase::Controls);
+    }
+    std::thread other([&] { ProfileScope scope(&profiler, ProfilePhase::TransportSolve); });
+    other.join();
+    profiler.count(ProfileCounter::Factorizations, 5);
+
+    EXPECT_EQ(profiler.calls(ProfilePhase::Controls), 3);
+    EXPECT_EQ(profiler.calls(ProfilePhase::TransportSolve), 1);
+    EXPECT_EQ(profiler.calls(ProfilePhase::Output), 0);
+    EXPECT_EQ(profiler.counter(ProfileCounter::Factorizations), 5);
+
+    profiler.stop();
+    const double wall = profiler.wallSeconds();
+    EXPECT_EQ(profiler.wallSeconds(), wall);
+
+    json s = profiler.summary();
+    EXPECT_EQ(s["threads"].get<int>(), 2);
+    EXPECT_EQ(s["phases"]["controls"]["calls"].get<int>(), 3);
+    EXPECT_FALSE(s["phases"].contains("output"));   // never ran
+    EXPECT_EQ(s["counters"]["factorizations"].get<int>(), 5);
+    EXPECT_FALSE(s.contains("traceEvents"));
+}
+
+TEST(Profiler, TransientRunCountsPhases) {
+    ModelInput model = smallModel();
+    model.transientConfig.airflowMethod = SolverMethod::SubRelaxation;
+    Profiler profiler;
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+    sim.setProfiler(&profiler);
+    TransientResult result = sim.run(model.network);
+    ASSERT_TRUE(result.completed);
+
+    const int64_t steps = profiler.counter(ProfileCounter::TimeSteps);
+    EXPECT_EQ(steps, 12);   // 1 h at 5 min
+    // One solve at start, one per step (no density coupling)
+    EXPECT_EQ(profiler.counter(ProfileCounter::AirflowSolves), steps + 1);
+    EXPECT_EQ(profiler.counter(ProfileCounter::OrderingCacheMisses), 1);
+    EXPECT_EQ(profiler.counter(ProfileCounter::OrderingCacheHits), steps);
+    int64_t newton = 0;
+    for (const auto& step : result.history) newton += step.airflow.iterations;
+    EXPECT_GE(profiler.counter(ProfileCounter::NewtonIterations), newton);
+    EXPECT_EQ(profiler.counter(ProfileCounter::TransportSolves), steps * 2);
+    EXPECT_EQ(profiler.calls(ProfilePhase::Output), static_cast<int64_t>(result.history.size()) + 2);
+    EXPECT_EQ(profiler.calls(ProfilePhase::Setup), 1);
+    EXPECT_GT(profiler.calls(ProfilePhase::Boundary), 0);   // AHS and occupant sources
+    EXPECT_GT(profiler.calls(ProfilePhase::AirflowFactor), 0);
+    EXPECT_GT(profiler.counter(ProfileCounter::AllocatedBytes), 0);
+
+    json s = profiler.summary();
+    EXPECT_LE(s["profiledSeconds"].get<double>(), s["wallSeconds"].get<double>() * 1.01);
+}
+
+TEST(Profiler, ProfileIsAddedToResults) {
+    ModelInput model = smallModel(1);
+    Profiler profiler;
+
+    std::ostringstream out;
+    auto sink = std::make_shared<JsonStreamWriter>(out);
+    sink->setProfile(&profiler);
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+    sim.setProfiler(&profiler);
+    sim.addResultSink(sink);
+    sim.setStoreHistory(false);
+    sim.run(model.network);
+
+    json doc = json::parse(out.str());
+    ASSERT_TRUE(doc.contains("profile"));
+    EXPECT_EQ(doc["profile"]["counters"]["timeSteps"].get<int>(), 12);
+    EXPECT_TRUE(doc["profile"]["phases"].contains("transport.solve"));
+
+    // Steady results
+    Profiler steadyProfiler;
+    Solver solver(SolverMethod::SubRelaxation);
+    solver.setProfiler(&steadyProfiler);
+    SolverResult r = solver.solve(model.network);
+    json steady = json::parse(JsonWriter::writeToString(model.network, r, -1, &steadyProfiler));
+    EXPECT_EQ(steady["profile"]["counters"]["newtonIterations"].get<int>(), r.iterations);
+    EXPECT_FALSE(json::parse(JsonWriter::writeToString(model.network, r)).contains("profile"));
+}
+
+TEST(Profiler, ChromeTrace) {
+    ModelInput model = smallModel(1);
+    Profiler profiler(true);
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+    sim.setProfiler(&profiler);
+    sim.run(model.network);
+
+    const std::string path = ::testing::TempDir() + "contam_profile_trace.json";
+    profiler.writeChromeTrace(path);
+    std::ifstream in(path);
+    json trace = json::parse(in);
+    std::remove(path.c_str());
+
+    const auto& events = trace["traceEvents"];
+    ASSERT_EQ(events.size(), profiler.traceEventCount() + 1);   // + process name
+    int airflow = 0;
+    for (const auto& e : events) {
+        if (e["ph"] != "X") continue;
+        EXPECT_GE(e["dur"].get<double>(), 0.0);
+        if (e["cat"] == "airflow") ++airflow;
+    }
+    EXPECT_GT(airflow, 0);
+    EXPECT_EQ(profiler.summary()["traceEvents"].get<std::size_t>(), profiler.traceEventCount());
+}
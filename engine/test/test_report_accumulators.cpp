@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+#include "test_models.h"
+#include "core/BatchSolve.h"
+#include "io/ReportAccumulators.h"
+#include "io/JsonReader.h"
+#include <algorithm>
+#include <memory>
+
+using namespace contam;
+using json = nlohmann::json;
+
+// The three-room model with HCHO as species id 1, also released in Room B,
+// and a CO2 sink in Room A, run for half an hour
+static ModelInput reportModel() {
+    json doc = test::threeRoomModel();
+    doc["species"][1]["id"] = 1;
+    doc["sources"].push_back({{"zoneId", 2}, {"speciesId", 1}, {"generationRate", 1e-6}});
+    doc["sources"].push_back({{"zoneId", 1}, {"speciesId", 0}, {"removalRate", 1e-4}});
+    doc["transient"]["endTime"] = 1800;
+    return JsonReader::readModelFromJson(doc);
+}
+
+struct AccumulatorRun {
+    ModelInput model;
+    std::shared_ptr<CsmAccumulator> csm;
+    std::shared_ptr<CexAccumulator> cex = std::make_shared<CexAccumulator>();
+    std::shared_ptr<EbwAccumulator> ebw;
+    std::shared_ptr<AchAccumulator> ach = std::make_shared<AchAccumulator>();
+    std::vector<Occupant> occupants{Occupant(1, "Resident", 1), Occupant(2, "Guest", 2, 2e-4)};
+    TransientResult result;
+
+    explicit AccumulatorRun(bool storeHistory) {
+        model = reportModel();
+        csm = std::make_shared<CsmAccumulator>(model.sources, model.schedules);
+        ebw = std::make_shared<EbwAccumulator>(occupants);
+        TransientSimulation sim;
+        configureSimulation(sim, model);
+        sim.setStoreHistory(storeHistory);
+        sim.addResultSink(csm);
+        sim.addResultSink(cex);
+        sim.addResultSink(ebw);
+        sim.addResultSink(ach);
+        result = sim.run(model.network);
+    }
+};
+
+TEST(ReportAccumulators, CsmClosesMassBalance) {
+    AccumulatorRun run(true);
+    ASSERT_TRUE(run.result.completed);
+    const auto& net = run.model.network;
+    const auto& history = run.result.history;
+    ASSERT_EQ(history.size(), 31u);   // t = 0 .. 1800 every 60 s
+
+    auto csm = run.csm->result();
+    ASSERT_EQ(csm.size(), 2u);
+    ASSERT_EQ(csm[0].zones.size(), 2u);
+
+    // Constant sources over the whole run: 1e-5 kg/s CO2 in Room A and
+    // 1e-6 kg/s HCHO in Room B for 1800 s
+    EXPECT_NEAR(csm[0].zones[0].totalEmission, 0.018, 1e-15);
+    EXPECT_EQ(csm[0].zones[1].totalEmission, 0.0);
+    EXPECT_EQ(csm[1].zones[0].totalEmission, 0.0);
+    EXPECT_NEAR(csm[1].zones[1].totalEmission, 1.8e-3, 1e-16);
+    EXPECT_NEAR(csm[0].totalBuildingEmission, 0.018, 1e-15);
+
+    // Removal R * V * C in Room A, exfiltration through link 12 (Room B ->
+    // Outdoor), both charged to the end of each 60 s step
+    const double densityB = net.getNode(2).getDensity();
+    double removal = 0.0;
+    double exfil[2] = {0.0, 0.0};
+    for (size_t s = 1; s < history.size(); ++s) {
+        const auto& step = history[s];
+        const double dt = step.time - history[s - 1].time;
+        EXPECT_GT(step.airflow.massFlows[0], 0.0);   // link 10 only ever flows inward
+        ASSERT_GT(step.airflow.massFlows[2], 0.0);
+        removal += 1e-4 * 50.0 * step.contaminant.concentrations[1][0] * dt;
+        for (int k = 0; k < 2; ++k) {
+            exfil[k] += step.airflow.massFlows[2] / densityB *
+                        step.contaminant.concentrations[2][k] * dt;
+        }
+    }
+    EXPECT_GT(removal, 0.0);
+    EXPECT_NEAR(csm[0].zones[0].totalRemoval, removal, 1e-12 * removal);
+    EXPECT_EQ(csm[1].totalBuildingRemoval, 0.0);
+    for (int k = 0; k < 2; ++k) {
+        EXPECT_GT(exfil[k], 0.0);
+        EXPECT_NEAR(csm[k].totalExfiltration, exfil[k], 1e-12 * exfil[k]);
+
+        // Everything emitted is removed, exfiltrated or still in the rooms
+        const auto& last = history.back().contaminant.concentrations;
+        const double held = 50.0 * last[1][k] + 30.0 * last[2][k];
+        EXPECT_NEAR(csm[k].totalBuildingEmission - csm[k].totalBuildingRemoval -
+                        csm[k].totalExfiltration,
+                    held, 1e-6 * csm[k].totalBuildingEmission);
+    }
+
+    // Statistics over all 31 recorded steps
+    for (int z = 0; z < 2; ++z) {
+        for (int k = 0; k < 2; ++k) {
+            double sum = 0.0, peak = 0.0, peakTime = 0.0;
+            for (const auto& step : history) {
+                double c = step.contaminant.concentrations[z + 1][k];
+                sum += c;
+                if (c > peak) {
+                    peak = c;
+                    peakTime = step.time;
+                }
+            }
+            const auto& zr = csm[k].zones[z];
+            EXPECT_NEAR(zr.avgConcentration, sum / history.size(), 1e-15);
+            EXPECT_DOUBLE_EQ(zr.peakConcentration, peak);
+            EXPECT_DOUBLE_EQ(zr.peakTime, peakTime);
+        }
+    }
+}
+
+TEST(ReportAccumulators, EbwChargesEachInterval) {
+    AccumulatorRun run(true);
+    const auto& history = run.result.history;
+    auto ebw = run.ebw->result();
+    ASSERT_EQ(ebw.size(), 4u);   // 2 occupants x 2 species
+
+    // Dose = breathing rate * concentration at the end of each interval * dt
+    for (size_t o = 0; o < run.occupants.size(); ++o) {
+        const Occupant& occ = run.occupants[o];
+        for (int k = 0; k < 2; ++k) {
+            double dose = 0.0;
+            for (size_t s = 1; s < history.size(); ++s) {
+                dose += occ.breathingRate * history[s].contaminant.concentrations[occ.currentZoneIdx][k] *
+                        (history[s].time - history[s - 1].time);
+            }
+            const auto& ex = ebw[o * 2 + k];
+            EXPECT_EQ(ex.occupantId, occ.id);
+            EXPECT_NEAR(ex.cumulativeDose, dose, 1e-12 * dose);
+        }
+    }
+    EXPECT_GT(ebw[0].cumulativeDose, 0.0);
+}
+
+TEST(ReportAccumulators, AchResultIsLastStep) {
+    AccumulatorRun run(true);
+    auto achRef = AchReport::compute(run.model.network, run.result.history.back().airflow.massFlows);
+    EXPECT_EQ(AchReport::formatCsv(run.ach->result()), AchReport::formatCsv(achRef));
+}
+
+TEST(ReportAccumulators, WorkWithoutHistory) {
+    AccumulatorRun full(true);
+    AccumulatorRun streamed(false);
+    ASSERT_TRUE(streamed.result.completed);
+    EXPECT_TRUE(streamed.result.history.empty());
+
+    EXPECT_EQ(CsmReport::formatCsv(streamed.csm->result()),
+              CsmReport::formatCsv(full.csm->result()));
+    EXPECT_EQ(CexReport::formatCsv(streamed.cex->result()),
+              CexReport::formatCsv(full.cex->result()));
+    EXPECT_EQ(EbwReport::formatCsv(streamed.ebw->result(), streamed.model.species),
+              EbwReport::formatCsv(full.ebw->result(), full.model.species));
+}
+
+TEST(ReportAccumulators, CexMatchesPerStepIntegration) {
+    AccumulatorRun run(true);
+    const auto& net = run.model.network;
+    const auto& history = run.result.history;
+
+    // Link 12 (index 2) runs Room B -> Outdoor
+    const double density = net.getNode(2).getDensity();
+    double total = 0.0;
+    for (size_t s = 1; s < history.size(); ++s) {
+        auto rate = [&](const TimeStepResult& step) {
+            double mf = step.airflow.massFlows[2];
+            return mf > 0.0 ? mf / density * step.contaminant.concentrations[2][1] : 0.0;
+        };
+        total += 0.5 * (rate(history[s - 1]) + rate(history[s])) *
+                 (history[s].time - history[s - 1].time);
+    }
+
+    auto cex = run.cex->result();
+    ASSERT_EQ(cex.size(), 2u);
+    ASSERT_EQ(cex[1].openings.size(), 2u);
+    EXPECT_EQ(cex[1].openings[1].linkId, 12);
+    EXPECT_GT(total, 0.0);
+    EXPECT_NEAR(cex[1].openings[1].totalMassExfiltrated, total, 1e-12 * total);
+}
+
+TEST(ReportAccumulators, AchStatistics) {
+    AccumulatorRun run(true);
+    auto stats = run.ach->statistics();
+    ASSERT_EQ(stats.size(), 2u);
+    EXPECT_EQ(stats[0].zoneName, "Room A");
+    EXPECT_EQ(stats[0].samples, run.result.history.size());
+
+    double sum = 0.0, lo = 1e300, hi = -1e300;
+    for (const auto& step : run.result.history) {
+        double ach = AchReport::compute(run.model.network, step.airflow.massFlows)[1].totalAch;
+        sum += ach;
+        lo = std::min(lo, ach);
+        hi = std::max(hi, ach);
+    }
+    EXPECT_NEAR(stats[1].meanAch, sum / run.result.history.size(), 1e-12);
+    EXPECT_DOUBLE_EQ(stats[1].minAch, lo);
+    EXPECT_DOUBLE_EQ(stats[1].maxAch, hi);
+    EXPECT_GT(stats[0].meanInfiltrationAch, 0.0);   // Room A draws from outdoors
+    EXPECT_GT(stats[1].meanMechanicalAch, 0.0);     // Room B is fed by Room A
+}
+
+TEST(ReportAccumulators, RejectFilteredOutput) {
+    auto model = reportModel();
+    OutputSpec spec;
+    spec.nodeIds = {2};
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+    sim.setOutputSpec(spec);
+    sim.addResultSink(std::make_shared<CsmAccumulator>());
+    EXPECT_THROW(sim.run(model.network), std::runtime_error);
+}
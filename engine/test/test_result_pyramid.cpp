@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include "core/BatchSolve.h"
+#include "io/ResultPyramid.h"
+#include "io/JsonReader.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+
+using namespace contam;
+
+static std::string tempPath(const std::string& name) {
+    return testing::TempDir() + name;
+}
+
+// One node whose pressure equals the step index; every 7th step is NaN
+static TimeStepResult rampStep(std::size_t i) {
+    TimeStepResult step{};
+    step.time = 60.0 * i;
+    double p = static_cast<double>(i);
+    if (i % 7 == 3) p = std::numeric_limits<double>::quiet_NaN();
+    step.airflow.pressures = {p};
+    return step;
+}
+
+static Network rampNetwork() {
+    Network network;
+    network.addNode(Node(0, "Out", NodeType::Ambient));
+    return network;
+}
+
+static ResultPyramid buildRamp(std::size_t steps) {
+    ResultPyramid pyr;
+    pyr.begin(rampNetwork(), {}, OutputSelection{});
+    for (std::size_t i = 0; i < steps; ++i) pyr.onStep(rampStep(i));
+    pyr.end(true);
+    return pyr;
+}
+
+static std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+TEST(ResultPyramid, LevelsAndStatistics) {
+    auto pyr = buildRamp(2500);
+    EXPECT_EQ(pyr.numBins(0), 2500u);
+    EXPECT_EQ(pyr.numBins(1), 250u);
+    EXPECT_EQ(pyr.numBins(2), 25u);
+    EXPECT_EQ(pyr.numBins(3), 3u);   // two full bins and a partial one
+
+    // Steps 0..9, step 3 is NaN
+    auto b = pyr.bin(1, 0, 0);
+    EXPECT_DOUBLE_EQ(b.tStart, 0.0);
+    EXPECT_DOUBLE_EQ(b.tEnd, 540.0);
+    EXPECT_FLOAT_EQ(b.min, 0.0f);
+    EXPECT_FLOAT_EQ(b.max, 9.0f);
+    EXPECT_FLOAT_EQ(b.mean, (45.0f - 3.0f) / 9.0f);
+
+    // Mean of the partial top bin is weighted by sample count, not bin count
+    auto top = pyr.bin(3, 2, 0);
+    double sum = 0.0;
+    int count = 0;
+    for (int i = 2000; i < 2500; ++i) {
+        if (i % 7 == 3) continue;
+        sum += i;
+        ++count;
+    }
+    EXPECT_DOUBLE_EQ(top.tStart, 60.0 * 2000);
+    EXPECT_DOUBLE_EQ(top.tEnd, 60.0 * 2499);
+    EXPECT_FLOAT_EQ(top.min, 2000.0f);
+    EXPECT_FLOAT_EQ(top.max, 2499.0f);
+    EXPECT_NEAR(top.mean, sum / count, 1e-3);
+}
+
+TEST(ResultPyramid, QueryPicksLevel) {
+    auto pyr = buildRamp(2500);
+    const double tEnd = 60.0 * 2499;
+
+    auto wide = pyr.query(0, 0.0, tEnd, 20);
+    EXPECT_EQ(wide.level, 2);
+    EXPECT_EQ(wide.bins.size(), 25u);
+
+    auto coarse = pyr.query(0, 0.0, tEnd, 2);
+    EXPECT_EQ(coarse.level, 3);
+
+    // Window covering bins 10..19 of the x10 level
+    auto narrow = pyr.query(0, 6000.0, 11940.0, 10);
+    EXPECT_EQ(narrow.level, 1);
+    ASSERT_EQ(narrow.bins.size(), 10u);
+    EXPECT_DOUBLE_EQ(narrow.bins.front().tStart, 6000.0);
+
+    // Too few bins at every level and no full-resolution source
+    auto fine = pyr.query(0, 0.0, 3000.0, 500);
+    EXPECT_EQ(fine.level, 1);
+
+    EXPECT_TRUE(pyr.query(0, 100.0, 50.0, 10).bins.empty());
+    EXPECT_THROW(pyr.query(1, 0.0, tEnd, 10), std::out_of_range);
+}
+
+TEST(ResultPyramid, SaveLoadRoundTrip) {
+    auto pyr = buildRamp(1234);
+    const std::string path = tempPath("pyramid_roundtrip.crp");
+    pyr.save(path);
+
+    auto loaded = ResultPyramid::load(path);
+    EXPECT_EQ(loaded.numSteps(), 1234u);
+    for (int level = 1; level <= 3; ++level) {
+        ASSERT_EQ(loaded.numBins(level), pyr.numBins(level));
+        for (std::size_t i = 0; i < pyr.numBins(level); ++i) {
+            EXPECT_FLOAT_EQ(loaded.bin(level, i, 0).mean, pyr.bin(level, i, 0).mean);
+        }
+    }
+    std::remove(path.c_str());
+}
+
+TEST(ResultPyramid, StreamsBinsToFile) {
+    const std::string inMemory = tempPath("pyramid_memory.crp");
+    const std::string streamed = tempPath("pyramid_streamed.crp");
+    buildRamp(23456).save(inMemory);
+
+    ResultPyramid sink(streamed);
+    sink.begin(rampNetwork(), {}, OutputSelection{});
+    std::size_t early = 0;
+    for (std::size_t i = 0; i < 23456; ++i) {
+        sink.onStep(rampStep(i));
+        if (i == 100) early = sink.memoryBytes();
+    }
+    // Finished bins leave memory as they complete
+    EXPECT_EQ(sink.memoryBytes(), early);
+    EXPECT_EQ(sink.numBins(1), 0u);
+    sink.end(true);
+
+    EXPECT_EQ(readFile(streamed), readFile(inMemory));
+    EXPECT_FALSE(std::ifstream(streamed + ".spill1").good());
+    auto loaded = ResultPyramid::load(streamed);
+    EXPECT_EQ(loaded.numBins(1), 2346u);
+    EXPECT_EQ(loaded.numBins(3), 24u);
+    std::remove(inMemory.c_str());
+    std::remove(streamed.c_str());
+}
+
+TEST(ResultPyramid, SinkWithFullResolutionFallback) {
+    auto model = JsonReader::readModelFromString(R"({
+        "flowElements": { "crack": { "type": "PowerLawOrifice", "C": 0.001, "n": 0.65 } },
+        "nodes": [
+            { "id": 0, "name": "Outdoor", "type": "ambient", "temperature": 283.15 },
+            { "id": 1, "name": "Room", "temperature": 293.15, "volume": 50.0 }
+        ],
+        "links": [ { "id": 1, "from": 0, "to": 1, "elevation": 0.5, "element": "crack" } ],
+        "species": [ { "id": 0, "name": "CO2", "molarMass": 0.044 } ],
+        "sources": [ { "zoneId": 1, "speciesId": 0, "generationRate": 1e-5 } ],
+        "transient": { "endTime": 3600, "timeStep": 60, "outputInterval": 60 }
+    })");
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+
+    const std::string crs = tempPath("pyramid_full.crs");
+    const std::string crp = tempPath("pyramid_full.crp");
+    sim.addResultSink(std::make_shared<ColumnarResultsWriter>(crs));
+    sim.addResultSink(std::make_shared<ResultPyramid>(crp));
+    sim.setStoreHistory(false);
+    ASSERT_TRUE(sim.run(model.network).completed);
+
+    auto pyr = ResultPyramid::load(crp);
+    ColumnarResultsReader full(crs);
+    EXPECT_EQ(pyr.numSteps(), 61u);
+    EXPECT_EQ(pyr.numBins(1), 7u);
+
+    const std::size_t co2 = pyr.layout().concentration(1, 0);
+    auto q = pyr.query(co2, 0.0, 3600.0, 30, &full);
+    EXPECT_EQ(q.level, 0);
+    ASSERT_EQ(q.bins.size(), 61u);
+    EXPECT_FLOAT_EQ(q.bins.back().mean, full.concentration(1, 0)[60]);
+    EXPECT_GE(pyr.bin(1, 6, co2).max, pyr.bin(1, 0, co2).max);
+
+    std::remove(crs.c_str());
+    std::remove(crp.c_str());
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include "test_models.h"
+#include "core/BatchSolve.h"
+#include "io/ResultRecorder.h"
+#include "io/JsonReader.h"
+#include <cmath>
+#include <memory>
+
+using namespace contam;
+using json = nlohmann::json;
+
+// The three-room model with HCHO as species id 1
+static ModelInput recorderModel() {
+    json doc = test::threeRoomModel();
+    doc["species"][1]["id"] = 1;
+    return JsonReader::readModelFromJson(doc);
+}
+
+static TransientResult runRecorded(const std::shared_ptr<ResultRecorder>& rec,
+                                   const OutputSpec& spec = {}) {
+    auto model = recorderModel();
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+    sim.setOutputSpec(spec);
+    sim.addResultSink(rec);
+    return sim.run(model.network);
+}
+
+TEST(ResultRecorder, ContiguousCopyOfHistory) {
+    auto rec = std::make_shared<ResultRecorder>(16);
+    auto result = runRecorded(rec);
+    ASSERT_TRUE(result.completed);
+    EXPECT_FALSE(rec->recording());
+    EXPECT_TRUE(rec->completed());
+
+    auto r = rec->results();
+    ASSERT_EQ(r->numSteps(), 11u);
+    ASSERT_EQ(r->numNodes, 3u);
+    ASSERT_EQ(r->numLinks, 3u);
+    ASSERT_EQ(r->numSpecies, 2u);
+    ASSERT_EQ(r->concentrations.size(), 11u * 3u * 2u);
+
+    for (std::size_t t = 0; t < r->numSteps(); ++t) {
+        const auto& step = result.history[t];
+        EXPECT_EQ(r->times[t], step.time);
+        EXPECT_EQ(r->iterations[t], step.airflow.iterations);
+        for (std::size_t i = 0; i < 3; ++i) {
+            EXPECT_EQ(r->pressures[t * 3 + i], step.airflow.pressures[i]);
+            EXPECT_EQ(r->massFlows[t * 3 + i], step.airflow.massFlows[i]);
+            for (std::size_t k = 0; k < 2; ++k) {
+                EXPECT_EQ(r->concentrations[(t * 3 + i) * 2 + k],
+                          step.contaminant.concentrations[i][k]);
+            }
+        }
+    }
+}
+
+TEST(ResultRecorder, NewRunKeepsEarlierResults) {
+    auto rec = std::make_shared<ResultRecorder>();
+    runRecorded(rec);
+    auto first = rec->results();
+    const double* data = first->concentrations.data();
+
+    OutputSpec spec;
+    spec.nodeIds = {2};
+    spec.pressureInterval = 120.0;
+    runRecorded(rec, spec);
+    auto second = rec->results();
+
+    EXPECT_NE(first, second);
+    EXPECT_EQ(first->concentrations.data(), data);
+    EXPECT_EQ(first->numNodes, 3u);
+
+    // Filtered run: one node, pressures only every other output step
+    ASSERT_EQ(second->numNodes, 1u);
+    ASSERT_EQ(second->pressures.size(), 11u);
+    EXPECT_FALSE(std::isnan(second->pressures[0]));
+    EXPECT_TRUE(std::isnan(second->pressures[1]));
+    EXPECT_FALSE(std::isnan(second->pressures[2]));
+    EXPECT_EQ(second->output.node(0), 2);
+}
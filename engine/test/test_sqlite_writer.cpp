@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "test_models.h"
+#include "core/BatchSolve.h"
+
+#ifdef CONTAM_HAS_SQLITE3
+
+#include "io/SqliteWriter.h"
+#include "io/JsonReader.h"
+#include <sqlite3.h>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+using namespace contam;
+using json = nlohmann::json;
+
+// The three-room model with CO2 only and a name that needs SQL quoting
+static ModelInput sqliteModel() {
+    json doc = test::threeRoomModel();
+    doc["nodes"][1]["name"] = "Owner's Room";
+    doc["species"].erase(1);
+    return JsonReader::readModelFromJson(doc);
+}
+
+// Run a query returning a single row; the callback reads its columns
+template <typename F>
+static void queryRow(const std::string& path, const char* sql, F&& read) {
+    sqlite3* db = nullptr;
+    ASSERT_EQ(sqlite3_open(path.c_str(), &db), SQLITE_OK);
+    sqlite3_stmt* st = nullptr;
+    ASSERT_EQ(sqlite3_prepare_v2(db, sql, -1, &st, nullptr), SQLITE_OK) << sqlite3_errmsg(db);
+    ASSERT_EQ(sqlite3_step(st), SQLITE_ROW) << sql;
+    read(st);
+    sqlite3_finalize(st);
+    sqlite3_close(db);
+}
+
+static TransientResult runWithSink(const std::string& path, const SqliteOptions& options) {
+    auto model = sqliteModel();
+    TransientSimulation sim;
+    configureSimulation(sim, model);
+    std::remove(path.c_str());
+    auto sink = std::make_shared<SqliteWriter>(path, options);
+    sim.addResultSink(sink);
+    return sim.run(model.network);
+}
+
+TEST(SqliteWriter, LongSchemaSink) {
+    const std::string path = testing::TempDir() + "sqlite_long.db";
+    SqliteOptions options;
+    options.batchRows = 7;   // many small transactions
+    auto result = runWithSink(path, options);
+    ASSERT_TRUE(result.completed);
+
+    queryRow(path, "SELECT COUNT(*) FROM transient", [](sqlite3_stmt* st) {
+        EXPECT_EQ(sqlite3_column_int(st, 0), 11 * 3);
+    });
+    queryRow(path, "SELECT COUNT(*) FROM transient_conc", [](sqlite3_stmt* st) {
+        EXPECT_EQ(sqlite3_column_int(st, 0), 11 * 3);
+    });
+    const double expected = result.history[5].contaminant.concentrations[1][0];
+    queryRow(path, "SELECT concentration FROM transient_conc WHERE time = 300 AND node_id = 1",
+             [&](sqlite3_stmt* st) { EXPECT_DOUBLE_EQ(sqlite3_column_double(st, 0), expected); });
+    queryRow(path, "SELECT name FROM nodes WHERE id = 1", [](sqlite3_stmt* st) {
+        EXPECT_STREQ(reinterpret_cast<const char*>(sqlite3_column_text(st, 0)), "Owner's Room");
+    });
+    queryRow(path, "SELECT value FROM metadata WHERE key = 'completed'", [](sqlite3_stmt* st) {
+        EXPECT_STREQ(reinterpret_cast<const char*>(sqlite3_column_text(st, 0)), "true");
+    });
+    queryRow(path, "SELECT COUNT(*) FROM sqlite_master WHERE type = 'index' AND name LIKE 'idx_%'",
+             [](sqlite3_stmt* st) { EXPECT_EQ(sqlite3_column_int(st, 0), 3); });
+    queryRow(path, "PRAGMA journal_mode", [](sqlite3_stmt* st) {
+        EXPECT_STREQ(reinterpret_cast<const char*>(sqlite3_column_text(st, 0)), "wal");
+    });
+    std::remove(path.c_str());
+}
+
+TEST(SqliteWriter, BlobSchemaSink) {
+    const std::string path = testing::TempDir() + "sqlite_blob.db";
+    SqliteOptions options;
+    options.schema = SqliteSchema::Blob;
+    auto result = runWithSink(path, options);
+    ASSERT_TRUE(result.completed);
+
+    queryRow(path, "SELECT COUNT(*) FROM transient_steps", [](sqlite3_stmt* st) {
+        EXPECT_EQ(sqlite3_column_int(st, 0), 11);
+    });
+    const auto& step = result.history.back();
+    queryRow(path, "SELECT pressures, concentrations FROM transient_steps WHERE time = 600",
+             [&](sqlite3_stmt* st) {
+        ASSERT_EQ(sqlite3_column_bytes(st, 0), static_cast<int>(3 * sizeof(double)));
+        double p[3];
+        std::memcpy(p, sqlite3_column_blob(st, 0), sizeof(p));
+        EXPECT_DOUBLE_EQ(p[2], step.airflow.pressures[2]);
+        ASSERT_EQ(sqlite3_column_bytes(st, 1), static_cast<int>(3 * sizeof(double)));
+        double c[3];
+        std::memcpy(c, sqlite3_column_blob(st, 1), sizeof(c));
+        EXPECT_DOUBLE_EQ(c[1], step.contaminant.concentrations[1][0]);
+    });
+    queryRow(path, "SELECT value FROM metadata WHERE key = 'blob_format'", [](sqlite3_stmt* st) {
+        EXPECT_STREQ(reinterpret_cast<const char*>(sqlite3_column_text(st, 0)), "float64");
+    });
+    std::remove(path.c_str());
+}
+
+TEST(SqliteWriter, RunningTwiceReplacesResults) {
+    const std::string path = testing::TempDir() + "sqlite_twice.db";
+    std::remove(path.c_str());
+    auto model = sqliteModel();
+    auto count = [&](const char* sql, int expected) {
+        queryRow(path, sql, [&](sqlite3_stmt* st) { EXPECT_EQ(sqlite3_column_int(st, 0), expected) << sql; });
+    };
+
+    // Two runs through one writer
+    {
+        TransientSimulation sim;
+        configureSimulation(sim, model);
+        sim.addResultSink(std::make_shared<SqliteWriter>(path));
+        ASSERT_TRUE(sim.run(model.network).completed);
+        ASSERT_TRUE(sim.run(model.network).completed);
+    }
+    count("SELECT COUNT(*) FROM transient", 11 * 3);
+    count("SELECT COUNT(*) FROM transient_conc", 11 * 3);
+    count("SELECT COUNT(*) FROM nodes", 3);
+    count("SELECT COUNT(*) FROM metadata WHERE key = 'schema'", 1);
+
+    // New writers on the existing file, switching schema and back
+    for (SqliteSchema schema : {SqliteSchema::Blob, SqliteSchema::Long}) {
+        TransientSimulation sim;
+        configureSimulation(sim, model);
+        SqliteOptions options;
+        options.schema = schema;
+        sim.addResultSink(std::make_shared<SqliteWriter>(path, options));
+        ASSERT_TRUE(sim.run(model.network).completed);
+    }
+    count("SELECT COUNT(*) FROM transient", 11 * 3);
+    count("SELECT COUNT(*) FROM transient_flows", 11 * 3);
+    count("SELECT COUNT(*) FROM sqlite_master WHERE name = 'transient_steps'", 0);
+    queryRow(path, "SELECT value FROM metadata WHERE key = 'schema'", [](sqlite3_stmt* st) {
+        EXPECT_STREQ(reinterpret_cast<const char*>(sqlite3_column_text(st, 0)), "long");
+    });
+    std::remove(path.c_str());
+}
+
+#endif // CONTAM_HAS_SQLITE3
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include "core/TransientSimulation.h"
+#include "elements/PowerLawOrifice.h"
+#include "io/StreamEventWriter.h"
+#include <nlohmann/json.hpp>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace contam;
+using json = nlohmann::json;
+
+static Network makeVentedRoom() {
+    Network net;
+    Node outdoor(0, "Outdoor", NodeType::Ambient);
+    outdoor.setTemperature(283.15);
+    net.addNode(outdoor);
+
+    Node room(3, "Room");
+    room.setTemperature(293.15);
+    room.setVolume(30.0);
+    net.addNode(room);
+
+    Link l1(7, 0, 1, 0.5);
+    l1.setFlowElement(std::make_unique<PowerLawOrifice>(0.003, 0.65));
+    net.addLink(std::move(l1));
+
+    Link l2(8, 1, 0, 2.5);
+    l2.setFlowElement(std::make_unique<PowerLawOrifice>(0.003, 0.65));
+    net.addLink(std::move(l2));
+    return net;
+}
+
+static std::vector<json> parseLines(const std::string& text) {
+    std::vector<json> events;
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) events.push_back(json::parse(line));
+    return events;
+}
+
+TEST(StreamEvents, TransientRun) {
+    Network net = makeVentedRoom();
+    TransientSimulation sim;
+    TransientConfig config;
+    config.endTime = 1800;
+    config.timeStep = 60;
+    config.outputInterval = 60;   // 31 output steps
+    sim.setConfig(config);
+    sim.setSpecies({Species(0, "CO2", 0.044, 0.0, 7.2e-4)});
+    sim.setSources({Source(3, 0, 5e-6)});
+
+    StreamEventOptions options;
+    options.endTime = config.endTime;
+    options.minInterval = 0.0;
+    options.frameStride = 7;
+    options.nodeIds = {3};
+    std::ostringstream out;
+    auto events = std::make_shared<StreamEventWriter>(out, options);
+    sim.addResultSink(events);
+    sim.setProgressCallback([&](double t, double end) { return events->progress(t, end); });
+    sim.setStoreHistory(false);
+    ASSERT_TRUE(sim.run(net).completed);
+
+    auto lines = parseLines(out.str());
+    ASSERT_FALSE(lines.empty());
+    EXPECT_EQ(lines.front()["event"], "start");
+    EXPECT_EQ(lines.front()["nodes"], json::array({3}));
+    EXPECT_EQ(lines.front()["links"], json::array({7, 8}));
+
+    std::vector<json> frames, progress;
+    for (const auto& ev : lines) {
+        if (ev["event"] == "frame") frames.push_back(ev);
+        if (ev["event"] == "progress") progress.push_back(ev);
+    }
+    // Steps 0, 7, 14, 21, 28 and the last one (30)
+    ASSERT_EQ(frames.size(), 6u);
+    EXPECT_DOUBLE_EQ(frames[1]["time"].get<double>(), 420.0);
+    EXPECT_DOUBLE_EQ(frames.back()["time"].get<double>(), 1800.0);
+    EXPECT_EQ(frames.back()["pressures"].size(), 1u);
+    EXPECT_EQ(frames.back()["massFlows"].size(), 2u);
+    EXPECT_GT(frames.back()["concentrations"][0][0].get<double>(),
+              frames.front()["concentrations"][0][0].get<double>());
+
+    ASSERT_EQ(progress.size(), 30u);
+    EXPECT_DOUBLE_EQ(progress.back()["fraction"].get<double>(), 1.0);
+    EXPECT_DOUBLE_EQ(progress.back()["eta"].get<double>(), 0.0);
+
+    const json& last = lines.back();
+    EXPECT_EQ(last["event"], "end");
+    EXPECT_TRUE(last["completed"].get<bool>());
+    EXPECT_EQ(last["outputSteps"], 31);
+    EXPECT_EQ(last["frames"], 6);
+    const json& solver = lines[lines.size() - 2];
+    EXPECT_EQ(solver["event"], "solver");
+    EXPECT_EQ(solver["unconverged"], 0);
+}
+
+TEST(StreamEvents, UnknownSeriesId) {
+    Network net = makeVentedRoom();
+    TransientSimulation sim;
+    TransientConfig config;
+    config.endTime = 60;
+    config.timeStep = 60;
+    sim.setConfig(config);
+
+    StreamEventOptions options;
+    options.linkIds = {42};
+    std::ostringstream out;
+    sim.addResultSink(std::make_shared<StreamEventWriter>(out, options));
+    EXPECT_THROW(sim.run(net), std::runtime_error);
+}
+
+TEST(StreamEvents, EndChartsLatestSkippedStep) {
+    Network net = makeVentedRoom();
+    std::vector<Species> species{Species(0, "CO2", 0.044)};
+    StreamEventOptions options;
+    options.frameStride = 10;
+    std::ostringstream out;
+    StreamEventWriter events(out, options);
+    events.begin(net, species, OutputSelection());
+
+    // Skipped steps are kept, not serialized; reusing one buffer for every
+    // step must not leak into the frame written by end()
+    TimeStepResult step{};
+    step.airflow.pressures = {0.0, 0.0};
+    step.airflow.massFlows = {0.0, 0.0};
+    step.contaminant.concentrations = {{0.0}, {0.0}};
+    for (int k = 0; k < 5; ++k) {
+        step.time = 60.0 * k;
+        step.airflow.pressures[1] = -0.5 * k;
+        step.contaminant.concentrations[1][0] = 1e-4 * k;
+        events.onStep(step);
+    }
+    const std::size_t held = events.memoryBytes();
+    step.time = 999.0;
+    step.contaminant.concentrations[1][0] = 1.0;
+    events.end(true);
+
+    std::vector<json> frames;
+    for (const auto& ev : parseLines(out.str())) {
+        if (ev["event"] == "frame") frames.push_back(ev);
+    }
+    ASSERT_EQ(frames.size(), 2u);   // step 0 and the last one
+    EXPECT_DOUBLE_EQ(frames[1]["time"].get<double>(), 240.0);
+    EXPECT_DOUBLE_EQ(frames[1]["pressures"][1].get<double>(), -2.0);
+    EXPECT_DOUBLE_EQ(frames[1]["concentrations"][1][0].get<double>(), 4e-4);
+    EXPECT_GT(held, 0u);
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "core/BatchSolve.h"
+#include "core/Sweep.h"
+#include "io/JsonReader.h"
+#include "io/JsonWriter.h"
+#include "io/ModelCache.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <stdexcept>
+
+using namespace contam;
+
+static const std::string SWEEP_MODEL_JSON = R"({
+    "nodes": [
+        { "id": 0, "name": "Outdoor", "type": "ambient", "temperature": 283.15 },
+        { "id": 1, "name": "Room", "temperature": 293.15, "volume": 40.0 }
+    ],
+    "links": [
+        { "id": 10, "from": 0, "to": 1, "elevation": 1.0,
+          "element": { "type": "Fan", "maxFlow": 0.05, "shutoffPressure": 200.0 } },
+        { "id": 11, "from": 1, "to": 0, "elevation": 2.0,
+          "element": { "type": "PowerLawOrifice", "C": 0.006, "n": 0.65 } }
+    ],
+    "sweep": {
+        "method": "grid",
+        "parameters": [
+            { "name": "fan_speed:10", "min": 0.5, "max": 1.5, "steps": 3 },
+            { "name": "orifice_c:11", "values": [0.004, 0.008] }
+        ]
+    }
+})";
+
+// ── Expansion ────────────────────────────────────────────────────────
+
+TEST(Sweep, GridExpansion) {
+    SweepSpec spec;
+    spec.parameters = {{"a", {}, 1.0, 3.0, 3, false}, {"b", {10.0, 20.0}, 0, 0, 0, false}};
+    SweepPlan plan = expandSweep(spec);
+    ASSERT_EQ(plan.numVariants, 6u);
+    EXPECT_EQ(plan.names, (std::vector<std::string>{"a", "b"}));
+    // First parameter slowest
+    EXPECT_EQ(std::vector<double>(plan.row(0), plan.row(0) + 2), (std::vector<double>{1.0, 10.0}));
+    EXPECT_EQ(std::vector<double>(plan.row(1), plan.row(1) + 2), (std::vector<double>{1.0, 20.0}));
+    EXPECT_EQ(std::vector<double>(plan.row(5), plan.row(5) + 2), (std::vector<double>{3.0, 20.0}));
+
+    spec.parameters = {{"c", {}, 1.0, 100.0, 3, true}};
+    plan = expandSweep(spec);
+    EXPECT_NEAR(plan.values[1], 10.0, 1e-9);
+
+    spec.parameters = {{"d", {}, 1.0, 2.0, 0, false}};
+    EXPECT_THROW(expandSweep(spec), std::runtime_error);
+    EXPECT_THROW(expandSweep(SweepSpec{}), std::runtime_error);
+}
+
+TEST(Sweep, LatinHypercubeStratifies) {
+    SweepSpec spec;
+    spec.method = SweepMethod::LatinHypercube;
+    spec.samples = 20;
+    spec.seed = 7;
+    spec.parameters = {{"a", {}, 0.0, 1.0, 0, false}, {"b", {}, 10.0, 30.0, 0, false}};
+    SweepPlan plan = expandSweep(spec);
+    ASSERT_EQ(plan.numVariants, 20u);
+
+    // Every parameter has exactly one sample in each of the 20 strata
+    for (std::size_t p = 0; p < 2; ++p) {
+        const double lo = p == 0 ? 0.0 : 10.0, span = p == 0 ? 1.0 : 20.0;
+        std::set<int> strata;
+        for (std::size_t v = 0; v < 20; ++v) {
+            strata.insert(static_cast<int>((plan.row(v)[p] - lo) / span * 20.0));
+        }
+        EXPECT_EQ(strata.size(), 20u);
+    }
+
+    EXPECT_EQ(expandSweep(spec).values, plan.values);   // reproducible
+    spec.seed = 8;
+    EXPECT_NE(expandSweep(spec).values, plan.values);
+}
+
+// ── Runs ─────────────────────────────────────────────────────────────
+
+TEST(Sweep, SteadyVariantsMatchIndividualSolves) {
+    auto model = JsonReader::readModelFromString(SWEEP_MODEL_JSON);
+    ThreadPool pool(3);
+    SweepResult result = runSweep(model, pool);
+    ASSERT_EQ(result.variants.size(), 6u);
+    EXPECT_FALSE(result.transient);
+
+    auto params = parseBatchParameters(result.plan.names, model);
+    for (std::size_t v = 0; v < 6; ++v) {
+        const auto& r = result.variants[v];
+        ASSERT_TRUE(r.ok) << r.error;
+        Network net = model.network;
+        std::vector<Source> sources;
+        for (std::size_t p = 0; p < params.size(); ++p) params[p].apply(net, sources, result.plan.row(v)[p]);
+        SolverResult expected = Solver().solve(net);
+        // Warm and cold starts agree to within the convergence tolerance
+        EXPECT_NEAR(r.massFlows[0], expected.massFlows[0], 5e-5) << "variant " << v;
+    }
+    // Faster fan, same orifice: more flow
+    EXPECT_GT(result.variants[4].massFlows[0], result.variants[0].massFlows[0]);
+
+    auto doc = nlohmann::json::parse(JsonWriter::writeSweepToString(model, result));
+    EXPECT_EQ(doc["sweep"]["variants"], 6);
+    EXPECT_EQ(doc["variants"][5]["values"][1], 0.008);
+    EXPECT_TRUE(doc["variants"][5]["converged"].get<bool>());
+}
+
+TEST(Sweep, TransientSourceRates) {
+    auto j = nlohmann::json::parse(SWEEP_MODEL_JSON);
+    j["species"] = {{{"id", 0}, {"name", "CO2"}, {"molarMass", 0.044}}};
+    j["sources"] = {{{"zoneId", 1}, {"speciesId", 0}, {"generationRate", 1e-5}}};
+    j["transient"] = {{"endTime", 1200}, {"timeStep", 60}, {"outputInterval", 120}};
+    j["sweep"] = {{"method", "lhs"}, {"samples", 4}, {"seed", 3},
+                  {"parameters", {{{"name", "source_rate:0"}, {"min", 1e-6}, {"max", 1e-5}}}}};
+    auto model = JsonReader::readModelFromString(j.dump());
+
+    // The sweep survives the model cache
+    auto cached = ModelCache::deserialize(ModelCache::serialize(model));
+    ASSERT_EQ(cached.sweep.parameters.size(), 1u);
+    EXPECT_EQ(cached.sweep.method, SweepMethod::LatinHypercube);
+    EXPECT_EQ(cached.sweep.samples, 4);
+
+    ThreadPool pool(2);
+    SweepResult result = runSweep(cached, pool);
+    ASSERT_TRUE(result.transient);
+    ASSERT_EQ(result.variants.size(), 4u);
+    for (std::size_t v = 0; v < 4; ++v) {
+        const auto& r = result.variants[v];
+        ASSERT_TRUE(r.ok) << r.error;
+        EXPECT_EQ(r.outputSteps, 11u);
+        ASSERT_EQ(r.peakConcentrations.size(), 2u);   // 2 nodes x 1 species
+        // Linear in the source rate
+        EXPECT_NEAR(r.finalConcentrations[1] / result.plan.row(v)[0],
+                    result.variants[0].finalConcentrations[1] / result.plan.row(0)[0], 1e-6);
+        EXPECT_LE(r.meanConcentrations[1], r.peakConcentrations[1]);
+    }
+
+    model.sweep.parameters[0].name = "source_rate:3";
+    EXPECT_THROW(runSweep(model, pool), std::runtime_error);
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "io/TextTokenizer.h"
+#include "io/CvfReader.h"
+#include "io/WpcReader.h"
+#include "io/WeatherReader.h"
+#include "io/ContaminantReader.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace contam;
+
+static std::string tempPath(const std::string& ext) {
+    return std::string("_test_text_tokenizer") + ext;
+}
+
+// ── LineTokenizer ────────────────────────────────────────────────────
+
+TEST(LineTokenizer, NumbersAndLineNumbers) {
+    LineTokenizer tok("# header\n\n  1.5  -2e3 +4\r\n7 x\n");
+    ASSERT_TRUE(tok.nextLine());
+    EXPECT_TRUE(tok.isBlankOrComment("#"));
+    ASSERT_TRUE(tok.nextLine());
+    EXPECT_TRUE(tok.isBlankOrComment("#"));
+
+    ASSERT_TRUE(tok.nextLine());
+    EXPECT_EQ(tok.lineNumber(), 3);
+    double a, b, c;
+    EXPECT_TRUE(tok.nextDouble(a));
+    EXPECT_TRUE(tok.nextDouble(b));
+    EXPECT_TRUE(tok.nextDouble(c));
+    EXPECT_DOUBLE_EQ(a, 1.5);
+    EXPECT_DOUBLE_EQ(b, -2000.0);
+    EXPECT_DOUBLE_EQ(c, 4.0);
+    EXPECT_TRUE(tok.atLineEnd());  // trailing '\r' is whitespace
+
+    ASSERT_TRUE(tok.nextLine());
+    int i;
+    EXPECT_TRUE(tok.nextInt(i));
+    EXPECT_EQ(i, 7);
+    double bad;
+    EXPECT_FALSE(tok.nextDouble(bad));
+    EXPECT_FALSE(tok.nextLine());
+}
+
+TEST(LineTokenizer, MissingFileMessage) {
+    try {
+        TextSource::fromFile("_no_such_file.wth", "weather file");
+        FAIL() << "expected throw";
+    } catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string(e.what()).find("Cannot open weather file"), std::string::npos);
+    }
+}
+
+// ── Readers on the shared tokenizer ──────────────────────────────────
+
+TEST(TextReaders, CvfErrorKeepsLineNumber) {
+    try {
+        CvfReader::readFromString("0 1\n# c\n10 2\n5 3\n", 1);
+        FAIL() << "expected throw";
+    } catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string(e.what()).find("line 4"), std::string::npos);
+        EXPECT_NE(std::string(e.what()).find("monotonically"), std::string::npos);
+    }
+}
+
+TEST(TextReaders, CvfMultiColumnFromMappedFile) {
+    std::string path = tempPath(".cvf");
+    {
+        std::ofstream f(path);
+        f << "# t a b\r\n0 0.0 10.0\r\n100 1.0 20.0\r\n";
+    }
+    auto scheds = CvfReader::readMultiColumnFromFile(path, 5);
+    ASSERT_EQ(scheds.size(), 2u);
+    EXPECT_EQ(scheds[1].id, 6);
+    EXPECT_NEAR(scheds[0].getValue(50.0), 0.5, 1e-12);
+    EXPECT_NEAR(scheds[1].getValue(50.0), 15.0, 1e-12);
+    std::remove(path.c_str());
+}
+
+TEST(TextReaders, WpcTrailingCommentStopsRow) {
+    auto records = WpcReader::readPressureString("0 1 2 # note\n");
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].pressures.size(), 2u);
+}
+
+TEST(TextReaders, WeatherString) {
+    auto records = WeatherReader::readString(
+        "! CONTAM weather\n"
+        "month day hour T P Ws Wd RH\n"
+        "1 1 1 10.0 101325 3.0 180 60\n"
+        "1 1 2 12.0 101300 4.0 190\n");
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_NEAR(records[0].temperature, 283.15, 1e-9);
+    EXPECT_NEAR(records[0].humidity, 0.6, 1e-12);
+    EXPECT_NEAR(records[1].humidity, 0.5, 1e-12);
+    EXPECT_NEAR(records[1].windDirection, 190.0, 1e-12);
+}
+
+TEST(TextReaders, ContaminantRecords) {
+    auto records = ContaminantReader::parse("# t id c\n0 1 1e-6\n60 1 2e-6\nbad line\n");
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[1].speciesId, 1);
+    EXPECT_NEAR(ContaminantReader::interpolate(records, 1, 30.0), 1.5e-6, 1e-15);
+}
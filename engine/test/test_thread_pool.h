@@ -0,0 +1,23 @@
+#pragma once
+// Shared thread-pool helper for tests
+
+#include "utils/ThreadPool.h"
+
+namespace contam::test {
+
+// Sizes the shared pool for the enclosing block and restores the previous
+// size when it ends, also when an assertion leaves the test early
+class SharedThreadsScope {
+public:
+    explicit SharedThreadsScope(unsigned threads) : previous_(ThreadPool::sharedThreads()) {
+        ThreadPool::setSharedThreads(threads);
+    }
+    ~SharedThreadsScope() { ThreadPool::setSharedThreads(previous_); }
+    SharedThreadsScope(const SharedThreadsScope&) = delete;
+    SharedThreadsScope& operator=(const SharedThreadsScope&) = delete;
+
+private:
+    unsigned previous_;
+};
+
+} // namespace contam::test
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include "core/TransientSimulation.h"
+#include "control/Actuator.h"
+#include "elements/PowerLawOrifice.h"
+#include "elements/Damper.h"
+#include "io/ResultRecorder.h"
+#include <cmath>
+#include <memory>
+
+using namespace contam;
+
+// Room ventilated through a crack and a damper, with a CO2 source
+static Network makeDamperRoom() {
+    Network net;
+    Node outdoor(0, "Outdoor", NodeType::Ambient);
+    outdoor.setTemperature(283.15);
+    net.addNode(outdoor);
+
+    Node room(1, "Room");
+    room.setTemperature(293.15);
+    room.setVolume(30.0);
+    net.addNode(room);
+
+    Link l1(1, 0, 1, 0.5);
+    l1.setFlowElement(std::make_unique<PowerLawOrifice>(0.003, 0.65));
+    net.addLink(std::move(l1));
+
+    Link l2(2, 1, 0, 2.5);
+    l2.setFlowElement(std::make_unique<Damper>(0.005, 0.65, 0.1));
+    net.addLink(std::move(l2));
+    return net;
+}
+
+static void configure(TransientSimulation& sim) {
+    TransientConfig config;
+    config.endTime = 1800;
+    config.timeStep = 30;
+    config.outputInterval = 300;
+    sim.setConfig(config);
+    sim.setSpecies({Species(0, "CO2", 0.044, 0.0, 7.2e-4)});
+    sim.setSources({Source(1, 0, 5e-6)});
+}
+
+TEST(TransientStepping, MatchesRun) {
+    Network runNet = makeDamperRoom();
+    TransientSimulation runSim;
+    configure(runSim);
+    auto expected = runSim.run(runNet);
+
+    Network net = makeDamperRoom();
+    TransientSimulation sim;
+    configure(sim);
+    sim.setStoreHistory(false);
+    sim.start(net);
+    std::vector<std::shared_ptr<const TimeStepResult>> steps = {sim.lastStep()};
+    while (sim.advance()) steps.push_back(sim.lastStep());
+    auto result = sim.finish();
+
+    EXPECT_TRUE(result.completed);
+    EXPECT_TRUE(result.history.empty());
+    EXPECT_FALSE(sim.isRunning());
+    ASSERT_EQ(steps.size(), expected.history.size());
+    for (std::size_t i = 0; i < steps.size(); ++i) {
+        EXPECT_DOUBLE_EQ(steps[i]->time, expected.history[i].time);
+        EXPECT_EQ(steps[i]->contaminant.concentrations, expected.history[i].contaminant.concentrations);
+        EXPECT_EQ(steps[i]->airflow.massFlows, expected.history[i].airflow.massFlows);
+    }
+    EXPECT_THROW(sim.advance(), std::runtime_error);
+}
+
+TEST(TransientStepping, InputsChangeBetweenSteps) {
+    Network refNet = makeDamperRoom();
+    TransientSimulation ref;
+    configure(ref);
+    const double unchanged600 = ref.run(refNet).history[2].contaminant.concentrations[1][0];
+
+    Network net = makeDamperRoom();
+    TransientSimulation sim;
+    configure(sim);
+    auto recorder = std::make_shared<ResultRecorder>();
+    sim.addResultSink(recorder);
+
+    sim.start(net);
+    ASSERT_TRUE(sim.advance());
+    const double outflowClosed = net.getLink(1).getMassFlow();
+
+    // Switch the source off and open the damper from outside the engine
+    sim.setSources({});
+    sim.setActuators({Actuator(0, "Damper_act", ActuatorType::DamperFraction, 1)});
+    sim.setActuatorOverride(0, 1.0);
+    ASSERT_TRUE(sim.advance());
+    EXPECT_GT(net.getLink(1).getMassFlow(), outflowClosed);
+    EXPECT_LT(sim.lastStep()->contaminant.concentrations[1][0], unchanged600);
+    EXPECT_DOUBLE_EQ(sim.currentTime(), 600.0);
+
+    // Stopping early reports an incomplete run to the sinks
+    auto result = sim.finish();
+    EXPECT_FALSE(result.completed);
+    EXPECT_EQ(result.history.size(), 3u);
+    EXPECT_FALSE(recorder->completed());
+    EXPECT_EQ(recorder->results()->numSteps(), 3u);
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "core/TransientSimulation.h"
+#include "elements/PowerLawOrifice.h"
+#include "io/WpcBinary.h"
+#include "io/WpcReader.h"
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace contam;
+
+static std::string tempPath(const std::string& ext) {
+    return std::string("_test_wpc_binary") + ext;
+}
+
+static void writeText(const std::string& path, const std::string& content) {
+    std::ofstream f(path);
+    f << content;
+}
+
+// ── Packing and cursor interpolation ─────────────────────────────────
+
+TEST(WpcBinary, PackPressureRecords) {
+    auto records = WpcReader::readPressureString(
+        "0.0   1.0 2.0\n"
+        "60.0  3.0 4.0\n"
+        "120.0 5.0 6.0\n");
+    auto table = WpcBinary::pack(records);
+    EXPECT_EQ(table.stride, 2u);
+    ASSERT_EQ(table.times.size(), 3u);
+    ASSERT_EQ(table.values.size(), 6u);
+    EXPECT_NEAR(table.values[4], 5.0, 1e-12);
+}
+
+TEST(WpcBinary, PackRejectsRaggedRows) {
+    auto records = WpcReader::readPressureString(
+        "0.0  1.0 2.0\n"
+        "60.0 3.0\n");
+    EXPECT_THROW(WpcBinary::pack(records), std::runtime_error);
+}
+
+TEST(WpcBinary, CursorMatchesLegacyInterpolation) {
+    auto records = WpcReader::readPressureString(
+        "0.0    0.0  100.0\n"
+        "100.0  50.0  0.0\n"
+        "200.0  10.0  20.0\n"
+        "300.0  10.0  20.0\n");
+    auto table = WpcBinary::pack(records);
+    WpcCursor cursor;
+    double out[2];
+
+    // Forward sweep, then jump backwards to exercise the search fallback
+    for (double t : {-10.0, 0.0, 25.0, 100.0, 150.0, 299.0, 400.0, 50.0, 175.0}) {
+        cursor.interpolate(table.view(), t, out);
+        auto legacy = WpcReader::interpolatePressure(records, t);
+        EXPECT_NEAR(out[0], legacy[0], 1e-12) << "t=" << t;
+        EXPECT_NEAR(out[1], legacy[1], 1e-12) << "t=" << t;
+    }
+}
+
+// ── File round trip through the mapped reader ────────────────────────
+
+TEST(WpcBinary, PressureFileRoundTrip) {
+    std::string txt = tempPath(".wpc");
+    std::string bin = tempPath(".wpb");
+    writeText(txt,
+        "# time open0 open1 open2\n"
+        "0.0    10.0 20.0 30.0\n"
+        "3600.0 15.0 25.0 35.0\n");
+    WpcBinary::convertPressureFile(txt, bin);
+
+    {
+        WpcBinaryReader reader(bin);
+        EXPECT_EQ(reader.kind(), WpcBinaryKind::Pressure);
+        EXPECT_EQ(reader.numRecords(), 2u);
+        EXPECT_EQ(reader.numOpenings(), 3u);
+
+        WpcCursor cursor;
+        double out[3];
+        cursor.interpolate(reader.view(), 1800.0, out);
+        EXPECT_NEAR(out[0], 12.5, 1e-12);
+        EXPECT_NEAR(out[2], 32.5, 1e-12);
+    }
+    std::remove(txt.c_str());
+    std::remove(bin.c_str());
+}
+
+TEST(WpcBinary, ReaderRejectsOtherKinds) {
+    std::string path = tempPath("_kind.wpb");
+    WpcPackedTable table;
+    table.times = {0.0, 60.0};
+    table.values = {1.0, 2.0, 3.0, 4.0};
+    table.stride = 2;
+    table.numOpenings = 2;
+    WpcBinary::write(path, table);
+    EXPECT_TRUE(WpcBinary::isBinaryFile(path));
+
+    // Flip the kind to the retired concentration layout
+    {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(offsetof(WpcBinaryHeader, kind));
+        uint16_t kind = 1;
+        f.write(reinterpret_cast<const char*>(&kind), sizeof(kind));
+    }
+    EXPECT_THROW(WpcBinaryReader reader(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(WpcBinary, ReaderRejectsForeignFile) {
+    std::string path = tempPath("_bad.wpb");
+    writeText(path, std::string(64, 'x'));
+    EXPECT_THROW(WpcBinaryReader reader(path), std::runtime_error);
+    EXPECT_FALSE(WpcBinary::isBinaryFile(path));
+    std::remove(path.c_str());
+}
+
+// ── Transient runs ───────────────────────────────────────────────────
+
+TEST(WpcBinary, RaggedRecordsKeepLegacyInterpolation) {
+    Network net;
+    Node outdoor(1, "Out", NodeType::Ambient);
+    outdoor.setTemperature(293.15);
+    net.addNode(outdoor);
+    Node room(2, "Room");
+    room.setTemperature(293.15);
+    room.setVolume(50.0);
+    net.addNode(room);
+    Link link(1, 0, 1, 1.5);
+    link.setFlowElement(std::make_unique<PowerLawOrifice>(0.01, 0.65));
+    net.addLink(std::move(link));
+
+    // The second record is short; packing would reject it
+    auto records = WpcReader::readPressureString(
+        "0.0   10.0 99.0\n"
+        "120.0 20.0\n");
+    TransientConfig config;
+    config.endTime = 60.0;
+    config.timeStep = 60.0;
+    config.outputInterval = 60.0;
+    TransientSimulation sim;
+    sim.setConfig(config);
+    sim.setWpcPressures(records);
+    sim.setWpcLinkIndices({0});
+    EXPECT_TRUE(sim.run(net).completed);
+    EXPECT_NEAR(net.getNode(0).getPressure(), WpcReader::interpolatePressure(records, 60.0)[0], 1e-12);
+}